@@ -0,0 +1,109 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing a benchmark comparing the checked and unchecked access
+ * policies of the simple multiplication and transposition loops
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "benchmarks/benchmark_shapes.h"
+#include "matrix_library/cpu_simple/simple_kernels.h"
+#include "matrix_library/utils/matrix_utils.h"
+
+/**
+ * @brief Benchmarks the simple multiply-accumulate loop with one access
+ * policy on square matrices
+ *
+ * @tparam T Any numeric type
+ * @tparam Access CheckedAccess or UncheckedAccess
+ * @param state State of the benchmark holding the number of rows and columns
+ */
+template <typename T, typename Access>
+void BM_MultiplyAccumulate(benchmark::State& state) {
+  const size_t n = benchmark_shapes::Dimension(state, 0);
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      n, n, static_cast<T>(1), static_cast<T>(1));
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(
+      n, n, static_cast<T>(2));
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(
+      n, n, static_cast<T>(0));
+  for (auto _ : state) {
+    matrix_library::cpu_simple::simple_kernels::MultiplyAccumulate(A, B, C,
+                                                                   Access());
+    benchmark::ClobberMemory();
+  }
+  benchmark_shapes::SetRateCounters(state, 2.0 * static_cast<double>(n * n * n),
+                                    static_cast<double>(3 * n * n * sizeof(T)));
+}
+
+/**
+ * @brief Benchmarks the simple transpose loop with one access policy on
+ * square matrices
+ *
+ * @tparam T Any numeric type
+ * @tparam Access CheckedAccess or UncheckedAccess
+ * @param state State of the benchmark holding the number of rows and columns
+ */
+template <typename T, typename Access>
+void BM_Transpose(benchmark::State& state) {
+  const size_t n = benchmark_shapes::Dimension(state, 0);
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      n, n, static_cast<T>(1), static_cast<T>(1));
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(
+      n, n, static_cast<T>(0));
+  for (auto _ : state) {
+    matrix_library::cpu_simple::simple_kernels::Transpose(A, C, Access());
+    benchmark::ClobberMemory();
+  }
+  benchmark_shapes::SetRateCounters(state, 0.0,
+                                    static_cast<double>(2 * n * n * sizeof(T)));
+}
+
+/**
+ * @brief Registers both benchmarks of one access policy for int, float and
+ * double
+ */
+#define ACCESS_POLICY_BENCHMARKS(Access)                                    \
+  BENCHMARK_TEMPLATE(BM_MultiplyAccumulate, int, Access)                    \
+      ->ArgName("n")                                                        \
+      ->Arg(64)                                                             \
+      ->Arg(256)                                                            \
+      ->Arg(512);                                                           \
+  BENCHMARK_TEMPLATE(BM_MultiplyAccumulate, float, Access)                  \
+      ->ArgName("n")                                                        \
+      ->Arg(64)                                                             \
+      ->Arg(256)                                                            \
+      ->Arg(512);                                                           \
+  BENCHMARK_TEMPLATE(BM_MultiplyAccumulate, double, Access)                 \
+      ->ArgName("n")                                                        \
+      ->Arg(64)                                                             \
+      ->Arg(256)                                                            \
+      ->Arg(512);                                                           \
+  BENCHMARK_TEMPLATE(BM_Transpose, int, Access)                             \
+      ->ArgName("n")                                                        \
+      ->Arg(64)                                                             \
+      ->Arg(256)                                                            \
+      ->Arg(512);                                                           \
+  BENCHMARK_TEMPLATE(BM_Transpose, float, Access)                           \
+      ->ArgName("n")                                                        \
+      ->Arg(64)                                                             \
+      ->Arg(256)                                                            \
+      ->Arg(512);                                                           \
+  BENCHMARK_TEMPLATE(BM_Transpose, double, Access)                          \
+      ->ArgName("n")                                                        \
+      ->Arg(64)                                                             \
+      ->Arg(256)                                                            \
+      ->Arg(512)
+
+ACCESS_POLICY_BENCHMARKS(
+    matrix_library::cpu_simple::simple_kernels::CheckedAccess);
+ACCESS_POLICY_BENCHMARKS(
+    matrix_library::cpu_simple::simple_kernels::UncheckedAccess);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing the matrix shapes and counters shared by the benchmarks
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef BENCHMARKS__BENCHMARK_SHAPES_H_
+#define BENCHMARKS__BENCHMARK_SHAPES_H_
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+namespace benchmark_shapes {
+
+/**
+ * @brief Registers the matrix shapes used by benchmarks of a single matrix.
+ * Covers square, tall-skinny, short-fat, row vector, column vector and scalar
+ * matrices
+ *
+ * @param bench Benchmark to register the shapes with
+ */
+inline void MatrixShapes(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"rows", "cols"});
+  // Square
+  bench->Args({64, 64})->Args({256, 256})->Args({1024, 1024});
+  // Tall-skinny and short-fat
+  bench->Args({16384, 16})->Args({16, 16384});
+  // Row vector, column vector and scalar
+  bench->Args({1, 65536})->Args({65536, 1})->Args({1, 1});
+}
+
+/**
+ * @brief Registers the shapes used by benchmarks of A (m x k) * B (k x n).
+ * Covers square, tall-skinny, short-fat, matrix-vector, vector-matrix, outer
+ * product, dot product and scalar products
+ *
+ * @param bench Benchmark to register the shapes with
+ */
+inline void MultiplyShapes(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"m", "n", "k"});
+  // Square
+  bench->Args({64, 64, 64})->Args({256, 256, 256})->Args({512, 512, 512});
+  // Tall-skinny and short-fat
+  bench->Args({8192, 16, 16})->Args({16, 8192, 16});
+  // Matrix-vector and vector-matrix
+  bench->Args({1024, 1, 1024})->Args({1, 1024, 1024});
+  // Outer product, dot product and scalar
+  bench->Args({1024, 1024, 1})->Args({1, 1, 65536})->Args({1, 1, 1});
+}
+
+/**
+ * @brief Reads one of the shape arguments of a benchmark
+ *
+ * @param state State of the running benchmark
+ * @param index Index of the argument
+ * @return size_t Value of the argument
+ */
+inline size_t Dimension(const benchmark::State& state, size_t index) {
+  return static_cast<size_t>(state.range(index));
+}
+
+/**
+ * @brief Reports the floating point operations and memory traffic of one
+ * iteration as per second rates. These show up as FLOPS and Bytes columns in
+ * G/s, i.e. GFLOP/s and GB/s
+ *
+ * @param state State of the finished benchmark
+ * @param flops Operations done in one iteration. Not reported when zero
+ * @param bytes Bytes read and written in one iteration
+ */
+inline void SetRateCounters(benchmark::State& state, double flops,
+                            double bytes) {
+  if (flops > 0.0) {
+    state.counters["FLOPS"] =
+        benchmark::Counter(flops, benchmark::Counter::kIsIterationInvariantRate,
+                           benchmark::Counter::kIs1000);
+  }
+  state.counters["Bytes"] =
+      benchmark::Counter(bytes, benchmark::Counter::kIsIterationInvariantRate,
+                         benchmark::Counter::kIs1000);
+}
+
+}  // namespace benchmark_shapes
+
+#endif
@@ -0,0 +1,193 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing benchmarks of the matrix operations of the CPU simple and
+ * CPU parallel versions of library
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "benchmarks/benchmark_shapes.h"
+#include "matrix_library/cpu_parallel/matrix_ops.h"
+#include "matrix_library/cpu_simple/matrix_ops.h"
+#include "matrix_library/utils/dense_matrix.h"
+#include "matrix_library/utils/matrix_utils.h"
+
+/**
+ * @brief Matrices stored as nested vectors
+ */
+struct NestedLayout {
+  /**
+   * @brief Creates a sequential matrix stored as nested vectors
+   *
+   * @tparam T Any numeric type
+   * @param rows Number of rows
+   * @param cols Number of columns
+   * @return std::vector<std::vector<T>> Created matrix
+   */
+  template <typename T>
+  static std::vector<std::vector<T>> Create(size_t rows, size_t cols) {
+    return matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+        rows, cols, static_cast<T>(1), static_cast<T>(1));
+  }
+};
+
+/**
+ * @brief Matrices stored in one contiguous buffer
+ */
+struct DenseLayout {
+  /**
+   * @brief Creates a sequential matrix stored in one contiguous buffer
+   *
+   * @tparam T Any numeric type
+   * @param rows Number of rows
+   * @param cols Number of columns
+   * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Created matrix
+   */
+  template <typename T>
+  static matrix_library::utils::dense_matrix::DenseMatrix<T> Create(
+      size_t rows, size_t cols) {
+    return matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+        rows, cols, static_cast<T>(1), static_cast<T>(1));
+  }
+};
+
+/**
+ * @brief Forwards to the CPU simple version of library
+ */
+struct CpuSimple {
+  /**
+   * @brief Multiplies 2 matrices with the CPU simple version
+   *
+   * @tparam Matrix Nested vector or dense matrix
+   * @param A Matrix A to be multiplied in A * B
+   * @param B Matrix B to be multipled in A * B
+   * @return Matrix Matrix C that is equal to A * B
+   */
+  template <typename Matrix>
+  static Matrix Multiply(const Matrix& A, const Matrix& B) {
+    return matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  }
+
+  /**
+   * @brief Transposes a matrix with the CPU simple version
+   *
+   * @tparam Matrix Nested vector or dense matrix
+   * @param original_matrix Matrix that we will make a transpose of
+   * @return Matrix Transposed matrix
+   */
+  template <typename Matrix>
+  static Matrix Transpose(const Matrix& original_matrix) {
+    return matrix_library::cpu_simple::matrix_ops::MatrixTranspose(
+        original_matrix);
+  }
+};
+
+/**
+ * @brief Forwards to the CPU parallel version of library
+ */
+struct CpuParallel {
+  /**
+   * @brief Multiplies 2 matrices with the CPU parallel version
+   *
+   * @tparam Matrix Nested vector or dense matrix
+   * @param A Matrix A to be multiplied in A * B
+   * @param B Matrix B to be multipled in A * B
+   * @return Matrix Matrix C that is equal to A * B
+   */
+  template <typename Matrix>
+  static Matrix Multiply(const Matrix& A, const Matrix& B) {
+    return matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  }
+
+  /**
+   * @brief Transposes a matrix with the CPU parallel version
+   *
+   * @tparam Matrix Nested vector or dense matrix
+   * @param original_matrix Matrix that we will make a transpose of
+   * @return Matrix Transposed matrix
+   */
+  template <typename Matrix>
+  static Matrix Transpose(const Matrix& original_matrix) {
+    return matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(
+        original_matrix);
+  }
+};
+
+/**
+ * @brief Benchmarks C = A * B including the allocation of C
+ *
+ * @tparam T Any numeric type
+ * @tparam Layout NestedLayout or DenseLayout
+ * @tparam Backend CpuSimple or CpuParallel
+ * @param state State of the benchmark holding m, n and k
+ */
+template <typename T, typename Layout, typename Backend>
+void BM_MatrixMultiply(benchmark::State& state) {
+  const size_t m = benchmark_shapes::Dimension(state, 0);
+  const size_t n = benchmark_shapes::Dimension(state, 1);
+  const size_t k = benchmark_shapes::Dimension(state, 2);
+  auto A = Layout::template Create<T>(m, k);
+  auto B = Layout::template Create<T>(k, n);
+  for (auto _ : state) {
+    auto C = Backend::Multiply(A, B);
+    benchmark::DoNotOptimize(C);
+    benchmark::ClobberMemory();
+  }
+  benchmark_shapes::SetRateCounters(
+      state, 2.0 * static_cast<double>(m * n * k),
+      static_cast<double>((m * k + k * n + m * n) * sizeof(T)));
+}
+
+/**
+ * @brief Benchmarks transposing a matrix including the allocation of the
+ * transpose
+ *
+ * @tparam T Any numeric type
+ * @tparam Layout NestedLayout or DenseLayout
+ * @tparam Backend CpuSimple or CpuParallel
+ * @param state State of the benchmark holding rows and cols
+ */
+template <typename T, typename Layout, typename Backend>
+void BM_MatrixTranspose(benchmark::State& state) {
+  const size_t rows = benchmark_shapes::Dimension(state, 0);
+  const size_t cols = benchmark_shapes::Dimension(state, 1);
+  auto A = Layout::template Create<T>(rows, cols);
+  for (auto _ : state) {
+    auto transposed = Backend::Transpose(A);
+    benchmark::DoNotOptimize(transposed);
+    benchmark::ClobberMemory();
+  }
+  benchmark_shapes::SetRateCounters(
+      state, 0.0, static_cast<double>(2 * rows * cols * sizeof(T)));
+}
+
+/**
+ * @brief Registers the multiply and transpose benchmarks of one layout and
+ * version of library for int, float and double
+ */
+#define MATRIX_OPS_BENCHMARKS(Layout, Backend)                      \
+  BENCHMARK_TEMPLATE(BM_MatrixMultiply, int, Layout, Backend)       \
+      ->Apply(benchmark_shapes::MultiplyShapes);                    \
+  BENCHMARK_TEMPLATE(BM_MatrixMultiply, float, Layout, Backend)     \
+      ->Apply(benchmark_shapes::MultiplyShapes);                    \
+  BENCHMARK_TEMPLATE(BM_MatrixMultiply, double, Layout, Backend)    \
+      ->Apply(benchmark_shapes::MultiplyShapes);                    \
+  BENCHMARK_TEMPLATE(BM_MatrixTranspose, int, Layout, Backend)      \
+      ->Apply(benchmark_shapes::MatrixShapes);                      \
+  BENCHMARK_TEMPLATE(BM_MatrixTranspose, float, Layout, Backend)    \
+      ->Apply(benchmark_shapes::MatrixShapes);                      \
+  BENCHMARK_TEMPLATE(BM_MatrixTranspose, double, Layout, Backend)   \
+      ->Apply(benchmark_shapes::MatrixShapes)
+
+MATRIX_OPS_BENCHMARKS(NestedLayout, CpuSimple);
+MATRIX_OPS_BENCHMARKS(DenseLayout, CpuSimple);
+MATRIX_OPS_BENCHMARKS(NestedLayout, CpuParallel);
+MATRIX_OPS_BENCHMARKS(DenseLayout, CpuParallel);
+
+BENCHMARK_MAIN();
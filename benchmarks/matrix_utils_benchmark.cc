@@ -0,0 +1,219 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing benchmarks of the matrix utilities for nested vector and
+ * contiguous matrices
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "benchmarks/benchmark_shapes.h"
+#include "matrix_library/utils/dense_matrix.h"
+#include "matrix_library/utils/matrix_utils.h"
+
+/**
+ * @brief Forwards to the utilities for matrices stored as nested vectors
+ */
+struct NestedUtils {
+  /**
+   * @brief Creates a matrix with every element set to one value
+   *
+   * @tparam T Any numeric type
+   * @param rows Number of rows
+   * @param cols Number of columns
+   * @param value Value of every element
+   * @return std::vector<std::vector<T>> Created matrix
+   */
+  template <typename T>
+  static std::vector<std::vector<T>> Create(size_t rows, size_t cols,
+                                            T value) {
+    return matrix_library::utils::matrix_utils::CreateMatrix(rows, cols,
+                                                             value);
+  }
+
+  /**
+   * @brief Creates a matrix with sequentially increasing elements
+   *
+   * @tparam T Any numeric type
+   * @param rows Number of rows
+   * @param cols Number of columns
+   * @param start Value of the first element
+   * @param step Difference between consecutive elements
+   * @return std::vector<std::vector<T>> Created matrix
+   */
+  template <typename T>
+  static std::vector<std::vector<T>> CreateSequential(size_t rows, size_t cols,
+                                                      T start, T step) {
+    return matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+        rows, cols, start, step);
+  }
+
+  /**
+   * @brief Checks if 2 matrices are equal
+   *
+   * @tparam T Any numeric type
+   * @param A First matrix
+   * @param B Second matrix
+   * @return true If the matrices are equal
+   * @return false If the matrices are not equal
+   */
+  template <typename T>
+  static bool Equal(const std::vector<std::vector<T>>& A,
+                    const std::vector<std::vector<T>>& B) {
+    return matrix_library::utils::matrix_utils::IsMatricesEqual(A, B);
+  }
+};
+
+/**
+ * @brief Forwards to the utilities for matrices stored in one contiguous
+ * buffer
+ */
+struct DenseUtils {
+  /**
+   * @brief Creates a matrix with every element set to one value
+   *
+   * @tparam T Any numeric type
+   * @param rows Number of rows
+   * @param cols Number of columns
+   * @param value Value of every element
+   * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Created matrix
+   */
+  template <typename T>
+  static matrix_library::utils::dense_matrix::DenseMatrix<T> Create(
+      size_t rows, size_t cols, T value) {
+    return matrix_library::utils::dense_matrix::CreateMatrix(rows, cols,
+                                                             value);
+  }
+
+  /**
+   * @brief Creates a matrix with sequentially increasing elements
+   *
+   * @tparam T Any numeric type
+   * @param rows Number of rows
+   * @param cols Number of columns
+   * @param start Value of the first element
+   * @param step Difference between consecutive elements
+   * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Created matrix
+   */
+  template <typename T>
+  static matrix_library::utils::dense_matrix::DenseMatrix<T> CreateSequential(
+      size_t rows, size_t cols, T start, T step) {
+    return matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+        rows, cols, start, step);
+  }
+
+  /**
+   * @brief Checks if 2 matrices are equal
+   *
+   * @tparam T Any numeric type
+   * @param A First matrix
+   * @param B Second matrix
+   * @return true If the matrices are equal
+   * @return false If the matrices are not equal
+   */
+  template <typename T>
+  static bool Equal(
+      const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+      const matrix_library::utils::dense_matrix::DenseMatrix<T>& B) {
+    return matrix_library::utils::dense_matrix::IsMatricesEqual(A, B);
+  }
+};
+
+/**
+ * @brief Benchmarks creating a matrix filled with one value
+ *
+ * @tparam T Any numeric type
+ * @tparam Utils NestedUtils or DenseUtils
+ * @param state State of the benchmark holding rows and cols
+ */
+template <typename T, typename Utils>
+void BM_CreateMatrix(benchmark::State& state) {
+  const size_t rows = benchmark_shapes::Dimension(state, 0);
+  const size_t cols = benchmark_shapes::Dimension(state, 1);
+  for (auto _ : state) {
+    auto A = Utils::Create(rows, cols, static_cast<T>(1));
+    benchmark::DoNotOptimize(A);
+    benchmark::ClobberMemory();
+  }
+  benchmark_shapes::SetRateCounters(
+      state, 0.0, static_cast<double>(rows * cols * sizeof(T)));
+}
+
+/**
+ * @brief Benchmarks creating a sequential matrix
+ *
+ * @tparam T Any numeric type
+ * @tparam Utils NestedUtils or DenseUtils
+ * @param state State of the benchmark holding rows and cols
+ */
+template <typename T, typename Utils>
+void BM_CreateSequentialMatrix(benchmark::State& state) {
+  const size_t rows = benchmark_shapes::Dimension(state, 0);
+  const size_t cols = benchmark_shapes::Dimension(state, 1);
+  for (auto _ : state) {
+    auto A = Utils::CreateSequential(rows, cols, static_cast<T>(0),
+                                     static_cast<T>(1));
+    benchmark::DoNotOptimize(A);
+    benchmark::ClobberMemory();
+  }
+  benchmark_shapes::SetRateCounters(
+      state, 0.0, static_cast<double>(rows * cols * sizeof(T)));
+}
+
+/**
+ * @brief Benchmarks comparing 2 equal matrices, which reads every element of
+ * both
+ *
+ * @tparam T Any numeric type
+ * @tparam Utils NestedUtils or DenseUtils
+ * @param state State of the benchmark holding rows and cols
+ */
+template <typename T, typename Utils>
+void BM_IsMatricesEqual(benchmark::State& state) {
+  const size_t rows = benchmark_shapes::Dimension(state, 0);
+  const size_t cols = benchmark_shapes::Dimension(state, 1);
+  auto A = Utils::CreateSequential(rows, cols, static_cast<T>(0),
+                                   static_cast<T>(1));
+  auto B = Utils::CreateSequential(rows, cols, static_cast<T>(0),
+                                   static_cast<T>(1));
+  for (auto _ : state) {
+    bool equal = Utils::Equal(A, B);
+    benchmark::DoNotOptimize(equal);
+  }
+  benchmark_shapes::SetRateCounters(
+      state, 0.0, static_cast<double>(2 * rows * cols * sizeof(T)));
+}
+
+/**
+ * @brief Registers the utility benchmarks of one layout for int, float and
+ * double
+ */
+#define MATRIX_UTILS_BENCHMARKS(Utils)                                  \
+  BENCHMARK_TEMPLATE(BM_CreateMatrix, int, Utils)                       \
+      ->Apply(benchmark_shapes::MatrixShapes);                          \
+  BENCHMARK_TEMPLATE(BM_CreateMatrix, float, Utils)                     \
+      ->Apply(benchmark_shapes::MatrixShapes);                          \
+  BENCHMARK_TEMPLATE(BM_CreateMatrix, double, Utils)                    \
+      ->Apply(benchmark_shapes::MatrixShapes);                          \
+  BENCHMARK_TEMPLATE(BM_CreateSequentialMatrix, int, Utils)             \
+      ->Apply(benchmark_shapes::MatrixShapes);                          \
+  BENCHMARK_TEMPLATE(BM_CreateSequentialMatrix, float, Utils)           \
+      ->Apply(benchmark_shapes::MatrixShapes);                          \
+  BENCHMARK_TEMPLATE(BM_CreateSequentialMatrix, double, Utils)          \
+      ->Apply(benchmark_shapes::MatrixShapes);                          \
+  BENCHMARK_TEMPLATE(BM_IsMatricesEqual, int, Utils)                    \
+      ->Apply(benchmark_shapes::MatrixShapes);                          \
+  BENCHMARK_TEMPLATE(BM_IsMatricesEqual, float, Utils)                  \
+      ->Apply(benchmark_shapes::MatrixShapes);                          \
+  BENCHMARK_TEMPLATE(BM_IsMatricesEqual, double, Utils)                 \
+      ->Apply(benchmark_shapes::MatrixShapes)
+
+MATRIX_UTILS_BENCHMARKS(NestedUtils);
+MATRIX_UTILS_BENCHMARKS(DenseUtils);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing example usage of the contiguous dense matrix
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#include <iostream>
+#include <vector>
+
+#include "matrix_library/cpu_simple/matrix_ops.h"
+#include "matrix_library/utils/dense_matrix.h"
+#include "matrix_library/utils/matrix_utils.h"
+
+/**
+ * @brief Demonstrating usage of the dense matrix and migrating from nested
+ * vectors
+ *
+ * @return int Returns 0 when suceeds. Non zero code returned on failure
+ */
+int main() {
+  size_t n = 4, m = 3;
+  matrix_library::utils::dense_matrix::DenseMatrix<int> A =
+      matrix_library::utils::dense_matrix::CreateSequentialMatrix(n, m, 1, 1);
+  matrix_library::utils::dense_matrix::DenseMatrix<int> B =
+      matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A);
+  matrix_library::utils::dense_matrix::DenseMatrix<int> C =
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  matrix_library::utils::dense_matrix::PrintMatrix(A);
+  matrix_library::utils::dense_matrix::PrintMatrix(B);
+  matrix_library::utils::dense_matrix::PrintMatrix(C);
+
+  // Existing nested vector code can convert at the boundary
+  std::vector<std::vector<int>> A_nested =
+      matrix_library::utils::matrix_utils::CreateSequentialMatrix(n, m, 1, 1);
+  std::vector<std::vector<int>> C_nested =
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+          A_nested,
+          matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A_nested));
+  if (!matrix_library::utils::dense_matrix::IsMatricesEqual(
+          C,
+          matrix_library::utils::dense_matrix::FromNestedVector(C_nested))) {
+    return -1;
+  }
+
+  // A transpose view multiplies by A^T without materializing it
+  matrix_library::utils::dense_matrix::DenseMatrix<int> C_view =
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+          A, matrix_library::utils::dense_matrix::Transposed(A));
+  if (!matrix_library::utils::dense_matrix::IsMatricesEqual(C, C_view)) {
+    return -1;
+  }
+
+  // A * A^T is symmetric so only one triangle of it needs multiplying
+  matrix_library::utils::dense_matrix::DenseMatrix<int> C_symmetric =
+      matrix_library::cpu_simple::matrix_ops::SymmetricRankKUpdate(A);
+  if (!matrix_library::utils::dense_matrix::IsMatricesEqual(C, C_symmetric)) {
+    return -1;
+  }
+
+  // Strassen's multiplication pays off for large square products. A crossover
+  // of 1 recurses all the way down to show it agrees on a small one
+  matrix_library::utils::dense_matrix::DenseMatrix<int> C_strassen =
+      matrix_library::cpu_simple::matrix_ops::StrassenMultiply(A, B, 1);
+  if (!matrix_library::utils::dense_matrix::IsMatricesEqual(C, C_strassen)) {
+    return -1;
+  }
+  return 0;
+}
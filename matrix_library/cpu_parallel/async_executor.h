@@ -0,0 +1,130 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the asynchronous executor of the CPU
+ * parallel version of library. Submitted operations are queued and run in
+ * submission order on a dispatcher thread owned by the executor, which splits
+ * each of them across the shared thread pool like a synchronous call would.
+ * The submitting thread gets a std::future back and is free to do other work,
+ * such as reading the next request, in the meantime
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_PARALLEL__ASYNC_EXECUTOR_H_
+#define MATRIX_LIBRARY__CPU_PARALLEL__ASYNC_EXECUTOR_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "matrix_library/cpu_parallel/thread_pool.h"
+
+namespace matrix_library {
+namespace cpu_parallel {
+namespace async_executor {
+
+/**
+ * @brief Queue of operations run in submission order by a dispatcher thread,
+ * one after another with each using every thread of the pool. Destroying the
+ * executor runs the operations still queued before it returns
+ */
+class AsyncExecutor {
+ public:
+  /**
+   * @brief Starts the dispatcher thread
+   */
+  AsyncExecutor() : stop_(false) {
+    dispatcher_ = std::thread(&AsyncExecutor::DispatchLoop, this);
+  }
+
+  AsyncExecutor(const AsyncExecutor&) = delete;
+  AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+
+  ~AsyncExecutor() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    ready_.notify_all();
+    dispatcher_.join();
+  }
+
+  /**
+   * @brief Queues an operation
+   *
+   * @tparam F Callable taking no arguments
+   * @param operation Operation, moved into the queue
+   * @return std::future<decltype(std::declval<F&>()())> Ready with the
+   * result of the operation, or with the exception it threw, once it has run
+   * @throws Runtime Error if the executor is being destroyed
+   */
+  template <typename F>
+  std::future<decltype(std::declval<F&>()())> Submit(F operation) {
+    using Result = decltype(std::declval<F&>()());
+    // Shared so the type erased queue entry stays copyable
+    std::shared_ptr<std::packaged_task<Result()>> task =
+        std::make_shared<std::packaged_task<Result()>>(std::move(operation));
+    std::future<Result> future = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stop_) {
+        throw std::runtime_error("Executor is shutting down");
+      }
+      queue_.push_back([task]() { (*task)(); });
+    }
+    ready_.notify_one();
+    return future;
+  }
+
+ private:
+  void DispatchLoop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          return;
+        }
+        task = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      // Exceptions are stored in the future by the packaged task
+      task();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> queue_;
+  bool stop_;
+  std::thread dispatcher_;
+};
+
+/**
+ * @brief Executor used by the asynchronous operations of the library,
+ * started on the first asynchronous call
+ *
+ * @return AsyncExecutor& Shared executor
+ */
+inline AsyncExecutor& SharedAsyncExecutor() {
+  // The pool is created first so it outlives the operations still queued
+  // when the executor is destroyed at exit
+  matrix_library::cpu_parallel::thread_pool::SharedThreadPool();
+  static AsyncExecutor executor;
+  return executor;
+}
+
+}  // namespace async_executor
+}  // namespace cpu_parallel
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,239 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the multiplication plans of the CPU
+ * parallel version of library. A plan is made once for a shape, layout and
+ * thread count and resolves everything MatrixMultiplyInto decides on every
+ * call: the kernel, the micro-kernel and block sizes, the split of rows
+ * across threads and the packing workspace. Executing it only checks the
+ * shapes and runs the chosen kernel
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_PARALLEL__GEMM_PLAN_H_
+#define MATRIX_LIBRARY__CPU_PARALLEL__GEMM_PLAN_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#include "matrix_library/cpu_parallel/parallel_config.h"
+#include "matrix_library/cpu_parallel/parallel_kernels.h"
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/cpu_simple/simple_kernels.h"
+#include "matrix_library/cpu_simple/vector_kernels.h"
+#include "matrix_library/utils/dense_matrix.h"
+
+namespace matrix_library {
+namespace cpu_parallel {
+namespace gemm_plan {
+
+/**
+ * @brief Kernel a plan runs
+ */
+enum class GemmPath {
+  /// Streaming dot, matrix-vector or outer product kernels
+  kVector,
+  /// Streaming kernels with rows split across threads
+  kParallelVector,
+  /// Simple i-k-j loop for products too small to pack
+  kSimple,
+  /// Blocked kernel, with rows split across threads when there are several
+  /// row blocks
+  kBlocked
+};
+
+/**
+ * @brief Multiplication C = op_a(A) * op_b(B), or C += op_a(A) * op_b(B), of
+ * a fixed shape, planned once and executed many times. A plan owns its
+ * workspace so executing it does not allocate. Executing the same plan from
+ * several threads at once is not supported, each thread makes its own
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class GemmPlan {
+ public:
+  /**
+   * @brief Plans a product
+   *
+   * @param m Number of rows in op_a(A) and C
+   * @param n Number of columns in op_b(B) and C
+   * @param k Number of columns in op_a(A) and rows in op_b(B)
+   * @param op_a Whether A is transposed
+   * @param op_b Whether B is transposed
+   * @param num_threads Number of threads to use
+   */
+  GemmPlan(size_t m, size_t n, size_t k,
+           matrix_library::utils::dense_matrix::Operation op_a =
+               matrix_library::utils::dense_matrix::Operation::kNoTranspose,
+           matrix_library::utils::dense_matrix::Operation op_b =
+               matrix_library::utils::dense_matrix::Operation::kNoTranspose,
+           size_t num_threads =
+               matrix_library::cpu_parallel::parallel_config::GetNumThreads())
+      : m_(m),
+        n_(n),
+        k_(k),
+        transpose_a_(
+            op_a == matrix_library::utils::dense_matrix::Operation::kTranspose),
+        transpose_b_(
+            op_b == matrix_library::utils::dense_matrix::Operation::kTranspose),
+        num_threads_(std::max<size_t>(num_threads, 1)),
+        kernel_(matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<
+                T>()),
+        blocks_(matrix_library::cpu_simple::blocked_gemm::ComputeBlockSizes(
+            kernel_,
+            matrix_library::cpu_simple::blocked_gemm::GetCacheSizes())),
+        row_blocks_{1, m},
+        workspace_stride_(0) {
+    // Same choices as MatrixMultiplyInto, made once. Transposed operands are
+    // read through packing so only plain ones take the streaming kernels
+    if (!transpose_a_ && !transpose_b_ &&
+        matrix_library::cpu_simple::vector_kernels::IsVectorShape(m, n, k)) {
+      path_ = matrix_library::cpu_parallel::parallel_kernels::
+                      UseParallelVectorMultiply(m, n, k, num_threads_)
+                  ? GemmPath::kParallelVector
+                  : GemmPath::kVector;
+      // Every thread reads the gathered column of B, so it lives in the
+      // workspace rather than in per thread scratch
+      if (path_ == GemmPath::kParallelVector && n == 1 && k > 1) {
+        workspace_.resize(k);
+      }
+      return;
+    }
+    const bool parallel =
+        matrix_library::cpu_parallel::parallel_kernels::UseParallelMultiply(
+            m, n, k, num_threads_);
+    if (!parallel &&
+        !matrix_library::cpu_simple::blocked_gemm::UseBlockedGemm(m, n, k)) {
+      path_ = GemmPath::kSimple;
+      return;
+    }
+    path_ = GemmPath::kBlocked;
+    row_blocks_ = matrix_library::cpu_parallel::parallel_kernels::PartitionRows(
+        m, kernel_.mr, parallel ? num_threads_ : 1);
+    // Workspaces start on separate cache lines so threads do not share them
+    const size_t line = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+    workspace_stride_ =
+        (matrix_library::cpu_simple::blocked_gemm::GemmWorkspaceSize(
+             row_blocks_.rows_per_block, n, k, kernel_, blocks_) +
+         line - 1) /
+        line * line;
+    workspace_.resize(workspace_stride_ * row_blocks_.num_blocks);
+  }
+
+  size_t m() const { return m_; }
+  size_t n() const { return n_; }
+  size_t k() const { return k_; }
+  size_t num_threads() const { return num_threads_; }
+
+  /**
+   * @brief Gets the kernel the plan runs
+   */
+  GemmPath path() const { return path_; }
+
+  /**
+   * @brief Gets the number of row blocks the blocked kernel is split into,
+   * one per thread
+   */
+  size_t num_blocks() const { return row_blocks_.num_blocks; }
+
+  /**
+   * @brief Runs the planned product
+   *
+   * @param A Matrix A to be multiplied in op_a(A) * op_b(B)
+   * @param B Matrix B to be multipled in op_a(A) * op_b(B)
+   * @param C Matrix with m rows and n columns. Must not be A or B
+   * @param accumulate Add the product to C instead of overwriting it
+   * @throws Runtime Error if the matrices do not have the planned shapes
+   * @throws Runtime Error if C is A or B
+   */
+  void Execute(const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+               const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+               matrix_library::utils::dense_matrix::DenseMatrix<T>& C,
+               bool accumulate = false) {
+    if (A.num_rows() != (transpose_a_ ? k_ : m_) ||
+        A.num_cols() != (transpose_a_ ? m_ : k_) ||
+        B.num_rows() != (transpose_b_ ? n_ : k_) ||
+        B.num_cols() != (transpose_b_ ? k_ : n_) || C.num_rows() != m_ ||
+        C.num_cols() != n_) {
+      throw std::runtime_error("Matrices do not match the plan");
+    }
+    if (&C == &A || &C == &B) {
+      throw std::runtime_error("Matrix C cannot be one of the inputs");
+    }
+    switch (path_) {
+      case GemmPath::kVector:
+        matrix_library::cpu_simple::vector_kernels::MultiplyVectorShape<T>(
+            m_, n_, k_, [&A](size_t i) { return A.row(i); },
+            [&B](size_t p) { return B.row(p); },
+            [&C](size_t i) { return C.row(i); }, accumulate);
+        return;
+      case GemmPath::kParallelVector:
+        matrix_library::cpu_parallel::parallel_kernels::MultiplyVectorShape<
+            T>(
+            m_, n_, k_, [&A](size_t i) { return A.row(i); },
+            [&B](size_t p) { return B.row(p); },
+            [&C](size_t i) { return C.row(i); }, accumulate, num_threads_,
+            workspace_.data());
+        return;
+      default:
+        break;
+    }
+    // Swapping the strides reads the stored matrix in transposed order
+    const matrix_library::cpu_simple::blocked_gemm::StridedOperand<T> a(
+        A.data(), transpose_a_ ? 1 : A.leading_dimension(),
+        transpose_a_ ? A.leading_dimension() : 1);
+    const matrix_library::cpu_simple::blocked_gemm::StridedOperand<T> b(
+        B.data(), transpose_b_ ? 1 : B.leading_dimension(),
+        transpose_b_ ? B.leading_dimension() : 1);
+    if (path_ == GemmPath::kSimple) {
+      // The simple loop always sums into C so it starts from 0 when
+      // overwriting
+      if (!accumulate) {
+        for (size_t i = 0; i < m_; i++) {
+          std::fill(C.row(i), C.row(i) + n_, static_cast<T>(0));
+        }
+      }
+      // Plain operands keep the row pointer loop the compiler vectorizes
+      if (!transpose_a_ && !transpose_b_) {
+        matrix_library::cpu_simple::simple_kernels::MultiplyAccumulate(
+            A, B, C,
+            matrix_library::cpu_simple::simple_kernels::DefaultAccess());
+      } else {
+        matrix_library::cpu_simple::simple_kernels::MultiplyAccumulate(
+            m_, n_, k_, a, b, C.data(), C.leading_dimension());
+      }
+      return;
+    }
+    matrix_library::cpu_parallel::parallel_kernels::PlannedGemm<T>(
+        m_, n_, k_, a, b,
+        matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(
+            C.data(), C.leading_dimension()),
+        accumulate, kernel_, blocks_, row_blocks_, workspace_.data(),
+        workspace_stride_);
+  }
+
+ private:
+  size_t m_;
+  size_t n_;
+  size_t k_;
+  bool transpose_a_;
+  bool transpose_b_;
+  size_t num_threads_;
+  GemmPath path_;
+  matrix_library::cpu_simple::blocked_gemm::MicroKernel<T> kernel_;
+  matrix_library::cpu_simple::blocked_gemm::BlockSizes blocks_;
+  matrix_library::cpu_parallel::parallel_kernels::RowBlocks row_blocks_;
+  size_t workspace_stride_;
+  typename matrix_library::utils::dense_matrix::DenseMatrix<T>::Storage
+      workspace_;
+};
+
+}  // namespace gemm_plan
+}  // namespace cpu_parallel
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,1251 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of matrix operations in CPU parallel version
+ * of library
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_PARALLEL__MATRIX_OPS_H_
+#define MATRIX_LIBRARY__CPU_PARALLEL__MATRIX_OPS_H_
+
+#include <exception>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix_library/cpu_parallel/async_executor.h"
+#include "matrix_library/cpu_parallel/parallel_config.h"
+#include "matrix_library/cpu_parallel/parallel_kernels.h"
+#include "matrix_library/cpu_simple/batched_gemm.h"
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/cpu_simple/matrix_chain.h"
+#include "matrix_library/cpu_simple/matrix_ops.h"
+#include "matrix_library/cpu_simple/packed_matrix.h"
+#include "matrix_library/cpu_simple/vector_kernels.h"
+#include "matrix_library/utils/dense_matrix.h"
+#include "matrix_library/utils/matrix_utils.h"
+
+namespace matrix_library {
+namespace cpu_parallel {
+namespace matrix_ops {
+
+/**
+ * @brief Multiplies 2 matrices into a preallocated matrix if possible
+ * otherwise it throws an error. Rows of C are split across threads when the
+ * product is large enough. The storage of C is reused so steady state loops do
+ * not allocate
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @param C Matrix with as many rows as A and as many columns as B. Set to
+ * A * B, or to C + A * B when accumulating. Must not be A or B
+ * @param accumulate Add the product to C instead of overwriting it
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A or B
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline void MatrixMultiplyInto(const std::vector<std::vector<T>>& A,
+                               const std::vector<std::vector<T>>& B,
+                               std::vector<std::vector<T>>& C,
+                               bool accumulate = false) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  // Invalid, empty and small products are handled by the CPU simple version
+  if (!matrix_library::utils::matrix_utils::CanMatricesMultiply(A, B) ||
+      matrix_library::utils::matrix_utils::IsMatrixEmpty(B) ||
+      !matrix_library::cpu_parallel::parallel_kernels::UseParallelProduct(
+          A.size(), B.front().size(), B.size(), num_threads)) {
+    matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(A, B, C,
+                                                               accumulate);
+    return;
+  }
+  if (&C == &A || &C == &B) {
+    throw std::runtime_error("Matrix C cannot be one of the inputs");
+  }
+  if (C.size() != A.size() ||
+      !matrix_library::utils::matrix_utils::IsMatrixFollowingDimensions(
+          C, B.front().size())) {
+    throw std::runtime_error("Matrix C has the wrong shape");
+  }
+  if (matrix_library::cpu_simple::vector_kernels::IsVectorShape(
+          A.size(), B.front().size(), B.size())) {
+    matrix_library::cpu_parallel::parallel_kernels::MultiplyVectorShape<T>(
+        A.size(), B.front().size(), B.size(),
+        [&A](size_t i) { return A[i].data(); },
+        [&B](size_t p) { return B[p].data(); },
+        [&C](size_t i) { return C[i].data(); }, accumulate, num_threads);
+    return;
+  }
+  matrix_library::cpu_parallel::parallel_kernels::Gemm<T>(
+      A.size(), B.front().size(), B.size(),
+      matrix_library::cpu_simple::blocked_gemm::NestedOperand<T>(A),
+      matrix_library::cpu_simple::blocked_gemm::NestedOperand<T>(B),
+      matrix_library::cpu_simple::blocked_gemm::NestedOutput<T>(C),
+      accumulate, num_threads);
+}
+
+/**
+ * @brief Multiplies 2 matrices if possible otherwise it throws an error. Rows
+ * of C are split across threads when the product is large enough
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @return std::vector<std::vector<T>> Matrix C that is equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline std::vector<std::vector<T>> MatrixMultiply(
+    const std::vector<std::vector<T>>& A,
+    const std::vector<std::vector<T>>& B) {
+  // If the 2 matrices cannot be multiplied throw a runtime error
+  if (!matrix_library::utils::matrix_utils::CanMatricesMultiply(A, B)) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  // Empty products are handled by the CPU simple version
+  if (matrix_library::utils::matrix_utils::IsMatrixEmpty(B)) {
+    return matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  }
+  std::vector<std::vector<T>> C =
+      matrix_library::utils::matrix_utils::CreateMatrix(
+          A.size(), B.front().size(), static_cast<T>(0));
+  MatrixMultiplyInto(A, B, C, true);
+  return C;
+}
+
+/**
+ * @brief Multiplies 2 contiguous matrices into a preallocated matrix if
+ * possible otherwise it throws an error. Rows of C are split across threads
+ * when the product is large enough. The storage of C is reused so steady state
+ * loops do not allocate
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @param C Matrix with as many rows as A and as many columns as B. Set to
+ * A * B, or to C + A * B when accumulating. Must not be A or B
+ * @param accumulate Add the product to C instead of overwriting it
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A or B
+ */
+template <typename T>
+inline void MatrixMultiplyInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C,
+    bool accumulate = false) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  if (A.num_cols() != B.num_rows() || &C == &A || &C == &B ||
+      C.num_rows() != A.num_rows() || C.num_cols() != B.num_cols() ||
+      !matrix_library::cpu_parallel::parallel_kernels::UseParallelProduct(
+          A.num_rows(), B.num_cols(), A.num_cols(), num_threads)) {
+    // Invalid and small products are handled by the CPU simple version
+    matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(A, B, C,
+                                                               accumulate);
+    return;
+  }
+  if (matrix_library::cpu_simple::vector_kernels::IsVectorShape(
+          A.num_rows(), B.num_cols(), A.num_cols())) {
+    matrix_library::cpu_parallel::parallel_kernels::MultiplyVectorShape<T>(
+        A.num_rows(), B.num_cols(), A.num_cols(),
+        [&A](size_t i) { return A.row(i); },
+        [&B](size_t p) { return B.row(p); },
+        [&C](size_t i) { return C.row(i); }, accumulate, num_threads);
+    return;
+  }
+  matrix_library::cpu_parallel::parallel_kernels::Gemm<T>(
+      A.num_rows(), B.num_cols(), A.num_cols(),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+          A.data(), A.leading_dimension(), 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+          B.data(), B.leading_dimension(), 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(
+          C.data(), C.leading_dimension()),
+      accumulate, num_threads);
+}
+
+/**
+ * @brief Multiplies 2 contiguous matrices if possible otherwise it throws an
+ * error. Rows of C are split across threads when the product is large enough
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B) {
+  if (A.num_cols() != B.num_rows()) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  // Every element is overwritten so the output is left uninitialized
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(
+      A.num_rows(), B.num_cols(),
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  MatrixMultiplyInto(A, B, C, false);
+  return C;
+}
+
+/**
+ * @brief Multiplies 2 contiguous matrices, either of which can be read in
+ * transposed order, into a preallocated matrix if possible otherwise it throws
+ * an error. Transposed operands are never copied, the kernel reads them
+ * through its packing routine. Rows of C are split across threads when the
+ * product is large enough
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in op_a(A) * op_b(B)
+ * @param op_a Whether A is transposed
+ * @param B Matrix B to be multipled in op_a(A) * op_b(B)
+ * @param op_b Whether B is transposed
+ * @param C Matrix with as many rows as op_a(A) and as many columns as
+ * op_b(B). Set to op_a(A) * op_b(B), or to C + op_a(A) * op_b(B) when
+ * accumulating. Must not be A or B
+ * @param accumulate Add the product to C instead of overwriting it
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A or B
+ */
+template <typename T>
+inline void MatrixMultiplyInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    matrix_library::utils::dense_matrix::Operation op_a,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::Operation op_b,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C,
+    bool accumulate = false) {
+  const bool transpose_a =
+      op_a == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const bool transpose_b =
+      op_b == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  const size_t m = transpose_a ? A.num_cols() : A.num_rows();
+  const size_t k = transpose_a ? A.num_rows() : A.num_cols();
+  const size_t n = transpose_b ? B.num_rows() : B.num_cols();
+  if (k != (transpose_b ? B.num_cols() : B.num_rows()) || &C == &A ||
+      &C == &B || C.num_rows() != m || C.num_cols() != n ||
+      !matrix_library::cpu_parallel::parallel_kernels::UseParallelMultiply(
+          m, n, k, num_threads)) {
+    // Invalid and small products are handled by the CPU simple version
+    matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+        A, op_a, B, op_b, C, accumulate);
+    return;
+  }
+  // Swapping the strides reads the stored matrix in transposed order
+  matrix_library::cpu_parallel::parallel_kernels::Gemm<T>(
+      m, n, k,
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+          A.data(), transpose_a ? 1 : A.leading_dimension(),
+          transpose_a ? A.leading_dimension() : 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+          B.data(), transpose_b ? 1 : B.leading_dimension(),
+          transpose_b ? B.leading_dimension() : 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(
+          C.data(), C.leading_dimension()),
+      accumulate, num_threads);
+}
+
+/**
+ * @brief Computes C = epilogue(op_a(A) * op_b(B)) for contiguous matrices if
+ * possible otherwise it throws an error. The epilogue runs on each tile of the
+ * product before it is stored so C is written once
+ *
+ * @tparam T Any numeric type of A and B, in which products are accumulated
+ * @tparam U Any numeric type of C
+ * @tparam Epilogue Callable taking (i, j, value) for element (i, j) of the
+ * product and returning what is stored in C. Called concurrently
+ * @param A Matrix A to be multiplied in op_a(A) * op_b(B)
+ * @param op_a Whether A is transposed
+ * @param B Matrix B to be multipled in op_a(A) * op_b(B)
+ * @param op_b Whether B is transposed
+ * @param C Matrix with as many rows as op_a(A) and as many columns as
+ * op_b(B). Must not be A or B
+ * @param epilogue Epilogue applied to every element of the product
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A or B
+ */
+template <typename T, typename U, typename Epilogue,
+          typename = typename std::enable_if<
+              std::is_class<Epilogue>::value>::type>
+inline void MatrixMultiplyInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    matrix_library::utils::dense_matrix::Operation op_a,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::Operation op_b,
+    matrix_library::utils::dense_matrix::DenseMatrix<U>& C,
+    const Epilogue& epilogue) {
+  const bool transpose_a =
+      op_a == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const bool transpose_b =
+      op_b == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  const size_t m = transpose_a ? A.num_cols() : A.num_rows();
+  const size_t k = transpose_a ? A.num_rows() : A.num_cols();
+  const size_t n = transpose_b ? B.num_rows() : B.num_cols();
+  if (k != (transpose_b ? B.num_cols() : B.num_rows()) ||
+      static_cast<const void*>(&C) == static_cast<const void*>(&A) ||
+      static_cast<const void*>(&C) == static_cast<const void*>(&B) ||
+      C.num_rows() != m || C.num_cols() != n ||
+      !matrix_library::cpu_parallel::parallel_kernels::UseParallelMultiply(
+          m, n, k, num_threads)) {
+    // Invalid and small products are handled by the CPU simple version
+    matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+        A, op_a, B, op_b, C, epilogue);
+    return;
+  }
+  // Swapping the strides reads the stored matrix in transposed order
+  matrix_library::cpu_parallel::parallel_kernels::GemmEpilogue<T>(
+      m, n, k,
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+          A.data(), transpose_a ? 1 : A.leading_dimension(),
+          transpose_a ? A.leading_dimension() : 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+          B.data(), transpose_b ? 1 : B.leading_dimension(),
+          transpose_b ? B.leading_dimension() : 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<U>(
+          C.data(), C.leading_dimension()),
+      epilogue, num_threads);
+}
+
+/**
+ * @brief Multiplies a contiguous matrix with a packed matrix into a
+ * preallocated matrix if possible otherwise it throws an error. Rows of C are
+ * split across threads, all of which read the same panels of B
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Packed matrix B to be multipled in A * B
+ * @param C Matrix with as many rows as A and as many columns as B. Must not
+ * be A
+ * @param accumulate Add the product to C instead of overwriting it
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A
+ */
+template <typename T>
+inline void MatrixMultiplyInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::cpu_simple::packed_matrix::PackedMatrix<T>& B,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C,
+    bool accumulate = false) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  if (A.num_cols() != B.num_rows() || &C == &A ||
+      C.num_rows() != A.num_rows() || C.num_cols() != B.num_cols() ||
+      !B.MatchesKernel(matrix_library::cpu_simple::blocked_gemm::
+                           DefaultMicroKernel<T>()) ||
+      !matrix_library::cpu_parallel::parallel_kernels::UseParallelMultiply(
+          A.num_rows(), B.num_cols(), B.num_rows(), num_threads)) {
+    // Invalid, small and repacking products are handled by the CPU simple
+    // version
+    matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(A, B, C,
+                                                               accumulate);
+    return;
+  }
+  matrix_library::cpu_parallel::parallel_kernels::Gemm<T>(
+      A.num_rows(), B.num_cols(), B.num_rows(),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+          A.data(), A.leading_dimension(), 1),
+      B.panels(),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(
+          C.data(), C.leading_dimension()),
+      accumulate, num_threads);
+}
+
+/**
+ * @brief Computes C = epilogue(A * B) for a contiguous matrix A and a packed
+ * matrix B if possible otherwise it throws an error. Rows of C are split
+ * across threads
+ *
+ * @tparam T Any numeric type of A and B, in which products are accumulated
+ * @tparam U Any numeric type of C
+ * @tparam Epilogue Callable taking (i, j, value) for element (i, j) of the
+ * product and returning what is stored in C. Called concurrently
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Packed matrix B to be multipled in A * B
+ * @param C Matrix with as many rows as A and as many columns as B. Must not
+ * be A
+ * @param epilogue Epilogue applied to every element of the product
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A
+ */
+template <typename T, typename U, typename Epilogue,
+          typename = typename std::enable_if<
+              std::is_class<Epilogue>::value>::type>
+inline void MatrixMultiplyInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::cpu_simple::packed_matrix::PackedMatrix<T>& B,
+    matrix_library::utils::dense_matrix::DenseMatrix<U>& C,
+    const Epilogue& epilogue) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  if (A.num_cols() != B.num_rows() ||
+      static_cast<const void*>(&C) == static_cast<const void*>(&A) ||
+      C.num_rows() != A.num_rows() || C.num_cols() != B.num_cols() ||
+      !B.MatchesKernel(matrix_library::cpu_simple::blocked_gemm::
+                           DefaultMicroKernel<T>()) ||
+      !matrix_library::cpu_parallel::parallel_kernels::UseParallelMultiply(
+          A.num_rows(), B.num_cols(), B.num_rows(), num_threads)) {
+    // Invalid, small and repacking products are handled by the CPU simple
+    // version
+    matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(A, B, C,
+                                                               epilogue);
+    return;
+  }
+  matrix_library::cpu_parallel::parallel_kernels::GemmEpilogue<T>(
+      A.num_rows(), B.num_cols(), B.num_rows(),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+          A.data(), A.leading_dimension(), 1),
+      B.panels(),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<U>(
+          C.data(), C.leading_dimension()),
+      epilogue, num_threads);
+}
+
+/**
+ * @brief Multiplies a contiguous matrix with a packed matrix if possible
+ * otherwise it throws an error. Rows of C are split across threads
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Packed matrix B to be multipled in A * B
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that
+ * is equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::cpu_simple::packed_matrix::PackedMatrix<T>& B) {
+  if (A.num_cols() != B.num_rows()) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(
+      A.num_rows(), B.num_cols(),
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  MatrixMultiplyInto(A, B, C);
+  return C;
+}
+
+/**
+ * @brief Multiplies 2 contiguous matrices, either of which can be read in
+ * transposed order, if possible otherwise it throws an error
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in op_a(A) * op_b(B)
+ * @param op_a Whether A is transposed
+ * @param B Matrix B to be multipled in op_a(A) * op_b(B)
+ * @param op_b Whether B is transposed
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to op_a(A) * op_b(B)
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    matrix_library::utils::dense_matrix::Operation op_a,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::Operation op_b) {
+  const bool transpose_a =
+      op_a == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const bool transpose_b =
+      op_b == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  if ((transpose_a ? A.num_rows() : A.num_cols()) !=
+      (transpose_b ? B.num_cols() : B.num_rows())) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  // Every element is overwritten so the output is left uninitialized
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(
+      transpose_a ? A.num_cols() : A.num_rows(),
+      transpose_b ? B.num_rows() : B.num_cols(),
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  MatrixMultiplyInto(A, op_a, B, op_b, C, false);
+  return C;
+}
+
+/**
+ * @brief Multiplies A^T * B without materializing A^T
+ *
+ * @tparam T Any numeric type
+ * @param A View of the transpose of a matrix
+ * @param B Matrix B
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::TransposeView<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B) {
+  return MatrixMultiply(
+      A.matrix(), matrix_library::utils::dense_matrix::Operation::kTranspose,
+      B, matrix_library::utils::dense_matrix::Operation::kNoTranspose);
+}
+
+/**
+ * @brief Multiplies A * B^T without materializing B^T
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param B View of the transpose of a matrix
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::TransposeView<T>& B) {
+  return MatrixMultiply(
+      A, matrix_library::utils::dense_matrix::Operation::kNoTranspose,
+      B.matrix(), matrix_library::utils::dense_matrix::Operation::kTranspose);
+}
+
+/**
+ * @brief Multiplies A^T * B^T without materializing either transpose
+ *
+ * @tparam T Any numeric type
+ * @param A View of the transpose of a matrix
+ * @param B View of the transpose of a matrix
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::TransposeView<T>& A,
+    const matrix_library::utils::dense_matrix::TransposeView<T>& B) {
+  return MatrixMultiply(
+      A.matrix(), matrix_library::utils::dense_matrix::Operation::kTranspose,
+      B.matrix(), matrix_library::utils::dense_matrix::Operation::kTranspose);
+}
+
+/**
+ * @brief Multiplies a chain of contiguous matrices in the cheapest order.
+ * The order is chosen by dynamic programming over a cost model of the kernels
+ * and intermediate buffers are reused as the chain is evaluated. Independent
+ * sub-products run concurrently when they are too small to use every thread
+ * on their own
+ *
+ * @tparam T Any numeric type
+ * @param matrices Matrices to multiply from left to right. Each must have as
+ * many columns as the next has rows
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Product of all
+ * the matrices
+ * @throws Runtime Error if the chain has no matrices
+ * @throws Runtime Error if consecutive matrices cannot multiply
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MultiplyChain(
+    const std::vector<std::reference_wrapper<
+        const matrix_library::utils::dense_matrix::DenseMatrix<T>>>&
+        matrices) {
+  if (matrices.empty()) {
+    throw std::runtime_error("Chain has no matrices");
+  }
+  std::vector<size_t> dims(1, matrices.front().get().num_rows());
+  for (const auto& matrix : matrices) {
+    if (matrix.get().num_rows() != dims.back()) {
+      throw std::runtime_error("Matrices in the chain cannot multiply");
+    }
+    dims.push_back(matrix.get().num_cols());
+  }
+  if (matrices.size() == 1) {
+    return matrices.front().get();
+  }
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  return matrix_library::cpu_simple::matrix_chain::Execute(
+      matrices, matrix_library::cpu_simple::matrix_chain::PlanChain(dims),
+      [num_threads](const std::vector<
+                    matrix_library::cpu_simple::matrix_chain::ChainProduct<T>>&
+                        products) {
+        // Products that fill every thread on their own run one after another
+        bool concurrent = products.size() > 1;
+        if (products.size() < num_threads) {
+          for (const auto& product : products) {
+            if (matrix_library::cpu_parallel::parallel_kernels::
+                    UseParallelProduct(product.left->num_rows(),
+                                       product.right->num_cols(),
+                                       product.left->num_cols(),
+                                       num_threads)) {
+              concurrent = false;
+            }
+          }
+        }
+        if (!concurrent) {
+          for (const auto& product : products) {
+            MatrixMultiplyInto(*product.left, *product.right, *product.out);
+          }
+          return;
+        }
+        matrix_library::cpu_parallel::parallel_kernels::ForEachConcurrently(
+            products.size(),
+            [&products](size_t i) {
+              matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+                  *products[i].left, *products[i].right, *products[i].out);
+            },
+            num_threads);
+      });
+}
+
+/**
+ * @brief Multiplies a chain of contiguous matrices in the cheapest order, as
+ * in MultiplyChain({std::cref(A), std::cref(B), std::cref(C)})
+ *
+ * @tparam T Any numeric type
+ * @param matrices Matrices to multiply from left to right. Each must have as
+ * many columns as the next has rows
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Product of all
+ * the matrices
+ * @throws Runtime Error if the chain has no matrices
+ * @throws Runtime Error if consecutive matrices cannot multiply
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MultiplyChain(
+    std::initializer_list<std::reference_wrapper<
+        const matrix_library::utils::dense_matrix::DenseMatrix<T>>>
+        matrices) {
+  return MultiplyChain(std::vector<std::reference_wrapper<
+                           const matrix_library::utils::dense_matrix::
+                               DenseMatrix<T>>>(matrices));
+}
+
+/**
+ * @brief Computes the dot product of 2 vectors. A single sum does not gain
+ * from threads so this is the CPU simple version
+ *
+ * @tparam T Any numeric type
+ * @param x Vector x
+ * @param y Vector y with as many elements as x
+ * @return T Sum of x[i] * y[i]
+ * @throws Runtime Error if the vectors have different sizes
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline T Dot(const std::vector<T>& x, const std::vector<T>& y) {
+  return matrix_library::cpu_simple::matrix_ops::Dot(x, y);
+}
+
+/**
+ * @brief Multiplies a matrix with a vector. Rows are split across threads
+ * when the matrix is large enough
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param x Vector with as many elements as A has columns
+ * @return std::vector<T> Vector y that is equal to A * x
+ * @throws Runtime Error if the matrix and vector cannot be multiplied
+ * @throws Runtime error if the matrix has a column mismatch
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline std::vector<T> MatrixVectorMultiply(
+    const std::vector<std::vector<T>>& A, const std::vector<T>& x) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  if (x.empty() ||
+      !matrix_library::cpu_parallel::parallel_kernels::
+          UseParallelVectorMultiply(A.size(), 1, x.size(), num_threads) ||
+      !matrix_library::utils::matrix_utils::IsMatrixFollowingDimensions(
+          A, x.size())) {
+    // Invalid and small products are handled by the CPU simple version
+    return matrix_library::cpu_simple::matrix_ops::MatrixVectorMultiply(A, x);
+  }
+  std::vector<T> y(A.size());
+  matrix_library::cpu_parallel::parallel_kernels::MultiplyVectorShape<T>(
+      A.size(), 1, x.size(), [&A](size_t i) { return A[i].data(); },
+      [&x](size_t p) { return &x[p]; }, [&y](size_t i) { return &y[i]; },
+      false, num_threads);
+  return y;
+}
+
+/**
+ * @brief Multiplies a contiguous matrix with a vector. Rows are split across
+ * threads when the matrix is large enough
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param x Vector with as many elements as A has columns
+ * @return std::vector<T> Vector y that is equal to A * x
+ * @throws Runtime Error if the matrix and vector cannot be multiplied
+ */
+template <typename T>
+inline std::vector<T> MatrixVectorMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const std::vector<T>& x) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  if (A.num_cols() != x.size() || x.empty() ||
+      !matrix_library::cpu_parallel::parallel_kernels::
+          UseParallelVectorMultiply(A.num_rows(), 1, x.size(), num_threads)) {
+    // Invalid and small products are handled by the CPU simple version
+    return matrix_library::cpu_simple::matrix_ops::MatrixVectorMultiply(A, x);
+  }
+  std::vector<T> y(A.num_rows());
+  matrix_library::cpu_parallel::parallel_kernels::MultiplyVectorShape<T>(
+      A.num_rows(), 1, x.size(), [&A](size_t i) { return A.row(i); },
+      [&x](size_t p) { return &x[p]; }, [&y](size_t i) { return &y[i]; },
+      false, num_threads);
+  return y;
+}
+
+/**
+ * @brief Computes the outer product x * y^T of 2 vectors. Rows are split
+ * across threads when the result is large enough
+ *
+ * @tparam T Any numeric type
+ * @param x Vector giving the rows
+ * @param y Vector giving the columns
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C with
+ * C(i, j) = x[i] * y[j]. An empty x gives a matrix with no rows and no columns
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> OuterProduct(
+    const std::vector<T>& x, const std::vector<T>& y) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  if (y.empty() ||
+      !matrix_library::cpu_parallel::parallel_kernels::
+          UseParallelVectorMultiply(x.size(), y.size(), 1, num_threads)) {
+    return matrix_library::cpu_simple::matrix_ops::OuterProduct(x, y);
+  }
+  // Every element is overwritten so the output is left uninitialized
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(
+      x.size(), y.size(),
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  matrix_library::cpu_parallel::parallel_kernels::MultiplyVectorShape<T>(
+      x.size(), y.size(), 1, [&x](size_t i) { return &x[i]; },
+      [&y](size_t) { return y.data(); }, [&C](size_t i) { return C.row(i); },
+      false, num_threads);
+  return C;
+}
+
+/**
+ * @brief Multiplies a batch of independent matrix pairs of the same shape,
+ * given as arrays of pointers to row-major blocks. Shapes are validated and
+ * the kernel is chosen once for the whole batch, and entries are split across
+ * threads when the batch is large enough. Nothing is allocated
+ *
+ * @tparam T Any numeric type
+ * @param m Number of rows in every A and C
+ * @param n Number of columns in every B and C
+ * @param k Number of columns in every A and rows in every B
+ * @param A Pointers to the A matrices
+ * @param lda Leading dimension of every A
+ * @param B Pointers to the B matrices, as many as A
+ * @param ldb Leading dimension of every B
+ * @param C Pointers to the C matrices, as many as A. Each is set to A * B, or
+ * to C + A * B when accumulating. Must not overlap each other, A or B
+ * @param ldc Leading dimension of every C
+ * @param accumulate Add the products to C instead of overwriting it
+ * @throws Runtime Error if the batches have different sizes
+ * @throws Runtime Error if a leading dimension is too small
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline void BatchedMatrixMultiply(size_t m, size_t n, size_t k,
+                                  const std::vector<const T*>& A, size_t lda,
+                                  const std::vector<const T*>& B, size_t ldb,
+                                  const std::vector<T*>& C, size_t ldc,
+                                  bool accumulate = false) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  // Invalid and small batches are handled by the CPU simple version
+  if (A.size() != B.size() || A.size() != C.size() ||
+      !matrix_library::cpu_simple::batched_gemm::IsValidBatchLayout(
+          m, n, k, lda, ldb, ldc, 1, 0) ||
+      !matrix_library::cpu_parallel::parallel_kernels::UseParallelBatch(
+          C.size(), m, n, k, num_threads)) {
+    matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply(
+        m, n, k, A, lda, B, ldb, C, ldc, accumulate);
+    return;
+  }
+  matrix_library::cpu_parallel::parallel_kernels::BatchedGemm<T>(
+      C.size(), m, n, k, [&A](size_t e) { return A[e]; }, lda,
+      [&B](size_t e) { return B[e]; }, ldb, [&C](size_t e) { return C[e]; },
+      ldc, accumulate, num_threads);
+}
+
+/**
+ * @brief Multiplies a batch of independent matrix pairs of the same shape,
+ * stored as row-major blocks a fixed stride apart. Shapes are validated and
+ * the kernel is chosen once for the whole batch, and entries are split across
+ * threads when the batch is large enough. Nothing is allocated
+ *
+ * @tparam T Any numeric type
+ * @param batch_size Number of products
+ * @param m Number of rows in every A and C
+ * @param n Number of columns in every B and C
+ * @param k Number of columns in every A and rows in every B
+ * @param A First A matrix
+ * @param lda Leading dimension of every A
+ * @param stride_a Distance between consecutive A matrices. 0 uses the same A
+ * for every product
+ * @param B First B matrix
+ * @param ldb Leading dimension of every B
+ * @param stride_b Distance between consecutive B matrices. 0 uses the same B
+ * for every product
+ * @param C First C matrix. Each is set to A * B, or to C + A * B when
+ * accumulating. Must not overlap A or B
+ * @param ldc Leading dimension of every C
+ * @param stride_c Distance between consecutive C matrices
+ * @param accumulate Add the products to C instead of overwriting it
+ * @throws Runtime Error if a leading dimension is too small
+ * @throws Runtime Error if entries of C overlap
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline void BatchedMatrixMultiply(size_t batch_size, size_t m, size_t n,
+                                  size_t k, const T* A, size_t lda,
+                                  size_t stride_a, const T* B, size_t ldb,
+                                  size_t stride_b, T* C, size_t ldc,
+                                  size_t stride_c, bool accumulate = false) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  // Invalid and small batches are handled by the CPU simple version
+  if (!matrix_library::cpu_simple::batched_gemm::IsValidBatchLayout(
+          m, n, k, lda, ldb, ldc, batch_size, stride_c) ||
+      !matrix_library::cpu_parallel::parallel_kernels::UseParallelBatch(
+          batch_size, m, n, k, num_threads)) {
+    matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply(
+        batch_size, m, n, k, A, lda, stride_a, B, ldb, stride_b, C, ldc,
+        stride_c, accumulate);
+    return;
+  }
+  matrix_library::cpu_parallel::parallel_kernels::BatchedGemm<T>(
+      batch_size, m, n, k,
+      [A, stride_a](size_t e) { return A + e * stride_a; }, lda,
+      [B, stride_b](size_t e) { return B + e * stride_b; }, ldb,
+      [C, stride_c](size_t e) { return C + e * stride_c; }, ldc, accumulate,
+      num_threads);
+}
+
+/**
+ * @brief Transposes matrix into a preallocated matrix if possible. Square
+ * tiles are split across threads when the matrix is large enough. The storage
+ * of the transposed matrix is reused so steady state loops do not allocate
+ *
+ * @tparam T Any numeric type
+ * @param original_matrix 2D matrix that we will make a transpose of
+ * @param transposed_matrix 2D matrix with as many rows as the original matrix
+ * has columns and as many columns as it has rows. Must not be the original
+ * matrix
+ * @throws Runtime error if the original matrix has no row
+ * @throws Runtime error if the original matrix has no columns
+ * @throws Runtime error if the original matrix has column count mismatch
+ * @throws Runtime error if the transposed matrix has the wrong shape or is the
+ * original matrix
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline void MatrixTransposeInto(
+    const std::vector<std::vector<T>>& original_matrix,
+    std::vector<std::vector<T>>& transposed_matrix) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  // Invalid and small matrices are handled by the CPU simple version
+  if (matrix_library::utils::matrix_utils::IsMatrixEmpty(original_matrix) ||
+      !matrix_library::cpu_parallel::parallel_kernels::UseParallelTranspose(
+          original_matrix.size(), original_matrix.front().size(),
+          num_threads)) {
+    matrix_library::cpu_simple::matrix_ops::MatrixTransposeInto(
+        original_matrix, transposed_matrix);
+    return;
+  }
+  // If matrix has a column mismatch it cannot be transposed
+  if (!matrix_library::utils::matrix_utils::IsMatrixFollowingDimensions(
+          original_matrix, original_matrix.front().size())) {
+    throw std::runtime_error("Original matrix has a column mismatch");
+  }
+  if (&transposed_matrix == &original_matrix) {
+    throw std::runtime_error("Transposed matrix cannot be the original matrix");
+  }
+  if (transposed_matrix.size() != original_matrix.front().size() ||
+      !matrix_library::utils::matrix_utils::IsMatrixFollowingDimensions(
+          transposed_matrix, original_matrix.size())) {
+    throw std::runtime_error("Transposed matrix has the wrong shape");
+  }
+  matrix_library::cpu_parallel::parallel_kernels::Transpose(
+      original_matrix.size(), original_matrix.front().size(),
+      matrix_library::cpu_simple::blocked_gemm::NestedOperand<T>(
+          original_matrix),
+      matrix_library::cpu_simple::blocked_gemm::NestedOutput<T>(
+          transposed_matrix),
+      num_threads);
+}
+
+/**
+ * @brief Transposes a matrix of bools into a preallocated matrix if possible.
+ * Rows of bools pack several elements in a word, so threads writing to
+ * different columns of one row would race and the CPU simple version is used
+ *
+ * @param original_matrix 2D matrix that we will make a transpose of
+ * @param transposed_matrix 2D matrix with as many rows as the original matrix
+ * has columns and as many columns as it has rows. Must not be the original
+ * matrix
+ * @throws Runtime error if the original matrix has no row
+ * @throws Runtime error if the original matrix has no columns
+ * @throws Runtime error if the original matrix has column count mismatch
+ * @throws Runtime error if the transposed matrix has the wrong shape or is the
+ * original matrix
+ */
+inline void MatrixTransposeInto(
+    const std::vector<std::vector<bool>>& original_matrix,
+    std::vector<std::vector<bool>>& transposed_matrix) {
+  matrix_library::cpu_simple::matrix_ops::MatrixTransposeInto(
+      original_matrix, transposed_matrix);
+}
+
+/**
+ * @brief Transposes matrix if possible. Square tiles are split across threads
+ * when the matrix is large enough
+ *
+ * @tparam T Any numeric type
+ * @param original_matrix 2D matrix that we will make a transpose of
+ * @return std::vector<std::vector<T>> Transposed 2D matrix
+ * @throws Runtime error if the original matrix has no row
+ * @throws Runtime error if the original matrix has no columns
+ * @throws Runtime error if the original matrix has column count mismatch
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline std::vector<std::vector<T>> MatrixTranspose(
+    const std::vector<std::vector<T>>& original_matrix) {
+  // Invalid matrices are handled by the CPU simple version
+  if (matrix_library::utils::matrix_utils::IsMatrixEmpty(original_matrix) ||
+      matrix_library::utils::matrix_utils::IsVectorEmpty(
+          original_matrix.front())) {
+    return matrix_library::cpu_simple::matrix_ops::MatrixTranspose(
+        original_matrix);
+  }
+  std::vector<std::vector<T>> transposed_matrix =
+      matrix_library::utils::matrix_utils::CreateMatrix(
+          original_matrix.front().size(), original_matrix.size(),
+          static_cast<T>(0));
+  MatrixTransposeInto(original_matrix, transposed_matrix);
+  return transposed_matrix;
+}
+
+/**
+ * @brief Transposes contiguous matrix into a preallocated matrix if possible.
+ * Square tiles are split across threads when the matrix is large enough. The
+ * storage of the transposed matrix is reused so steady state loops do not
+ * allocate
+ *
+ * @tparam T Any numeric type
+ * @param original_matrix Matrix that we will make a transpose of
+ * @param transposed_matrix Matrix with as many rows as the original matrix has
+ * columns and as many columns as it has rows. Must not be the original matrix
+ * @throws Runtime error if the original matrix has no row
+ * @throws Runtime error if the original matrix has no columns
+ * @throws Runtime error if the transposed matrix has the wrong shape or is the
+ * original matrix
+ */
+template <typename T>
+inline void MatrixTransposeInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& original_matrix,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& transposed_matrix) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  // Invalid and small matrices are handled by the CPU simple version
+  if (&transposed_matrix == &original_matrix ||
+      transposed_matrix.num_rows() != original_matrix.num_cols() ||
+      transposed_matrix.num_cols() != original_matrix.num_rows() ||
+      !matrix_library::cpu_parallel::parallel_kernels::UseParallelTranspose(
+          original_matrix.num_rows(), original_matrix.num_cols(),
+          num_threads)) {
+    matrix_library::cpu_simple::matrix_ops::MatrixTransposeInto(
+        original_matrix, transposed_matrix);
+    return;
+  }
+  matrix_library::cpu_parallel::parallel_kernels::Transpose(
+      original_matrix.num_rows(), original_matrix.num_cols(),
+      original_matrix.data(), original_matrix.leading_dimension(),
+      transposed_matrix.data(), transposed_matrix.leading_dimension(),
+      num_threads);
+}
+
+/**
+ * @brief Transposes contiguous matrix if possible. Square tiles are split
+ * across threads when the matrix is large enough
+ *
+ * @tparam T Any numeric type
+ * @param original_matrix Matrix that we will make a transpose of
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Transposed
+ * matrix
+ * @throws Runtime error if the original matrix has no row
+ * @throws Runtime error if the original matrix has no columns
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixTranspose(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>&
+        original_matrix) {
+  // Invalid matrices are handled by the CPU simple version
+  if (original_matrix.empty() || original_matrix.num_cols() == 0) {
+    return matrix_library::cpu_simple::matrix_ops::MatrixTranspose(
+        original_matrix);
+  }
+  matrix_library::utils::dense_matrix::DenseMatrix<T> transposed_matrix(
+      original_matrix.num_cols(), original_matrix.num_rows(),
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  MatrixTransposeInto(original_matrix, transposed_matrix);
+  return transposed_matrix;
+}
+
+/**
+ * @brief Create a Matrix of provided dimensions filled with value provided.
+ * Large matrices are filled by the threads that later multiply their rows, in
+ * the row split of the parallel multiply, so with several NUMA nodes the
+ * pages of each row block are placed on the node that reads them
+ *
+ * @tparam T Any numeric type
+ * @param num_rows Number of rows in matrix
+ * @param num_cols Number of columns in matrix
+ * @param value_to_fill Value to fill in matrix
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Contiguous
+ * matrix with provided dimensions and value
+ * @throws Runtime error if we are trying to make a matrix with 0 rows and non
+ * zero columns
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> CreateMatrix(
+    size_t num_rows, size_t num_cols, T value_to_fill) {
+  const size_t num_threads =
+      matrix_library::cpu_parallel::parallel_config::GetNumThreads();
+  if (!matrix_library::cpu_parallel::parallel_kernels::UseParallelFill(
+          num_rows, num_cols, num_threads)) {
+    return matrix_library::utils::dense_matrix::CreateMatrix(
+        num_rows, num_cols, value_to_fill);
+  }
+  // Left untouched so no page is placed before the threads fill it
+  matrix_library::utils::dense_matrix::DenseMatrix<T> matrix(
+      num_rows, num_cols,
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  matrix_library::cpu_parallel::parallel_kernels::FillRows(
+      num_rows, num_cols, matrix.data(), matrix.leading_dimension(),
+      value_to_fill, num_threads);
+  return matrix;
+}
+
+/**
+ * @brief Type of the product of 2 matrices
+ */
+template <typename MatrixA, typename MatrixB>
+using ProductType =
+    decltype(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(
+        std::declval<const MatrixA&>(), std::declval<const MatrixB&>()));
+
+/**
+ * @brief Type of the transpose of a matrix
+ */
+template <typename Matrix>
+using TransposeType =
+    decltype(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(
+        std::declval<const Matrix&>()));
+
+namespace internal {
+
+/**
+ * @brief Product of 2 matrices owned by a queued operation
+ */
+template <typename MatrixA, typename MatrixB>
+struct MultiplyTask {
+  MatrixA A;
+  MatrixB B;
+
+  ProductType<MatrixA, MatrixB> operator()() const {
+    return matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  }
+};
+
+/**
+ * @brief Product of 2 matrices owned by a queued operation, handed to a
+ * callback with the exception it threw if any
+ */
+template <typename MatrixA, typename MatrixB, typename Callback>
+struct MultiplyCallbackTask {
+  MatrixA A;
+  MatrixB B;
+  Callback callback;
+
+  void operator()() {
+    ProductType<MatrixA, MatrixB> product;
+    std::exception_ptr error;
+    try {
+      product = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    callback(std::move(product), error);
+  }
+};
+
+/**
+ * @brief Transpose of a matrix owned by a queued operation
+ */
+template <typename Matrix>
+struct TransposeTask {
+  Matrix original_matrix;
+
+  TransposeType<Matrix> operator()() const {
+    return matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(
+        original_matrix);
+  }
+};
+
+/**
+ * @brief Transpose of a matrix owned by a queued operation, handed to a
+ * callback with the exception it threw if any
+ */
+template <typename Matrix, typename Callback>
+struct TransposeCallbackTask {
+  Matrix original_matrix;
+  Callback callback;
+
+  void operator()() {
+    TransposeType<Matrix> transposed_matrix;
+    std::exception_ptr error;
+    try {
+      transposed_matrix =
+          matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(
+              original_matrix);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    callback(std::move(transposed_matrix), error);
+  }
+};
+
+}  // namespace internal
+
+/**
+ * @brief Multiplies 2 matrices on the shared asynchronous executor. The
+ * operands are taken by value and owned by the operation, so the caller may
+ * reuse or destroy its own right away. Moving them in avoids a copy
+ *
+ * @tparam MatrixA Any matrix type MatrixMultiply takes as A
+ * @tparam MatrixB Any matrix type MatrixMultiply takes as B
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @return std::future<ProductType<MatrixA, MatrixB>> Ready with A * B, or
+ * with the error MatrixMultiply throws if they cannot be multiplied. Dropping
+ * it does not cancel the operation
+ */
+template <typename MatrixA, typename MatrixB>
+inline std::future<ProductType<MatrixA, MatrixB>> MatrixMultiplyAsync(
+    MatrixA A, MatrixB B) {
+  return matrix_library::cpu_parallel::async_executor::SharedAsyncExecutor()
+      .Submit(internal::MultiplyTask<MatrixA, MatrixB>{std::move(A),
+                                                       std::move(B)});
+}
+
+/**
+ * @brief Multiplies 2 matrices on the shared asynchronous executor and hands
+ * the product to a callback. The operands are owned by the operation as for
+ * the future returning version
+ *
+ * @tparam MatrixA Any matrix type MatrixMultiply takes as A
+ * @tparam MatrixB Any matrix type MatrixMultiply takes as B
+ * @tparam Callback Callable taking (ProductType<MatrixA, MatrixB>&& product,
+ * std::exception_ptr error)
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @param callback Called on the executor thread with A * B and a null error,
+ * or with an empty product and the error MatrixMultiply threw. Must not block
+ * on other asynchronous operations
+ * @return std::future<void> Handle ready once the callback has returned, with
+ * the exception the callback threw if any
+ */
+template <typename MatrixA, typename MatrixB, typename Callback>
+inline std::future<void> MatrixMultiplyAsync(MatrixA A, MatrixB B,
+                                             Callback callback) {
+  return matrix_library::cpu_parallel::async_executor::SharedAsyncExecutor()
+      .Submit(internal::MultiplyCallbackTask<MatrixA, MatrixB, Callback>{
+          std::move(A), std::move(B), std::move(callback)});
+}
+
+/**
+ * @brief Multiplies 2 matrices into a preallocated matrix on the shared
+ * asynchronous executor. Nothing is copied, so A, B and C must stay alive and
+ * must not be modified or read as C until the future is ready
+ *
+ * @tparam MatrixA Any matrix type MatrixMultiplyInto takes as A
+ * @tparam MatrixB Any matrix type MatrixMultiplyInto takes as B
+ * @tparam MatrixC Any matrix type MatrixMultiplyInto takes as C
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @param C Matrix with as many rows as A and as many columns as B. Set to
+ * A * B, or to C + A * B when accumulating. Must not be A or B
+ * @param accumulate Add the product to C instead of overwriting it
+ * @return std::future<void> Ready once C holds the product, or with the error
+ * MatrixMultiplyInto throws
+ */
+template <typename MatrixA, typename MatrixB, typename MatrixC>
+inline std::future<void> MatrixMultiplyIntoAsync(const MatrixA& A,
+                                                 const MatrixB& B, MatrixC& C,
+                                                 bool accumulate = false) {
+  return matrix_library::cpu_parallel::async_executor::SharedAsyncExecutor()
+      .Submit([&A, &B, &C, accumulate]() {
+        matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyInto(
+            A, B, C, accumulate);
+      });
+}
+
+/**
+ * @brief Transposes a matrix on the shared asynchronous executor. The matrix
+ * is taken by value and owned by the operation. Moving it in avoids a copy
+ *
+ * @tparam Matrix Any matrix type MatrixTranspose takes
+ * @param original_matrix Matrix that we will make a transpose of
+ * @return std::future<TransposeType<Matrix>> Ready with the transpose, or
+ * with the error MatrixTranspose throws
+ */
+template <typename Matrix>
+inline std::future<TransposeType<Matrix>> MatrixTransposeAsync(
+    Matrix original_matrix) {
+  return matrix_library::cpu_parallel::async_executor::SharedAsyncExecutor()
+      .Submit(internal::TransposeTask<Matrix>{std::move(original_matrix)});
+}
+
+/**
+ * @brief Transposes a matrix on the shared asynchronous executor and hands
+ * the transpose to a callback
+ *
+ * @tparam Matrix Any matrix type MatrixTranspose takes
+ * @tparam Callback Callable taking (TransposeType<Matrix>&& transposed_matrix,
+ * std::exception_ptr error)
+ * @param original_matrix Matrix that we will make a transpose of
+ * @param callback Called on the executor thread with the transpose and a null
+ * error, or with an empty matrix and the error MatrixTranspose threw
+ * @return std::future<void> Handle ready once the callback has returned
+ */
+template <typename Matrix, typename Callback>
+inline std::future<void> MatrixTransposeAsync(Matrix original_matrix,
+                                              Callback callback) {
+  return matrix_library::cpu_parallel::async_executor::SharedAsyncExecutor()
+      .Submit(internal::TransposeCallbackTask<Matrix, Callback>{
+          std::move(original_matrix), std::move(callback)});
+}
+
+}  // namespace matrix_ops
+}  // namespace cpu_parallel
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,260 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the NUMA topology discovery of the CPU
+ * parallel version of library. Nodes and their cores are read from
+ * /sys/devices/system/node so there is no dependency on libnuma. Machines
+ * without that directory are treated as a single node holding every core
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_PARALLEL__NUMA_TOPOLOGY_H_
+#define MATRIX_LIBRARY__CPU_PARALLEL__NUMA_TOPOLOGY_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace matrix_library {
+namespace cpu_parallel {
+namespace numa_topology {
+
+/**
+ * @brief Directory the kernel describes NUMA nodes in
+ */
+constexpr const char* kSysfsNodeRoot = "/sys/devices/system/node";
+
+/**
+ * @brief NUMA node and the cores attached to it
+ */
+struct NumaNode {
+  /// Node number given by the kernel
+  size_t id;
+  /// Cores of the node in increasing order
+  std::vector<size_t> cpus;
+};
+
+/**
+ * @brief Nodes of a machine that have cores. Nodes holding only memory are
+ * left out as no thread can run on them
+ */
+struct NumaTopology {
+  std::vector<NumaNode> nodes;
+
+  /**
+   * @brief Gets the number of nodes
+   */
+  size_t num_nodes() const { return nodes.size(); }
+
+  /**
+   * @brief Gets the number of cores over all nodes
+   */
+  size_t NumCpus() const {
+    size_t num_cpus = 0;
+    for (const auto& node : nodes) {
+      num_cpus += node.cpus.size();
+    }
+    return num_cpus;
+  }
+
+  /**
+   * @brief Gets the index in nodes of the node a core belongs to
+   *
+   * @param cpu Core number
+   * @return size_t Index of the node, 0 if no node lists the core
+   */
+  size_t NodeOfCpu(size_t cpu) const {
+    for (size_t node = 0; node < nodes.size(); node++) {
+      if (std::binary_search(nodes[node].cpus.begin(), nodes[node].cpus.end(),
+                             cpu)) {
+        return node;
+      }
+    }
+    return 0;
+  }
+};
+
+/**
+ * @brief Parses a kernel list such as "0-3,8,10-11"
+ *
+ * @param list List of numbers and inclusive ranges separated by commas
+ * @return std::vector<size_t> Numbers in the list in increasing order
+ * @throws Runtime Error if the list is malformed
+ */
+inline std::vector<size_t> ParseCpuList(const std::string& list) {
+  std::vector<size_t> cpus;
+  size_t position = 0;
+  // Reads a number at position and moves past it
+  auto read_number = [&list, &position]() -> size_t {
+    const size_t start = position;
+    size_t value = 0;
+    while (position < list.size() && list[position] >= '0' &&
+           list[position] <= '9') {
+      value = value * 10 + static_cast<size_t>(list[position] - '0');
+      position++;
+    }
+    if (position == start) {
+      throw std::runtime_error("Malformed cpu list");
+    }
+    return value;
+  };
+  while (position < list.size() && list[position] != '\n') {
+    const size_t first = read_number();
+    size_t last = first;
+    if (position < list.size() && list[position] == '-') {
+      position++;
+      last = read_number();
+      if (last < first) {
+        throw std::runtime_error("Malformed cpu list");
+      }
+    }
+    for (size_t cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+    if (position < list.size() && list[position] == ',') {
+      position++;
+    }
+  }
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return cpus;
+}
+
+/**
+ * @brief Topology of a machine with a single node holding every core
+ *
+ * @return NumaTopology Single node topology
+ */
+inline NumaTopology SingleNodeTopology() {
+  NumaTopology topology;
+  NumaNode node;
+  node.id = 0;
+  const size_t num_cpus =
+      std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  for (size_t cpu = 0; cpu < num_cpus; cpu++) {
+    node.cpus.push_back(cpu);
+  }
+  topology.nodes.push_back(node);
+  return topology;
+}
+
+/**
+ * @brief Reads the topology described under a sysfs style directory, with an
+ * online file listing the nodes and a node<N>/cpulist file per node
+ *
+ * @param root Directory to read
+ * @return NumaTopology Nodes with cores, or a single node holding every core
+ * if the directory cannot be read
+ */
+inline NumaTopology ReadNumaTopology(const std::string& root = kSysfsNodeRoot) {
+  std::ifstream online(root + "/online");
+  std::string node_list;
+  if (!std::getline(online, node_list)) {
+    return SingleNodeTopology();
+  }
+  NumaTopology topology;
+  try {
+    for (size_t id : ParseCpuList(node_list)) {
+      std::ifstream cpulist(root + "/node" + std::to_string(id) + "/cpulist");
+      std::string cpus;
+      if (!std::getline(cpulist, cpus)) {
+        continue;
+      }
+      NumaNode node;
+      node.id = id;
+      node.cpus = ParseCpuList(cpus);
+      if (!node.cpus.empty()) {
+        topology.nodes.push_back(node);
+      }
+    }
+  } catch (const std::runtime_error&) {
+    return SingleNodeTopology();
+  }
+  if (topology.nodes.empty()) {
+    return SingleNodeTopology();
+  }
+  return topology;
+}
+
+/**
+ * @brief Topology of this machine, read once
+ *
+ * @return const NumaTopology& Topology
+ */
+inline const NumaTopology& GetNumaTopology() {
+  static const NumaTopology topology = ReadNumaTopology();
+  return topology;
+}
+
+/**
+ * @brief Gets the core the calling thread is running on
+ *
+ * @return size_t Core number, 0 if it cannot be known
+ */
+inline size_t CurrentCpu() {
+#ifdef __linux__
+  const int cpu = sched_getcpu();
+  return cpu >= 0 ? static_cast<size_t>(cpu) : 0;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief Splits rows between nodes in proportion to their cores. Every node
+ * gets whole micro-panels, so a matrix created with the same split is first
+ * touched by the node that later multiplies its rows
+ *
+ * @param num_rows Number of rows
+ * @param mr Height of the micro-panels
+ * @param topology Topology to split for
+ * @return std::vector<size_t> num_nodes + 1 bounds. Node i gets rows
+ * [bounds[i], bounds[i + 1])
+ */
+inline std::vector<size_t> PartitionRowsByNode(size_t num_rows, size_t mr,
+                                               const NumaTopology& topology) {
+  const size_t num_nodes = topology.num_nodes();
+  const size_t num_panels = (num_rows + mr - 1) / mr;
+  const size_t num_cpus = std::max<size_t>(topology.NumCpus(), 1);
+  std::vector<size_t> bounds(num_nodes + 1, 0);
+  size_t cpus_before = 0;
+  for (size_t node = 0; node < num_nodes; node++) {
+    cpus_before += topology.nodes[node].cpus.size();
+    bounds[node + 1] =
+        std::min(num_panels * cpus_before / num_cpus * mr, num_rows);
+  }
+  bounds[num_nodes] = num_rows;
+  return bounds;
+}
+
+/**
+ * @brief Gets how many of num_threads threads fall on a node, in proportion to
+ * its cores and at least 1
+ *
+ * @param node Index of the node
+ * @param num_threads Number of threads over all nodes
+ * @param topology Topology
+ * @return size_t Number of threads of the node
+ */
+inline size_t ThreadsOnNode(size_t node, size_t num_threads,
+                            const NumaTopology& topology) {
+  const size_t num_cpus = std::max<size_t>(topology.NumCpus(), 1);
+  return std::max<size_t>(
+      num_threads * topology.nodes[node].cpus.size() / num_cpus, 1);
+}
+
+}  // namespace numa_topology
+}  // namespace cpu_parallel
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,96 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the threading configuration of the CPU
+ * parallel version of library
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_PARALLEL__PARALLEL_CONFIG_H_
+#define MATRIX_LIBRARY__CPU_PARALLEL__PARALLEL_CONFIG_H_
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace matrix_library {
+namespace cpu_parallel {
+namespace parallel_config {
+
+/**
+ * @brief Default number of times an idle worker of the thread pool looks for
+ * work before it parks
+ */
+constexpr size_t kDefaultSpinCount = 256;
+
+/**
+ * @brief Thread count requested by the caller. 0 means use the default
+ *
+ * @return std::atomic<size_t>& Requested thread count
+ */
+inline std::atomic<size_t>& RequestedNumThreads() {
+  static std::atomic<size_t> num_threads(0);
+  return num_threads;
+}
+
+/**
+ * @brief Sets the number of threads parallel operations use
+ *
+ * @param num_threads Number of threads. 0 restores the default of one thread
+ * per available core
+ */
+inline void SetNumThreads(size_t num_threads) {
+  RequestedNumThreads().store(num_threads);
+}
+
+/**
+ * @brief Gets the number of threads parallel operations use
+ *
+ * @return size_t Number of threads, counting the calling thread
+ */
+inline size_t GetNumThreads() {
+  const size_t requested = RequestedNumThreads().load();
+  if (requested != 0) {
+    return requested;
+  }
+  const size_t num_cores =
+      static_cast<size_t>(std::thread::hardware_concurrency());
+  return num_cores > 0 ? num_cores : 1;
+}
+
+/**
+ * @brief Spin count requested by the caller
+ *
+ * @return std::atomic<size_t>& Spin count
+ */
+inline std::atomic<size_t>& RequestedSpinCount() {
+  static std::atomic<size_t> spin_count(kDefaultSpinCount);
+  return spin_count;
+}
+
+/**
+ * @brief Sets how many times an idle worker of the thread pool looks for work
+ * before it parks. Spinning keeps back to back parallel calls from paying for
+ * a wake up, parking gives the core back to other processes
+ *
+ * @param spin_count Number of attempts. 0 parks as soon as there is no work
+ */
+inline void SetSpinCount(size_t spin_count) {
+  RequestedSpinCount().store(spin_count);
+}
+
+/**
+ * @brief Gets how many times an idle worker of the thread pool looks for work
+ * before it parks
+ *
+ * @return size_t Number of attempts
+ */
+inline size_t GetSpinCount() { return RequestedSpinCount().load(); }
+
+}  // namespace parallel_config
+}  // namespace cpu_parallel
+}  // namespace matrix_library
+
+#endif
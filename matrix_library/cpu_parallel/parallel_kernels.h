@@ -0,0 +1,728 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the multithreaded multiplication and
+ * transposition loops used by the CPU parallel version of library. Every loop
+ * runs on the shared thread pool
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_PARALLEL__PARALLEL_KERNELS_H_
+#define MATRIX_LIBRARY__CPU_PARALLEL__PARALLEL_KERNELS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "matrix_library/cpu_parallel/numa_topology.h"
+#include "matrix_library/cpu_parallel/thread_pool.h"
+#include "matrix_library/cpu_simple/batched_gemm.h"
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/cpu_simple/gemm_epilogues.h"
+#include "matrix_library/cpu_simple/transpose_kernels.h"
+#include "matrix_library/cpu_simple/vector_kernels.h"
+#include "matrix_library/utils/dense_matrix.h"
+
+namespace matrix_library {
+namespace cpu_parallel {
+namespace parallel_kernels {
+
+/**
+ * @brief Products with fewer multiply-adds (m * n * k) than this run on the
+ * calling thread. Below it handing out the work costs more than it saves
+ */
+constexpr size_t kParallelMultiplyThreshold = 128 * 128 * 128;
+
+/**
+ * @brief Transposes with fewer elements than this run on the calling thread
+ */
+constexpr size_t kParallelTransposeThreshold = 256 * 256;
+
+/**
+ * @brief Matrix-vector and outer products touching fewer elements than this
+ * run on the calling thread
+ */
+constexpr size_t kParallelVectorThreshold = 256 * 256;
+
+/**
+ * @brief Matrices with fewer elements than this are filled on the calling
+ * thread
+ */
+constexpr size_t kParallelFillThreshold = 256 * 256;
+
+/**
+ * @brief Side of the square tiles a parallel transpose is split into
+ */
+constexpr size_t kTransposeTile = 64;
+
+/**
+ * @brief Checks if a product of the given shape should be split across
+ * threads
+ *
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param num_threads Number of threads available
+ * @return true If the product should run in parallel
+ * @return false If the product should run on the calling thread
+ */
+inline bool UseParallelMultiply(size_t m, size_t n, size_t k,
+                                size_t num_threads) {
+  return num_threads > 1 && m > 1 && m * n * k >= kParallelMultiplyThreshold;
+}
+
+/**
+ * @brief Checks if a transpose of the given shape should be split across
+ * threads
+ *
+ * @param num_rows Number of rows in the original matrix
+ * @param num_cols Number of columns in the original matrix
+ * @param num_threads Number of threads available
+ * @return true If the transpose should run in parallel
+ * @return false If the transpose should run on the calling thread
+ */
+inline bool UseParallelTranspose(size_t num_rows, size_t num_cols,
+                                 size_t num_threads) {
+  return num_threads > 1 && num_rows * num_cols >= kParallelTransposeThreshold;
+}
+
+/**
+ * @brief Checks if filling a matrix of the given shape should be split across
+ * threads
+ *
+ * @param num_rows Number of rows in the matrix
+ * @param num_cols Number of columns in the matrix
+ * @param num_threads Number of threads available
+ * @return true If the fill should run in parallel
+ * @return false If the fill should run on the calling thread
+ */
+inline bool UseParallelFill(size_t num_rows, size_t num_cols,
+                            size_t num_threads) {
+  return num_threads > 1 && num_rows > 1 &&
+         num_rows * num_cols >= kParallelFillThreshold;
+}
+
+/**
+ * @brief Checks if a matrix-vector or outer product of the given shape should
+ * be split across threads. Dot and vector-matrix products produce a single
+ * row and always run on the calling thread
+ *
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param num_threads Number of threads available
+ * @return true If the product should run in parallel
+ * @return false If the product should run on the calling thread
+ */
+inline bool UseParallelVectorMultiply(size_t m, size_t n, size_t k,
+                                      size_t num_threads) {
+  return num_threads > 1 && m > 1 && (n == 1 || k == 1) &&
+         m * n * k >= kParallelVectorThreshold;
+}
+
+/**
+ * @brief Checks if a batch of products should be split across threads. The
+ * whole batch counts towards the threshold as entries are independent
+ *
+ * @param batch_size Number of products
+ * @param m Number of rows in every A and C
+ * @param n Number of columns in every B and C
+ * @param k Number of columns in every A and rows in every B
+ * @param num_threads Number of threads available
+ * @return true If the batch should run in parallel
+ * @return false If the batch should run on the calling thread
+ */
+inline bool UseParallelBatch(size_t batch_size, size_t m, size_t n, size_t k,
+                             size_t num_threads) {
+  return num_threads > 1 && batch_size > 1 &&
+         batch_size * m * n * k >= kParallelMultiplyThreshold;
+}
+
+/**
+ * @brief Checks if a product of the given shape should be split across
+ * threads, by the streaming kernels for dot, matrix-vector and outer product
+ * shapes and by the blocked kernel otherwise
+ *
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param num_threads Number of threads available
+ * @return true If the product should run in parallel
+ * @return false If the product should run on the calling thread
+ */
+inline bool UseParallelProduct(size_t m, size_t n, size_t k,
+                               size_t num_threads) {
+  return matrix_library::cpu_simple::vector_kernels::IsVectorShape(m, n, k)
+             ? UseParallelVectorMultiply(m, n, k, num_threads)
+             : UseParallelMultiply(m, n, k, num_threads);
+}
+
+/**
+ * @brief Split of the rows of C into blocks, one per thread
+ */
+struct RowBlocks {
+  size_t num_blocks;
+  size_t rows_per_block;
+};
+
+/**
+ * @brief Splits the rows of C into at most one block per thread. Blocks are
+ * whole micro-panels so only the last one has a partial panel
+ *
+ * @param m Number of rows in C
+ * @param mr Height of the micro-panels
+ * @param num_threads Number of threads to use
+ * @return RowBlocks Number of blocks and rows in each
+ */
+inline RowBlocks PartitionRows(size_t m, size_t mr, size_t num_threads) {
+  const size_t num_panels = (m + mr - 1) / mr;
+  RowBlocks row_blocks;
+  row_blocks.num_blocks = std::max<size_t>(std::min(num_threads, num_panels),
+                                           static_cast<size_t>(1));
+  row_blocks.rows_per_block =
+      (num_panels + row_blocks.num_blocks - 1) / row_blocks.num_blocks * mr;
+  return row_blocks;
+}
+
+/**
+ * @brief Block of rows of C assigned to a thread of a NUMA node
+ */
+struct NodeRowBlock {
+  size_t node;
+  size_t row_start;
+  size_t rows;
+};
+
+/**
+ * @brief Splits the rows of C between NUMA nodes as PartitionRowsByNode does,
+ * then the rows of each node into one block per thread of the node. A matrix
+ * first touched by these blocks has its rows on the node that multiplies them
+ *
+ * @param m Number of rows in C
+ * @param mr Height of the micro-panels
+ * @param num_threads Number of threads over all nodes
+ * @param topology Nodes and their cores
+ * @param node_bounds Set to num_nodes + 1 bounds. The blocks of node i are
+ * [node_bounds[i], node_bounds[i + 1])
+ * @return std::vector<NodeRowBlock> Blocks of every node in node order
+ */
+inline std::vector<NodeRowBlock> PartitionNodeRows(
+    size_t m, size_t mr, size_t num_threads,
+    const matrix_library::cpu_parallel::numa_topology::NumaTopology& topology,
+    std::vector<size_t>& node_bounds) {
+  const std::vector<size_t> node_rows =
+      matrix_library::cpu_parallel::numa_topology::PartitionRowsByNode(
+          m, mr, topology);
+  std::vector<NodeRowBlock> blocks;
+  node_bounds.assign(topology.num_nodes() + 1, 0);
+  for (size_t node = 0; node < topology.num_nodes(); node++) {
+    const size_t rows = node_rows[node + 1] - node_rows[node];
+    const RowBlocks split = PartitionRows(
+        rows, mr,
+        matrix_library::cpu_parallel::numa_topology::ThreadsOnNode(
+            node, num_threads, topology));
+    for (size_t block = 0; block < split.num_blocks; block++) {
+      const size_t row_start = block * split.rows_per_block;
+      if (row_start < rows) {
+        blocks.push_back(NodeRowBlock{
+            node, node_rows[node] + row_start,
+            std::min(split.rows_per_block, rows - row_start)});
+      }
+    }
+    node_bounds[node + 1] = blocks.size();
+  }
+  return blocks;
+}
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, on a pool whose
+ * workers span several NUMA nodes. Rows of C are split by PartitionNodeRows.
+ * Every node packs its own copy of B, first touching it, so its threads read
+ * B from local memory, and runs the blocked kernel on its row blocks
+ *
+ * @tparam T Any numeric type
+ * @tparam OpA Operand type of A
+ * @tparam OpB Operand type of B
+ * @tparam OutC Output type of C
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a Operand A
+ * @param b Operand B
+ * @param c Output C
+ * @param accumulate Add the product to C instead of overwriting it
+ * @param num_threads Number of threads to use
+ * @param pool Pool to run on
+ */
+template <typename T, typename OpA, typename OpB, typename OutC>
+inline void NumaGemm(size_t m, size_t n, size_t k, const OpA& a, const OpB& b,
+                     const OutC& c, bool accumulate, size_t num_threads,
+                     matrix_library::cpu_parallel::thread_pool::ThreadPool&
+                         pool) {
+  const matrix_library::cpu_simple::blocked_gemm::MicroKernel<T> kernel =
+      matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<T>();
+  static const matrix_library::cpu_simple::blocked_gemm::BlockSizes blocks =
+      matrix_library::cpu_simple::blocked_gemm::ComputeBlockSizes(
+          kernel, matrix_library::cpu_simple::blocked_gemm::GetCacheSizes());
+  const size_t nr = kernel.nr;
+  const size_t kc = std::max<size_t>(blocks.kc, 1);
+  const size_t nc = std::max<size_t>((blocks.nc + nr - 1) / nr, 1) * nr;
+  const size_t num_nodes = pool.num_nodes();
+  std::vector<size_t> block_bounds;
+  const std::vector<NodeRowBlock> row_blocks = PartitionNodeRows(
+      m, kernel.mr, num_threads, pool.topology(), block_bounds);
+  // Nodes with rows pack B one column block per iteration. The buffers are
+  // left untouched until then so their pages land on the packing node
+  const size_t num_col_blocks = (n + nc - 1) / nc;
+  std::vector<std::vector<
+      T, matrix_library::utils::dense_matrix::DefaultInitAllocator<T>>>
+      packed(num_nodes);
+  std::vector<size_t> pack_bounds(num_nodes + 1, 0);
+  std::vector<size_t> iteration_nodes;
+  for (size_t node = 0; node < num_nodes; node++) {
+    const bool has_rows = block_bounds[node] < block_bounds[node + 1];
+    if (has_rows) {
+      packed[node].resize(k * ((n + nr - 1) / nr * nr));
+      iteration_nodes.insert(iteration_nodes.end(), num_col_blocks, node);
+    }
+    pack_bounds[node + 1] = iteration_nodes.size();
+  }
+  pool.ParallelForNodes(
+      pack_bounds,
+      [&](size_t i) {
+        const size_t node = iteration_nodes[i];
+        matrix_library::cpu_simple::blocked_gemm::PackPanelColumns(
+            b, k, n, kc, nc, nr, (i - pack_bounds[node]) * nc,
+            packed[node].data());
+      },
+      num_threads);
+  pool.ParallelForNodes(
+      block_bounds,
+      [&](size_t i) {
+        const NodeRowBlock& block = row_blocks[i];
+        matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+            block.rows, n, k,
+            matrix_library::cpu_simple::blocked_gemm::RowOffsetOperand<OpA>(
+                a, block.row_start),
+            matrix_library::cpu_simple::blocked_gemm::PrePackedPanels<T>(
+                packed[block.node].data(), k, kc, nc),
+            matrix_library::cpu_simple::blocked_gemm::RowOffsetOutput<OutC>(
+                c, block.row_start),
+            accumulate, kernel, blocks);
+      },
+      num_threads);
+}
+
+/**
+ * @brief Runs NumaGemm when the shared pool spans several NUMA nodes
+ *
+ * @return true If the product was computed
+ * @return false If the pool has a single node
+ */
+template <typename T, typename OpA, typename OpB, typename OutC>
+inline bool TryNumaGemm(size_t m, size_t n, size_t k, const OpA& a,
+                        const OpB& b, const OutC& c, bool accumulate,
+                        size_t num_threads) {
+  matrix_library::cpu_parallel::thread_pool::ThreadPool& pool =
+      matrix_library::cpu_parallel::thread_pool::SharedThreadPool();
+  if (pool.num_nodes() <= 1) {
+    return false;
+  }
+  NumaGemm<T>(m, n, k, a, b, c, accumulate, num_threads, pool);
+  return true;
+}
+
+/**
+ * @brief Pre-packed B is already shared read-only by every thread, so it is
+ * not copied per node
+ */
+template <typename T, typename OpA, typename OutC>
+inline bool TryNumaGemm(
+    size_t, size_t, size_t, const OpA&,
+    const matrix_library::cpu_simple::blocked_gemm::PrePackedPanels<T>&,
+    const OutC&, bool, size_t) {
+  return false;
+}
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, by giving each
+ * thread a block of rows of C. Every block runs the blocked kernel of the CPU
+ * simple version with its own packing buffers. Pools spanning several NUMA
+ * nodes split the work by node with NumaGemm
+ *
+ * @tparam T Any numeric type
+ * @tparam OpA Operand type of A
+ * @tparam OpB Operand type of B
+ * @tparam OutC Output type of C
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a Operand A
+ * @param b Operand B
+ * @param c Output C
+ * @param accumulate Add the product to C instead of overwriting it
+ * @param num_threads Number of threads to use
+ */
+template <typename T, typename OpA, typename OpB, typename OutC>
+inline void Gemm(size_t m, size_t n, size_t k, const OpA& a, const OpB& b,
+                 const OutC& c, bool accumulate, size_t num_threads) {
+  if (TryNumaGemm<T>(m, n, k, a, b, c, accumulate, num_threads)) {
+    return;
+  }
+  const RowBlocks row_blocks = PartitionRows(
+      m, matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<T>().mr,
+      num_threads);
+  const size_t num_blocks = row_blocks.num_blocks;
+  const size_t rows_per_block = row_blocks.rows_per_block;
+  matrix_library::cpu_parallel::thread_pool::ParallelFor(
+      num_blocks,
+      [&](size_t block) {
+        const size_t row_start = block * rows_per_block;
+        if (row_start < m) {
+          const size_t rows = std::min(rows_per_block, m - row_start);
+          matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+              rows, n, k,
+              matrix_library::cpu_simple::blocked_gemm::RowOffsetOperand<OpA>(
+                  a, row_start),
+              b,
+              matrix_library::cpu_simple::blocked_gemm::RowOffsetOutput<OutC>(
+                  c, row_start),
+              accumulate);
+        }
+      },
+      num_blocks);
+}
+
+/**
+ * @brief Computes C = epilogue(A * B) by giving each thread a block of rows of
+ * C. Every block runs the blocked kernel of the CPU simple version with the
+ * epilogue shifted to its rows
+ *
+ * @tparam T Accumulation type of A and B
+ * @tparam OpA Operand type of A
+ * @tparam OpB Operand type of B
+ * @tparam OutC Output type of C
+ * @tparam Epilogue Callable taking (i, j, value) and returning what is stored
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a Operand A
+ * @param b Operand B
+ * @param c Output C
+ * @param epilogue Epilogue applied to every element
+ * @param num_threads Number of threads to use
+ */
+template <typename T, typename OpA, typename OpB, typename OutC,
+          typename Epilogue>
+inline void GemmEpilogue(size_t m, size_t n, size_t k, const OpA& a,
+                         const OpB& b, const OutC& c, const Epilogue& epilogue,
+                         size_t num_threads) {
+  const RowBlocks row_blocks = PartitionRows(
+      m, matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<T>().mr,
+      num_threads);
+  const size_t num_blocks = row_blocks.num_blocks;
+  const size_t rows_per_block = row_blocks.rows_per_block;
+  matrix_library::cpu_parallel::thread_pool::ParallelFor(
+      num_blocks,
+      [&](size_t block) {
+        const size_t row_start = block * rows_per_block;
+        if (row_start < m) {
+          const size_t rows = std::min(rows_per_block, m - row_start);
+          matrix_library::cpu_simple::blocked_gemm::GemmEpilogue<T>(
+              rows, n, k,
+              matrix_library::cpu_simple::blocked_gemm::RowOffsetOperand<OpA>(
+                  a, row_start),
+              b,
+              matrix_library::cpu_simple::blocked_gemm::RowOffsetOutput<OutC>(
+                  c, row_start),
+              matrix_library::cpu_simple::gemm_epilogues::RowOffsetEpilogue<
+                  Epilogue>(epilogue, row_start));
+        }
+      },
+      num_blocks);
+}
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, with every
+ * decision made ahead of time by a plan. Each block of rows runs the blocked
+ * kernel with the given micro-kernel, block sizes and its own workspace
+ *
+ * @tparam T Any numeric type
+ * @tparam OpA Operand type of A
+ * @tparam OpB Operand type of B
+ * @tparam OutC Output type of C
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a Operand A
+ * @param b Operand B
+ * @param c Output C
+ * @param accumulate Add the product to C instead of overwriting it
+ * @param kernel Micro-kernel to use
+ * @param blocks Block sizes to use
+ * @param row_blocks Split of the rows of C, one thread per block
+ * @param workspace Workspace of every block, workspace_stride elements apart
+ * @param workspace_stride Distance between the workspaces of 2 blocks
+ */
+template <typename T, typename OpA, typename OpB, typename OutC>
+inline void PlannedGemm(
+    size_t m, size_t n, size_t k, const OpA& a, const OpB& b, const OutC& c,
+    bool accumulate,
+    const matrix_library::cpu_simple::blocked_gemm::MicroKernel<T>& kernel,
+    const matrix_library::cpu_simple::blocked_gemm::BlockSizes& blocks,
+    const RowBlocks& row_blocks, T* workspace, size_t workspace_stride) {
+  const size_t num_blocks = row_blocks.num_blocks;
+  const size_t rows_per_block = row_blocks.rows_per_block;
+  // One block runs on the calling thread without offsetting the operands
+  if (num_blocks <= 1) {
+    matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+        m, n, k, a, b, c, accumulate, kernel, blocks, workspace);
+    return;
+  }
+  matrix_library::cpu_parallel::thread_pool::ParallelFor(
+      num_blocks,
+      [&](size_t block) {
+        const size_t row_start = block * rows_per_block;
+        if (row_start < m) {
+          const size_t rows = std::min(rows_per_block, m - row_start);
+          matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+              rows, n, k,
+              matrix_library::cpu_simple::blocked_gemm::RowOffsetOperand<OpA>(
+                  a, row_start),
+              b,
+              matrix_library::cpu_simple::blocked_gemm::RowOffsetOutput<OutC>(
+                  c, row_start),
+              accumulate, kernel, blocks,
+              workspace + block * workspace_stride);
+        }
+      },
+      num_blocks);
+}
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, for every entry
+ * of a batch by giving each thread a contiguous range of entries. Every range
+ * runs the batched kernel of the CPU simple version. Layouts are assumed to be
+ * validated by the caller
+ *
+ * @tparam T Any numeric type
+ * @tparam AAt Callable returning a pointer to entry e of A
+ * @tparam BAt Callable returning a pointer to entry e of B
+ * @tparam CAt Callable returning a pointer to entry e of C
+ * @param batch_size Number of products
+ * @param m Number of rows in every A and C
+ * @param n Number of columns in every B and C
+ * @param k Number of columns in every A and rows in every B
+ * @param a_at Entries of A
+ * @param lda Leading dimension of A
+ * @param b_at Entries of B
+ * @param ldb Leading dimension of B
+ * @param c_at Entries of C
+ * @param ldc Leading dimension of C
+ * @param accumulate Add the products to C instead of overwriting it
+ * @param num_threads Number of threads to use
+ */
+template <typename T, typename AAt, typename BAt, typename CAt>
+inline void BatchedGemm(size_t batch_size, size_t m, size_t n, size_t k,
+                        const AAt& a_at, size_t lda, const BAt& b_at,
+                        size_t ldb, const CAt& c_at, size_t ldc,
+                        bool accumulate, size_t num_threads) {
+  const size_t num_blocks =
+      std::max<size_t>(std::min(num_threads, batch_size), 1);
+  const size_t entries_per_block = (batch_size + num_blocks - 1) / num_blocks;
+  matrix_library::cpu_parallel::thread_pool::ParallelFor(
+      num_blocks,
+      [&](size_t block) {
+        const size_t begin = std::min(block * entries_per_block, batch_size);
+        const size_t end = std::min(begin + entries_per_block, batch_size);
+        matrix_library::cpu_simple::batched_gemm::Multiply<T>(
+            begin, end, m, n, k, a_at, lda, b_at, ldb, c_at, ldc, accumulate);
+      },
+      num_blocks);
+}
+
+/**
+ * @brief Computes a matrix-vector product y = A * x or an outer product
+ * C = x * y^T, or adds it to C when accumulating, by giving each thread a
+ * block of rows of C. Shapes are assumed to be validated by the caller and to
+ * pass UseParallelVectorMultiply
+ *
+ * @tparam T Any numeric type
+ * @tparam RowA Callable returning a pointer to row i of A
+ * @tparam RowB Callable returning a pointer to row p of B
+ * @tparam RowC Callable returning a pointer to row i of C
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a_row Rows of A
+ * @param b_row Rows of B
+ * @param c_row Rows of C
+ * @param accumulate Add the product to C instead of overwriting it
+ * @param num_threads Number of threads to use
+ * @param column Buffer of at least k elements the column of B is gathered
+ * into for a matrix-vector product. Every thread reads it, so it must not be
+ * per thread scratch, which a thread waiting on the loop may reuse for a task
+ * of another loop
+ */
+template <typename T, typename RowA, typename RowB, typename RowC>
+inline void MultiplyVectorShape(size_t m, size_t n, size_t k,
+                                const RowA& a_row, const RowB& b_row,
+                                const RowC& c_row, bool accumulate,
+                                size_t num_threads, T* column) {
+  // The vector is shared by every thread. A column of B is gathered once on
+  // the calling thread
+  const T* vector =
+      k == 1 ? b_row(0)
+             : matrix_library::cpu_simple::vector_kernels::GatherColumn<T>(
+                   k, b_row, column);
+  const size_t num_blocks = std::max<size_t>(std::min(num_threads, m), 1);
+  const size_t rows_per_block = (m + num_blocks - 1) / num_blocks;
+  matrix_library::cpu_parallel::thread_pool::ParallelFor(
+      num_blocks,
+      [&](size_t block) {
+        const size_t row_start = std::min(block * rows_per_block, m);
+        const size_t row_end = std::min(row_start + rows_per_block, m);
+        if (k == 1) {
+          matrix_library::cpu_simple::vector_kernels::OuterProduct<T>(
+              row_start, row_end, n,
+              [&a_row](size_t i) { return a_row(i)[0]; }, vector, c_row,
+              accumulate);
+        } else {
+          matrix_library::cpu_simple::vector_kernels::MatrixVector<T>(
+              row_start, row_end, k, a_row, vector, c_row, accumulate);
+        }
+      },
+      num_blocks);
+}
+
+/**
+ * @brief Computes a matrix-vector product or an outer product as above, with
+ * the column of B gathered into a buffer owned by this call
+ */
+template <typename T, typename RowA, typename RowB, typename RowC>
+inline void MultiplyVectorShape(size_t m, size_t n, size_t k,
+                                const RowA& a_row, const RowB& b_row,
+                                const RowC& c_row, bool accumulate,
+                                size_t num_threads) {
+  std::vector<T, matrix_library::utils::dense_matrix::DefaultInitAllocator<T>>
+      column(k == 1 ? 0 : k);
+  MultiplyVectorShape<T>(m, n, k, a_row, b_row, c_row, accumulate,
+                         num_threads, column.data());
+}
+
+/**
+ * @brief Runs independent tasks concurrently. Tasks may differ widely in size,
+ * which stealing evens out
+ *
+ * @tparam Task Callable taking the index of a task
+ * @param num_tasks Number of tasks
+ * @param task Task to run for every index
+ * @param num_threads Number of threads to use
+ */
+template <typename Task>
+inline void ForEachConcurrently(size_t num_tasks, const Task& task,
+                                size_t num_threads) {
+  matrix_library::cpu_parallel::thread_pool::ParallelFor(num_tasks, task,
+                                                         num_threads);
+}
+
+/**
+ * @brief Fills a row-major matrix with the row blocks of PartitionNodeRows, so
+ * each page is first touched, and placed, on the NUMA node whose threads later
+ * multiply its rows
+ *
+ * @tparam T Any numeric type
+ * @param num_rows Number of rows in the matrix
+ * @param num_cols Number of columns in the matrix
+ * @param data First element of the matrix
+ * @param ld Leading dimension of the matrix
+ * @param value Value to fill with
+ * @param num_threads Number of threads to use
+ */
+template <typename T>
+inline void FillRows(size_t num_rows, size_t num_cols, T* data, size_t ld,
+                     T value, size_t num_threads) {
+  matrix_library::cpu_parallel::thread_pool::ThreadPool& pool =
+      matrix_library::cpu_parallel::thread_pool::SharedThreadPool();
+  std::vector<size_t> block_bounds;
+  const std::vector<NodeRowBlock> row_blocks = PartitionNodeRows(
+      num_rows,
+      matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<T>().mr,
+      num_threads, pool.topology(), block_bounds);
+  pool.ParallelForNodes(
+      block_bounds,
+      [&](size_t i) {
+        const NodeRowBlock& block = row_blocks[i];
+        for (size_t row = block.row_start;
+             row < block.row_start + block.rows; row++) {
+          std::fill(data + row * ld, data + row * ld + num_cols, value);
+        }
+      },
+      num_threads);
+}
+
+/**
+ * @brief Writes the transpose of an operand into an output, one square tile
+ * per task. A tile is read and written while it is still in cache
+ *
+ * @tparam OpIn Operand type of the original matrix
+ * @tparam Out Output type of the transposed matrix
+ * @param num_rows Number of rows in the original matrix
+ * @param num_cols Number of columns in the original matrix
+ * @param in Original matrix
+ * @param out Transposed matrix
+ * @param num_threads Number of threads to use
+ */
+template <typename OpIn, typename Out>
+inline void Transpose(size_t num_rows, size_t num_cols, const OpIn& in,
+                      const Out& out, size_t num_threads) {
+  matrix_library::cpu_parallel::thread_pool::ParallelForTiles(
+      num_rows, num_cols, kTransposeTile, kTransposeTile,
+      [&](size_t row_start, size_t row_end, size_t col_start,
+          size_t col_end) {
+        for (size_t j = col_start; j < col_end; j++) {
+          auto out_row = out.Row(j);
+          for (size_t i = row_start; i < row_end; i++) {
+            out_row[i] = in(i, j);
+          }
+        }
+      },
+      num_threads);
+}
+
+/**
+ * @brief Writes the transpose of a row-major block into another, one square
+ * tile per task. Each tile runs the cache-oblivious transpose of the CPU simple
+ * version with its in-register tile kernels
+ *
+ * @tparam T Any numeric type
+ * @param num_rows Number of rows in the original matrix
+ * @param num_cols Number of columns in the original matrix
+ * @param in Original matrix
+ * @param ldi Leading dimension of in
+ * @param out Transposed matrix. Must not overlap in
+ * @param ldo Leading dimension of out
+ * @param num_threads Number of threads to use
+ */
+template <typename T>
+inline void Transpose(size_t num_rows, size_t num_cols, const T* in,
+                      size_t ldi, T* out, size_t ldo, size_t num_threads) {
+  matrix_library::cpu_parallel::thread_pool::ParallelForTiles(
+      num_rows, num_cols, kTransposeTile, kTransposeTile,
+      [&](size_t row_start, size_t row_end, size_t col_start,
+          size_t col_end) {
+        matrix_library::cpu_simple::transpose_kernels::Transpose(
+            row_end - row_start, col_end - col_start,
+            in + row_start * ldi + col_start, ldi,
+            out + col_start * ldo + row_start, ldo);
+      },
+      num_threads);
+}
+
+}  // namespace parallel_kernels
+}  // namespace cpu_parallel
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,424 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the tile task graph of the CPU parallel
+ * version of library. Tile operations are submitted in program order with the
+ * tiles they read and write, and the graph infers the dependencies between
+ * them: a task reading a tile waits for its last writer, and a task writing a
+ * tile waits for the last writer and the readers since. Waiting on the graph
+ * runs it on the thread pool, starting every task as soon as the tasks it
+ * depends on are done, so consecutive blocked phases overlap instead of being
+ * separated by a barrier. A task is started by the last of its dependencies
+ * to finish, so no thread of the pool ever blocks waiting for a task
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_PARALLEL__TASK_GRAPH_H_
+#define MATRIX_LIBRARY__CPU_PARALLEL__TASK_GRAPH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "matrix_library/cpu_parallel/parallel_config.h"
+#include "matrix_library/cpu_parallel/thread_pool.h"
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/utils/dense_matrix.h"
+
+namespace matrix_library {
+namespace cpu_parallel {
+namespace task_graph {
+
+/**
+ * @brief How a task uses a tile
+ */
+enum class Access { kRead, kWrite, kReadWrite };
+
+/**
+ * @brief Tile a task uses, identified by its address
+ */
+struct Dependency {
+  const void* tile;
+  Access access;
+};
+
+/**
+ * @brief Declares that a task reads a tile
+ *
+ * @param tile Address identifying the tile, such as its first element
+ * @return Dependency Read dependency
+ */
+inline Dependency Read(const void* tile) {
+  return Dependency{tile, Access::kRead};
+}
+
+/**
+ * @brief Declares that a task overwrites a tile without reading it
+ *
+ * @param tile Address identifying the tile, such as its first element
+ * @return Dependency Write dependency
+ */
+inline Dependency Write(const void* tile) {
+  return Dependency{tile, Access::kWrite};
+}
+
+/**
+ * @brief Declares that a task reads and updates a tile
+ *
+ * @param tile Address identifying the tile, such as its first element
+ * @return Dependency Read-write dependency
+ */
+inline Dependency ReadWrite(const void* tile) {
+  return Dependency{tile, Access::kReadWrite};
+}
+
+namespace internal {
+
+/**
+ * @brief Submitted task and the tasks waiting for it
+ */
+struct Task {
+  std::function<void()> run;
+  std::vector<size_t> successors;
+  // Tasks this one still waits for. The task finishing last starts it
+  std::atomic<size_t> pending;
+};
+
+/**
+ * @brief Last writer of a tile and the readers since
+ */
+struct TileState {
+  size_t last_writer;
+  std::vector<size_t> readers;
+};
+
+/**
+ * @brief Graphs whose tasks the calling thread is running, innermost last.
+ * A thread waiting in a parallel loop may run tasks of any graph, so a graph
+ * can be anywhere on its stack
+ *
+ * @return std::vector<const void*>& Graphs being run
+ */
+inline std::vector<const void*>& RunningGraphs() {
+  static thread_local std::vector<const void*> graphs;
+  return graphs;
+}
+
+/**
+ * @brief Checks if the calling thread is running a task of a graph
+ *
+ * @param graph Graph
+ * @return true If one of its tasks is on the stack of the thread
+ */
+inline bool IsRunningGraph(const void* graph) {
+  const std::vector<const void*>& graphs = RunningGraphs();
+  return std::find(graphs.begin(), graphs.end(), graph) != graphs.end();
+}
+
+/**
+ * @brief Marks a graph as running on the calling thread for its lifetime
+ */
+class RunningGraphScope {
+ public:
+  explicit RunningGraphScope(const void* graph) {
+    RunningGraphs().push_back(graph);
+  }
+
+  RunningGraphScope(const RunningGraphScope&) = delete;
+  RunningGraphScope& operator=(const RunningGraphScope&) = delete;
+
+  ~RunningGraphScope() { RunningGraphs().pop_back(); }
+};
+
+}  // namespace internal
+
+/**
+ * @brief Graph of tile tasks with dependencies inferred from the tiles they
+ * use, in the style of the sequential task flow of PLASMA and StarPU. Tasks
+ * are submitted from one thread and run by Wait, which may be called again
+ * for the next batch of tasks
+ */
+class TaskGraph {
+ public:
+  /**
+   * @brief Sentinel for a tile no submitted task has written
+   */
+  static constexpr size_t kNoTask = static_cast<size_t>(-1);
+
+  TaskGraph() : num_threads_(1), failed_(false) {}
+
+  TaskGraph(const TaskGraph&) = delete;
+  TaskGraph& operator=(const TaskGraph&) = delete;
+
+  /**
+   * @brief Gets the number of tasks submitted since the last Wait
+   */
+  size_t num_tasks() const { return tasks_.size(); }
+
+  /**
+   * @brief Gets the number of tasks a task waits for
+   *
+   * @param task Index returned by Submit
+   * @return size_t Number of distinct tasks it depends on
+   */
+  size_t NumDependencies(size_t task) const {
+    return tasks_.at(task)->pending.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Adds a task after the tasks already submitted
+   *
+   * @param run Operation of the task. Tiles it uses must stay alive until
+   * Wait returns
+   * @param dependencies Tiles the task uses. A tile listed several times
+   * counts as its strongest access
+   * @return size_t Index of the task
+   */
+  size_t Submit(std::function<void()> run,
+                const std::vector<Dependency>& dependencies) {
+    const size_t id = tasks_.size();
+    std::unique_ptr<internal::Task> task(new internal::Task());
+    task->run = std::move(run);
+    task->pending.store(0, std::memory_order_relaxed);
+    tasks_.push_back(std::move(task));
+    for (const Dependency& dependency : dependencies) {
+      auto inserted = tiles_.insert(std::make_pair(
+          dependency.tile, internal::TileState{kNoTask, {}}));
+      internal::TileState& state = inserted.first->second;
+      if (dependency.access == Access::kRead) {
+        AddEdge(state.last_writer, id);
+        if (state.readers.empty() || state.readers.back() != id) {
+          state.readers.push_back(id);
+        }
+        continue;
+      }
+      // Writers wait for the readers of the previous value, which already
+      // wait for its writer
+      if (state.readers.empty()) {
+        AddEdge(state.last_writer, id);
+      }
+      for (size_t reader : state.readers) {
+        AddEdge(reader, id);
+      }
+      state.readers.clear();
+      state.last_writer = id;
+    }
+    return id;
+  }
+
+  /**
+   * @brief Adds a task after the tasks already submitted
+   *
+   * @param run Operation of the task
+   * @param dependencies Tiles the task uses
+   * @return size_t Index of the task
+   */
+  size_t Submit(std::function<void()> run,
+                std::initializer_list<Dependency> dependencies) {
+    return Submit(std::move(run), std::vector<Dependency>(dependencies));
+  }
+
+  /**
+   * @brief Runs every submitted task on the thread pool and returns once all
+   * are done. A task starts as soon as the tasks it depends on are done, on
+   * whichever thread finished the last of them or stole it. The graph is
+   * empty afterwards. If a task throws, the tasks not yet started are skipped
+   * and the first exception is rethrown here
+   *
+   * @param num_threads Number of threads to run on, counting the calling
+   * thread
+   * @throws Runtime Error if called from one of the graph's tasks
+   */
+  void Wait(
+      size_t num_threads =
+          matrix_library::cpu_parallel::parallel_config::GetNumThreads()) {
+    if (internal::IsRunningGraph(this)) {
+      throw std::runtime_error("A graph cannot be waited on by its own tasks");
+    }
+    std::vector<size_t> ready;
+    for (size_t id = 0; id < tasks_.size(); id++) {
+      if (tasks_[id]->pending.load(std::memory_order_relaxed) == 0) {
+        ready.push_back(id);
+      }
+    }
+    num_threads_ = std::max<size_t>(num_threads, 1);
+    // Every task is started by its last dependency, inside the parallel loop
+    // that ran it, so the tasks are all done once this loop returns
+    RunAll(ready);
+    tasks_.clear();
+    tiles_.clear();
+    std::exception_ptr error = error_;
+    error_ = nullptr;
+    failed_.store(false, std::memory_order_relaxed);
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+ private:
+  void AddEdge(size_t from, size_t to) {
+    if (from == kNoTask || from == to) {
+      return;
+    }
+    std::vector<size_t>& successors = tasks_[from]->successors;
+    // Edges into a task are added while it is the last one submitted
+    if (!successors.empty() && successors.back() == to) {
+      return;
+    }
+    successors.push_back(to);
+    tasks_[to]->pending.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Runs ready tasks, and the tasks they start, split across the pool
+   */
+  void RunAll(const std::vector<size_t>& ready) {
+    matrix_library::cpu_parallel::thread_pool::ParallelFor(
+        ready.size(), [this, &ready](size_t index) { RunFrom(ready[index]); },
+        num_threads_);
+  }
+
+  /**
+   * @brief Runs a task, then the tasks it was the last dependency of. A
+   * single one is run next on the same thread and several are split across
+   * the pool, whose waiting threads run other work instead of blocking
+   */
+  void RunFrom(size_t id) {
+    internal::RunningGraphScope scope(this);
+    std::vector<size_t> ready;
+    while (true) {
+      internal::Task& task = *tasks_[id];
+      if (!failed_.load(std::memory_order_relaxed)) {
+        try {
+          task.run();
+        } catch (...) {
+          if (!failed_.exchange(true)) {
+            error_ = std::current_exception();
+          }
+        }
+      }
+      // Skipped tasks still start their successors, which skip in turn
+      ready.clear();
+      for (size_t successor : task.successors) {
+        if (tasks_[successor]->pending.fetch_sub(
+                1, std::memory_order_acq_rel) == 1) {
+          ready.push_back(successor);
+        }
+      }
+      if (ready.size() != 1) {
+        break;
+      }
+      id = ready.front();
+    }
+    if (!ready.empty()) {
+      RunAll(ready);
+    }
+  }
+
+  std::vector<std::unique_ptr<internal::Task>> tasks_;
+  std::unordered_map<const void*, internal::TileState> tiles_;
+  size_t num_threads_;
+  std::atomic<bool> failed_;
+  std::exception_ptr error_;
+};
+
+/**
+ * @brief Submits the tile tasks of C = A * B, or C += A * B when
+ * accumulating, without waiting for them. C is cut into tile_size square
+ * tiles and task (i, j, p) adds tile (i, p) of A times tile (p, j) of B to
+ * tile (i, j) of C, so a product submitted after another one whose C it reads
+ * starts on each tile as soon as that tile is done. Tiles are identified by
+ * their first element, so products chained in a graph use the same tile size
+ *
+ * @tparam T Any numeric type
+ * @param graph Graph to submit to
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @param C Matrix with as many rows as A and as many columns as B. Must not
+ * be A or B
+ * @param tile_size Side of the tiles
+ * @param accumulate Add the product to C instead of overwriting it
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A or B
+ * @throws Runtime Error if tile_size is 0
+ */
+template <typename T>
+inline void SubmitTiledMultiply(
+    TaskGraph& graph,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C, size_t tile_size,
+    bool accumulate = false) {
+  if (A.num_cols() != B.num_rows()) {
+    throw std::runtime_error("Matrices cannot be multiplied");
+  }
+  if (C.num_rows() != A.num_rows() || C.num_cols() != B.num_cols()) {
+    throw std::runtime_error("Matrix C has the wrong shape");
+  }
+  if (&C == &A || &C == &B) {
+    throw std::runtime_error("Matrix C cannot be one of the inputs");
+  }
+  if (tile_size == 0) {
+    throw std::runtime_error("Tile size cannot be 0");
+  }
+  const size_t m = A.num_rows();
+  const size_t n = B.num_cols();
+  const size_t k = A.num_cols();
+  const size_t lda = A.leading_dimension();
+  const size_t ldb = B.leading_dimension();
+  const size_t ldc = C.leading_dimension();
+  for (size_t i = 0; i < m; i += tile_size) {
+    for (size_t j = 0; j < n; j += tile_size) {
+      const size_t rows = std::min(tile_size, m - i);
+      const size_t cols = std::min(tile_size, n - j);
+      T* c = C.data() + i * ldc + j;
+      if (k == 0 && !accumulate) {
+        graph.Submit(
+            [c, rows, cols, ldc]() {
+              for (size_t row = 0; row < rows; row++) {
+                std::fill(c + row * ldc, c + row * ldc + cols,
+                          static_cast<T>(0));
+              }
+            },
+            {Write(c)});
+        continue;
+      }
+      for (size_t p = 0; p < k; p += tile_size) {
+        const size_t depth = std::min(tile_size, k - p);
+        const T* a = A.data() + i * lda + p;
+        const T* b = B.data() + p * ldb + j;
+        // The first task of a tile of C overwrites it unless accumulating
+        const bool add = accumulate || p > 0;
+        graph.Submit(
+            [a, b, c, rows, cols, depth, lda, ldb, ldc, add]() {
+              matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+                  rows, cols, depth,
+                  matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+                      a, lda, 1),
+                  matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+                      b, ldb, 1),
+                  matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(
+                      c, ldc),
+                  add);
+            },
+            {Read(a), Read(b), add ? ReadWrite(c) : Write(c)});
+      }
+    }
+  }
+}
+
+}  // namespace task_graph
+}  // namespace cpu_parallel
+}  // namespace matrix_library
+
+#endif
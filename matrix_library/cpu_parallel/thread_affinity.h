@@ -0,0 +1,321 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the thread affinity configuration of the
+ * CPU parallel version of library. Workers of the thread pool can be pinned
+ * one per core, either to an explicit list of cores or by a compact or
+ * scatter policy over the NUMA topology, so they stop migrating between cores
+ * and stay off the cores of other latency critical threads. The policy is set
+ * through SetAffinity or the MATRIX_LIBRARY_AFFINITY environment variable,
+ * which takes "none", "compact", "scatter" or a list of cores like "4-7,12"
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_PARALLEL__THREAD_AFFINITY_H_
+#define MATRIX_LIBRARY__CPU_PARALLEL__THREAD_AFFINITY_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "matrix_library/cpu_parallel/numa_topology.h"
+
+namespace matrix_library {
+namespace cpu_parallel {
+namespace thread_affinity {
+
+/**
+ * @brief Environment variable read for the affinity policy on first use
+ */
+constexpr const char* kAffinityEnvVar = "MATRIX_LIBRARY_AFFINITY";
+
+/**
+ * @brief How workers of the thread pool are placed on cores
+ */
+enum class AffinityPolicy {
+  /// Workers are not pinned. On machines with several NUMA nodes they are
+  /// still bound to the cores of their node
+  kNone,
+  /// Worker i is pinned to core i + 1 with the cores in node order, filling a
+  /// node before using the next. The calling thread is expected on the first
+  /// core
+  kCompact,
+  /// Like kCompact but with the cores taken from each node in turn, spreading
+  /// workers over the nodes
+  kScatter,
+  /// Worker i is pinned to core i of an explicit list, wrapping around when
+  /// there are more workers than cores
+  kCpuList
+};
+
+/**
+ * @brief Affinity policy and, for kCpuList, its cores
+ */
+struct AffinityConfig {
+  AffinityPolicy policy;
+  std::vector<size_t> cpus;
+};
+
+/**
+ * @brief Parses an affinity specification as taken by MATRIX_LIBRARY_AFFINITY
+ *
+ * @param spec "none", "compact", "scatter" or a list of cores like "4-7,12"
+ * @return AffinityConfig Policy described
+ * @throws Runtime Error if the specification is malformed
+ * @throws Runtime Error if the list of cores is empty
+ */
+inline AffinityConfig ParseAffinity(const std::string& spec) {
+  if (spec.empty() || spec == "none") {
+    return AffinityConfig{AffinityPolicy::kNone, {}};
+  }
+  if (spec == "compact") {
+    return AffinityConfig{AffinityPolicy::kCompact, {}};
+  }
+  if (spec == "scatter") {
+    return AffinityConfig{AffinityPolicy::kScatter, {}};
+  }
+  AffinityConfig config{
+      AffinityPolicy::kCpuList,
+      matrix_library::cpu_parallel::numa_topology::ParseCpuList(spec)};
+  // A list ending before its first entry, such as "\n", names no cpu
+  if (config.cpus.empty()) {
+    throw std::runtime_error("The list of cpus is empty");
+  }
+  return config;
+}
+
+namespace internal {
+
+/**
+ * @brief Affinity requested by the caller, and a counter bumped on every
+ * change so the pool knows when to pin its workers again
+ */
+struct AffinityState {
+  std::mutex mutex;
+  AffinityConfig config;
+  std::atomic<uint64_t> generation;
+};
+
+/**
+ * @brief Affinity state, starting from MATRIX_LIBRARY_AFFINITY. A malformed
+ * variable leaves workers unpinned
+ *
+ * @return AffinityState& State
+ */
+inline AffinityState& State() {
+  static AffinityState state;
+  static std::once_flag read_env;
+  std::call_once(read_env, []() {
+    state.config = AffinityConfig{AffinityPolicy::kNone, {}};
+    state.generation.store(0);
+    const char* spec = std::getenv(kAffinityEnvVar);
+    if (spec != nullptr) {
+      try {
+        state.config = ParseAffinity(spec);
+      } catch (const std::runtime_error&) {
+        state.config = AffinityConfig{AffinityPolicy::kNone, {}};
+      }
+    }
+  });
+  return state;
+}
+
+/**
+ * @brief Replaces the requested affinity
+ */
+inline void Store(const AffinityConfig& config) {
+  AffinityState& state = State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.config = config;
+  state.generation.fetch_add(1, std::memory_order_release);
+}
+
+}  // namespace internal
+
+/**
+ * @brief Sets how workers of the thread pool are placed on cores. Workers
+ * already started are pinned again before the next parallel call
+ *
+ * @param policy kNone, kCompact or kScatter
+ * @throws Runtime Error if the policy is kCpuList, which needs its cores
+ */
+inline void SetAffinity(AffinityPolicy policy) {
+  if (policy == AffinityPolicy::kCpuList) {
+    throw std::runtime_error("The cpu list policy needs a list of cpus");
+  }
+  internal::Store(AffinityConfig{policy, {}});
+}
+
+/**
+ * @brief Pins workers of the thread pool to an explicit list of cores
+ *
+ * @param cpus Cores, worker i getting cpus[i % cpus.size()]
+ * @throws Runtime Error if the list is empty
+ */
+inline void SetAffinityCpus(const std::vector<size_t>& cpus) {
+  if (cpus.empty()) {
+    throw std::runtime_error("The list of cpus is empty");
+  }
+  internal::Store(AffinityConfig{AffinityPolicy::kCpuList, cpus});
+}
+
+/**
+ * @brief Sets the affinity from a specification as taken by
+ * MATRIX_LIBRARY_AFFINITY
+ *
+ * @param spec "none", "compact", "scatter" or a list of cores like "4-7,12"
+ * @throws Runtime Error if the specification is malformed or lists no core
+ */
+inline void SetAffinity(const std::string& spec) {
+  internal::Store(ParseAffinity(spec));
+}
+
+/**
+ * @brief Gets the affinity workers of the thread pool are placed with
+ *
+ * @return AffinityConfig Current policy
+ */
+inline AffinityConfig GetAffinity() {
+  internal::AffinityState& state = internal::State();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return state.config;
+}
+
+/**
+ * @brief Gets a counter that changes whenever the affinity is set
+ *
+ * @return uint64_t Counter
+ */
+inline uint64_t AffinityGeneration() {
+  return internal::State().generation.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Gets the core a worker is pinned to under a policy
+ *
+ * @param config Policy
+ * @param topology Nodes and their cores
+ * @param worker Index of the worker
+ * @return std::vector<size_t> The core of the worker, or nothing if the
+ * policy does not pin it
+ */
+inline std::vector<size_t> WorkerCpus(
+    const AffinityConfig& config,
+    const matrix_library::cpu_parallel::numa_topology::NumaTopology& topology,
+    size_t worker) {
+  std::vector<size_t> order;
+  switch (config.policy) {
+    case AffinityPolicy::kCpuList:
+      if (config.cpus.empty()) {
+        return {};
+      }
+      return {config.cpus[worker % config.cpus.size()]};
+    case AffinityPolicy::kCompact:
+      for (const auto& node : topology.nodes) {
+        order.insert(order.end(), node.cpus.begin(), node.cpus.end());
+      }
+      break;
+    case AffinityPolicy::kScatter:
+      for (size_t rank = 0; order.size() < topology.NumCpus(); rank++) {
+        for (const auto& node : topology.nodes) {
+          if (rank < node.cpus.size()) {
+            order.push_back(node.cpus[rank]);
+          }
+        }
+      }
+      break;
+    default:
+      return {};
+  }
+  if (order.empty()) {
+    return {};
+  }
+  return {order[(worker + 1) % order.size()]};
+}
+
+/**
+ * @brief Gets the cores a thread may run on
+ *
+ * @param thread Native handle of the thread
+ * @return std::vector<size_t> Cores in increasing order, or nothing if they
+ * cannot be read
+ */
+inline std::vector<size_t> ThreadCpus(std::thread::native_handle_type thread) {
+  std::vector<size_t> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (pthread_getaffinity_np(thread, sizeof(set), &set) == 0) {
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#else
+  static_cast<void>(thread);
+#endif
+  return cpus;
+}
+
+/**
+ * @brief Gets the cores the calling thread may run on
+ *
+ * @return std::vector<size_t> Cores in increasing order, or nothing if they
+ * cannot be read
+ */
+inline std::vector<size_t> CurrentThreadCpus() {
+#ifdef __linux__
+  return ThreadCpus(pthread_self());
+#else
+  return {};
+#endif
+}
+
+/**
+ * @brief Restricts a thread to a set of cores. Best effort, the thread keeps
+ * its cores if the set cannot be applied
+ *
+ * @param thread Native handle of the thread
+ * @param cpus Cores the thread may run on
+ * @return true If the set was applied
+ * @return false If it was rejected or affinity is not supported
+ */
+inline bool BindThread(std::thread::native_handle_type thread,
+                       const std::vector<size_t>& cpus) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (size_t cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return !cpus.empty() &&
+         pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+#else
+  static_cast<void>(thread);
+  static_cast<void>(cpus);
+  return false;
+#endif
+}
+
+}  // namespace thread_affinity
+}  // namespace cpu_parallel
+}  // namespace matrix_library
+
+#endif
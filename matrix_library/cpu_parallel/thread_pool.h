@@ -0,0 +1,1049 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the thread pool of the CPU parallel version
+ * of library. Every parallel kernel runs on one pool owned by the library,
+ * started the first time it is needed and kept until the program exits, so a
+ * parallel call does not start or join threads. Each thread has a Chase-Lev
+ * deque: a loop is split in halves pushed onto the deque of the thread
+ * running it, and idle threads steal the oldest halves of other threads. A
+ * parallel loop started inside a task runs on the threads already in the pool
+ * instead of starting more. On machines with several NUMA nodes each worker is
+ * bound to the cores of one node, and loops split by node run each share on
+ * the workers of its node. Workers can also be pinned one per core with the
+ * policies of thread_affinity
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_PARALLEL__THREAD_POOL_H_
+#define MATRIX_LIBRARY__CPU_PARALLEL__THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "matrix_library/cpu_parallel/numa_topology.h"
+#include "matrix_library/cpu_parallel/parallel_config.h"
+#include "matrix_library/cpu_parallel/thread_affinity.h"
+
+namespace matrix_library {
+namespace cpu_parallel {
+namespace thread_pool {
+
+/**
+ * @brief Most worker threads a pool starts
+ */
+constexpr size_t kMaxWorkers = 256;
+
+/**
+ * @brief Most threads outside a pool that can run parallel loops on it at the
+ * same time. Any more run their loops serially
+ */
+constexpr size_t kMaxExternalThreads = 8;
+
+/**
+ * @brief Number of pieces a loop is cut into per thread, so threads that
+ * finish early have something left to steal
+ */
+constexpr size_t kChunksPerThread = 4;
+
+/**
+ * @brief Size of a cache line, kept between data written by different threads
+ */
+constexpr size_t kCacheLineSize = 64;
+
+/**
+ * @brief Tells the core the thread is spinning so it can yield to its
+ * sibling hyperthread
+ */
+inline void CpuRelax() {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+  __builtin_ia32_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief Chase-Lev work stealing deque. The thread owning it pushes and pops
+ * at the bottom, any thread steals from the top. The ring of slots doubles
+ * when full and old rings are kept until the deque is destroyed, as a thief
+ * may still be reading one
+ *
+ * @tparam T Pointer type of the items
+ */
+template <typename T>
+class WorkStealingDeque {
+  static_assert(std::is_pointer<T>::value,
+                "WorkStealingDeque holds pointers");
+
+ public:
+  /**
+   * @brief Creates an empty deque
+   *
+   * @param capacity Initial number of slots, rounded up to a power of 2
+   */
+  explicit WorkStealingDeque(size_t capacity = 64) : top_(0), bottom_(0) {
+    size_t rounded = 1;
+    while (rounded < capacity) {
+      rounded *= 2;
+    }
+    rings_.emplace_back(new Ring(rounded));
+    ring_.store(rings_.back().get(), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  /**
+   * @brief Adds an item at the bottom. Only the owner may call it
+   *
+   * @param item Item to add
+   */
+  void Push(T item) {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const int64_t top = top_.load(std::memory_order_acquire);
+    Ring* ring = ring_.load(std::memory_order_relaxed);
+    if (bottom - top >= static_cast<int64_t>(ring->capacity)) {
+      ring = Grow(ring, top, bottom);
+    }
+    ring->Put(bottom, item);
+    bottom_.store(bottom + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Removes the item at the bottom, the last one pushed. Only the
+   * owner may call it
+   *
+   * @param item Set to the removed item
+   * @return true If an item was removed
+   * @return false If the deque was empty or a thief took the last item
+   */
+  bool Pop(T& item) {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Ring* ring = ring_.load(std::memory_order_relaxed);
+    // Publishing the smaller bottom before reading top is what keeps the
+    // owner and a thief from both taking the last item
+    bottom_.store(bottom, std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_seq_cst);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+    item = ring->Get(bottom);
+    if (top < bottom) {
+      return true;
+    }
+    // The last item is raced for with the thieves
+    const bool won = top_.compare_exchange_strong(
+        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  /**
+   * @brief Removes the item at the top, the oldest one. Any thread may call
+   * it
+   *
+   * @param item Set to the removed item
+   * @return true If an item was removed
+   * @return false If the deque was empty or another thread won the item
+   */
+  bool Steal(T& item) {
+    int64_t top = top_.load(std::memory_order_seq_cst);
+    const int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+    if (top >= bottom) {
+      return false;
+    }
+    const T candidate = ring_.load(std::memory_order_acquire)->Get(top);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+    item = candidate;
+    return true;
+  }
+
+  /**
+   * @brief Checks if the deque looks empty. Only a hint when other threads
+   * use the deque
+   */
+  bool Empty() const {
+    return top_.load(std::memory_order_acquire) >=
+           bottom_.load(std::memory_order_acquire);
+  }
+
+ private:
+  /**
+   * @brief Power of 2 ring of slots indexed by the unwrapped position
+   */
+  struct Ring {
+    explicit Ring(size_t size)
+        : capacity(size), slots(new std::atomic<T>[size]) {}
+
+    T Get(int64_t position) const {
+      return slots[static_cast<size_t>(position) & (capacity - 1)].load(
+          std::memory_order_relaxed);
+    }
+
+    void Put(int64_t position, T item) {
+      slots[static_cast<size_t>(position) & (capacity - 1)].store(
+          item, std::memory_order_relaxed);
+    }
+
+    size_t capacity;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+  Ring* Grow(Ring* ring, int64_t top, int64_t bottom) {
+    rings_.emplace_back(new Ring(ring->capacity * 2));
+    Ring* grown = rings_.back().get();
+    for (int64_t position = top; position < bottom; position++) {
+      grown->Put(position, ring->Get(position));
+    }
+    ring_.store(grown, std::memory_order_release);
+    return grown;
+  }
+
+  // Thieves write top and the owner writes bottom, so they are kept on
+  // separate cache lines
+  std::atomic<int64_t> top_;
+  char top_padding_[kCacheLineSize - sizeof(std::atomic<int64_t>)];
+  std::atomic<int64_t> bottom_;
+  char bottom_padding_[kCacheLineSize - sizeof(std::atomic<int64_t>)];
+  std::atomic<Ring*> ring_;
+  std::vector<std::unique_ptr<Ring>> rings_;
+};
+
+class ThreadPool;
+
+namespace internal {
+
+struct Job;
+
+/**
+ * @brief Range [begin, end) of the chunks of a job. A task splits off its
+ * upper half for other threads until it holds a single chunk
+ */
+struct Task {
+  Job* job;
+  size_t begin;
+  size_t end;
+};
+
+/**
+ * @brief Parallel loop over num_iterations iterations cut into num_chunks
+ * contiguous chunks. Lives on the stack of the thread that started the loop,
+ * which waits for every chunk before returning
+ */
+struct Job {
+  Job(size_t iterations, size_t chunks,
+      void (*run_function)(const void*, size_t, size_t), const void* loop_body)
+      : num_iterations(iterations),
+        num_chunks(chunks),
+        run(run_function),
+        body(loop_body),
+        tasks(chunks),
+        remaining(chunks),
+        failed(false) {}
+
+  /**
+   * @brief First iteration of a chunk
+   */
+  size_t ChunkBegin(size_t chunk) const {
+    return chunk * num_iterations / num_chunks;
+  }
+
+  size_t num_iterations;
+  size_t num_chunks;
+  void (*run)(const void*, size_t, size_t);
+  const void* body;
+  // A task starting at chunk c is only ever created once, so it lives at
+  // tasks[c]
+  std::vector<Task> tasks;
+  std::atomic<size_t> remaining;
+  std::atomic<bool> failed;
+  std::exception_ptr error;
+};
+
+/**
+ * @brief Iterations [next, end) of a loop split by node that are left for
+ * one node
+ */
+struct NodeShare {
+  std::atomic<size_t> next;
+  size_t end;
+};
+
+/**
+ * @brief Parallel loop whose iterations are split between NUMA nodes. Lives
+ * on the stack of the thread that started it, which waits for every
+ * iteration and for every thread still looking at it before returning
+ */
+struct NodeJob {
+  NodeJob(const std::vector<size_t>& node_bounds,
+          void (*run_function)(const void*, size_t, size_t),
+          const void* loop_body)
+      : run(run_function),
+        body(loop_body),
+        shares(new NodeShare[node_bounds.size() - 1]),
+        remaining(node_bounds.back() - node_bounds.front()),
+        users(0),
+        failed(false) {
+    for (size_t node = 0; node + 1 < node_bounds.size(); node++) {
+      shares[node].next.store(node_bounds[node]);
+      shares[node].end = node_bounds[node + 1];
+    }
+  }
+
+  void (*run)(const void*, size_t, size_t);
+  const void* body;
+  std::unique_ptr<NodeShare[]> shares;
+  std::atomic<size_t> remaining;
+  std::atomic<size_t> users;
+  std::atomic<bool> failed;
+  std::exception_ptr error;
+};
+
+/**
+ * @brief Loops split by node with work left for a node
+ */
+struct NodeQueue {
+  std::mutex mutex;
+  std::vector<NodeJob*> jobs;
+  std::atomic<size_t> num_jobs;
+};
+
+/**
+ * @brief Worker thread of a pool, the deque it owns and the index of the
+ * NUMA node it is bound to
+ */
+struct Worker {
+  explicit Worker(size_t worker_node) : node(worker_node), pinned(false) {}
+
+  WorkStealingDeque<Task*> deque;
+  size_t node;
+  // Whether an affinity policy restricted the worker to a core
+  bool pinned;
+};
+
+/**
+ * @brief Runs iterations [begin, end) of a loop body
+ */
+template <typename Body>
+inline void RunRange(const void* body, size_t begin, size_t end) {
+  const Body& loop_body = *static_cast<const Body*>(body);
+  for (size_t i = begin; i < end; i++) {
+    loop_body(i);
+  }
+}
+
+/**
+ * @brief Pool and deque of the calling thread, when it is a worker of a pool
+ * or is running a loop on one, and the node of a worker
+ */
+struct ThreadContext {
+  const ThreadPool* pool;
+  WorkStealingDeque<Task*>* deque;
+  size_t node;
+};
+
+inline ThreadContext& CurrentContext() {
+  static thread_local ThreadContext context = {nullptr, nullptr, 0};
+  return context;
+}
+
+}  // namespace internal
+
+/**
+ * @brief Placement of a worker thread of a pool
+ */
+struct WorkerAffinity {
+  /// Index of the worker
+  size_t worker;
+  /// Index of the NUMA node the worker takes node shares of
+  size_t node;
+  /// Cores the worker may run on, as reported by the kernel
+  std::vector<size_t> cpus;
+};
+
+/**
+ * @brief Pool of worker threads running parallel loops by work stealing.
+ * Workers are started on demand and when idle look for work
+ * parallel_config::GetSpinCount() times before they park
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Creates a pool for the NUMA topology of this machine
+   */
+  ThreadPool()
+      : ThreadPool(matrix_library::cpu_parallel::numa_topology::
+                       GetNumaTopology()) {}
+
+  /**
+   * @brief Creates a pool for a given NUMA topology. Workers are spread over
+   * the nodes in the order of their cores
+   *
+   * @param topology Nodes and their cores
+   */
+  explicit ThreadPool(
+      const matrix_library::cpu_parallel::numa_topology::NumaTopology&
+          topology)
+      : topology_(topology),
+        node_queues_(new internal::NodeQueue[topology.num_nodes()]),
+        num_workers_(0),
+        steal_start_(0),
+        num_sleeping_(0),
+        epoch_(0),
+        stop_(false),
+        initial_cpus_(matrix_library::cpu_parallel::thread_affinity::
+                          CurrentThreadCpus()),
+        affinity_generation_(matrix_library::cpu_parallel::thread_affinity::
+                                 AffinityGeneration()) {
+    for (size_t node = 0; node < topology_.num_nodes(); node++) {
+      node_queues_[node].num_jobs.store(0);
+      cpu_nodes_.insert(cpu_nodes_.end(), topology_.nodes[node].cpus.size(),
+                        node);
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+      epoch_++;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  /**
+   * @brief Gets the number of worker threads started so far
+   */
+  size_t num_workers() const {
+    return num_workers_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Gets the NUMA topology the pool spreads its workers over
+   */
+  const matrix_library::cpu_parallel::numa_topology::NumaTopology& topology()
+      const {
+    return topology_;
+  }
+
+  /**
+   * @brief Gets the number of NUMA nodes the pool spreads its workers over
+   */
+  size_t num_nodes() const { return topology_.num_nodes(); }
+
+  /**
+   * @brief Gets the index of the NUMA node of the calling thread
+   *
+   * @return size_t Node of the worker, or of the core the caller runs on
+   */
+  size_t CurrentNode() const {
+    const internal::ThreadContext& context = internal::CurrentContext();
+    if (context.pool == this && context.deque != nullptr &&
+        IsWorkerDeque(context.deque)) {
+      return context.node;
+    }
+    return topology_.NodeOfCpu(
+        matrix_library::cpu_parallel::numa_topology::CurrentCpu());
+  }
+
+  /**
+   * @brief Starts worker threads until there are at least num_workers of
+   * them, up to kMaxWorkers. Worker i goes to the node of the core the
+   * affinity policy pins it to or, when it is not pinned, to the node of core
+   * i + 1 in node order, the calling thread being expected on the first.
+   * Workers already started are pinned again if the policy changed
+   *
+   * @param num_workers Number of workers wanted
+   */
+  void Reserve(size_t num_workers) {
+    const size_t wanted = std::min(num_workers, kMaxWorkers);
+    const uint64_t generation =
+        matrix_library::cpu_parallel::thread_affinity::AffinityGeneration();
+    if (num_workers_.load(std::memory_order_acquire) >= wanted &&
+        affinity_generation_.load(std::memory_order_relaxed) == generation) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    const matrix_library::cpu_parallel::thread_affinity::AffinityConfig
+        config = matrix_library::cpu_parallel::thread_affinity::GetAffinity();
+    const size_t num_started = num_workers_.load(std::memory_order_relaxed);
+    if (affinity_generation_.load(std::memory_order_relaxed) != generation) {
+      for (size_t index = 0; index < num_started; index++) {
+        PinWorker(index, config);
+      }
+      affinity_generation_.store(generation, std::memory_order_relaxed);
+    }
+    for (size_t index = num_started; index < wanted; index++) {
+      const std::vector<size_t> cpus =
+          matrix_library::cpu_parallel::thread_affinity::WorkerCpus(
+              config, topology_, index);
+      workers_[index].reset(new internal::Worker(
+          cpus.empty() ? cpu_nodes_[(index + 1) % cpu_nodes_.size()]
+                       : topology_.NodeOfCpu(cpus[0])));
+      threads_.emplace_back(&ThreadPool::WorkerLoop, this, index);
+      PinWorker(index, config);
+      num_workers_.store(index + 1, std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief Reports where the workers started so far run, after applying a
+   * pending change of the affinity policy
+   *
+   * @return std::vector<WorkerAffinity> Placement of every worker
+   */
+  std::vector<WorkerAffinity> WorkerAffinities() {
+    Reserve(0);
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    std::vector<WorkerAffinity> affinities;
+    for (size_t index = 0; index < num_workers_.load(std::memory_order_relaxed);
+         index++) {
+      affinities.push_back(WorkerAffinity{
+          index, workers_[index]->node,
+          matrix_library::cpu_parallel::thread_affinity::ThreadCpus(
+              threads_[index].native_handle())});
+    }
+    return affinities;
+  }
+
+  /**
+   * @brief Runs body(i) for every i in [0, num_iterations) and returns once
+   * all have finished. The calling thread takes part. Iterations are cut into
+   * contiguous chunks, kChunksPerThread per thread, which idle threads steal
+   * from each other. If an iteration throws, the chunks not yet started are
+   * skipped and the first exception is rethrown here
+   *
+   * @tparam Body Callable taking the index of an iteration
+   * @param num_iterations Number of iterations
+   * @param body Loop body
+   * @param num_threads Number of threads the loop is split for, counting the
+   * calling thread. 1 runs it serially
+   */
+  template <typename Body>
+  void ParallelFor(size_t num_iterations, const Body& body,
+                   size_t num_threads) {
+    if (num_threads <= 1 || num_iterations <= 1) {
+      internal::RunRange<Body>(&body, 0, num_iterations);
+      return;
+    }
+    Reserve(num_threads - 1);
+    internal::ThreadContext& context = internal::CurrentContext();
+    const internal::ThreadContext saved = context;
+    // Threads outside the pool borrow a deque for the length of the loop. A
+    // loop started inside one of its iterations reuses it
+    std::unique_lock<std::mutex> slot_lock;
+    if (context.pool != this) {
+      context.pool = this;
+      context.deque = AcquireExternalDeque(slot_lock);
+      if (context.deque == nullptr) {
+        context = saved;
+        internal::RunRange<Body>(&body, 0, num_iterations);
+        return;
+      }
+    }
+    internal::Job job(num_iterations,
+                      std::min(num_iterations, num_threads * kChunksPerThread),
+                      &internal::RunRange<Body>, &body);
+    Execute(job, 0, job.num_chunks, *context.deque);
+    // Help with any work in the pool until every chunk of this loop is done.
+    // A worker also serves its node, as a loop split by node started inside
+    // one of the chunks may be waiting on it
+    const bool is_worker = IsWorkerDeque(context.deque);
+    const size_t spin_count =
+        matrix_library::cpu_parallel::parallel_config::GetSpinCount();
+    size_t idle = 0;
+    while (job.remaining.load(std::memory_order_acquire) > 0) {
+      if (RunDequeWork(*context.deque) ||
+          (is_worker && RunNodeWork(context.node))) {
+        idle = 0;
+      } else if (idle < spin_count) {
+        idle++;
+        CpuRelax();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    context = saved;
+    if (job.failed.load(std::memory_order_acquire)) {
+      std::rethrow_exception(job.error);
+    }
+  }
+
+  /**
+   * @brief Runs body(i) for every i in [node_bounds[0], node_bounds.back())
+   * with iterations [node_bounds[node], node_bounds[node + 1]) run by the
+   * workers of that NUMA node, and returns once all have finished. Iterations
+   * are not stolen across nodes, so data a node first touched stays local.
+   * The calling thread runs the share of its own node, and the shares of
+   * nodes without workers. With a single node it is ParallelFor
+   *
+   * @tparam Body Callable taking the index of an iteration
+   * @param node_bounds num_nodes() + 1 increasing bounds
+   * @param body Loop body
+   * @param num_threads Number of threads the loop is split for, counting the
+   * calling thread. 1 runs it serially
+   */
+  template <typename Body>
+  void ParallelForNodes(const std::vector<size_t>& node_bounds,
+                        const Body& body, size_t num_threads) {
+    const size_t begin = node_bounds.front();
+    const size_t end = node_bounds.back();
+    if (num_threads <= 1 || end - begin <= 1 || num_nodes() <= 1) {
+      ParallelFor(
+          end - begin, [&body, begin](size_t i) { body(begin + i); },
+          num_threads);
+      return;
+    }
+    Reserve(num_threads - 1);
+    internal::NodeJob job(node_bounds, &internal::RunRange<Body>, &body);
+    for (size_t node = 0; node < num_nodes(); node++) {
+      if (node_bounds[node] < node_bounds[node + 1]) {
+        std::lock_guard<std::mutex> lock(node_queues_[node].mutex);
+        node_queues_[node].jobs.push_back(&job);
+        node_queues_[node].num_jobs.fetch_add(1, std::memory_order_release);
+      }
+    }
+    WakeAll();
+    const size_t own_node = CurrentNode();
+    RunShare(job, own_node);
+    for (size_t node = 0; node < num_nodes(); node++) {
+      if (!HasWorkerOnNode(node)) {
+        RunShare(job, node);
+      }
+    }
+    // Keep serving the node while waiting, as its workers may be waiting on
+    // a loop started inside this one. A caller running a chunk of another
+    // loop also helps with the chunks of the pool, which a worker of another
+    // node may be waiting on
+    WorkStealingDeque<internal::Task*>* const deque =
+        internal::CurrentContext().pool == this
+            ? internal::CurrentContext().deque
+            : nullptr;
+    const size_t spin_count =
+        matrix_library::cpu_parallel::parallel_config::GetSpinCount();
+    size_t idle = 0;
+    while (job.remaining.load(std::memory_order_acquire) > 0) {
+      if (RunNodeWork(own_node) ||
+          (deque != nullptr && RunDequeWork(*deque))) {
+        idle = 0;
+      } else if (idle < spin_count) {
+        idle++;
+        CpuRelax();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    for (size_t node = 0; node < num_nodes(); node++) {
+      std::lock_guard<std::mutex> lock(node_queues_[node].mutex);
+      std::vector<internal::NodeJob*>& jobs = node_queues_[node].jobs;
+      const auto position = std::find(jobs.begin(), jobs.end(), &job);
+      if (position != jobs.end()) {
+        jobs.erase(position);
+        node_queues_[node].num_jobs.fetch_sub(1, std::memory_order_release);
+      }
+    }
+    while (job.users.load(std::memory_order_acquire) > 0) {
+      CpuRelax();
+    }
+    if (job.failed.load(std::memory_order_acquire)) {
+      std::rethrow_exception(job.error);
+    }
+  }
+
+ private:
+  /**
+   * @brief Deque borrowed by a thread outside the pool
+   */
+  struct ExternalDeque {
+    std::mutex owner;
+    WorkStealingDeque<internal::Task*> deque;
+  };
+
+  bool IsWorkerDeque(const WorkStealingDeque<internal::Task*>* deque) const {
+    const size_t num_workers = num_workers_.load(std::memory_order_acquire);
+    for (size_t index = 0; index < num_workers; index++) {
+      if (&workers_[index]->deque == deque) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool HasWorkerOnNode(size_t node) const {
+    const size_t num_workers = num_workers_.load(std::memory_order_acquire);
+    for (size_t index = 0; index < num_workers; index++) {
+      if (workers_[index]->node == node) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Runs iterations of the share of a node until none are left
+   *
+   * @return true If any iteration was run
+   */
+  bool RunShare(internal::NodeJob& job, size_t node) {
+    internal::NodeShare& share = job.shares[node];
+    bool ran = false;
+    while (true) {
+      const size_t i = share.next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= share.end) {
+        return ran;
+      }
+      if (!job.failed.load(std::memory_order_relaxed)) {
+        try {
+          job.run(job.body, i, i + 1);
+        } catch (...) {
+          if (!job.failed.exchange(true)) {
+            job.error = std::current_exception();
+          }
+        }
+      }
+      ran = true;
+      job.remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }
+
+  /**
+   * @brief Runs what is left of the share of a node in the loops split by
+   * node
+   *
+   * @return true If any iteration was run
+   */
+  bool RunNodeWork(size_t node) {
+    internal::NodeQueue& queue = node_queues_[node];
+    if (queue.num_jobs.load(std::memory_order_acquire) == 0) {
+      return false;
+    }
+    bool ran = false;
+    for (size_t index = 0;; index++) {
+      internal::NodeJob* job;
+      {
+        // A job counted as used is not left by its caller until released
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (index >= queue.jobs.size()) {
+          return ran;
+        }
+        job = queue.jobs[index];
+        job->users.fetch_add(1, std::memory_order_acq_rel);
+      }
+      ran = RunShare(*job, node) || ran;
+      job->users.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }
+
+  bool HasNodeWork(size_t node) {
+    internal::NodeQueue& queue = node_queues_[node];
+    if (queue.num_jobs.load(std::memory_order_acquire) == 0) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (internal::NodeJob* job : queue.jobs) {
+      if (job->shares[node].next.load(std::memory_order_relaxed) <
+          job->shares[node].end) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  WorkStealingDeque<internal::Task*>* AcquireExternalDeque(
+      std::unique_lock<std::mutex>& slot_lock) {
+    for (auto& external : external_) {
+      std::unique_lock<std::mutex> lock(external.owner, std::try_to_lock);
+      if (lock.owns_lock()) {
+        slot_lock = std::move(lock);
+        return &external.deque;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Runs chunks [begin, end) of a job, pushing the upper halves onto
+   * the deque of the calling thread until a single chunk is left
+   */
+  void Execute(internal::Job& job, size_t begin, size_t end,
+               WorkStealingDeque<internal::Task*>& deque) {
+    while (end - begin > 1) {
+      const size_t middle = begin + (end - begin) / 2;
+      job.tasks[middle] = internal::Task{&job, middle, end};
+      deque.Push(&job.tasks[middle]);
+      Wake();
+      end = middle;
+    }
+    if (!job.failed.load(std::memory_order_relaxed)) {
+      try {
+        job.run(job.body, job.ChunkBegin(begin), job.ChunkBegin(begin + 1));
+      } catch (...) {
+        if (!job.failed.exchange(true)) {
+          job.error = std::current_exception();
+        }
+      }
+    }
+    // The job may be gone as soon as its last chunk is counted
+    job.remaining.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  /**
+   * @brief Runs a task popped from the deque of the calling thread or stolen
+   * from another one
+   *
+   * @return true If a task was run
+   */
+  bool RunDequeWork(WorkStealingDeque<internal::Task*>& deque) {
+    internal::Task* task;
+    if (!deque.Pop(task) && !StealAny(&deque, task)) {
+      return false;
+    }
+    Execute(*task->job, task->begin, task->end, deque);
+    return true;
+  }
+
+  /**
+   * @brief Steals a task from any deque other than own, starting from a
+   * different one each call so thieves spread out
+   */
+  bool StealAny(const WorkStealingDeque<internal::Task*>* own,
+                internal::Task*& task) {
+    const size_t num_workers = num_workers_.load(std::memory_order_acquire);
+    const size_t num_deques = num_workers + kMaxExternalThreads;
+    const size_t start = steal_start_.fetch_add(1, std::memory_order_relaxed);
+    for (size_t offset = 0; offset < num_deques; offset++) {
+      const size_t index = (start + offset) % num_deques;
+      WorkStealingDeque<internal::Task*>& victim =
+          index < num_workers ? workers_[index]->deque
+                              : external_[index - num_workers].deque;
+      if (&victim != own && victim.Steal(task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool HasWork() const {
+    const size_t num_workers = num_workers_.load(std::memory_order_acquire);
+    for (size_t index = 0; index < num_workers; index++) {
+      if (!workers_[index]->deque.Empty()) {
+        return true;
+      }
+    }
+    for (const auto& external : external_) {
+      if (!external.deque.Empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Wakes a parked worker after work was pushed, if any are parked
+   */
+  void Wake() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num_sleeping_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      epoch_++;
+    }
+    wake_.notify_one();
+  }
+
+  /**
+   * @brief Wakes every parked worker, as a loop split by node needs workers
+   * of every node
+   */
+  void WakeAll() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num_sleeping_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      epoch_++;
+    }
+    wake_.notify_all();
+  }
+
+  /**
+   * @brief Applies an affinity policy to a started worker. Unpinned workers
+   * are bound to the cores of their node when there are several nodes, and
+   * get back the cores the pool was created with when a policy is dropped.
+   * Called with start_mutex_ held
+   */
+  void PinWorker(
+      size_t index,
+      const matrix_library::cpu_parallel::thread_affinity::AffinityConfig&
+          config) {
+    internal::Worker& worker = *workers_[index];
+    std::vector<size_t> cpus =
+        matrix_library::cpu_parallel::thread_affinity::WorkerCpus(
+            config, topology_, index);
+    if (cpus.empty()) {
+      if (num_nodes() > 1) {
+        cpus = topology_.nodes[worker.node].cpus;
+      } else if (worker.pinned) {
+        cpus = initial_cpus_;
+      }
+    }
+    if (!cpus.empty()) {
+      matrix_library::cpu_parallel::thread_affinity::BindThread(
+          threads_[index].native_handle(), cpus);
+    }
+    worker.pinned = config.policy !=
+                    matrix_library::cpu_parallel::thread_affinity::
+                        AffinityPolicy::kNone;
+  }
+
+  void WorkerLoop(size_t index) {
+    WorkStealingDeque<internal::Task*>& deque = workers_[index]->deque;
+    const size_t node = workers_[index]->node;
+    internal::CurrentContext() = internal::ThreadContext{this, &deque, node};
+    size_t idle = 0;
+    while (true) {
+      if (RunNodeWork(node) || RunDequeWork(deque)) {
+        idle = 0;
+        continue;
+      }
+      if (idle <
+          matrix_library::cpu_parallel::parallel_config::GetSpinCount()) {
+        idle++;
+        CpuRelax();
+        continue;
+      }
+      // Parked workers are counted before looking for work one last time, so
+      // a push either is seen here or sees the count and wakes a worker
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      if (stop_) {
+        return;
+      }
+      const uint64_t epoch = epoch_;
+      num_sleeping_.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!HasWork() && !HasNodeWork(node)) {
+        wake_.wait(lock, [this, epoch]() { return epoch_ != epoch; });
+      }
+      num_sleeping_.fetch_sub(1, std::memory_order_relaxed);
+      idle = 0;
+    }
+  }
+
+  matrix_library::cpu_parallel::numa_topology::NumaTopology topology_;
+  // Node of every core, with the cores in node order
+  std::vector<size_t> cpu_nodes_;
+  std::unique_ptr<internal::NodeQueue[]> node_queues_;
+  std::atomic<size_t> num_workers_;
+  std::unique_ptr<internal::Worker> workers_[kMaxWorkers];
+  ExternalDeque external_[kMaxExternalThreads];
+  std::vector<std::thread> threads_;
+  std::mutex start_mutex_;
+  std::atomic<size_t> steal_start_;
+  std::atomic<size_t> num_sleeping_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  uint64_t epoch_;
+  bool stop_;
+  // Cores of the thread that created the pool, restored when pins are dropped
+  std::vector<size_t> initial_cpus_;
+  // Affinity generation the started workers are pinned for
+  std::atomic<uint64_t> affinity_generation_;
+};
+
+/**
+ * @brief Pool shared by every parallel kernel of the library, started on the
+ * first parallel call
+ *
+ * @return ThreadPool& Shared pool
+ */
+inline ThreadPool& SharedThreadPool() {
+  static ThreadPool pool;
+  return pool;
+}
+
+/**
+ * @brief Runs body(i) for every i in [0, num_iterations) on the shared pool
+ *
+ * @tparam Body Callable taking the index of an iteration
+ * @param num_iterations Number of iterations
+ * @param body Loop body
+ * @param num_threads Number of threads the loop is split for, counting the
+ * calling thread
+ */
+template <typename Body>
+inline void ParallelFor(size_t num_iterations, const Body& body,
+                        size_t num_threads) {
+  SharedThreadPool().ParallelFor(num_iterations, body, num_threads);
+}
+
+/**
+ * @brief Reports where the workers of the shared pool run
+ *
+ * @return std::vector<WorkerAffinity> Placement of every worker started so
+ * far
+ */
+inline std::vector<WorkerAffinity> GetWorkerAffinities() {
+  return SharedThreadPool().WorkerAffinities();
+}
+
+/**
+ * @brief Runs body(row_start, row_end, col_start, col_end) for every tile of
+ * a num_rows x num_cols grid cut into tile_rows x tile_cols tiles, on the
+ * shared pool. Tiles on the last row and column may be smaller
+ *
+ * @tparam Body Callable taking the bounds of a tile
+ * @param num_rows Number of rows in the grid
+ * @param num_cols Number of columns in the grid
+ * @param tile_rows Number of rows in a tile
+ * @param tile_cols Number of columns in a tile
+ * @param body Tile body
+ * @param num_threads Number of threads the tiles are split for, counting the
+ * calling thread
+ */
+template <typename Body>
+inline void ParallelForTiles(size_t num_rows, size_t num_cols,
+                             size_t tile_rows, size_t tile_cols,
+                             const Body& body, size_t num_threads) {
+  const size_t row_tiles = (num_rows + tile_rows - 1) / tile_rows;
+  const size_t col_tiles = (num_cols + tile_cols - 1) / tile_cols;
+  ParallelFor(
+      row_tiles * col_tiles,
+      [&](size_t tile) {
+        const size_t row_start = tile / col_tiles * tile_rows;
+        const size_t col_start = tile % col_tiles * tile_cols;
+        body(row_start, std::min(row_start + tile_rows, num_rows), col_start,
+             std::min(col_start + tile_cols, num_cols));
+      },
+      num_threads);
+}
+
+}  // namespace thread_pool
+}  // namespace cpu_parallel
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,240 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the batched multiplication kernels used by
+ * the CPU simple version of library. Every entry of a batch has the same shape
+ * so the kernel is chosen once per batch. Small square shapes get kernels with
+ * the dimensions fixed at compile time
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__BATCHED_GEMM_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__BATCHED_GEMM_H_
+
+#include <algorithm>
+#include <cstddef>
+
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace batched_gemm {
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, for one entry of
+ * a batch. The dimensions are bound when the kernel is chosen
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+using SmallKernel = void (*)(const T* a, size_t lda, const T* b, size_t ldb,
+                             T* c, size_t ldc, bool accumulate);
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, for row-major
+ * blocks whose dimensions are compile time constants. Every loop has a
+ * constant trip count so the compiler unrolls them and keeps the row of C
+ * being built in registers
+ *
+ * @tparam T Any numeric type
+ * @tparam M Number of rows in A and C
+ * @tparam N Number of columns in B and C
+ * @tparam K Number of columns in A and rows in B
+ * @param a A
+ * @param lda Leading dimension of A
+ * @param b B
+ * @param ldb Leading dimension of B
+ * @param c C
+ * @param ldc Leading dimension of C
+ * @param accumulate Add the product to C instead of overwriting it
+ */
+template <typename T, size_t M, size_t N, size_t K>
+inline void FixedMultiply(const T* a, size_t lda, const T* b, size_t ldb,
+                          T* c, size_t ldc, bool accumulate) {
+  for (size_t i = 0; i < M; i++) {
+    T row[N] = {};
+    for (size_t p = 0; p < K; p++) {
+      const T a_ip = a[i * lda + p];
+      const T* b_row = b + p * ldb;
+      for (size_t j = 0; j < N; j++) {
+        row[j] += a_ip * b_row[j];
+      }
+    }
+    T* c_row = c + i * ldc;
+    if (accumulate) {
+      for (size_t j = 0; j < N; j++) {
+        c_row[j] += row[j];
+      }
+    } else {
+      std::copy(row, row + N, c_row);
+    }
+  }
+}
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, for small
+ * row-major blocks of any shape in i-k-j order
+ *
+ * @tparam T Any numeric type
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a A
+ * @param lda Leading dimension of A
+ * @param b B
+ * @param ldb Leading dimension of B
+ * @param c C
+ * @param ldc Leading dimension of C
+ * @param accumulate Add the product to C instead of overwriting it
+ */
+template <typename T>
+inline void SmallMultiply(size_t m, size_t n, size_t k, const T* a,
+                          size_t lda, const T* b, size_t ldb, T* c, size_t ldc,
+                          bool accumulate) {
+  for (size_t i = 0; i < m; i++) {
+    T* c_row = c + i * ldc;
+    if (!accumulate) {
+      std::fill(c_row, c_row + n, static_cast<T>(0));
+    }
+    for (size_t p = 0; p < k; p++) {
+      const T a_ip = a[i * lda + p];
+      const T* b_row = b + p * ldb;
+      for (size_t j = 0; j < n; j++) {
+        c_row[j] += a_ip * b_row[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Gets the kernel with fixed dimensions for a shape. Only square shapes
+ * from 2 to 32 commonly used by batched workloads have one
+ *
+ * @tparam T Any numeric type
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @return SmallKernel<T> Kernel for the shape or nullptr if there is none
+ */
+template <typename T>
+inline SmallKernel<T> FixedKernel(size_t m, size_t n, size_t k) {
+  if (m != n || n != k) {
+    return nullptr;
+  }
+  switch (m) {
+    case 2:
+      return &FixedMultiply<T, 2, 2, 2>;
+    case 3:
+      return &FixedMultiply<T, 3, 3, 3>;
+    case 4:
+      return &FixedMultiply<T, 4, 4, 4>;
+    case 5:
+      return &FixedMultiply<T, 5, 5, 5>;
+    case 6:
+      return &FixedMultiply<T, 6, 6, 6>;
+    case 8:
+      return &FixedMultiply<T, 8, 8, 8>;
+    case 12:
+      return &FixedMultiply<T, 12, 12, 12>;
+    case 16:
+      return &FixedMultiply<T, 16, 16, 16>;
+    case 24:
+      return &FixedMultiply<T, 24, 24, 24>;
+    case 32:
+      return &FixedMultiply<T, 32, 32, 32>;
+    default:
+      return nullptr;
+  }
+}
+
+/**
+ * @brief Checks if the leading dimensions and batch strides of a batched
+ * product describe valid row-major blocks. Entries of C must not overlap
+ * each other while entries of A and B may, a stride of 0 reusing one matrix
+ * for the whole batch
+ *
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param lda Leading dimension of A
+ * @param ldb Leading dimension of B
+ * @param ldc Leading dimension of C
+ * @param batch_size Number of entries in the batch
+ * @param stride_c Distance between entries of C. Ignored for batches given as
+ * pointer arrays
+ * @return true If the layout is valid
+ * @return false If a leading dimension is too small or entries of C overlap
+ */
+inline bool IsValidBatchLayout(size_t m, size_t n, size_t k, size_t lda,
+                               size_t ldb, size_t ldc, size_t batch_size,
+                               size_t stride_c) {
+  if ((m > 0 && lda < k) || (k > 0 && ldb < n) || (m > 0 && ldc < n)) {
+    return false;
+  }
+  return batch_size < 2 || m == 0 || n == 0 ||
+         stride_c >= (m - 1) * ldc + n;
+}
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, for a range of
+ * entries of a batch. The kernel is chosen once for the whole range. Fixed
+ * dimension kernels take small square shapes, the blocked kernel takes large
+ * ones and the rest run the simple loop
+ *
+ * @tparam T Any numeric type
+ * @tparam AAt Callable returning a pointer to entry e of A
+ * @tparam BAt Callable returning a pointer to entry e of B
+ * @tparam CAt Callable returning a pointer to entry e of C
+ * @param begin First entry
+ * @param end One past the last entry
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a_at Entries of A
+ * @param lda Leading dimension of A
+ * @param b_at Entries of B
+ * @param ldb Leading dimension of B
+ * @param c_at Entries of C
+ * @param ldc Leading dimension of C
+ * @param accumulate Add the products to C instead of overwriting it
+ */
+template <typename T, typename AAt, typename BAt, typename CAt>
+inline void Multiply(size_t begin, size_t end, size_t m, size_t n, size_t k,
+                     const AAt& a_at, size_t lda, const BAt& b_at, size_t ldb,
+                     const CAt& c_at, size_t ldc, bool accumulate) {
+  if (m == 0 || n == 0) {
+    return;
+  }
+  const SmallKernel<T> kernel = FixedKernel<T>(m, n, k);
+  if (kernel != nullptr) {
+    for (size_t e = begin; e < end; e++) {
+      kernel(a_at(e), lda, b_at(e), ldb, c_at(e), ldc, accumulate);
+    }
+  } else if (matrix_library::cpu_simple::blocked_gemm::UseBlockedGemm(m, n,
+                                                                      k)) {
+    for (size_t e = begin; e < end; e++) {
+      matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+          m, n, k,
+          matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+              a_at(e), lda, 1),
+          matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+              b_at(e), ldb, 1),
+          matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(c_at(e),
+                                                                     ldc),
+          accumulate);
+    }
+  } else {
+    for (size_t e = begin; e < end; e++) {
+      SmallMultiply(m, n, k, a_at(e), lda, b_at(e), ldb, c_at(e), ldc,
+                    accumulate);
+    }
+  }
+}
+
+}  // namespace batched_gemm
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
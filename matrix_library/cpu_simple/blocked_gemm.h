@@ -0,0 +1,954 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the cache blocked, packed matrix
+ * multiplication kernel used by the CPU simple version of library
+ *
+ * The kernel follows the GotoBLAS / BLIS layering. C is split into nc wide
+ * column blocks, the inner dimension into kc deep blocks and A into mc tall
+ * row blocks. A kc x nc block of B is packed once into nr wide micro-panels
+ * sized to stay in L3, an mc x kc block of A is packed into mr tall
+ * micro-panels sized to stay in L2, and a micro-kernel multiplies one A
+ * micro-panel with one B micro-panel out of L1 into an mr x nr tile
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__BLOCKED_GEMM_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__BLOCKED_GEMM_H_
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix_library/cpu_simple/cpu_features.h"
+#include "matrix_library/cpu_simple/simd_kernels.h"
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace blocked_gemm {
+
+/**
+ * @brief Products with at least this many multiply-adds (m * n * k) go through
+ * the blocked kernel. Below it packing costs more than it saves
+ */
+constexpr size_t kBlockedGemmThreshold = 64 * 64 * 64;
+
+/**
+ * @brief Checks if a product of the given shape should use the blocked kernel
+ *
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @return true If the blocked kernel should be used
+ * @return false If the simple triple loop should be used
+ */
+inline bool UseBlockedGemm(size_t m, size_t n, size_t k) {
+  return m * n * k >= kBlockedGemmThreshold;
+}
+
+/**
+ * @brief Read only operand stored with arbitrary row and column strides.
+ * Swapping the strides gives the transpose without moving any data
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class StridedOperand {
+ public:
+  StridedOperand(const T* data, size_t row_stride, size_t col_stride)
+      : data_(data), row_stride_(row_stride), col_stride_(col_stride) {}
+
+  T operator()(size_t i, size_t j) const {
+    return data_[i * row_stride_ + j * col_stride_];
+  }
+
+ private:
+  const T* data_;
+  size_t row_stride_;
+  size_t col_stride_;
+};
+
+/**
+ * @brief Read only operand backed by a nested vector matrix
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class NestedOperand {
+ public:
+  explicit NestedOperand(const std::vector<std::vector<T>>& matrix)
+      : matrix_(&matrix) {}
+
+  T operator()(size_t i, size_t j) const {
+#ifdef MATRIX_LIBRARY_CHECKED_ACCESS
+    return matrix_->at(i).at(j);
+#else
+    return (*matrix_)[i][j];
+#endif
+  }
+
+ private:
+  const std::vector<std::vector<T>>* matrix_;
+};
+
+/**
+ * @brief Read only operand whose elements are those of another operand times
+ * a scalar. The scaling happens while packing so the micro-kernel is unchanged
+ *
+ * @tparam T Any numeric type
+ * @tparam Op Operand type being scaled
+ */
+template <typename T, typename Op>
+class ScaledOperand {
+ public:
+  ScaledOperand(const Op& op, T alpha) : op_(op), alpha_(alpha) {}
+
+  T operator()(size_t i, size_t j) const {
+    return static_cast<T>(alpha_ * op_(i, j));
+  }
+
+ private:
+  Op op_;
+  T alpha_;
+};
+
+/**
+ * @brief Writable output stored row-major with a leading dimension
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class StridedOutput {
+ public:
+  StridedOutput(T* data, size_t leading_dimension)
+      : data_(data), leading_dimension_(leading_dimension) {}
+
+  T* Row(size_t i) const { return data_ + i * leading_dimension_; }
+
+ private:
+  T* data_;
+  size_t leading_dimension_;
+};
+
+/**
+ * @brief Writable output backed by a nested vector matrix
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class NestedOutput {
+ public:
+  explicit NestedOutput(std::vector<std::vector<T>>& matrix)
+      : matrix_(&matrix) {}
+
+  T* Row(size_t i) const {
+#ifdef MATRIX_LIBRARY_CHECKED_ACCESS
+    return matrix_->at(i).data();
+#else
+    return (*matrix_)[i].data();
+#endif
+  }
+
+ private:
+  std::vector<std::vector<T>>* matrix_;
+};
+
+/**
+ * @brief Operand whose row 0 is row row_offset of another operand. Lets a
+ * block of rows be multiplied on its own
+ *
+ * @tparam Op Operand type being offset
+ */
+template <typename Op>
+class RowOffsetOperand {
+ public:
+  RowOffsetOperand(const Op& op, size_t row_offset)
+      : op_(op), row_offset_(row_offset) {}
+
+  auto operator()(size_t i, size_t j) const
+      -> decltype(std::declval<const Op&>()(i, j)) {
+    return op_(i + row_offset_, j);
+  }
+
+ private:
+  Op op_;
+  size_t row_offset_;
+};
+
+/**
+ * @brief Output whose row 0 is row row_offset of another output
+ *
+ * @tparam Out Output type being offset
+ */
+template <typename Out>
+class RowOffsetOutput {
+ public:
+  RowOffsetOutput(const Out& out, size_t row_offset)
+      : out_(out), row_offset_(row_offset) {}
+
+  auto Row(size_t i) const -> decltype(std::declval<const Out&>().Row(i)) {
+    return out_.Row(i + row_offset_);
+  }
+
+ private:
+  Out out_;
+  size_t row_offset_;
+};
+
+/**
+ * @brief Description of a micro-kernel. The compute function multiplies a
+ * packed mr x kc micro-panel of A with a packed kc x nr micro-panel of B and
+ * overwrites the mr x nr row-major tile with the result
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+struct MicroKernel {
+  size_t mr;
+  size_t nr;
+  void (*compute)(size_t kc, const T* a_panel, const T* b_panel, T* c_tile);
+};
+
+/**
+ * @brief Portable micro-kernel. The accumulator tile is small enough to live
+ * in registers and the fixed trip counts let the compiler unroll it
+ *
+ * @tparam T Any numeric type
+ * @tparam MR Rows in the tile
+ * @tparam NR Columns in the tile
+ */
+template <typename T, size_t MR, size_t NR>
+inline void ScalarMicroKernel(size_t kc, const T* a_panel, const T* b_panel,
+                              T* c_tile) {
+  T acc[MR * NR];
+  for (size_t idx = 0; idx < MR * NR; idx++) {
+    acc[idx] = static_cast<T>(0);
+  }
+  for (size_t p = 0; p < kc; p++) {
+    const T* a = a_panel + p * MR;
+    const T* b = b_panel + p * NR;
+    for (size_t r = 0; r < MR; r++) {
+      for (size_t c = 0; c < NR; c++) {
+        acc[r * NR + c] += a[r] * b[c];
+      }
+    }
+  }
+  std::copy(acc, acc + MR * NR, c_tile);
+}
+
+/**
+ * @brief Picks the micro-kernel for a type and instruction set level. Types
+ * without SIMD kernels always get the portable one
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+struct MicroKernelSelector {
+  static MicroKernel<T> Select(
+      matrix_library::cpu_simple::cpu_features::SimdLevel) {
+    MicroKernel<T> kernel = {4, 4, &ScalarMicroKernel<T, 4, 4>};
+    return kernel;
+  }
+};
+
+#ifdef MATRIX_LIBRARY_X86_SIMD
+/**
+ * @brief Float kernels. 4x8 on SSE4.2, 6x16 on AVX2 and 14x32 on AVX-512
+ */
+template <>
+struct MicroKernelSelector<float> {
+  static MicroKernel<float> Select(
+      matrix_library::cpu_simple::cpu_features::SimdLevel level) {
+    using matrix_library::cpu_simple::cpu_features::SimdLevel;
+    namespace simd = matrix_library::cpu_simple::simd_kernels;
+    MicroKernel<float> kernel = {4, 4, &ScalarMicroKernel<float, 4, 4>};
+    if (level >= SimdLevel::kAvx512) {
+      kernel = {14, 32, &simd::Avx512MicroKernel<simd::Avx512FloatOps, 14, 2>};
+    } else if (level >= SimdLevel::kAvx2) {
+      kernel = {6, 16, &simd::Avx2MicroKernel<simd::Avx2FloatOps, 6, 2>};
+    } else if (level >= SimdLevel::kSse42) {
+      kernel = {4, 8, &simd::Sse42MicroKernel<simd::Sse42FloatOps, 4, 2>};
+    }
+    return kernel;
+  }
+};
+
+/**
+ * @brief Double kernels. 4x4 on SSE4.2, 6x8 on AVX2 and 14x16 on AVX-512
+ */
+template <>
+struct MicroKernelSelector<double> {
+  static MicroKernel<double> Select(
+      matrix_library::cpu_simple::cpu_features::SimdLevel level) {
+    using matrix_library::cpu_simple::cpu_features::SimdLevel;
+    namespace simd = matrix_library::cpu_simple::simd_kernels;
+    MicroKernel<double> kernel = {4, 4, &ScalarMicroKernel<double, 4, 4>};
+    if (level >= SimdLevel::kAvx512) {
+      kernel = {14, 16,
+                &simd::Avx512MicroKernel<simd::Avx512DoubleOps, 14, 2>};
+    } else if (level >= SimdLevel::kAvx2) {
+      kernel = {6, 8, &simd::Avx2MicroKernel<simd::Avx2DoubleOps, 6, 2>};
+    } else if (level >= SimdLevel::kSse42) {
+      kernel = {4, 4, &simd::Sse42MicroKernel<simd::Sse42DoubleOps, 4, 2>};
+    }
+    return kernel;
+  }
+};
+
+/**
+ * @brief 32 bit integer kernels. 4x8 on SSE4.2, 6x16 on AVX2 and 14x32 on
+ * AVX-512. Products wrap exactly like the scalar loop
+ */
+template <>
+struct MicroKernelSelector<int32_t> {
+  static MicroKernel<int32_t> Select(
+      matrix_library::cpu_simple::cpu_features::SimdLevel level) {
+    using matrix_library::cpu_simple::cpu_features::SimdLevel;
+    namespace simd = matrix_library::cpu_simple::simd_kernels;
+    MicroKernel<int32_t> kernel = {4, 4, &ScalarMicroKernel<int32_t, 4, 4>};
+    if (level >= SimdLevel::kAvx512) {
+      kernel = {14, 32, &simd::Avx512MicroKernel<simd::Avx512Int32Ops, 14, 2>};
+    } else if (level >= SimdLevel::kAvx2) {
+      kernel = {6, 16, &simd::Avx2MicroKernel<simd::Avx2Int32Ops, 6, 2>};
+    } else if (level >= SimdLevel::kSse42) {
+      kernel = {4, 8, &simd::Sse42MicroKernel<simd::Sse42Int32Ops, 4, 2>};
+    }
+    return kernel;
+  }
+};
+#endif
+
+/**
+ * @brief Micro-kernel for a type at a given instruction set level
+ *
+ * @tparam T Any numeric type
+ * @param level Instruction set level. Must be supported by the CPU
+ * @return MicroKernel<T> Micro-kernel description
+ */
+template <typename T>
+inline MicroKernel<T> MicroKernelForLevel(
+    matrix_library::cpu_simple::cpu_features::SimdLevel level) {
+  return MicroKernelSelector<T>::Select(level);
+}
+
+/**
+ * @brief Micro-kernel used for a given type. The best one for the CPU the
+ * process runs on
+ *
+ * @tparam T Any numeric type
+ * @return MicroKernel<T> Micro-kernel description
+ */
+template <typename T>
+inline MicroKernel<T> DefaultMicroKernel() {
+  static const MicroKernel<T> kernel = MicroKernelForLevel<T>(
+      matrix_library::cpu_simple::cpu_features::GetSimdLevel());
+  return kernel;
+}
+
+/**
+ * @brief Data cache sizes in bytes
+ */
+struct CacheSizes {
+  size_t l1;
+  size_t l2;
+  size_t l3;
+};
+
+/**
+ * @brief Queries the data cache sizes of the machine, falling back to common
+ * values when the platform does not report them
+ *
+ * @return CacheSizes Cache sizes in bytes
+ */
+inline CacheSizes DetectCacheSizes() {
+  CacheSizes sizes = {32 * 1024, 256 * 1024, 2 * 1024 * 1024};
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) && \
+    defined(_SC_LEVEL3_CACHE_SIZE)
+  const long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+  const long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  const long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+  if (l1 > 0) {
+    sizes.l1 = static_cast<size_t>(l1);
+  }
+  if (l2 > 0) {
+    sizes.l2 = static_cast<size_t>(l2);
+  }
+  if (l3 > 0) {
+    sizes.l3 = static_cast<size_t>(l3);
+  }
+#endif
+  return sizes;
+}
+
+/**
+ * @brief Cache sizes detected once per process
+ *
+ * @return const CacheSizes& Cache sizes in bytes
+ */
+inline const CacheSizes& GetCacheSizes() {
+  static const CacheSizes sizes = DetectCacheSizes();
+  return sizes;
+}
+
+/**
+ * @brief Block sizes of the three outer loops
+ */
+struct BlockSizes {
+  size_t mc;
+  size_t kc;
+  size_t nc;
+};
+
+/**
+ * @brief Derives block sizes from the cache sizes. A B micro-panel takes half
+ * of L1 so it stays there while A micro-panels stream past it, an mc x kc
+ * block of A takes half of L2 and a kc x nc block of B takes half of L3
+ *
+ * @tparam T Any numeric type
+ * @param kernel Micro-kernel the blocks feed
+ * @param caches Cache sizes in bytes
+ * @return BlockSizes Block sizes
+ */
+template <typename T>
+inline BlockSizes ComputeBlockSizes(const MicroKernel<T>& kernel,
+                                    const CacheSizes& caches) {
+  BlockSizes blocks;
+  blocks.kc = (caches.l1 / 2) / (kernel.nr * sizeof(T));
+  blocks.kc = std::min<size_t>(std::max<size_t>(blocks.kc, 32), 512);
+  blocks.mc = (caches.l2 / 2) / (blocks.kc * sizeof(T));
+  blocks.mc = std::max(blocks.mc / kernel.mr, static_cast<size_t>(1)) *
+              kernel.mr;
+  blocks.nc = (caches.l3 / 2) / (blocks.kc * sizeof(T));
+  blocks.nc = std::min<size_t>(blocks.nc, 8192);
+  blocks.nc = std::max(blocks.nc / kernel.nr, static_cast<size_t>(1)) *
+              kernel.nr;
+  return blocks;
+}
+
+/**
+ * @brief Per thread scratch buffer reused across calls so steady state
+ * multiplication does not allocate
+ *
+ * @tparam T Any numeric type
+ * @param size Number of elements needed
+ * @return T* Scratch buffer of at least size elements
+ */
+template <typename T>
+inline T* ScratchBuffer(size_t size) {
+  static thread_local std::vector<T> buffer;
+  if (buffer.size() < size) {
+    buffer.resize(size);
+  }
+  return buffer.data();
+}
+
+/**
+ * @brief Packs an mc x kc block of A into mr tall micro-panels. Within a
+ * micro-panel the mr values of each column are adjacent. Rows past the end of
+ * A are padded with zeros so the micro-kernel always sees full panels
+ *
+ * @tparam T Any numeric type
+ * @tparam OpA Operand type of A
+ */
+template <typename T, typename OpA>
+inline void PackA(const OpA& a, size_t row_start, size_t col_start,
+                  size_t mc, size_t kc, size_t mr, T* packed) {
+  for (size_t ir = 0; ir < mc; ir += mr) {
+    const size_t rows = std::min(mr, mc - ir);
+    for (size_t p = 0; p < kc; p++) {
+      for (size_t r = 0; r < rows; r++) {
+        packed[r] = a(row_start + ir + r, col_start + p);
+      }
+      for (size_t r = rows; r < mr; r++) {
+        packed[r] = static_cast<T>(0);
+      }
+      packed += mr;
+    }
+  }
+}
+
+/**
+ * @brief Packs a kc x nc block of B into nr wide micro-panels. Within a
+ * micro-panel the nr values of each row are adjacent. Columns past the end of
+ * B are padded with zeros
+ *
+ * @tparam T Any numeric type
+ * @tparam OpB Operand type of B
+ */
+template <typename T, typename OpB>
+inline void PackB(const OpB& b, size_t row_start, size_t col_start,
+                  size_t kc, size_t nc, size_t nr, T* packed) {
+  for (size_t jr = 0; jr < nc; jr += nr) {
+    const size_t cols = std::min(nr, nc - jr);
+    for (size_t p = 0; p < kc; p++) {
+      for (size_t c = 0; c < cols; c++) {
+        packed[c] = b(row_start + p, col_start + jr + c);
+      }
+      for (size_t c = cols; c < nr; c++) {
+        packed[c] = static_cast<T>(0);
+      }
+      packed += nr;
+    }
+  }
+}
+
+/**
+ * @brief Packs the kc x nc blocks of the nc wide column block of B starting at
+ * column jc, laid out as PackPanels lays them out. Column blocks are disjoint
+ * so several threads can pack one B together
+ *
+ * @tparam T Any numeric type
+ * @tparam OpB Operand type of B
+ * @param b Operand B
+ * @param k Number of rows in B
+ * @param n Number of columns in B
+ * @param kc Depth of the blocks
+ * @param nc Width of the blocks. A multiple of nr
+ * @param nr Width of the micro-panels
+ * @param jc First column of the column block. A multiple of nc
+ * @param packed Buffer of k * round_up(n, nr) elements
+ */
+template <typename T, typename OpB>
+inline void PackPanelColumns(const OpB& b, size_t k, size_t n, size_t kc,
+                             size_t nc, size_t nr, size_t jc, T* packed) {
+  const size_t cols = std::min(nc, n - jc);
+  const size_t padded_cols = (cols + nr - 1) / nr * nr;
+  for (size_t pc = 0; pc < k; pc += kc) {
+    PackB(b, pc, jc, std::min(kc, k - pc), cols, nr,
+          packed + jc * k + pc * padded_cols);
+  }
+}
+
+/**
+ * @brief Packs a whole k x n operand B into kc x nc blocks of nr wide
+ * micro-panels, in the order the blocked algorithm visits them. Block
+ * (pc, jc) starts at jc * k + pc * round_up(nc, nr) so every block can be
+ * found without an index
+ *
+ * @tparam T Any numeric type
+ * @tparam OpB Operand type of B
+ * @param b Operand B
+ * @param k Number of rows in B
+ * @param n Number of columns in B
+ * @param kc Depth of the blocks
+ * @param nc Width of the blocks. A multiple of nr
+ * @param nr Width of the micro-panels
+ * @param packed Buffer of k * round_up(n, nr) elements
+ */
+template <typename T, typename OpB>
+inline void PackPanels(const OpB& b, size_t k, size_t n, size_t kc, size_t nc,
+                       size_t nr, T* packed) {
+  for (size_t jc = 0; jc < n; jc += nc) {
+    PackPanelColumns(b, k, n, kc, nc, nr, jc, packed);
+  }
+}
+
+/**
+ * @brief Source of packed blocks of B that packs an operand into the scratch
+ * buffer every time a block is needed
+ *
+ * @tparam OpB Operand type of B
+ */
+template <typename OpB>
+class OperandPanels {
+ public:
+  explicit OperandPanels(const OpB& b) : b_(b) {}
+
+  BlockSizes Blocks(const BlockSizes& blocks) const { return blocks; }
+
+  template <typename T>
+  const T* Block(size_t pc, size_t jc, size_t kc, size_t nc, size_t nr,
+                 T* buffer) const {
+    PackB(b_, pc, jc, kc, nc, nr, buffer);
+    return buffer;
+  }
+
+ private:
+  OpB b_;
+};
+
+/**
+ * @brief Source of packed blocks of B already laid out by PackPanels. It
+ * fixes the depth and width of the blocks to the ones B was packed with, and
+ * only works with micro-kernels of the same nr
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class PrePackedPanels {
+ public:
+  /**
+   * @param data Blocks laid out by PackPanels
+   * @param k Number of rows in B
+   * @param kc Depth of the blocks
+   * @param nc Width of the blocks
+   */
+  PrePackedPanels(const T* data, size_t k, size_t kc, size_t nc)
+      : data_(data), k_(k), kc_(kc), nc_(nc) {}
+
+  BlockSizes Blocks(const BlockSizes& blocks) const {
+    BlockSizes packed_blocks = blocks;
+    packed_blocks.kc = kc_;
+    packed_blocks.nc = nc_;
+    return packed_blocks;
+  }
+
+  const T* Block(size_t pc, size_t jc, size_t, size_t nc, size_t nr,
+                 T*) const {
+    return data_ + jc * k_ + pc * ((nc + nr - 1) / nr * nr);
+  }
+
+ private:
+  const T* data_;
+  size_t k_;
+  size_t kc_;
+  size_t nc_;
+};
+
+/**
+ * @brief Maps an operand of B to the source of its packed blocks. Operands are
+ * packed on the fly and pre-packed panels are used as they are
+ *
+ * @tparam OpB Operand type of B
+ */
+template <typename OpB>
+struct PanelsOf {
+  using type = OperandPanels<OpB>;
+  static type Make(const OpB& b) { return type(b); }
+};
+
+template <typename T>
+struct PanelsOf<PrePackedPanels<T>> {
+  using type = PrePackedPanels<T>;
+  static const type& Make(const type& b) { return b; }
+};
+
+/**
+ * @brief Number of elements of workspace the blocked algorithm needs for a
+ * product, the packed blocks of A and B and one micro-tile
+ *
+ * @tparam T Any numeric type
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param kernel Micro-kernel to use
+ * @param blocks Block sizes to use
+ * @return size_t Number of elements
+ */
+template <typename T>
+inline size_t GemmWorkspaceSize(size_t m, size_t n, size_t k,
+                                const MicroKernel<T>& kernel,
+                                const BlockSizes& blocks) {
+  const size_t mr = kernel.mr;
+  const size_t nr = kernel.nr;
+  const size_t mc_block =
+      std::max((blocks.mc + mr - 1) / mr, static_cast<size_t>(1)) * mr;
+  const size_t nc_block =
+      std::max((blocks.nc + nr - 1) / nr, static_cast<size_t>(1)) * nr;
+  const size_t kc_block = std::max(blocks.kc, static_cast<size_t>(1));
+  const size_t mc_max = std::min(mc_block, (m + mr - 1) / mr * mr);
+  const size_t nc_max = std::min(nc_block, (n + nr - 1) / nr * nr);
+  const size_t kc_max = std::min(kc_block, k);
+  return mc_max * kc_max + kc_max * nc_max + mr * nr;
+}
+
+/**
+ * @brief Runs the blocked, packed algorithm for an m x k operand A and a k x n
+ * operand B and hands every finished micro-tile row to a store policy. Shapes
+ * are assumed to be validated by the caller
+ *
+ * @tparam T Any numeric type
+ * @tparam OpA Operand type of A
+ * @tparam PanelsB Source of packed blocks of B, OperandPanels or
+ * PrePackedPanels
+ * @tparam Store Callable taking (i, j, values, count, first_pass, last_pass)
+ * for the count products of row i starting at column j. values may be
+ * modified. first_pass and last_pass tell which kc deep blocks of the inner
+ * dimension the values cover. An empty inner dimension stores zeros once
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a Operand A
+ * @param b_panels Packed blocks of B
+ * @param kernel Micro-kernel to use
+ * @param requested_blocks Block sizes to use. Pre-packed B overrides kc and
+ * nc
+ * @param workspace At least GemmWorkspaceSize elements, or nullptr to use the
+ * scratch buffer of the thread
+ * @param store Store policy
+ */
+template <typename T, typename OpA, typename PanelsB, typename Store>
+inline void GemmTiles(size_t m, size_t n, size_t k, const OpA& a,
+                      const PanelsB& b_panels, const MicroKernel<T>& kernel,
+                      const BlockSizes& requested_blocks, T* workspace,
+                      const Store& store) {
+  if (m == 0 || n == 0) {
+    return;
+  }
+  const size_t mr = kernel.mr;
+  const size_t nr = kernel.nr;
+  // An empty inner dimension still defines C = 0
+  if (k == 0) {
+    T* const zeros = workspace != nullptr ? workspace : ScratchBuffer<T>(nr);
+    for (size_t i = 0; i < m; i++) {
+      for (size_t j = 0; j < n; j += nr) {
+        std::fill(zeros, zeros + nr, static_cast<T>(0));
+        store(i, j, zeros, std::min(nr, n - j), true, true);
+      }
+    }
+    return;
+  }
+  const BlockSizes blocks = b_panels.Blocks(requested_blocks);
+  // Blocks hold whole micro-panels so packing never runs past the buffers
+  const size_t mc_block =
+      std::max((blocks.mc + mr - 1) / mr, static_cast<size_t>(1)) * mr;
+  const size_t nc_block =
+      std::max((blocks.nc + nr - 1) / nr, static_cast<size_t>(1)) * nr;
+  const size_t kc_block = std::max(blocks.kc, static_cast<size_t>(1));
+  const size_t mc_max = std::min(mc_block, (m + mr - 1) / mr * mr);
+  const size_t nc_max = std::min(nc_block, (n + nr - 1) / nr * nr);
+  const size_t kc_max = std::min(kc_block, k);
+  const size_t packed_a_size = mc_max * kc_max;
+  const size_t packed_b_size = kc_max * nc_max;
+  T* const packed_a =
+      workspace != nullptr
+          ? workspace
+          : ScratchBuffer<T>(GemmWorkspaceSize(m, n, k, kernel, blocks));
+  T* const packed_b = packed_a + packed_a_size;
+  T* const tile = packed_b + packed_b_size;
+
+  for (size_t jc = 0; jc < n; jc += nc_block) {
+    const size_t nc = std::min(nc_block, n - jc);
+    for (size_t pc = 0; pc < k; pc += kc_block) {
+      const size_t kc = std::min(kc_block, k - pc);
+      const bool first_pass = pc == 0;
+      const bool last_pass = pc + kc == k;
+      const T* const b_block = b_panels.Block(pc, jc, kc, nc, nr, packed_b);
+      for (size_t ic = 0; ic < m; ic += mc_block) {
+        const size_t mc = std::min(mc_block, m - ic);
+        PackA(a, ic, pc, mc, kc, mr, packed_a);
+        for (size_t jr = 0; jr < nc; jr += nr) {
+          const size_t cols = std::min(nr, nc - jr);
+          const T* b_panel = b_block + jr * kc;
+          for (size_t ir = 0; ir < mc; ir += mr) {
+            const size_t rows = std::min(mr, mc - ir);
+            kernel.compute(kc, packed_a + ir * kc, b_panel, tile);
+            // Only the part of the tile inside C is stored
+            for (size_t r = 0; r < rows; r++) {
+              store(ic + ir + r, jc + jr, tile + r * nr, cols, first_pass,
+                    last_pass);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, for an m x k
+ * operand A and a k x n operand B using the blocked, packed algorithm. Shapes
+ * are assumed to be validated by the caller
+ *
+ * @tparam T Any numeric type
+ * @tparam OpA Operand type of A
+ * @tparam OpB Operand type of B, or PrePackedPanels
+ * @tparam OutC Output type of C
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a Operand A
+ * @param b Operand B
+ * @param c Output C
+ * @param accumulate Add the product to C instead of overwriting it
+ * @param kernel Micro-kernel to use
+ * @param blocks Block sizes to use
+ * @param workspace At least GemmWorkspaceSize elements, or nullptr to use the
+ * scratch buffer of the thread
+ */
+template <typename T, typename OpA, typename OpB, typename OutC>
+inline void Gemm(size_t m, size_t n, size_t k, const OpA& a, const OpB& b,
+                 const OutC& c, bool accumulate, const MicroKernel<T>& kernel,
+                 const BlockSizes& blocks, T* workspace = nullptr) {
+  GemmTiles<T>(m, n, k, a, PanelsOf<OpB>::Make(b), kernel, blocks, workspace,
+               [&c, accumulate](size_t i, size_t j, T* values, size_t count,
+                                bool first_pass, bool) {
+                 // The first pass over the inner dimension initializes C
+                 // unless the caller asked to accumulate into it
+                 T* c_row = c.Row(i) + j;
+                 if (first_pass && !accumulate) {
+                   std::copy(values, values + count, c_row);
+                 } else {
+                   for (size_t col = 0; col < count; col++) {
+                     c_row[col] += values[col];
+                   }
+                 }
+               });
+}
+
+/**
+ * @brief Row of partial sums kept between passes over the inner dimension.
+ * Outputs of the accumulation type hold their own partial sums
+ *
+ * @tparam T Any numeric type
+ * @param out_row Row of the output
+ * @return T* Row holding the partial sums
+ */
+template <typename T>
+inline T* PartialSumRow(T* out_row, T*) {
+  return out_row;
+}
+
+/**
+ * @brief Row of partial sums kept between passes over the inner dimension.
+ * Outputs of another type keep their partial sums in a separate buffer
+ *
+ * @tparam T Any numeric type
+ * @tparam U Output type
+ * @param buffer_row Row of the separate buffer
+ * @return T* Row holding the partial sums
+ */
+template <typename T, typename U>
+inline T* PartialSumRow(U*, T* buffer_row) {
+  return buffer_row;
+}
+
+/**
+ * @brief Computes C = epilogue(A * B) elementwise with the blocked, packed
+ * algorithm. The epilogue runs on each micro-tile row right before it is
+ * stored, so C is written once with final values instead of being read back by
+ * separate bias, activation or conversion passes. When the inner dimension
+ * takes several kc deep passes the partial sums live in C, or when C has
+ * another type than the accumulation in an m x nc scratch panel of the thread,
+ * which is written and read back once per pass. Shapes are assumed to be
+ * validated by the caller
+ *
+ * @tparam T Accumulation type of A and B
+ * @tparam OpA Operand type of A
+ * @tparam OpB Operand type of B, or PrePackedPanels
+ * @tparam OutC Output type of C. Its element type may differ from T
+ * @tparam Epilogue Callable taking (i, j, value) for element (i, j) of A * B
+ * and returning what is stored, converted to the element type of C
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a Operand A
+ * @param b Operand B
+ * @param c Output C
+ * @param epilogue Epilogue applied to every element
+ * @param kernel Micro-kernel to use
+ * @param blocks Block sizes to use
+ */
+template <typename T, typename OpA, typename OpB, typename OutC,
+          typename Epilogue>
+inline void GemmEpilogue(size_t m, size_t n, size_t k, const OpA& a,
+                         const OpB& b, const OutC& c, const Epilogue& epilogue,
+                         const MicroKernel<T>& kernel,
+                         const BlockSizes& blocks) {
+  using U = typename std::remove_pointer<decltype(
+      std::declval<const OutC&>().Row(0))>::type;
+  const typename PanelsOf<OpB>::type& b_panels = PanelsOf<OpB>::Make(b);
+  const BlockSizes panel_blocks = b_panels.Blocks(blocks);
+  const bool single_pass =
+      k <= std::max(panel_blocks.kc, static_cast<size_t>(1));
+  // Passes over the inner dimension run inside one nc wide column panel, so
+  // partial sums of another type than C only span that panel. They follow
+  // the packing buffers in the scratch buffer of the thread
+  const size_t nr = kernel.nr;
+  const size_t nc_block =
+      std::max((panel_blocks.nc + nr - 1) / nr, static_cast<size_t>(1)) * nr;
+  const size_t nc_max = std::min(nc_block, (n + nr - 1) / nr * nr);
+  const size_t partial_size =
+      single_pass || std::is_same<T, U>::value ? 0 : m * nc_max;
+  const size_t workspace_size =
+      GemmWorkspaceSize(m, n, k, kernel, panel_blocks);
+  T* const workspace = ScratchBuffer<T>(workspace_size + partial_size);
+  T* const partial_data = workspace + workspace_size;
+  GemmTiles<T>(
+      m, n, k, a, b_panels, kernel, blocks, workspace,
+      [&c, &epilogue, partial_data, nc_block, nc_max](
+          size_t i, size_t j, T* values, size_t count, bool first_pass,
+          bool last_pass) {
+        U* out_row = c.Row(i) + j;
+        T* partial_row =
+            first_pass && last_pass
+                ? nullptr
+                : PartialSumRow(out_row,
+                                partial_data + i * nc_max + j % nc_block);
+        if (!first_pass) {
+          for (size_t col = 0; col < count; col++) {
+            values[col] += partial_row[col];
+          }
+        }
+        if (!last_pass) {
+          std::copy(values, values + count, partial_row);
+          return;
+        }
+        for (size_t col = 0; col < count; col++) {
+          out_row[col] = static_cast<U>(epilogue(i, j + col, values[col]));
+        }
+      });
+}
+
+/**
+ * @brief Computes C = epilogue(A * B) with the default micro-kernel and block
+ * sizes
+ *
+ * @tparam T Accumulation type of A and B
+ * @tparam OpA Operand type of A
+ * @tparam OpB Operand type of B, or PrePackedPanels
+ * @tparam OutC Output type of C
+ * @tparam Epilogue Callable taking (i, j, value) and returning what is stored
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a Operand A
+ * @param b Operand B
+ * @param c Output C
+ * @param epilogue Epilogue applied to every element
+ */
+template <typename T, typename OpA, typename OpB, typename OutC,
+          typename Epilogue>
+inline void GemmEpilogue(size_t m, size_t n, size_t k, const OpA& a,
+                         const OpB& b, const OutC& c,
+                         const Epilogue& epilogue) {
+  const MicroKernel<T> kernel = DefaultMicroKernel<T>();
+  static const BlockSizes blocks = ComputeBlockSizes(kernel, GetCacheSizes());
+  GemmEpilogue<T>(m, n, k, a, b, c, epilogue, kernel, blocks);
+}
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, with the default
+ * micro-kernel and block sizes
+ *
+ * @tparam T Any numeric type
+ * @tparam OpA Operand type of A
+ * @tparam OpB Operand type of B, or PrePackedPanels
+ * @tparam OutC Output type of C
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a Operand A
+ * @param b Operand B
+ * @param c Output C
+ * @param accumulate Add the product to C instead of overwriting it
+ */
+template <typename T, typename OpA, typename OpB, typename OutC>
+inline void Gemm(size_t m, size_t n, size_t k, const OpA& a, const OpB& b,
+                 const OutC& c, bool accumulate) {
+  const MicroKernel<T> kernel = DefaultMicroKernel<T>();
+  static const BlockSizes blocks = ComputeBlockSizes(kernel, GetCacheSizes());
+  Gemm<T>(m, n, k, a, b, c, accumulate, kernel, blocks);
+}
+
+}  // namespace blocked_gemm
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,100 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the runtime CPU feature detection used to
+ * dispatch SIMD kernels
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__CPU_FEATURES_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__CPU_FEATURES_H_
+
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+/// Defined when x86 SIMD kernels are compiled in
+#define MATRIX_LIBRARY_X86_SIMD 1
+#endif
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace cpu_features {
+
+/**
+ * @brief Instruction set levels kernels are written for, in increasing order
+ */
+enum class SimdLevel { kScalar = 0, kSse42 = 1, kAvx2 = 2, kAvx512 = 3 };
+
+/**
+ * @brief Asks the CPU which instruction set levels it supports
+ *
+ * @return SimdLevel Highest supported level
+ */
+inline SimdLevel DetectSimdLevel() {
+#ifdef MATRIX_LIBRARY_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return SimdLevel::kSse42;
+  }
+#endif
+  return SimdLevel::kScalar;
+}
+
+/**
+ * @brief Parses an instruction set level name
+ *
+ * @param name One of scalar, sse4.2, avx2 or avx512
+ * @param level Parsed level
+ * @return true If the name was recognized
+ * @return false If the name was not recognized
+ */
+inline bool ParseSimdLevel(const char* name, SimdLevel* level) {
+  if (std::strcmp(name, "scalar") == 0) {
+    *level = SimdLevel::kScalar;
+  } else if (std::strcmp(name, "sse4.2") == 0) {
+    *level = SimdLevel::kSse42;
+  } else if (std::strcmp(name, "avx2") == 0) {
+    *level = SimdLevel::kAvx2;
+  } else if (std::strcmp(name, "avx512") == 0) {
+    *level = SimdLevel::kAvx512;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Instruction set level kernels are dispatched to. This is the highest
+ * level the CPU supports, capped by the MATRIX_LIBRARY_SIMD environment
+ * variable when it names a lower one. Detected once per process
+ *
+ * @return SimdLevel Level to dispatch to
+ */
+inline SimdLevel GetSimdLevel() {
+  static const SimdLevel level = []() {
+    SimdLevel detected = DetectSimdLevel();
+    SimdLevel requested;
+    const char* env = std::getenv("MATRIX_LIBRARY_SIMD");
+    if (env != nullptr && ParseSimdLevel(env, &requested) &&
+        requested < detected) {
+      detected = requested;
+    }
+    return detected;
+  }();
+  return level;
+}
+
+}  // namespace cpu_features
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
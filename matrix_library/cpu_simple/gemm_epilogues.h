@@ -0,0 +1,207 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the built in epilogues fused into the
+ * store phase of the multiplication kernels of the CPU simple version of
+ * library. An epilogue is a callable taking (i, j, value) for element (i, j)
+ * of a product and returning what is stored. Epilogues compose with Fuse, so
+ * Fuse(Scale<float>(2), ColumnBias<float>(bias), Relu()) stores
+ * max(2 * value + bias[j], 0)
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__GEMM_EPILOGUES_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__GEMM_EPILOGUES_H_
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace gemm_epilogues {
+
+/**
+ * @brief Stores the product unchanged
+ */
+struct Identity {
+  template <typename T>
+  T operator()(size_t, size_t, T value) const {
+    return value;
+  }
+};
+
+/**
+ * @brief Multiplies the product by a scalar
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class Scale {
+ public:
+  explicit Scale(T alpha) : alpha_(alpha) {}
+
+  T operator()(size_t, size_t, T value) const {
+    return static_cast<T>(alpha_ * value);
+  }
+
+ private:
+  T alpha_;
+};
+
+/**
+ * @brief Adds bias[j] to column j, the bias of a fully connected layer whose
+ * outputs are the columns
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class ColumnBias {
+ public:
+  /**
+   * @param bias One value per column of the product. Must outlive the
+   * multiplication
+   */
+  explicit ColumnBias(const T* bias) : bias_(bias) {}
+
+  T operator()(size_t, size_t j, T value) const {
+    return static_cast<T>(value + bias_[j]);
+  }
+
+ private:
+  const T* bias_;
+};
+
+/**
+ * @brief Adds bias[i] to row i
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class RowBias {
+ public:
+  /**
+   * @param bias One value per row of the product. Must outlive the
+   * multiplication
+   */
+  explicit RowBias(const T* bias) : bias_(bias) {}
+
+  T operator()(size_t i, size_t, T value) const {
+    return static_cast<T>(value + bias_[i]);
+  }
+
+ private:
+  const T* bias_;
+};
+
+/**
+ * @brief Rectified linear unit max(value, 0)
+ */
+struct Relu {
+  template <typename T>
+  T operator()(size_t, size_t, T value) const {
+    return value > static_cast<T>(0) ? value : static_cast<T>(0);
+  }
+};
+
+/**
+ * @brief Gaussian error linear unit value * Phi(value), with the exact erf
+ * form rather than the tanh approximation. Meant for floating point types
+ */
+struct Gelu {
+  template <typename T>
+  T operator()(size_t, size_t, T value) const {
+    const T inv_sqrt2 = static_cast<T>(0.70710678118654752);
+    return static_cast<T>(static_cast<T>(0.5) * value *
+                          (static_cast<T>(1) + std::erf(value * inv_sqrt2)));
+  }
+};
+
+/**
+ * @brief Applies First then Second
+ *
+ * @tparam First Epilogue applied to the product
+ * @tparam Second Epilogue applied to the result of First
+ */
+template <typename First, typename Second>
+class Compose {
+ public:
+  Compose(const First& first, const Second& second)
+      : first_(first), second_(second) {}
+
+  template <typename T>
+  auto operator()(size_t i, size_t j, T value) const
+      -> decltype(std::declval<const Second&>()(
+          i, j, std::declval<const First&>()(i, j, value))) {
+    return second_(i, j, first_(i, j, value));
+  }
+
+ private:
+  First first_;
+  Second second_;
+};
+
+/**
+ * @brief Type of the epilogue applying a list of epilogues in order
+ *
+ * @tparam E Epilogues
+ */
+template <typename... E>
+struct Fused;
+
+template <typename E>
+struct Fused<E> {
+  using type = E;
+  static type Make(const E& epilogue) { return epilogue; }
+};
+
+template <typename E, typename... Rest>
+struct Fused<E, Rest...> {
+  using type = Compose<E, typename Fused<Rest...>::type>;
+  static type Make(const E& epilogue, const Rest&... rest) {
+    return type(epilogue, Fused<Rest...>::Make(rest...));
+  }
+};
+
+/**
+ * @brief Combines epilogues into one applying them in order
+ *
+ * @tparam E Epilogues
+ * @param epilogues Epilogues in the order they apply
+ * @return Fused<E...>::type Combined epilogue
+ */
+template <typename... E>
+inline typename Fused<E...>::type Fuse(const E&... epilogues) {
+  return Fused<E...>::Make(epilogues...);
+}
+
+/**
+ * @brief Epilogue whose row 0 is row row_offset of another epilogue. Lets a
+ * block of rows be multiplied on its own
+ *
+ * @tparam E Epilogue being offset
+ */
+template <typename E>
+class RowOffsetEpilogue {
+ public:
+  RowOffsetEpilogue(const E& epilogue, size_t row_offset)
+      : epilogue_(epilogue), row_offset_(row_offset) {}
+
+  template <typename T>
+  auto operator()(size_t i, size_t j, T value) const
+      -> decltype(std::declval<const E&>()(i, j, value)) {
+    return epilogue_(i + row_offset_, j, value);
+  }
+
+ private:
+  E epilogue_;
+  size_t row_offset_;
+};
+
+}  // namespace gemm_epilogues
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,299 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the matrix chain planner used by the CPU
+ * simple version of library. The order of a chain of products is chosen by
+ * dynamic programming over a cost model of the kernels that will run it, and
+ * the chosen order is executed in waves of independent products
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__MATRIX_CHAIN_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__MATRIX_CHAIN_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/cpu_simple/vector_kernels.h"
+#include "matrix_library/utils/dense_matrix.h"
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace matrix_chain {
+
+/**
+ * @brief Cost of one multiply-add of the simple loop relative to one of the
+ * blocked kernel. Measured on small products below the blocked threshold
+ */
+constexpr double kSimpleLoopCost = 6.0;
+
+/**
+ * @brief Cost of streaming one element through the dot, matrix-vector and
+ * outer product kernels relative to one multiply-add of the blocked kernel.
+ * These shapes are bound by memory bandwidth rather than arithmetic
+ */
+constexpr double kVectorElementCost = 7.0;
+
+/**
+ * @brief Fixed cost of a product relative to one multiply-add of the blocked
+ * kernel. Covers dispatch and the output buffer, so tiny products are not free
+ */
+constexpr double kProductOverhead = 4096.0;
+
+/**
+ * @brief Estimates the time of C = A * B in units of one multiply-add of the
+ * blocked kernel, following the same shape dispatch as MatrixMultiply
+ *
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @return double Estimated cost
+ */
+inline double ProductCost(size_t m, size_t n, size_t k) {
+  const double dm = static_cast<double>(m);
+  const double dn = static_cast<double>(n);
+  const double dk = static_cast<double>(k);
+  if (matrix_library::cpu_simple::vector_kernels::IsVectorShape(m, n, k)) {
+    return kProductOverhead +
+           kVectorElementCost * (dm * dk + dk * dn + dm * dn);
+  }
+  if (matrix_library::cpu_simple::blocked_gemm::UseBlockedGemm(m, n, k)) {
+    return kProductOverhead + dm * dn * dk;
+  }
+  return kProductOverhead + kSimpleLoopCost * dm * dn * dk;
+}
+
+/**
+ * @brief Order in which a chain of products is evaluated. Matrix i of the
+ * chain has dims[i] rows and dims[i + 1] columns
+ */
+struct ChainPlan {
+  /// Row count of every matrix followed by the column count of the last one
+  std::vector<size_t> dims;
+  /// Entry first * n + last is the index the sub-chain first..last splits
+  /// after, so it is evaluated as (first..split) * (split + 1..last)
+  std::vector<size_t> splits;
+  /// Estimated cost of the whole chain
+  double cost;
+
+  /**
+   * @brief Gets the number of matrices in the chain
+   *
+   * @return size_t Number of matrices
+   */
+  size_t num_matrices() const { return dims.empty() ? 0 : dims.size() - 1; }
+
+  /**
+   * @brief Gets the index a sub-chain splits after
+   *
+   * @param first Index of the first matrix of the sub-chain
+   * @param last Index of the last matrix of the sub-chain, after first
+   * @return size_t Index of the last matrix of the left factor
+   */
+  size_t Split(size_t first, size_t last) const {
+    return splits[first * num_matrices() + last];
+  }
+};
+
+/**
+ * @brief Chooses the cheapest order of a chain of products with the classic
+ * O(n^3) dynamic program, pricing every product with ProductCost
+ *
+ * @param dims Row count of every matrix followed by the column count of the
+ * last one. Has at least 2 entries
+ * @return ChainPlan Cheapest order and its cost
+ */
+inline ChainPlan PlanChain(const std::vector<size_t>& dims) {
+  ChainPlan plan;
+  plan.dims = dims;
+  const size_t n = plan.num_matrices();
+  plan.splits.assign(n * n, 0);
+  std::vector<double> costs(n * n, 0.0);
+  for (size_t length = 2; length <= n; length++) {
+    for (size_t first = 0; first + length <= n; first++) {
+      const size_t last = first + length - 1;
+      double best = std::numeric_limits<double>::infinity();
+      for (size_t split = first; split < last; split++) {
+        const double cost =
+            costs[first * n + split] + costs[(split + 1) * n + last] +
+            ProductCost(dims[first], dims[last + 1], dims[split + 1]);
+        if (cost < best) {
+          best = cost;
+          plan.splits[first * n + last] = split;
+        }
+      }
+      costs[first * n + last] = best;
+    }
+  }
+  plan.cost = costs[n - 1];
+  return plan;
+}
+
+/**
+ * @brief Estimates the cost of evaluating a chain from left to right, as
+ * consecutive MatrixMultiply calls would
+ *
+ * @param dims Row count of every matrix followed by the column count of the
+ * last one. Has at least 2 entries
+ * @return double Estimated cost
+ */
+inline double LeftToRightCost(const std::vector<size_t>& dims) {
+  double cost = 0.0;
+  for (size_t i = 2; i < dims.size(); i++) {
+    cost += ProductCost(dims.front(), dims[i], dims[i - 1]);
+  }
+  return cost;
+}
+
+/**
+ * @brief One product of a plan. The sub-chain first..last is the product of
+ * first..split and split + 1..last
+ */
+struct ChainNode {
+  size_t first;
+  size_t split;
+  size_t last;
+};
+
+/**
+ * @brief Groups the products of a plan into waves. A product is in the wave
+ * after the later of its 2 factors, so products in the same wave do not
+ * depend on each other and can run concurrently
+ *
+ * @param plan Plan of a chain of at least 2 matrices
+ * @return std::vector<std::vector<ChainNode>> Waves in the order they must
+ * run. The last wave holds only the whole chain
+ */
+inline std::vector<std::vector<ChainNode>> PlanWaves(const ChainPlan& plan) {
+  std::vector<std::vector<ChainNode>> waves;
+  // Depth first with an explicit stack, recording the wave of each sub-chain
+  // once both of its factors have one
+  const size_t n = plan.num_matrices();
+  std::vector<size_t> heights(n * n, 0);
+  std::vector<std::pair<size_t, size_t>> stack(1, std::make_pair(0, n - 1));
+  while (!stack.empty()) {
+    const size_t first = stack.back().first;
+    const size_t last = stack.back().second;
+    const size_t split = plan.Split(first, last);
+    const bool left_done = split == first || heights[first * n + split] != 0;
+    const bool right_done =
+        split + 1 == last || heights[(split + 1) * n + last] != 0;
+    if (!left_done) {
+      stack.emplace_back(first, split);
+      continue;
+    }
+    if (!right_done) {
+      stack.emplace_back(split + 1, last);
+      continue;
+    }
+    stack.pop_back();
+    const size_t height = std::max(heights[first * n + split],
+                                   heights[(split + 1) * n + last]) +
+                          1;
+    heights[first * n + last] = height;
+    if (waves.size() < height) {
+      waves.resize(height);
+    }
+    waves[height - 1].push_back(ChainNode{first, split, last});
+  }
+  return waves;
+}
+
+/**
+ * @brief One product of a wave ready to run
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+struct ChainProduct {
+  const matrix_library::utils::dense_matrix::DenseMatrix<T>* left;
+  const matrix_library::utils::dense_matrix::DenseMatrix<T>* right;
+  matrix_library::utils::dense_matrix::DenseMatrix<T>* out;
+};
+
+/**
+ * @brief Evaluates a chain of products in the order of a plan. Intermediate
+ * results are freed as soon as the wave consuming them is done and their
+ * buffers are handed to later products, so the chain allocates little more
+ * than its largest intermediates
+ *
+ * @tparam T Any numeric type
+ * @tparam RunWave Callable taking a std::vector<ChainProduct<T>> and running
+ * every product in it
+ * @param matrices Matrices of the chain, at least 2
+ * @param plan Plan of the chain
+ * @param run_wave Runs one wave of independent products
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Product of the
+ * whole chain
+ */
+template <typename T, typename RunWave>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> Execute(
+    const std::vector<std::reference_wrapper<
+        const matrix_library::utils::dense_matrix::DenseMatrix<T>>>& matrices,
+    const ChainPlan& plan, const RunWave& run_wave) {
+  using Matrix = matrix_library::utils::dense_matrix::DenseMatrix<T>;
+  const size_t n = plan.num_matrices();
+  // Sub-chain first..last lives at first * n + last once computed
+  std::vector<Matrix> results(n * n);
+  std::vector<typename Matrix::Storage> free_buffers;
+  auto operand = [&](size_t first, size_t last) -> const Matrix* {
+    return first == last ? &matrices[first].get() : &results[first * n + last];
+  };
+  for (const auto& wave : PlanWaves(plan)) {
+    std::vector<ChainProduct<T>> products;
+    products.reserve(wave.size());
+    for (const ChainNode& node : wave) {
+      const size_t num_rows = plan.dims[node.first];
+      const size_t num_cols = plan.dims[node.last + 1];
+      // Reuse the smallest freed buffer that fits, otherwise the largest
+      const size_t size = num_rows * num_cols;
+      auto best = free_buffers.end();
+      for (auto it = free_buffers.begin(); it != free_buffers.end(); ++it) {
+        if (best == free_buffers.end() ||
+            (it->capacity() >= size
+                 ? best->capacity() < size || it->capacity() < best->capacity()
+                 : best->capacity() < size &&
+                       it->capacity() > best->capacity())) {
+          best = it;
+        }
+      }
+      typename Matrix::Storage storage;
+      if (best != free_buffers.end()) {
+        storage = std::move(*best);
+        free_buffers.erase(best);
+      }
+      storage.resize(size);
+      results[node.first * n + node.last] =
+          Matrix(num_rows, num_cols, std::move(storage));
+      products.push_back(ChainProduct<T>{
+          operand(node.first, node.split), operand(node.split + 1, node.last),
+          &results[node.first * n + node.last]});
+    }
+    run_wave(products);
+    for (const ChainNode& node : wave) {
+      if (node.split != node.first) {
+        free_buffers.push_back(
+            results[node.first * n + node.split].ReleaseStorage());
+      }
+      if (node.split + 1 != node.last) {
+        free_buffers.push_back(
+            results[(node.split + 1) * n + node.last].ReleaseStorage());
+      }
+    }
+  }
+  return std::move(results[n - 1]);
+}
+
+}  // namespace matrix_chain
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
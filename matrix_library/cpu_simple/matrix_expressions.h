@@ -0,0 +1,581 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the lazy matrix expressions of the CPU
+ * simple version of library. The operators build expression trees over
+ * contiguous matrices that are only evaluated when assigned to a DenseMatrix.
+ * Elementwise sums, differences and scalings are fused into a single pass over
+ * the result and every product, with its scale, becomes one call of the
+ * multiplication kernel accumulating into the result, so
+ * C = alpha * A * B + beta * D allocates nothing when C already has the right
+ * shape. Bring the operators in with
+ * using namespace matrix_library::cpu_simple::matrix_expressions
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__MATRIX_EXPRESSIONS_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__MATRIX_EXPRESSIONS_H_
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "matrix_library/cpu_simple/matrix_ops.h"
+#include "matrix_library/utils/dense_matrix.h"
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace matrix_expressions {
+
+/**
+ * @brief Evaluates an expression into a matrix. C is reshaped if needed, its
+ * storage is reused otherwise. The elementwise part is written in one pass and
+ * the products are then accumulated into C one kernel call each
+ *
+ * @tparam E Expression type
+ * @param expression Expression to evaluate
+ * @param C Matrix receiving the result. It may appear in the expression
+ * elementwise, as in C = A * B + C, but not as a factor of a product or
+ * transposed
+ * @throws Runtime Error if C is read at other positions than the ones written
+ */
+template <typename E>
+inline void Evaluate(
+    const E& expression,
+    matrix_library::utils::dense_matrix::DenseMatrix<typename E::value_type>&
+        C) {
+  using T = typename E::value_type;
+  if (expression.ReadsOutOfPlace(C)) {
+    throw std::runtime_error("Matrix C cannot be a factor or transposed");
+  }
+  const size_t num_rows = expression.num_rows();
+  const size_t num_cols = expression.num_cols();
+  if (C.num_rows() != num_rows || C.num_cols() != num_cols) {
+    C = matrix_library::utils::dense_matrix::DenseMatrix<T>(
+        num_rows, num_cols,
+        matrix_library::utils::dense_matrix::UninitializedTag());
+  }
+  bool overwrite = true;
+  if (E::kHasElementwise) {
+    for (size_t i = 0; i < num_rows; i++) {
+      T* c_row = C.row(i);
+      for (size_t j = 0; j < num_cols; j++) {
+        c_row[j] = expression.Element(i, j);
+      }
+    }
+    overwrite = false;
+  }
+  expression.AccumulateProducts(C, static_cast<T>(1), overwrite);
+}
+
+/**
+ * @brief Base of every expression. Evaluating it into a DenseMatrix is what
+ * DenseMatrix construction and assignment from an expression call
+ *
+ * @tparam Derived Expression type
+ */
+template <typename Derived>
+class Expression {
+ public:
+  /**
+   * @brief Evaluates the expression into a matrix
+   *
+   * @tparam T Any numeric type
+   * @param C Matrix receiving the result
+   */
+  template <typename T>
+  void EvaluateInto(
+      matrix_library::utils::dense_matrix::DenseMatrix<T>& C) const {
+    Evaluate(static_cast<const Derived&>(*this), C);
+  }
+};
+
+/**
+ * @brief Leaf reading a matrix as stored
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class MatrixTerm : public Expression<MatrixTerm<T>> {
+ public:
+  using value_type = T;
+  static constexpr bool kHasElementwise = true;
+
+  explicit MatrixTerm(
+      const matrix_library::utils::dense_matrix::DenseMatrix<T>& matrix)
+      : matrix_(&matrix) {}
+
+  size_t num_rows() const { return matrix_->num_rows(); }
+  size_t num_cols() const { return matrix_->num_cols(); }
+  T Element(size_t i, size_t j) const { return (*matrix_)(i, j); }
+
+  bool ReadsOutOfPlace(
+      const matrix_library::utils::dense_matrix::DenseMatrix<T>&) const {
+    return false;
+  }
+
+  void AccumulateProducts(matrix_library::utils::dense_matrix::DenseMatrix<T>&,
+                          T, bool&) const {}
+
+  const matrix_library::utils::dense_matrix::DenseMatrix<T>& matrix() const {
+    return *matrix_;
+  }
+
+ private:
+  const matrix_library::utils::dense_matrix::DenseMatrix<T>* matrix_;
+};
+
+/**
+ * @brief Leaf reading a matrix in transposed order
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class TransposeTerm : public Expression<TransposeTerm<T>> {
+ public:
+  using value_type = T;
+  static constexpr bool kHasElementwise = true;
+
+  explicit TransposeTerm(
+      const matrix_library::utils::dense_matrix::DenseMatrix<T>& matrix)
+      : matrix_(&matrix) {}
+
+  size_t num_rows() const { return matrix_->num_cols(); }
+  size_t num_cols() const { return matrix_->num_rows(); }
+  T Element(size_t i, size_t j) const { return (*matrix_)(j, i); }
+
+  bool ReadsOutOfPlace(
+      const matrix_library::utils::dense_matrix::DenseMatrix<T>& C) const {
+    return matrix_ == &C;
+  }
+
+  void AccumulateProducts(matrix_library::utils::dense_matrix::DenseMatrix<T>&,
+                          T, bool&) const {}
+
+  const matrix_library::utils::dense_matrix::DenseMatrix<T>& matrix() const {
+    return *matrix_;
+  }
+
+ private:
+  const matrix_library::utils::dense_matrix::DenseMatrix<T>* matrix_;
+};
+
+/**
+ * @brief Expression times a scalar. Scales of products are folded into the
+ * kernel call
+ *
+ * @tparam E Expression being scaled
+ */
+template <typename E>
+class ScaledTerm : public Expression<ScaledTerm<E>> {
+ public:
+  using value_type = typename E::value_type;
+  static constexpr bool kHasElementwise = E::kHasElementwise;
+
+  ScaledTerm(value_type alpha, const E& term) : alpha_(alpha), term_(term) {}
+
+  size_t num_rows() const { return term_.num_rows(); }
+  size_t num_cols() const { return term_.num_cols(); }
+  value_type Element(size_t i, size_t j) const {
+    return static_cast<value_type>(alpha_ * term_.Element(i, j));
+  }
+
+  bool ReadsOutOfPlace(
+      const matrix_library::utils::dense_matrix::DenseMatrix<value_type>& C)
+      const {
+    return term_.ReadsOutOfPlace(C);
+  }
+
+  void AccumulateProducts(
+      matrix_library::utils::dense_matrix::DenseMatrix<value_type>& C,
+      value_type scale, bool& overwrite) const {
+    term_.AccumulateProducts(C, static_cast<value_type>(scale * alpha_),
+                             overwrite);
+  }
+
+  value_type alpha() const { return alpha_; }
+  const E& term() const { return term_; }
+
+ private:
+  value_type alpha_;
+  E term_;
+};
+
+/**
+ * @brief Combines the elementwise parts of the 2 sides of a sum or a
+ * difference. Sides made only of products have no elementwise part and are
+ * skipped at compile time
+ *
+ * @tparam kLeft Whether the left side has an elementwise part
+ * @tparam kRight Whether the right side has an elementwise part
+ */
+template <bool kLeft, bool kRight>
+struct ElementwisePart;
+
+template <>
+struct ElementwisePart<true, true> {
+  template <typename L, typename R>
+  static typename L::value_type Sum(const L& left, const R& right, size_t i,
+                                    size_t j) {
+    return static_cast<typename L::value_type>(left.Element(i, j) +
+                                               right.Element(i, j));
+  }
+  template <typename L, typename R>
+  static typename L::value_type Difference(const L& left, const R& right,
+                                           size_t i, size_t j) {
+    return static_cast<typename L::value_type>(left.Element(i, j) -
+                                               right.Element(i, j));
+  }
+};
+
+template <>
+struct ElementwisePart<true, false> {
+  template <typename L, typename R>
+  static typename L::value_type Sum(const L& left, const R&, size_t i,
+                                    size_t j) {
+    return left.Element(i, j);
+  }
+  template <typename L, typename R>
+  static typename L::value_type Difference(const L& left, const R&, size_t i,
+                                           size_t j) {
+    return left.Element(i, j);
+  }
+};
+
+template <>
+struct ElementwisePart<false, true> {
+  template <typename L, typename R>
+  static typename L::value_type Sum(const L&, const R& right, size_t i,
+                                    size_t j) {
+    return right.Element(i, j);
+  }
+  template <typename L, typename R>
+  static typename L::value_type Difference(const L&, const R& right, size_t i,
+                                           size_t j) {
+    return static_cast<typename L::value_type>(-right.Element(i, j));
+  }
+};
+
+template <>
+struct ElementwisePart<false, false> {
+  template <typename L, typename R>
+  static typename L::value_type Sum(const L&, const R&, size_t, size_t) {
+    return static_cast<typename L::value_type>(0);
+  }
+  template <typename L, typename R>
+  static typename L::value_type Difference(const L&, const R&, size_t,
+                                           size_t) {
+    return static_cast<typename L::value_type>(0);
+  }
+};
+
+/**
+ * @brief Elementwise sum or difference of 2 expressions of the same shape
+ *
+ * @tparam L Left expression
+ * @tparam R Right expression
+ * @tparam kSubtract Whether the right side is subtracted
+ */
+template <typename L, typename R, bool kSubtract>
+class SumTerm : public Expression<SumTerm<L, R, kSubtract>> {
+  static_assert(std::is_same<typename L::value_type,
+                             typename R::value_type>::value,
+                "Both sides must have the same element type");
+
+ public:
+  using value_type = typename L::value_type;
+  static constexpr bool kHasElementwise =
+      L::kHasElementwise || R::kHasElementwise;
+
+  /**
+   * @throws Runtime Error if the 2 sides have different shapes
+   */
+  SumTerm(const L& left, const R& right) : left_(left), right_(right) {
+    if (left.num_rows() != right.num_rows() ||
+        left.num_cols() != right.num_cols()) {
+      throw std::runtime_error("Matrices have different shapes");
+    }
+  }
+
+  size_t num_rows() const { return left_.num_rows(); }
+  size_t num_cols() const { return left_.num_cols(); }
+  value_type Element(size_t i, size_t j) const {
+    using Part = ElementwisePart<L::kHasElementwise, R::kHasElementwise>;
+    return kSubtract ? Part::Difference(left_, right_, i, j)
+                     : Part::Sum(left_, right_, i, j);
+  }
+
+  bool ReadsOutOfPlace(
+      const matrix_library::utils::dense_matrix::DenseMatrix<value_type>& C)
+      const {
+    return left_.ReadsOutOfPlace(C) || right_.ReadsOutOfPlace(C);
+  }
+
+  void AccumulateProducts(
+      matrix_library::utils::dense_matrix::DenseMatrix<value_type>& C,
+      value_type scale, bool& overwrite) const {
+    left_.AccumulateProducts(C, scale, overwrite);
+    right_.AccumulateProducts(
+        C, kSubtract ? static_cast<value_type>(-scale) : scale, overwrite);
+  }
+
+ private:
+  L left_;
+  R right_;
+};
+
+/**
+ * @brief Product alpha * op_a(A) * op_b(B) of 2 matrices. It has no
+ * elementwise part, it is computed by the multiplication kernel straight into
+ * the result
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class ProductTerm : public Expression<ProductTerm<T>> {
+ public:
+  using value_type = T;
+  static constexpr bool kHasElementwise = false;
+
+  /**
+   * @throws Runtime Error if the 2 matrices cannot be multiplied
+   */
+  ProductTerm(T alpha,
+              const matrix_library::utils::dense_matrix::DenseMatrix<T>& a,
+              matrix_library::utils::dense_matrix::Operation op_a,
+              const matrix_library::utils::dense_matrix::DenseMatrix<T>& b,
+              matrix_library::utils::dense_matrix::Operation op_b)
+      : alpha_(alpha), a_(&a), op_a_(op_a), b_(&b), op_b_(op_b) {
+    const size_t k = IsTransposed(op_a) ? a.num_rows() : a.num_cols();
+    if (k != (IsTransposed(op_b) ? b.num_cols() : b.num_rows())) {
+      throw std::runtime_error("Matrices A and B cannot multiply");
+    }
+  }
+
+  size_t num_rows() const {
+    return IsTransposed(op_a_) ? a_->num_cols() : a_->num_rows();
+  }
+  size_t num_cols() const {
+    return IsTransposed(op_b_) ? b_->num_rows() : b_->num_cols();
+  }
+  T Element(size_t, size_t) const { return static_cast<T>(0); }
+
+  bool ReadsOutOfPlace(
+      const matrix_library::utils::dense_matrix::DenseMatrix<T>& C) const {
+    return a_ == &C || b_ == &C;
+  }
+
+  void AccumulateProducts(
+      matrix_library::utils::dense_matrix::DenseMatrix<T>& C, T scale,
+      bool& overwrite) const {
+    matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+        static_cast<T>(alpha_ * scale), *a_, op_a_, *b_, op_b_,
+        static_cast<T>(overwrite ? 0 : 1), C);
+    overwrite = false;
+  }
+
+ private:
+  static bool IsTransposed(matrix_library::utils::dense_matrix::Operation op) {
+    return op == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  }
+
+  T alpha_;
+  const matrix_library::utils::dense_matrix::DenseMatrix<T>* a_;
+  matrix_library::utils::dense_matrix::Operation op_a_;
+  const matrix_library::utils::dense_matrix::DenseMatrix<T>* b_;
+  matrix_library::utils::dense_matrix::Operation op_b_;
+};
+
+/**
+ * @brief Maps what the operators accept to expression terms. Matrices and
+ * transpose views become leaves and expressions are used as they are
+ *
+ * @tparam X Operand type
+ */
+template <typename X, typename = void>
+struct TermOf : std::false_type {};
+
+template <typename T>
+struct TermOf<matrix_library::utils::dense_matrix::DenseMatrix<T>>
+    : std::true_type {
+  using type = MatrixTerm<T>;
+  static type Make(
+      const matrix_library::utils::dense_matrix::DenseMatrix<T>& matrix) {
+    return type(matrix);
+  }
+};
+
+template <typename T>
+struct TermOf<matrix_library::utils::dense_matrix::TransposeView<T>>
+    : std::true_type {
+  using type = TransposeTerm<T>;
+  static type Make(
+      const matrix_library::utils::dense_matrix::TransposeView<T>& view) {
+    return type(view.matrix());
+  }
+};
+
+template <typename X>
+struct TermOf<X, typename std::enable_if<
+                     std::is_base_of<Expression<X>, X>::value>::type>
+    : std::true_type {
+  using type = X;
+  static const type& Make(const X& expression) { return expression; }
+};
+
+/**
+ * @brief Maps what can be a factor of a product to the matrix it reads, how it
+ * reads it and its scale. Scaled factors let alpha * A * B parse as
+ * (alpha * A) * B
+ *
+ * @tparam X Operand type
+ */
+template <typename X>
+struct FactorOf : std::false_type {};
+
+template <typename T>
+struct FactorOf<matrix_library::utils::dense_matrix::DenseMatrix<T>>
+    : std::true_type {
+  using value_type = T;
+  static const matrix_library::utils::dense_matrix::DenseMatrix<T>& Matrix(
+      const matrix_library::utils::dense_matrix::DenseMatrix<T>& matrix) {
+    return matrix;
+  }
+  static matrix_library::utils::dense_matrix::Operation Op() {
+    return matrix_library::utils::dense_matrix::Operation::kNoTranspose;
+  }
+  static T Alpha(const matrix_library::utils::dense_matrix::DenseMatrix<T>&) {
+    return static_cast<T>(1);
+  }
+};
+
+template <typename T>
+struct FactorOf<MatrixTerm<T>> : std::true_type {
+  using value_type = T;
+  static const matrix_library::utils::dense_matrix::DenseMatrix<T>& Matrix(
+      const MatrixTerm<T>& term) {
+    return term.matrix();
+  }
+  static matrix_library::utils::dense_matrix::Operation Op() {
+    return matrix_library::utils::dense_matrix::Operation::kNoTranspose;
+  }
+  static T Alpha(const MatrixTerm<T>&) { return static_cast<T>(1); }
+};
+
+template <typename T>
+struct FactorOf<matrix_library::utils::dense_matrix::TransposeView<T>>
+    : std::true_type {
+  using value_type = T;
+  static const matrix_library::utils::dense_matrix::DenseMatrix<T>& Matrix(
+      const matrix_library::utils::dense_matrix::TransposeView<T>& view) {
+    return view.matrix();
+  }
+  static matrix_library::utils::dense_matrix::Operation Op() {
+    return matrix_library::utils::dense_matrix::Operation::kTranspose;
+  }
+  static T Alpha(
+      const matrix_library::utils::dense_matrix::TransposeView<T>&) {
+    return static_cast<T>(1);
+  }
+};
+
+template <typename T>
+struct FactorOf<TransposeTerm<T>> : std::true_type {
+  using value_type = T;
+  static const matrix_library::utils::dense_matrix::DenseMatrix<T>& Matrix(
+      const TransposeTerm<T>& term) {
+    return term.matrix();
+  }
+  static matrix_library::utils::dense_matrix::Operation Op() {
+    return matrix_library::utils::dense_matrix::Operation::kTranspose;
+  }
+  static T Alpha(const TransposeTerm<T>&) { return static_cast<T>(1); }
+};
+
+template <typename E>
+struct FactorOf<ScaledTerm<E>> : FactorOf<E> {
+  using value_type = typename E::value_type;
+  static const matrix_library::utils::dense_matrix::DenseMatrix<value_type>&
+  Matrix(const ScaledTerm<E>& term) {
+    return FactorOf<E>::Matrix(term.term());
+  }
+  static value_type Alpha(const ScaledTerm<E>& term) {
+    return static_cast<value_type>(term.alpha() *
+                                   FactorOf<E>::Alpha(term.term()));
+  }
+};
+
+/**
+ * @brief Lazy elementwise sum of 2 matrices or expressions
+ *
+ * @throws Runtime Error if the 2 sides have different shapes
+ */
+template <typename L, typename R,
+          typename = typename std::enable_if<TermOf<L>::value &&
+                                             TermOf<R>::value>::type>
+inline SumTerm<typename TermOf<L>::type, typename TermOf<R>::type, false>
+operator+(const L& left, const R& right) {
+  return SumTerm<typename TermOf<L>::type, typename TermOf<R>::type, false>(
+      TermOf<L>::Make(left), TermOf<R>::Make(right));
+}
+
+/**
+ * @brief Lazy elementwise difference of 2 matrices or expressions
+ *
+ * @throws Runtime Error if the 2 sides have different shapes
+ */
+template <typename L, typename R,
+          typename = typename std::enable_if<TermOf<L>::value &&
+                                             TermOf<R>::value>::type>
+inline SumTerm<typename TermOf<L>::type, typename TermOf<R>::type, true>
+operator-(const L& left, const R& right) {
+  return SumTerm<typename TermOf<L>::type, typename TermOf<R>::type, true>(
+      TermOf<L>::Make(left), TermOf<R>::Make(right));
+}
+
+/**
+ * @brief Lazy product of a scalar with a matrix or expression
+ */
+template <typename X,
+          typename = typename std::enable_if<TermOf<X>::value>::type>
+inline ScaledTerm<typename TermOf<X>::type> operator*(
+    typename TermOf<X>::type::value_type alpha, const X& term) {
+  return ScaledTerm<typename TermOf<X>::type>(alpha, TermOf<X>::Make(term));
+}
+
+/**
+ * @brief Lazy product of a matrix or expression with a scalar
+ */
+template <typename X,
+          typename = typename std::enable_if<TermOf<X>::value>::type>
+inline ScaledTerm<typename TermOf<X>::type> operator*(
+    const X& term, typename TermOf<X>::type::value_type alpha) {
+  return ScaledTerm<typename TermOf<X>::type>(alpha, TermOf<X>::Make(term));
+}
+
+/**
+ * @brief Lazy product of 2 matrices, either of which may be transposed or
+ * scaled. Products of products are not expressions, MultiplyChain orders
+ * those
+ *
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename L, typename R,
+          typename = typename std::enable_if<FactorOf<L>::value &&
+                                             FactorOf<R>::value>::type>
+inline ProductTerm<typename FactorOf<L>::value_type> operator*(
+    const L& left, const R& right) {
+  using T = typename FactorOf<L>::value_type;
+  return ProductTerm<T>(
+      static_cast<T>(FactorOf<L>::Alpha(left) * FactorOf<R>::Alpha(right)),
+      FactorOf<L>::Matrix(left), FactorOf<L>::Op(), FactorOf<R>::Matrix(right),
+      FactorOf<R>::Op());
+}
+
+}  // namespace matrix_expressions
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
@@ -11,15 +11,108 @@
 #ifndef MATRIX_LIBRARY__CPU_SIMPLE__MATRIX_OPS_H_
 #define MATRIX_LIBRARY__CPU_SIMPLE__MATRIX_OPS_H_
 
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "matrix_library/cpu_simple/batched_gemm.h"
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/cpu_simple/gemm_epilogues.h"
+#include "matrix_library/cpu_simple/matrix_chain.h"
+#include "matrix_library/cpu_simple/packed_matrix.h"
+#include "matrix_library/cpu_simple/simple_kernels.h"
+#include "matrix_library/cpu_simple/strassen.h"
+#include "matrix_library/cpu_simple/syrk.h"
+#include "matrix_library/cpu_simple/transpose_kernels.h"
+#include "matrix_library/cpu_simple/vector_kernels.h"
+#include "matrix_library/utils/dense_matrix.h"
+#include "matrix_library/utils/fixed_matrix.h"
 #include "matrix_library/utils/matrix_utils.h"
 
 namespace matrix_library {
 namespace cpu_simple {
 namespace matrix_ops {
 
+/**
+ * @brief Multiplies 2 matrices into a preallocated matrix if possible
+ * otherwise it throws an error. The storage of C is reused so steady state
+ * loops do not allocate
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @param C Matrix with as many rows as A and as many columns as B. Set to
+ * A * B, or to C + A * B when accumulating. Must not be A or B
+ * @param accumulate Add the product to C instead of overwriting it
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A or B
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline void MatrixMultiplyInto(const std::vector<std::vector<T>>& A,
+                               const std::vector<std::vector<T>>& B,
+                               std::vector<std::vector<T>>& C,
+                               bool accumulate = false) {
+  // If the 2 matrices cannot be multiplied throw a runtime error
+  if (!matrix_library::utils::matrix_utils::CanMatricesMultiply(A, B)) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  if (&C == &A || &C == &B) {
+    throw std::runtime_error("Matrix C cannot be one of the inputs");
+  }
+  // C needs A number of rows and B number of columns
+  const size_t num_cols =
+      matrix_library::utils::matrix_utils::IsMatrixEmpty(B) ? 0
+                                                            : B.front().size();
+  if (C.size() != A.size() ||
+      !matrix_library::utils::matrix_utils::IsMatrixFollowingDimensions(
+          C, num_cols)) {
+    throw std::runtime_error("Matrix C has the wrong shape");
+  }
+  // If C has no rows or no columns there is nothing to compute
+  if (matrix_library::utils::matrix_utils::IsMatrixEmpty(C) || num_cols == 0) {
+    return;
+  }
+  // Dot, matrix-vector and outer products are bound by memory bandwidth and
+  // go through the streaming kernels
+  if (matrix_library::cpu_simple::vector_kernels::IsVectorShape(
+          A.size(), num_cols, B.size())) {
+    matrix_library::cpu_simple::vector_kernels::MultiplyVectorShape<T>(
+        A.size(), num_cols, B.size(),
+        [&A](size_t i) { return A[i].data(); },
+        [&B](size_t p) { return B[p].data(); },
+        [&C](size_t i) { return C[i].data(); }, accumulate);
+    return;
+  }
+  // Large products are tiled and packed so B is not streamed from memory
+  // once per row of A
+  if (matrix_library::cpu_simple::blocked_gemm::UseBlockedGemm(
+          A.size(), num_cols, B.size())) {
+    matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+        A.size(), num_cols, B.size(),
+        matrix_library::cpu_simple::blocked_gemm::NestedOperand<T>(A),
+        matrix_library::cpu_simple::blocked_gemm::NestedOperand<T>(B),
+        matrix_library::cpu_simple::blocked_gemm::NestedOutput<T>(C),
+        accumulate);
+    return;
+  }
+  // The simple loop always sums into C so it starts from 0 when overwriting
+  if (!accumulate) {
+    for (auto& row : C) {
+      std::fill(row.begin(), row.end(), static_cast<T>(0));
+    }
+  }
+  // Matrix multiplication done to be cache friendly
+  // In this the innermost loop variable is accessed in each row which is loaded
+  // contiguously in vector minimizing cache misses. Shapes were validated above
+  // so element accesses are only bounds checked in checked access builds
+  matrix_library::cpu_simple::simple_kernels::MultiplyAccumulate(
+      A, B, C, matrix_library::cpu_simple::simple_kernels::DefaultAccess());
+}
+
 /**
  * @brief Multiplies 2 matrices if possible otherwise it throws an error
  *
@@ -39,7 +132,6 @@ inline std::vector<std::vector<T>> MatrixMultiply(
     throw std::runtime_error("Matrices A and B cannot multiply");
   }
   // Create a matrix C with A number of rows and B number of columns
-  // Fill with default value of 0 to sum over
   std::vector<std::vector<T>> C;
   if (matrix_library::utils::matrix_utils::IsMatrixEmpty(B)) {
     C.resize(A.size());
@@ -47,45 +139,938 @@ inline std::vector<std::vector<T>> MatrixMultiply(
   }
   C = matrix_library::utils::matrix_utils::CreateMatrix(
       A.size(), B.front().size(), static_cast<T>(0));
+  MatrixMultiplyInto(A, B, C, true);
+  return C;
+}
 
-  // If C has no rows just return it
-  if (matrix_library::utils::matrix_utils::IsMatrixEmpty(C)) {
-    return C;
+/**
+ * @brief Multiplies 2 contiguous matrices into a preallocated matrix if
+ * possible otherwise it throws an error. The storage of C is reused so steady
+ * state loops do not allocate
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @param C Matrix with as many rows as A and as many columns as B. Set to
+ * A * B, or to C + A * B when accumulating. Must not be A or B
+ * @param accumulate Add the product to C instead of overwriting it
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A or B
+ */
+template <typename T>
+inline void MatrixMultiplyInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C,
+    bool accumulate = false) {
+  // Dimensions are explicit so only the inner dimensions need to agree
+  if (A.num_cols() != B.num_rows()) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
   }
-  // If C has no colums just return it
-  if (matrix_library::utils::matrix_utils::IsVectorEmpty(C.front())) {
-    return C;
+  if (&C == &A || &C == &B) {
+    throw std::runtime_error("Matrix C cannot be one of the inputs");
   }
-  // Matrix multiplication done to be cache friendly
-  // In this the innermost loop variable is accessed in each row which is loaded
-  // contiguously in vector minimizing cache misses
-  // i loops over every row in A
-  // k loops over every column in A and row in B
-  // j loops over every column in B
-  for (size_t i = 0; i < A.size(); i++) {
-    for (size_t k = 0; k < A.front().size(); k++) {
-      for (size_t j = 0; j < B.front().size(); j++) {
-        C.at(i).at(j) += (A.at(i).at(k) * B.at(k).at(j));
+  if (C.num_rows() != A.num_rows() || C.num_cols() != B.num_cols()) {
+    throw std::runtime_error("Matrix C has the wrong shape");
+  }
+  // Dot, matrix-vector and outer products are bound by memory bandwidth and
+  // go through the streaming kernels
+  if (matrix_library::cpu_simple::vector_kernels::IsVectorShape(
+          A.num_rows(), B.num_cols(), A.num_cols())) {
+    matrix_library::cpu_simple::vector_kernels::MultiplyVectorShape<T>(
+        A.num_rows(), B.num_cols(), A.num_cols(),
+        [&A](size_t i) { return A.row(i); },
+        [&B](size_t p) { return B.row(p); },
+        [&C](size_t i) { return C.row(i); }, accumulate);
+    return;
+  }
+  if (matrix_library::cpu_simple::blocked_gemm::UseBlockedGemm(
+          A.num_rows(), B.num_cols(), A.num_cols())) {
+    matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+        A.num_rows(), B.num_cols(), A.num_cols(),
+        matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+            A.data(), A.leading_dimension(), 1),
+        matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+            B.data(), B.leading_dimension(), 1),
+        matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(
+            C.data(), C.leading_dimension()),
+        accumulate);
+    return;
+  }
+  // The simple loop always sums into C so it starts from 0 when overwriting
+  if (!accumulate) {
+    for (size_t i = 0; i < C.num_rows(); i++) {
+      std::fill(C.row(i), C.row(i) + C.num_cols(), static_cast<T>(0));
+    }
+  }
+  // Same i-k-j order as the nested version
+  matrix_library::cpu_simple::simple_kernels::MultiplyAccumulate(
+      A, B, C, matrix_library::cpu_simple::simple_kernels::DefaultAccess());
+}
+
+/**
+ * @brief Multiplies 2 contiguous matrices if possible otherwise it throws an
+ * error
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B) {
+  if (A.num_cols() != B.num_rows()) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  // Every element is overwritten so the output is left uninitialized
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(
+      A.num_rows(), B.num_cols(),
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  MatrixMultiplyInto(A, B, C, false);
+  return C;
+}
+
+/**
+ * @brief Multiplies 2 fixed size matrices. Mismatched inner dimensions do not
+ * compile and the product can be evaluated at compile time
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows in A and C
+ * @tparam K Number of columns in A and rows in B
+ * @tparam C Number of columns in B and C
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @return matrix_library::utils::fixed_matrix::Matrix<T, R, C> Matrix C that
+ * is equal to A * B
+ */
+template <typename T, size_t R, size_t K, size_t C>
+constexpr matrix_library::utils::fixed_matrix::Matrix<T, R, C> MatrixMultiply(
+    const matrix_library::utils::fixed_matrix::Matrix<T, R, K>& A,
+    const matrix_library::utils::fixed_matrix::Matrix<T, K, C>& B) {
+  return matrix_library::utils::fixed_matrix::Multiply(A, B);
+}
+
+/**
+ * @brief Multiplies 2 contiguous matrices, either of which can be read in
+ * transposed order, into a preallocated matrix if possible otherwise it throws
+ * an error. Transposed operands are never copied, the kernel reads them
+ * through its packing routine
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in op_a(A) * op_b(B)
+ * @param op_a Whether A is transposed
+ * @param B Matrix B to be multipled in op_a(A) * op_b(B)
+ * @param op_b Whether B is transposed
+ * @param C Matrix with as many rows as op_a(A) and as many columns as
+ * op_b(B). Set to op_a(A) * op_b(B), or to C + op_a(A) * op_b(B) when
+ * accumulating. Must not be A or B
+ * @param accumulate Add the product to C instead of overwriting it
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A or B
+ */
+template <typename T>
+inline void MatrixMultiplyInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    matrix_library::utils::dense_matrix::Operation op_a,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::Operation op_b,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C,
+    bool accumulate = false) {
+  const bool transpose_a =
+      op_a == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const bool transpose_b =
+      op_b == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  if (!transpose_a && !transpose_b) {
+    MatrixMultiplyInto(A, B, C, accumulate);
+    return;
+  }
+  const size_t m = transpose_a ? A.num_cols() : A.num_rows();
+  const size_t k = transpose_a ? A.num_rows() : A.num_cols();
+  const size_t n = transpose_b ? B.num_rows() : B.num_cols();
+  if (k != (transpose_b ? B.num_cols() : B.num_rows())) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  if (&C == &A || &C == &B) {
+    throw std::runtime_error("Matrix C cannot be one of the inputs");
+  }
+  if (C.num_rows() != m || C.num_cols() != n) {
+    throw std::runtime_error("Matrix C has the wrong shape");
+  }
+  // Swapping the strides reads the stored matrix in transposed order
+  const matrix_library::cpu_simple::blocked_gemm::StridedOperand<T> a(
+      A.data(), transpose_a ? 1 : A.leading_dimension(),
+      transpose_a ? A.leading_dimension() : 1);
+  const matrix_library::cpu_simple::blocked_gemm::StridedOperand<T> b(
+      B.data(), transpose_b ? 1 : B.leading_dimension(),
+      transpose_b ? B.leading_dimension() : 1);
+  if (matrix_library::cpu_simple::blocked_gemm::UseBlockedGemm(m, n, k)) {
+    matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+        m, n, k, a, b,
+        matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(
+            C.data(), C.leading_dimension()),
+        accumulate);
+    return;
+  }
+  // The simple loop always sums into C so it starts from 0 when overwriting
+  if (!accumulate) {
+    for (size_t i = 0; i < C.num_rows(); i++) {
+      std::fill(C.row(i), C.row(i) + C.num_cols(), static_cast<T>(0));
+    }
+  }
+  matrix_library::cpu_simple::simple_kernels::MultiplyAccumulate(
+      m, n, k, a, b, C.data(), C.leading_dimension());
+}
+
+/**
+ * @brief Computes C = alpha * op_a(A) * op_b(B) + beta * C for contiguous
+ * matrices if possible otherwise it throws an error. alpha is applied while A
+ * is packed and beta in one pass over C, so the product itself is a single
+ * kernel call accumulating into C. As in BLAS, C is not read when beta is 0
+ * and A and B are not read when alpha is 0
+ *
+ * @tparam T Any numeric type
+ * @param alpha Scale of the product
+ * @param A Matrix A to be multiplied in op_a(A) * op_b(B)
+ * @param op_a Whether A is transposed
+ * @param B Matrix B to be multipled in op_a(A) * op_b(B)
+ * @param op_b Whether B is transposed
+ * @param beta Scale of the previous contents of C
+ * @param C Matrix with as many rows as op_a(A) and as many columns as
+ * op_b(B). Must not be A or B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A or B
+ */
+template <typename T>
+inline void MatrixMultiplyInto(
+    T alpha, const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    matrix_library::utils::dense_matrix::Operation op_a,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::Operation op_b, T beta,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C) {
+  const bool transpose_a =
+      op_a == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const bool transpose_b =
+      op_b == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const size_t m = transpose_a ? A.num_cols() : A.num_rows();
+  const size_t k = transpose_a ? A.num_rows() : A.num_cols();
+  const size_t n = transpose_b ? B.num_rows() : B.num_cols();
+  if (k != (transpose_b ? B.num_cols() : B.num_rows())) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  if (&C == &A || &C == &B) {
+    throw std::runtime_error("Matrix C cannot be one of the inputs");
+  }
+  if (C.num_rows() != m || C.num_cols() != n) {
+    throw std::runtime_error("Matrix C has the wrong shape");
+  }
+  const bool accumulate = beta != static_cast<T>(0);
+  if (accumulate && beta != static_cast<T>(1)) {
+    for (size_t i = 0; i < m; i++) {
+      T* c_row = C.row(i);
+      for (size_t j = 0; j < n; j++) {
+        c_row[j] = static_cast<T>(beta * c_row[j]);
       }
     }
   }
+  if (alpha == static_cast<T>(1)) {
+    MatrixMultiplyInto(A, op_a, B, op_b, C, accumulate);
+    return;
+  }
+  // The simple loop always sums into C so it starts from 0 when overwriting
+  if (!accumulate && (alpha == static_cast<T>(0) ||
+                      !matrix_library::cpu_simple::blocked_gemm::
+                          UseBlockedGemm(m, n, k))) {
+    for (size_t i = 0; i < m; i++) {
+      std::fill(C.row(i), C.row(i) + n, static_cast<T>(0));
+    }
+  }
+  if (alpha == static_cast<T>(0)) {
+    return;
+  }
+  // Swapping the strides reads the stored matrix in transposed order
+  const matrix_library::cpu_simple::blocked_gemm::ScaledOperand<
+      T, matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>>
+      a(matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+            A.data(), transpose_a ? 1 : A.leading_dimension(),
+            transpose_a ? A.leading_dimension() : 1),
+        alpha);
+  const matrix_library::cpu_simple::blocked_gemm::StridedOperand<T> b(
+      B.data(), transpose_b ? 1 : B.leading_dimension(),
+      transpose_b ? B.leading_dimension() : 1);
+  if (matrix_library::cpu_simple::blocked_gemm::UseBlockedGemm(m, n, k)) {
+    matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+        m, n, k, a, b,
+        matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(
+            C.data(), C.leading_dimension()),
+        accumulate);
+    return;
+  }
+  matrix_library::cpu_simple::simple_kernels::MultiplyAccumulate(
+      m, n, k, a, b, C.data(), C.leading_dimension());
+}
+
+/**
+ * @brief Computes C = epilogue(op_a(A) * op_b(B)) for contiguous matrices if
+ * possible otherwise it throws an error. The epilogue, for example a bias, an
+ * activation and a conversion to the type of C from gemm_epilogues, runs on
+ * each tile of the product before it is stored so C is written once instead of
+ * being read back by separate passes
+ *
+ * @tparam T Any numeric type of A and B, in which products are accumulated
+ * @tparam U Any numeric type of C
+ * @tparam Epilogue Callable taking (i, j, value) for element (i, j) of the
+ * product and returning what is stored in C
+ * @param A Matrix A to be multiplied in op_a(A) * op_b(B)
+ * @param op_a Whether A is transposed
+ * @param B Matrix B to be multipled in op_a(A) * op_b(B)
+ * @param op_b Whether B is transposed
+ * @param C Matrix with as many rows as op_a(A) and as many columns as
+ * op_b(B). Must not be A or B
+ * @param epilogue Epilogue applied to every element of the product
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A or B
+ */
+template <typename T, typename U, typename Epilogue,
+          typename = typename std::enable_if<
+              std::is_class<Epilogue>::value>::type>
+inline void MatrixMultiplyInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    matrix_library::utils::dense_matrix::Operation op_a,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::Operation op_b,
+    matrix_library::utils::dense_matrix::DenseMatrix<U>& C,
+    const Epilogue& epilogue) {
+  const bool transpose_a =
+      op_a == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const bool transpose_b =
+      op_b == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const size_t m = transpose_a ? A.num_cols() : A.num_rows();
+  const size_t k = transpose_a ? A.num_rows() : A.num_cols();
+  const size_t n = transpose_b ? B.num_rows() : B.num_cols();
+  if (k != (transpose_b ? B.num_cols() : B.num_rows())) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  if (static_cast<const void*>(&C) == static_cast<const void*>(&A) ||
+      static_cast<const void*>(&C) == static_cast<const void*>(&B)) {
+    throw std::runtime_error("Matrix C cannot be one of the inputs");
+  }
+  if (C.num_rows() != m || C.num_cols() != n) {
+    throw std::runtime_error("Matrix C has the wrong shape");
+  }
+  // Swapping the strides reads the stored matrix in transposed order. Small
+  // products also take the blocked kernel, it is the one with a store phase
+  matrix_library::cpu_simple::blocked_gemm::GemmEpilogue<T>(
+      m, n, k,
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+          A.data(), transpose_a ? 1 : A.leading_dimension(),
+          transpose_a ? A.leading_dimension() : 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+          B.data(), transpose_b ? 1 : B.leading_dimension(),
+          transpose_b ? B.leading_dimension() : 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<U>(
+          C.data(), C.leading_dimension()),
+      epilogue);
+}
+
+/**
+ * @brief Checks the shapes of C = A * B for a packed B
+ *
+ * @tparam T Any numeric type
+ * @tparam U Any numeric type of C
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A
+ */
+template <typename T, typename U>
+inline void ValidatePackedMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::cpu_simple::packed_matrix::PackedMatrix<T>& B,
+    const matrix_library::utils::dense_matrix::DenseMatrix<U>& C) {
+  if (A.num_cols() != B.num_rows()) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  if (static_cast<const void*>(&C) == static_cast<const void*>(&A)) {
+    throw std::runtime_error("Matrix C cannot be one of the inputs");
+  }
+  if (C.num_rows() != A.num_rows() || C.num_cols() != B.num_cols()) {
+    throw std::runtime_error("Matrix C has the wrong shape");
+  }
+}
+
+/**
+ * @brief Multiplies a contiguous matrix with a packed matrix into a
+ * preallocated matrix if possible otherwise it throws an error. B is not
+ * packed again, so repeated products with the same B only pack A
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Packed matrix B to be multipled in A * B
+ * @param C Matrix with as many rows as A and as many columns as B. Must not
+ * be A
+ * @param accumulate Add the product to C instead of overwriting it
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A
+ */
+template <typename T>
+inline void MatrixMultiplyInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::cpu_simple::packed_matrix::PackedMatrix<T>& B,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C,
+    bool accumulate = false) {
+  ValidatePackedMultiply(A, B, C);
+  const matrix_library::cpu_simple::blocked_gemm::StridedOperand<T> a(
+      A.data(), A.leading_dimension(), 1);
+  const matrix_library::cpu_simple::blocked_gemm::StridedOutput<T> c(
+      C.data(), C.leading_dimension());
+  // Panels packed for another micro-kernel are read element by element
+  if (B.MatchesKernel(
+          matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<T>())) {
+    matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+        A.num_rows(), B.num_cols(), B.num_rows(), a, B.panels(), c,
+        accumulate);
+  } else {
+    matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+        A.num_rows(), B.num_cols(), B.num_rows(), a,
+        matrix_library::cpu_simple::packed_matrix::PackedOperand<T>(B), c,
+        accumulate);
+  }
+}
+
+/**
+ * @brief Computes C = epilogue(A * B) for a contiguous matrix A and a packed
+ * matrix B if possible otherwise it throws an error. Neither B is packed
+ * again nor C read back, the serving path of a layer with fixed weights
+ *
+ * @tparam T Any numeric type of A and B, in which products are accumulated
+ * @tparam U Any numeric type of C
+ * @tparam Epilogue Callable taking (i, j, value) for element (i, j) of the
+ * product and returning what is stored in C
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Packed matrix B to be multipled in A * B
+ * @param C Matrix with as many rows as A and as many columns as B. Must not
+ * be A
+ * @param epilogue Epilogue applied to every element of the product
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ * @throws Runtime Error if C has the wrong shape or is A
+ */
+template <typename T, typename U, typename Epilogue,
+          typename = typename std::enable_if<
+              std::is_class<Epilogue>::value>::type>
+inline void MatrixMultiplyInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::cpu_simple::packed_matrix::PackedMatrix<T>& B,
+    matrix_library::utils::dense_matrix::DenseMatrix<U>& C,
+    const Epilogue& epilogue) {
+  ValidatePackedMultiply(A, B, C);
+  const matrix_library::cpu_simple::blocked_gemm::StridedOperand<T> a(
+      A.data(), A.leading_dimension(), 1);
+  const matrix_library::cpu_simple::blocked_gemm::StridedOutput<U> c(
+      C.data(), C.leading_dimension());
+  // Panels packed for another micro-kernel are read element by element
+  if (B.MatchesKernel(
+          matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<T>())) {
+    matrix_library::cpu_simple::blocked_gemm::GemmEpilogue<T>(
+        A.num_rows(), B.num_cols(), B.num_rows(), a, B.panels(), c, epilogue);
+  } else {
+    matrix_library::cpu_simple::blocked_gemm::GemmEpilogue<T>(
+        A.num_rows(), B.num_cols(), B.num_rows(), a,
+        matrix_library::cpu_simple::packed_matrix::PackedOperand<T>(B), c,
+        epilogue);
+  }
+}
+
+/**
+ * @brief Multiplies a contiguous matrix with a packed matrix if possible
+ * otherwise it throws an error
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Packed matrix B to be multipled in A * B
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that
+ * is equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::cpu_simple::packed_matrix::PackedMatrix<T>& B) {
+  if (A.num_cols() != B.num_rows()) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(
+      A.num_rows(), B.num_cols(),
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  MatrixMultiplyInto(A, B, C);
   return C;
 }
 
 /**
- * @brief Transposes matrix if possible
+ * @brief Multiplies 2 contiguous matrices, either of which can be read in
+ * transposed order, if possible otherwise it throws an error
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in op_a(A) * op_b(B)
+ * @param op_a Whether A is transposed
+ * @param B Matrix B to be multipled in op_a(A) * op_b(B)
+ * @param op_b Whether B is transposed
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to op_a(A) * op_b(B)
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    matrix_library::utils::dense_matrix::Operation op_a,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::Operation op_b) {
+  const bool transpose_a =
+      op_a == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const bool transpose_b =
+      op_b == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  if ((transpose_a ? A.num_rows() : A.num_cols()) !=
+      (transpose_b ? B.num_cols() : B.num_rows())) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  // Every element is overwritten so the output is left uninitialized
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(
+      transpose_a ? A.num_cols() : A.num_rows(),
+      transpose_b ? B.num_rows() : B.num_cols(),
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  MatrixMultiplyInto(A, op_a, B, op_b, C, false);
+  return C;
+}
+
+/**
+ * @brief Multiplies A^T * B without materializing A^T
+ *
+ * @tparam T Any numeric type
+ * @param A View of the transpose of a matrix
+ * @param B Matrix B
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::TransposeView<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B) {
+  return MatrixMultiply(
+      A.matrix(), matrix_library::utils::dense_matrix::Operation::kTranspose,
+      B, matrix_library::utils::dense_matrix::Operation::kNoTranspose);
+}
+
+/**
+ * @brief Multiplies A * B^T without materializing B^T
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param B View of the transpose of a matrix
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::TransposeView<T>& B) {
+  return MatrixMultiply(
+      A, matrix_library::utils::dense_matrix::Operation::kNoTranspose,
+      B.matrix(), matrix_library::utils::dense_matrix::Operation::kTranspose);
+}
+
+/**
+ * @brief Multiplies A^T * B^T without materializing either transpose
+ *
+ * @tparam T Any numeric type
+ * @param A View of the transpose of a matrix
+ * @param B View of the transpose of a matrix
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixMultiply(
+    const matrix_library::utils::dense_matrix::TransposeView<T>& A,
+    const matrix_library::utils::dense_matrix::TransposeView<T>& B) {
+  return MatrixMultiply(
+      A.matrix(), matrix_library::utils::dense_matrix::Operation::kTranspose,
+      B.matrix(), matrix_library::utils::dense_matrix::Operation::kTranspose);
+}
+
+/**
+ * @brief Computes the symmetric product op(A) * op(A)^T into a preallocated
+ * matrix. Only the triangle on and above the diagonal is multiplied and it is
+ * mirrored below, so it does about half the work of MatrixMultiply
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param op Whether A is transposed. kNoTranspose computes A * A^T and
+ * kTranspose computes A^T * A
+ * @param C Square matrix with as many rows as op(A). Set to op(A) * op(A)^T,
+ * or to C + op(A) * op(A)^T when accumulating, in which case C must be
+ * symmetric. Must not be A
+ * @param accumulate Add the product to C instead of overwriting it
+ * @throws Runtime Error if C has the wrong shape or is A
+ */
+template <typename T>
+inline void SymmetricRankKUpdateInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    matrix_library::utils::dense_matrix::Operation op,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C,
+    bool accumulate = false) {
+  const bool transpose =
+      op == matrix_library::utils::dense_matrix::Operation::kTranspose;
+  const size_t n = transpose ? A.num_cols() : A.num_rows();
+  const size_t k = transpose ? A.num_rows() : A.num_cols();
+  if (&C == &A) {
+    throw std::runtime_error("Matrix C cannot be one of the inputs");
+  }
+  if (C.num_rows() != n || C.num_cols() != n) {
+    throw std::runtime_error("Matrix C has the wrong shape");
+  }
+  matrix_library::cpu_simple::syrk::SymmetricRankK(
+      n, k, A.data(), transpose ? 1 : A.leading_dimension(),
+      transpose ? A.leading_dimension() : 1, C.data(), C.leading_dimension(),
+      accumulate);
+}
+
+/**
+ * @brief Computes the symmetric product op(A) * op(A)^T, the Gram matrix of
+ * the rows of op(A). Only one triangle is multiplied and it is mirrored, so it
+ * does about half the work of MatrixMultiply(A, Transposed(A))
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param op Whether A is transposed. kNoTranspose computes A * A^T and
+ * kTranspose computes A^T * A
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Symmetric
+ * matrix C that is equal to op(A) * op(A)^T
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T>
+SymmetricRankKUpdate(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    matrix_library::utils::dense_matrix::Operation op =
+        matrix_library::utils::dense_matrix::Operation::kNoTranspose) {
+  const size_t n =
+      op == matrix_library::utils::dense_matrix::Operation::kTranspose
+          ? A.num_cols()
+          : A.num_rows();
+  // Every element is written or mirrored so the output is left uninitialized
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(
+      n, n, matrix_library::utils::dense_matrix::UninitializedTag());
+  SymmetricRankKUpdateInto(A, op, C, false);
+  return C;
+}
+
+/**
+ * @brief Multiplies a chain of contiguous matrices in the cheapest order.
+ * The order is chosen by dynamic programming over a cost model of the kernels
+ * and intermediate buffers are reused as the chain is evaluated
+ *
+ * @tparam T Any numeric type
+ * @param matrices Matrices to multiply from left to right. Each must have as
+ * many columns as the next has rows
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Product of all
+ * the matrices
+ * @throws Runtime Error if the chain has no matrices
+ * @throws Runtime Error if consecutive matrices cannot multiply
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MultiplyChain(
+    const std::vector<std::reference_wrapper<
+        const matrix_library::utils::dense_matrix::DenseMatrix<T>>>&
+        matrices) {
+  if (matrices.empty()) {
+    throw std::runtime_error("Chain has no matrices");
+  }
+  std::vector<size_t> dims(1, matrices.front().get().num_rows());
+  for (const auto& matrix : matrices) {
+    if (matrix.get().num_rows() != dims.back()) {
+      throw std::runtime_error("Matrices in the chain cannot multiply");
+    }
+    dims.push_back(matrix.get().num_cols());
+  }
+  if (matrices.size() == 1) {
+    return matrices.front().get();
+  }
+  return matrix_library::cpu_simple::matrix_chain::Execute(
+      matrices, matrix_library::cpu_simple::matrix_chain::PlanChain(dims),
+      [](const std::vector<
+          matrix_library::cpu_simple::matrix_chain::ChainProduct<T>>&
+             products) {
+        for (const auto& product : products) {
+          MatrixMultiplyInto(*product.left, *product.right, *product.out);
+        }
+      });
+}
+
+/**
+ * @brief Multiplies a chain of contiguous matrices in the cheapest order, as
+ * in MultiplyChain({std::cref(A), std::cref(B), std::cref(C)})
+ *
+ * @tparam T Any numeric type
+ * @param matrices Matrices to multiply from left to right. Each must have as
+ * many columns as the next has rows
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Product of all
+ * the matrices
+ * @throws Runtime Error if the chain has no matrices
+ * @throws Runtime Error if consecutive matrices cannot multiply
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MultiplyChain(
+    std::initializer_list<std::reference_wrapper<
+        const matrix_library::utils::dense_matrix::DenseMatrix<T>>>
+        matrices) {
+  return MultiplyChain(std::vector<std::reference_wrapper<
+                           const matrix_library::utils::dense_matrix::
+                               DenseMatrix<T>>>(matrices));
+}
+
+/**
+ * @brief Computes the dot product of 2 vectors with the streaming kernel
+ *
+ * @tparam T Any numeric type
+ * @param x Vector x
+ * @param y Vector y with as many elements as x
+ * @return T Sum of x[i] * y[i]
+ * @throws Runtime Error if the vectors have different sizes
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline T Dot(const std::vector<T>& x, const std::vector<T>& y) {
+  if (x.size() != y.size()) {
+    throw std::runtime_error("Vectors x and y have different sizes");
+  }
+  return matrix_library::cpu_simple::vector_kernels::DefaultVectorKernels<
+      T>().dot(x.size(), x.data(), y.data());
+}
+
+/**
+ * @brief Multiplies a matrix with a vector, one dot product per row
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param x Vector with as many elements as A has columns
+ * @return std::vector<T> Vector y that is equal to A * x
+ * @throws Runtime Error if the matrix and vector cannot be multiplied
+ * @throws Runtime error if the matrix has a column mismatch
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline std::vector<T> MatrixVectorMultiply(
+    const std::vector<std::vector<T>>& A, const std::vector<T>& x) {
+  if (!matrix_library::utils::matrix_utils::IsMatrixFollowingDimensions(
+          A, x.size())) {
+    throw std::runtime_error("Matrix A and vector x cannot multiply");
+  }
+  std::vector<T> y(A.size());
+  matrix_library::cpu_simple::vector_kernels::MatrixVector<T>(
+      0, A.size(), x.size(), [&A](size_t i) { return A[i].data(); },
+      x.data(), [&y](size_t i) { return &y[i]; }, false);
+  return y;
+}
+
+/**
+ * @brief Multiplies a contiguous matrix with a vector, one dot product per row
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param x Vector with as many elements as A has columns
+ * @return std::vector<T> Vector y that is equal to A * x
+ * @throws Runtime Error if the matrix and vector cannot be multiplied
+ */
+template <typename T>
+inline std::vector<T> MatrixVectorMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const std::vector<T>& x) {
+  if (A.num_cols() != x.size()) {
+    throw std::runtime_error("Matrix A and vector x cannot multiply");
+  }
+  std::vector<T> y(A.num_rows());
+  matrix_library::cpu_simple::vector_kernels::MatrixVector<T>(
+      0, A.num_rows(), x.size(), [&A](size_t i) { return A.row(i); },
+      x.data(), [&y](size_t i) { return &y[i]; }, false);
+  return y;
+}
+
+/**
+ * @brief Computes the outer product x * y^T of 2 vectors by broadcasting each
+ * element of x over y
+ *
+ * @tparam T Any numeric type
+ * @param x Vector giving the rows
+ * @param y Vector giving the columns
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C with
+ * C(i, j) = x[i] * y[j]. An empty x gives a matrix with no rows and no columns
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> OuterProduct(
+    const std::vector<T>& x, const std::vector<T>& y) {
+  // A matrix with no rows cannot have columns
+  const size_t num_cols = x.empty() ? 0 : y.size();
+  // Every element is overwritten so the output is left uninitialized
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(
+      x.size(), num_cols,
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  matrix_library::cpu_simple::vector_kernels::OuterProduct<T>(
+      0, x.size(), num_cols, [&x](size_t i) { return x[i]; }, y.data(),
+      [&C](size_t i) { return C.row(i); }, false);
+  return C;
+}
+
+/**
+ * @brief Multiplies a batch of independent matrix pairs of the same shape,
+ * given as arrays of pointers to row-major blocks. Shapes are validated and
+ * the kernel is chosen once for the whole batch, small square shapes running
+ * kernels with their dimensions fixed at compile time. Nothing is allocated
+ *
+ * @tparam T Any numeric type
+ * @param m Number of rows in every A and C
+ * @param n Number of columns in every B and C
+ * @param k Number of columns in every A and rows in every B
+ * @param A Pointers to the A matrices
+ * @param lda Leading dimension of every A
+ * @param B Pointers to the B matrices, as many as A
+ * @param ldb Leading dimension of every B
+ * @param C Pointers to the C matrices, as many as A. Each is set to A * B, or
+ * to C + A * B when accumulating. Must not overlap each other, A or B
+ * @param ldc Leading dimension of every C
+ * @param accumulate Add the products to C instead of overwriting it
+ * @throws Runtime Error if the batches have different sizes
+ * @throws Runtime Error if a leading dimension is too small
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline void BatchedMatrixMultiply(size_t m, size_t n, size_t k,
+                                  const std::vector<const T*>& A, size_t lda,
+                                  const std::vector<const T*>& B, size_t ldb,
+                                  const std::vector<T*>& C, size_t ldc,
+                                  bool accumulate = false) {
+  if (A.size() != B.size() || A.size() != C.size()) {
+    throw std::runtime_error("Batches of A, B and C have different sizes");
+  }
+  // Pointer arrays place entries anywhere so no stride is checked
+  if (!matrix_library::cpu_simple::batched_gemm::IsValidBatchLayout(
+          m, n, k, lda, ldb, ldc, 1, 0)) {
+    throw std::runtime_error("Leading dimensions are too small");
+  }
+  matrix_library::cpu_simple::batched_gemm::Multiply<T>(
+      0, C.size(), m, n, k, [&A](size_t e) { return A[e]; }, lda,
+      [&B](size_t e) { return B[e]; }, ldb, [&C](size_t e) { return C[e]; },
+      ldc, accumulate);
+}
+
+/**
+ * @brief Multiplies a batch of independent matrix pairs of the same shape,
+ * stored as row-major blocks a fixed stride apart. Shapes are validated and
+ * the kernel is chosen once for the whole batch, small square shapes running
+ * kernels with their dimensions fixed at compile time. Nothing is allocated
+ *
+ * @tparam T Any numeric type
+ * @param batch_size Number of products
+ * @param m Number of rows in every A and C
+ * @param n Number of columns in every B and C
+ * @param k Number of columns in every A and rows in every B
+ * @param A First A matrix
+ * @param lda Leading dimension of every A
+ * @param stride_a Distance between consecutive A matrices. 0 uses the same A
+ * for every product
+ * @param B First B matrix
+ * @param ldb Leading dimension of every B
+ * @param stride_b Distance between consecutive B matrices. 0 uses the same B
+ * for every product
+ * @param C First C matrix. Each is set to A * B, or to C + A * B when
+ * accumulating. Must not overlap A or B
+ * @param ldc Leading dimension of every C
+ * @param stride_c Distance between consecutive C matrices
+ * @param accumulate Add the products to C instead of overwriting it
+ * @throws Runtime Error if a leading dimension is too small
+ * @throws Runtime Error if entries of C overlap
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline void BatchedMatrixMultiply(size_t batch_size, size_t m, size_t n,
+                                  size_t k, const T* A, size_t lda,
+                                  size_t stride_a, const T* B, size_t ldb,
+                                  size_t stride_b, T* C, size_t ldc,
+                                  size_t stride_c, bool accumulate = false) {
+  if (!matrix_library::cpu_simple::batched_gemm::IsValidBatchLayout(
+          m, n, k, lda, ldb, ldc, 1, 0)) {
+    throw std::runtime_error("Leading dimensions are too small");
+  }
+  if (!matrix_library::cpu_simple::batched_gemm::IsValidBatchLayout(
+          m, n, k, lda, ldb, ldc, batch_size, stride_c)) {
+    throw std::runtime_error("Entries of C overlap");
+  }
+  matrix_library::cpu_simple::batched_gemm::Multiply<T>(
+      0, batch_size, m, n, k,
+      [A, stride_a](size_t e) { return A + e * stride_a; }, lda,
+      [B, stride_b](size_t e) { return B + e * stride_b; }, ldb,
+      [C, stride_c](size_t e) { return C + e * stride_c; }, ldc, accumulate);
+}
+
+/**
+ * @brief Multiplies 2 contiguous matrices with the Winograd variant of
+ * Strassen's multiplication if possible otherwise it throws an error. Worth it
+ * for large square products. Floating point results can differ from
+ * MatrixMultiply in the last bits as the additions are reassociated
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @param crossover Dimension at or below which recursion stops and the blocked
+ * kernel is used
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Matrix C that is
+ * equal to A * B
+ * @throws Runtime Error if the 2 matrices cannot be multiplied
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> StrassenMultiply(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    size_t crossover =
+        matrix_library::cpu_simple::strassen::kDefaultStrassenCrossover) {
+  if (A.num_cols() != B.num_rows()) {
+    throw std::runtime_error("Matrices A and B cannot multiply");
+  }
+  // Every element is written by the recursion so the output is left
+  // uninitialized
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(
+      A.num_rows(), B.num_cols(),
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  matrix_library::cpu_simple::strassen::Multiply(
+      A.num_rows(), B.num_cols(), A.num_cols(), A.data(),
+      A.leading_dimension(), B.data(), B.leading_dimension(), C.data(),
+      C.leading_dimension(), crossover);
+  return C;
+}
+
+/**
+ * @brief Transposes matrix into a preallocated matrix if possible. The
+ * storage of the transposed matrix is reused so steady state loops do not
+ * allocate
  *
  * @tparam T Any numeric type
  * @param original_matrix 2D matrix that we will make a transpose of
- * @return std::vector<std::vector<T>> Transposed 2D matrix
+ * @param transposed_matrix 2D matrix with as many rows as the original matrix
+ * has columns and as many columns as it has rows. Must not be the original
+ * matrix
  * @throws Runtime error if the original matrix has no row
  * @throws Runtime error if the original matrix has no columns
  * @throws Runtime error if the original matrix has column count mismatch
+ * @throws Runtime error if the transposed matrix has the wrong shape or is the
+ * original matrix
  */
 template <typename T, typename = typename std::enable_if<
                           std::is_arithmetic<T>::value, T>::type>
-inline std::vector<std::vector<T>> MatrixTranspose(
-    const std::vector<std::vector<T>>& original_matrix) {
+inline void MatrixTransposeInto(
+    const std::vector<std::vector<T>>& original_matrix,
+    std::vector<std::vector<T>>& transposed_matrix) {
   // If matrix has no rows then this cannot be transposed
   if (matrix_library::utils::matrix_utils::IsMatrixEmpty(original_matrix)) {
     throw std::runtime_error("Original matrix has no rows");
@@ -100,22 +1085,175 @@ inline std::vector<std::vector<T>> MatrixTranspose(
           original_matrix, original_matrix.front().size())) {
     throw std::runtime_error("Original matrix has a column mismatch");
   }
+  if (&transposed_matrix == &original_matrix) {
+    throw std::runtime_error("Transposed matrix cannot be the original matrix");
+  }
+  // Transposed matrix needs transposed dimensions
+  if (transposed_matrix.size() != original_matrix.front().size() ||
+      !matrix_library::utils::matrix_utils::IsMatrixFollowingDimensions(
+          transposed_matrix, original_matrix.size())) {
+    throw std::runtime_error("Transposed matrix has the wrong shape");
+  }
+  // Storing every element in flipped location in transposed matrix
+  matrix_library::cpu_simple::simple_kernels::Transpose(
+      original_matrix, transposed_matrix,
+      matrix_library::cpu_simple::simple_kernels::DefaultAccess());
+}
+
+/**
+ * @brief Transposes matrix if possible
+ *
+ * @tparam T Any numeric type
+ * @param original_matrix 2D matrix that we will make a transpose of
+ * @return std::vector<std::vector<T>> Transposed 2D matrix
+ * @throws Runtime error if the original matrix has no row
+ * @throws Runtime error if the original matrix has no columns
+ * @throws Runtime error if the original matrix has column count mismatch
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline std::vector<std::vector<T>> MatrixTranspose(
+    const std::vector<std::vector<T>>& original_matrix) {
+  // If matrix has no rows then this cannot be transposed
+  if (matrix_library::utils::matrix_utils::IsMatrixEmpty(original_matrix)) {
+    throw std::runtime_error("Original matrix has no rows");
+  }
+  // If matrix has no columns then this cannot be transposed
+  if (matrix_library::utils::matrix_utils::IsVectorEmpty(
+          original_matrix.front())) {
+    throw std::runtime_error("Original matrix has no column");
+  }
   // Initialize a transposed matrix with transposed dimensions
   std::vector<std::vector<T>> transposed_matrix =
       matrix_library::utils::matrix_utils::CreateMatrix(
           original_matrix.front().size(), original_matrix.size(),
           static_cast<T>(0));
-  // Iterating through matrix elements
-  for (size_t i = 0; i < original_matrix.size(); i++) {
-    for (size_t j = 0; j < original_matrix.front().size(); j++) {
-      // Storing element in flipped location in transposed matrix
-      transposed_matrix.at(j).at(i) = original_matrix.at(i).at(j);
-    }
-  }
+  MatrixTransposeInto(original_matrix, transposed_matrix);
   // Return transposed matrix
   return transposed_matrix;
 }
 
+/**
+ * @brief Transposes contiguous matrix into a preallocated matrix if possible.
+ * The storage of the transposed matrix is reused so steady state loops do not
+ * allocate
+ *
+ * @tparam T Any numeric type
+ * @param original_matrix Matrix that we will make a transpose of
+ * @param transposed_matrix Matrix with as many rows as the original matrix has
+ * columns and as many columns as it has rows. Must not be the original matrix
+ * @throws Runtime error if the original matrix has no row
+ * @throws Runtime error if the original matrix has no columns
+ * @throws Runtime error if the transposed matrix has the wrong shape or is the
+ * original matrix
+ */
+template <typename T>
+inline void MatrixTransposeInto(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& original_matrix,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& transposed_matrix) {
+  // If matrix has no rows then this cannot be transposed
+  if (original_matrix.empty()) {
+    throw std::runtime_error("Original matrix has no rows");
+  }
+  // If matrix has no columns then this cannot be transposed
+  if (original_matrix.num_cols() == 0) {
+    throw std::runtime_error("Original matrix has no column");
+  }
+  if (&transposed_matrix == &original_matrix) {
+    throw std::runtime_error("Transposed matrix cannot be the original matrix");
+  }
+  if (transposed_matrix.num_rows() != original_matrix.num_cols() ||
+      transposed_matrix.num_cols() != original_matrix.num_rows()) {
+    throw std::runtime_error("Transposed matrix has the wrong shape");
+  }
+  matrix_library::cpu_simple::simple_kernels::Transpose(
+      original_matrix, transposed_matrix,
+      matrix_library::cpu_simple::simple_kernels::DefaultAccess());
+}
+
+/**
+ * @brief Transposes contiguous matrix if possible
+ *
+ * @tparam T Any numeric type
+ * @param original_matrix Matrix that we will make a transpose of
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Transposed
+ * matrix
+ * @throws Runtime error if the original matrix has no row
+ * @throws Runtime error if the original matrix has no columns
+ */
+template <typename T>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> MatrixTranspose(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>&
+        original_matrix) {
+  // If matrix has no rows then this cannot be transposed
+  if (original_matrix.empty()) {
+    throw std::runtime_error("Original matrix has no rows");
+  }
+  // If matrix has no columns then this cannot be transposed
+  if (original_matrix.num_cols() == 0) {
+    throw std::runtime_error("Original matrix has no column");
+  }
+  // Every element is written below so the output is left uninitialized
+  matrix_library::utils::dense_matrix::DenseMatrix<T> transposed_matrix(
+      original_matrix.num_cols(), original_matrix.num_rows(),
+      matrix_library::utils::dense_matrix::UninitializedTag());
+  MatrixTransposeInto(original_matrix, transposed_matrix);
+  return transposed_matrix;
+}
+
+/**
+ * @brief Transposes a fixed size matrix. It can be evaluated at compile time
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows in the original matrix
+ * @tparam C Number of columns in the original matrix
+ * @param original_matrix Matrix that we will make a transpose of
+ * @return matrix_library::utils::fixed_matrix::Matrix<T, C, R> Transposed
+ * matrix
+ */
+template <typename T, size_t R, size_t C>
+constexpr matrix_library::utils::fixed_matrix::Matrix<T, C, R> MatrixTranspose(
+    const matrix_library::utils::fixed_matrix::Matrix<T, R, C>&
+        original_matrix) {
+  return matrix_library::utils::fixed_matrix::Transpose(original_matrix);
+}
+
+/**
+ * @brief Transposes contiguous matrix in place so no second matrix is
+ * allocated. Square matrices swap mirrored blocks and keep their leading
+ * dimension. Other shapes are permuted by following cycles, which needs a
+ * bitmap of one bit per element, and come back without row padding
+ *
+ * @tparam T Any numeric type
+ * @param matrix Matrix replaced by its transpose
+ * @throws Runtime error if the matrix has no row
+ * @throws Runtime error if the matrix has no columns
+ */
+template <typename T>
+inline void MatrixTransposeInPlace(
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& matrix) {
+  // If matrix has no rows then this cannot be transposed
+  if (matrix.empty()) {
+    throw std::runtime_error("Original matrix has no rows");
+  }
+  // If matrix has no columns then this cannot be transposed
+  if (matrix.num_cols() == 0) {
+    throw std::runtime_error("Original matrix has no column");
+  }
+  const size_t num_rows = matrix.num_rows();
+  const size_t num_cols = matrix.num_cols();
+  matrix_library::cpu_simple::transpose_kernels::TransposeInPlace(
+      num_rows, num_cols, matrix.data(), matrix.leading_dimension());
+  if (num_rows == num_cols) {
+    return;
+  }
+  // The buffer is only shrunk to the packed size so it is never reallocated
+  auto storage = matrix.ReleaseStorage();
+  storage.resize(num_rows * num_cols);
+  matrix = matrix_library::utils::dense_matrix::DenseMatrix<T>(
+      num_cols, num_rows, std::move(storage));
+}
+
 }  // namespace matrix_ops
 }  // namespace cpu_simple
 }  // namespace matrix_library
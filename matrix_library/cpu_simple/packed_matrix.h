@@ -0,0 +1,372 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the pre-packed matrix of the CPU simple
+ * version of library. A matrix that is the B of many products, like the
+ * weights of a model, is packed once into the micro-panel layout of the
+ * blocked kernel so products with it skip packing B. Packed matrices are
+ * immutable, can be shared read-only across threads and can be serialized
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__PACKED_MATRIX_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__PACKED_MATRIX_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/utils/dense_matrix.h"
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace packed_matrix {
+
+/**
+ * @brief First field of a serialized packed matrix
+ */
+constexpr uint64_t kPackedMatrixMagic = 0x4b4341504c54414dULL;
+
+/**
+ * @brief Version of the serialized layout
+ */
+constexpr uint64_t kPackedMatrixVersion = 1;
+
+/**
+ * @brief Elements read at a time from streams whose length is unknown
+ */
+constexpr size_t kPackedReadChunkElements = size_t{1} << 20;
+
+/**
+ * @brief Matrix packed once into the kc x nc blocks of nr wide micro-panels
+ * read by the blocked kernel. It remembers the block sizes and nr it was
+ * packed with, and products with it only skip packing when the micro-kernel
+ * in use has the same nr. It is read element by element otherwise, so a
+ * matrix packed on another machine still multiplies correctly
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class PackedMatrix {
+  static_assert(std::is_arithmetic<T>::value,
+                "PackedMatrix requires a numeric type");
+
+ public:
+  /// Contiguous storage type backing the panels
+  using Storage = std::vector<
+      T, matrix_library::utils::dense_matrix::DefaultInitAllocator<T>>;
+  using value_type = T;
+
+  /**
+   * @brief Creates an empty packed matrix with no rows and no columns
+   */
+  PackedMatrix() : num_rows_(0), num_cols_(0), kc_(1), nc_(1), nr_(1) {}
+
+  /**
+   * @brief Packs a matrix for the micro-kernel and block sizes that the
+   * blocked kernel uses on this machine
+   *
+   * @param B Matrix to pack
+   * @param op_b Whether B is packed transposed, as for weights stored with one
+   * row per output
+   */
+  explicit PackedMatrix(
+      const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+      matrix_library::utils::dense_matrix::Operation op_b =
+          matrix_library::utils::dense_matrix::Operation::kNoTranspose)
+      : PackedMatrix(B, op_b, DefaultLayout()) {}
+
+  /**
+   * @brief Packs a matrix for an explicit micro-panel width and block sizes
+   *
+   * @param B Matrix to pack
+   * @param op_b Whether B is packed transposed
+   * @param nr Width of the micro-panels
+   * @param blocks Block sizes. Only kc and nc are used
+   * @throws Runtime Error if nr or a block size is 0
+   */
+  PackedMatrix(const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+               matrix_library::utils::dense_matrix::Operation op_b, size_t nr,
+               const matrix_library::cpu_simple::blocked_gemm::BlockSizes&
+                   blocks)
+      : PackedMatrix(B, op_b, Layout{nr, blocks.kc, blocks.nc}) {}
+
+  /**
+   * @brief Number of rows of the packed matrix, the inner dimension of
+   * products with it
+   */
+  size_t num_rows() const { return num_rows_; }
+
+  /**
+   * @brief Number of columns of the packed matrix
+   */
+  size_t num_cols() const { return num_cols_; }
+
+  /**
+   * @brief Depth of the packed blocks
+   */
+  size_t kc() const { return kc_; }
+
+  /**
+   * @brief Width of the packed blocks, a multiple of nr
+   */
+  size_t nc() const { return nc_; }
+
+  /**
+   * @brief Width of the micro-panels
+   */
+  size_t nr() const { return nr_; }
+
+  /**
+   * @brief Packed elements, padded with zeros to whole micro-panels
+   */
+  const Storage& storage() const { return storage_; }
+
+  /**
+   * @brief Gets element (i, j) of the matrix that was packed
+   *
+   * @param i Row index
+   * @param j Column index
+   * @return T Element (i, j)
+   */
+  T operator()(size_t i, size_t j) const {
+    const size_t jc = j / nc_ * nc_;
+    const size_t cols = std::min(nc_, num_cols_ - jc);
+    const size_t pc = i / kc_ * kc_;
+    const size_t kc = std::min(kc_, num_rows_ - pc);
+    const size_t jr = (j - jc) / nr_ * nr_;
+    return storage_[jc * num_rows_ + pc * ((cols + nr_ - 1) / nr_ * nr_) +
+                    jr * kc + (i - pc) * nr_ + (j - jc - jr)];
+  }
+
+  /**
+   * @brief Checks if a micro-kernel reads the panels as they are
+   *
+   * @param kernel Micro-kernel
+   * @return true If the micro-kernel has the nr the matrix was packed with
+   * @return false If the matrix must be read element by element
+   */
+  bool MatchesKernel(
+      const matrix_library::cpu_simple::blocked_gemm::MicroKernel<T>& kernel)
+      const {
+    return kernel.nr == nr_;
+  }
+
+  /**
+   * @brief View of the panels for the blocked kernel
+   *
+   * @return matrix_library::cpu_simple::blocked_gemm::PrePackedPanels<T>
+   * Panels of the matrix
+   */
+  matrix_library::cpu_simple::blocked_gemm::PrePackedPanels<T> panels()
+      const {
+    return matrix_library::cpu_simple::blocked_gemm::PrePackedPanels<T>(
+        storage_.data(), num_rows_, kc_, nc_);
+  }
+
+  /**
+   * @brief Writes the matrix in a binary form read back by Deserialize. The
+   * form uses the byte order of the machine
+   *
+   * @param out Stream to write to
+   * @throws Runtime Error if the stream fails
+   */
+  void Serialize(std::ostream& out) const {
+    const uint64_t header[] = {kPackedMatrixMagic, kPackedMatrixVersion,
+                               TypeTag(),          num_rows_,
+                               num_cols_,          kc_,
+                               nc_,                nr_};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(storage_.data()),
+              static_cast<std::streamsize>(storage_.size() * sizeof(T)));
+    if (!out) {
+      throw std::runtime_error("Packed matrix could not be written");
+    }
+  }
+
+  /**
+   * @brief Reads a matrix written by Serialize
+   *
+   * @param in Stream to read from
+   * @return PackedMatrix Matrix that was written
+   * @throws Runtime Error if the stream does not hold a packed matrix of this
+   * element type
+   * @throws Runtime Error if the dimensions overflow or the stream is too
+   * short for them
+   */
+  static PackedMatrix Deserialize(std::istream& in) {
+    uint64_t header[8];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || header[0] != kPackedMatrixMagic ||
+        header[1] != kPackedMatrixVersion || header[2] != TypeTag() ||
+        header[5] == 0 || header[7] == 0 || header[6] == 0 ||
+        header[6] % header[7] != 0) {
+      throw std::runtime_error("Stream does not hold a packed matrix");
+    }
+    for (size_t field = 3; field < 8; field++) {
+      if (static_cast<uint64_t>(static_cast<size_t>(header[field])) !=
+          header[field]) {
+        throw std::runtime_error("Packed matrix is too large");
+      }
+    }
+    PackedMatrix packed;
+    packed.num_rows_ = static_cast<size_t>(header[3]);
+    packed.num_cols_ = static_cast<size_t>(header[4]);
+    packed.kc_ = static_cast<size_t>(header[5]);
+    packed.nc_ = static_cast<size_t>(header[6]);
+    packed.nr_ = static_cast<size_t>(header[7]);
+    // The padded size is checked before anything is allocated, so a corrupt
+    // header cannot leave the storage smaller than its dimensions
+    const size_t max_size = std::numeric_limits<size_t>::max();
+    const size_t max_bytes =
+        static_cast<size_t>(std::numeric_limits<std::streamsize>::max());
+    if (packed.num_cols_ > max_size - (packed.nr_ - 1)) {
+      throw std::runtime_error("Packed matrix is too large");
+    }
+    const size_t padded_cols =
+        (packed.num_cols_ + packed.nr_ - 1) / packed.nr_ * packed.nr_;
+    if (padded_cols != 0 &&
+        packed.num_rows_ > std::min(max_size, max_bytes) / sizeof(T) /
+                               padded_cols) {
+      throw std::runtime_error("Packed matrix is too large");
+    }
+    const size_t size = packed.PackedSize();
+    // Seekable streams are checked to hold every element up front. Others
+    // are read in chunks so a short stream fails before it is all allocated
+    const std::streamoff remaining = RemainingBytes(in);
+    if (remaining >= 0 &&
+        static_cast<size_t>(remaining) / sizeof(T) < size) {
+      throw std::runtime_error("Stream does not hold a packed matrix");
+    }
+    const size_t chunk = remaining >= 0 ? size : kPackedReadChunkElements;
+    for (size_t start = 0; start < size; start += chunk) {
+      const size_t count = std::min(chunk, size - start);
+      packed.storage_.resize(start + count);
+      in.read(reinterpret_cast<char*>(packed.storage_.data() + start),
+              static_cast<std::streamsize>(count * sizeof(T)));
+      if (!in) {
+        throw std::runtime_error("Stream does not hold a packed matrix");
+      }
+    }
+    return packed;
+  }
+
+ private:
+  /**
+   * @brief Gets the bytes left in a stream without moving it
+   *
+   * @param in Stream
+   * @return std::streamoff Bytes left, -1 if the stream cannot seek
+   */
+  static std::streamoff RemainingBytes(std::istream& in) {
+    const std::istream::pos_type position = in.tellg();
+    if (position == std::istream::pos_type(-1)) {
+      in.clear();
+      return -1;
+    }
+    in.seekg(0, std::ios::end);
+    const std::istream::pos_type end = in.tellg();
+    in.seekg(position);
+    if (!in || end == std::istream::pos_type(-1)) {
+      in.clear();
+      in.seekg(position);
+      return -1;
+    }
+    return end - position;
+  }
+
+  /**
+   * @brief Micro-panel width and block sizes of a packed matrix
+   */
+  struct Layout {
+    size_t nr;
+    size_t kc;
+    size_t nc;
+  };
+
+  static Layout DefaultLayout() {
+    const matrix_library::cpu_simple::blocked_gemm::MicroKernel<T> kernel =
+        matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<T>();
+    const matrix_library::cpu_simple::blocked_gemm::BlockSizes blocks =
+        matrix_library::cpu_simple::blocked_gemm::ComputeBlockSizes(
+            kernel, matrix_library::cpu_simple::blocked_gemm::GetCacheSizes());
+    return Layout{kernel.nr, blocks.kc, blocks.nc};
+  }
+
+  /**
+   * @brief Element size and kind, so a stream of another type is rejected
+   */
+  static uint64_t TypeTag() {
+    const uint64_t kind = std::is_floating_point<T>::value ? 1
+                          : std::is_signed<T>::value       ? 2
+                                                           : 3;
+    return kind << 32 | sizeof(T);
+  }
+
+  PackedMatrix(const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+               matrix_library::utils::dense_matrix::Operation op_b,
+               const Layout& layout)
+      : nr_(layout.nr) {
+    if (layout.nr == 0 || layout.kc == 0 || layout.nc == 0) {
+      throw std::runtime_error("Packing layout has an empty dimension");
+    }
+    const bool transpose_b =
+        op_b == matrix_library::utils::dense_matrix::Operation::kTranspose;
+    num_rows_ = transpose_b ? B.num_cols() : B.num_rows();
+    num_cols_ = transpose_b ? B.num_rows() : B.num_cols();
+    // Same rounding as the blocked kernel so the blocks line up with its own
+    kc_ = layout.kc;
+    nc_ = (layout.nc + nr_ - 1) / nr_ * nr_;
+    storage_.resize(PackedSize());
+    // Swapping the strides reads the stored matrix in transposed order
+    matrix_library::cpu_simple::blocked_gemm::PackPanels(
+        matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+            B.data(), transpose_b ? 1 : B.leading_dimension(),
+            transpose_b ? B.leading_dimension() : 1),
+        num_rows_, num_cols_, kc_, nc_, nr_, storage_.data());
+  }
+
+  size_t PackedSize() const {
+    return num_rows_ * ((num_cols_ + nr_ - 1) / nr_ * nr_);
+  }
+
+  size_t num_rows_;
+  size_t num_cols_;
+  size_t kc_;
+  size_t nc_;
+  size_t nr_;
+  Storage storage_;
+};
+
+/**
+ * @brief Operand reading a packed matrix element by element, for
+ * micro-kernels of another nr than the one it was packed with
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class PackedOperand {
+ public:
+  explicit PackedOperand(const PackedMatrix<T>& matrix) : matrix_(&matrix) {}
+
+  T operator()(size_t i, size_t j) const { return (*matrix_)(i, j); }
+
+ private:
+  const PackedMatrix<T>* matrix_;
+};
+
+}  // namespace packed_matrix
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
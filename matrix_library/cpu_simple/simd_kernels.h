@@ -0,0 +1,398 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the hand written SIMD micro-kernels used by
+ * the blocked matrix multiplication of the CPU simple version of library
+ *
+ * Every kernel follows the micro-kernel contract of blocked_gemm.h. It
+ * multiplies a packed MR x kc micro-panel of A with a packed kc x NR
+ * micro-panel of B and overwrites the MR x NR row-major tile. The accumulator
+ * tile is held entirely in vector registers: each step loads NR / width
+ * vectors of B, broadcasts the MR values of A and updates MR * NR / width
+ * accumulators. Kernels are compiled for their instruction set with target
+ * attributes, so one binary carries all of them and cpu_features.h picks one
+ * at runtime
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__SIMD_KERNELS_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__SIMD_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "matrix_library/cpu_simple/cpu_features.h"
+
+#ifdef MATRIX_LIBRARY_X86_SIMD
+#include <immintrin.h>
+
+#define MATRIX_LIBRARY_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define MATRIX_LIBRARY_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define MATRIX_LIBRARY_TARGET_AVX512 __attribute__((target("avx512f")))
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace simd_kernels {
+
+/**
+ * @brief SSE4.2 operations on 4 floats
+ */
+struct Sse42FloatOps {
+  using Scalar = float;
+  using Vector = __m128;
+  static constexpr size_t kWidth = 4;
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector Zero() { return _mm_setzero_ps(); }
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector Load(const Scalar* ptr) {
+    return _mm_loadu_ps(ptr);
+  }
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector Broadcast(Scalar value) {
+    return _mm_set1_ps(value);
+  }
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector MulAdd(Vector a, Vector b,
+                                                   Vector acc) {
+    return _mm_add_ps(_mm_mul_ps(a, b), acc);
+  }
+  MATRIX_LIBRARY_TARGET_SSE42 static void Store(Scalar* ptr, Vector value) {
+    _mm_storeu_ps(ptr, value);
+  }
+};
+
+/**
+ * @brief SSE4.2 operations on 2 doubles
+ */
+struct Sse42DoubleOps {
+  using Scalar = double;
+  using Vector = __m128d;
+  static constexpr size_t kWidth = 2;
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector Zero() { return _mm_setzero_pd(); }
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector Load(const Scalar* ptr) {
+    return _mm_loadu_pd(ptr);
+  }
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector Broadcast(Scalar value) {
+    return _mm_set1_pd(value);
+  }
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector MulAdd(Vector a, Vector b,
+                                                   Vector acc) {
+    return _mm_add_pd(_mm_mul_pd(a, b), acc);
+  }
+  MATRIX_LIBRARY_TARGET_SSE42 static void Store(Scalar* ptr, Vector value) {
+    _mm_storeu_pd(ptr, value);
+  }
+};
+
+/**
+ * @brief SSE4.2 operations on 4 32 bit integers
+ */
+struct Sse42Int32Ops {
+  using Scalar = int32_t;
+  using Vector = __m128i;
+  static constexpr size_t kWidth = 4;
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector Zero() {
+    return _mm_setzero_si128();
+  }
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector Load(const Scalar* ptr) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+  }
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector Broadcast(Scalar value) {
+    return _mm_set1_epi32(value);
+  }
+  MATRIX_LIBRARY_TARGET_SSE42 static Vector MulAdd(Vector a, Vector b,
+                                                   Vector acc) {
+    return _mm_add_epi32(_mm_mullo_epi32(a, b), acc);
+  }
+  MATRIX_LIBRARY_TARGET_SSE42 static void Store(Scalar* ptr, Vector value) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), value);
+  }
+};
+
+/**
+ * @brief AVX2 operations on 8 floats using fused multiply-add
+ */
+struct Avx2FloatOps {
+  using Scalar = float;
+  using Vector = __m256;
+  static constexpr size_t kWidth = 8;
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector Zero() {
+    return _mm256_setzero_ps();
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector Load(const Scalar* ptr) {
+    return _mm256_loadu_ps(ptr);
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector Broadcast(Scalar value) {
+    return _mm256_set1_ps(value);
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector MulAdd(Vector a, Vector b,
+                                                  Vector acc) {
+    return _mm256_fmadd_ps(a, b, acc);
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static void Store(Scalar* ptr, Vector value) {
+    _mm256_storeu_ps(ptr, value);
+  }
+};
+
+/**
+ * @brief AVX2 operations on 4 doubles using fused multiply-add
+ */
+struct Avx2DoubleOps {
+  using Scalar = double;
+  using Vector = __m256d;
+  static constexpr size_t kWidth = 4;
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector Zero() {
+    return _mm256_setzero_pd();
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector Load(const Scalar* ptr) {
+    return _mm256_loadu_pd(ptr);
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector Broadcast(Scalar value) {
+    return _mm256_set1_pd(value);
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector MulAdd(Vector a, Vector b,
+                                                  Vector acc) {
+    return _mm256_fmadd_pd(a, b, acc);
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static void Store(Scalar* ptr, Vector value) {
+    _mm256_storeu_pd(ptr, value);
+  }
+};
+
+/**
+ * @brief AVX2 operations on 8 32 bit integers
+ */
+struct Avx2Int32Ops {
+  using Scalar = int32_t;
+  using Vector = __m256i;
+  static constexpr size_t kWidth = 8;
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector Zero() {
+    return _mm256_setzero_si256();
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector Load(const Scalar* ptr) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector Broadcast(Scalar value) {
+    return _mm256_set1_epi32(value);
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static Vector MulAdd(Vector a, Vector b,
+                                                  Vector acc) {
+    return _mm256_add_epi32(_mm256_mullo_epi32(a, b), acc);
+  }
+  MATRIX_LIBRARY_TARGET_AVX2 static void Store(Scalar* ptr, Vector value) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), value);
+  }
+};
+
+/**
+ * @brief AVX-512 operations on 16 floats using fused multiply-add
+ */
+struct Avx512FloatOps {
+  using Scalar = float;
+  using Vector = __m512;
+  static constexpr size_t kWidth = 16;
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector Zero() {
+    return _mm512_setzero_ps();
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector Load(const Scalar* ptr) {
+    return _mm512_loadu_ps(ptr);
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector Broadcast(Scalar value) {
+    return _mm512_set1_ps(value);
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector MulAdd(Vector a, Vector b,
+                                                    Vector acc) {
+    return _mm512_fmadd_ps(a, b, acc);
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static void Store(Scalar* ptr, Vector value) {
+    _mm512_storeu_ps(ptr, value);
+  }
+};
+
+/**
+ * @brief AVX-512 operations on 8 doubles using fused multiply-add
+ */
+struct Avx512DoubleOps {
+  using Scalar = double;
+  using Vector = __m512d;
+  static constexpr size_t kWidth = 8;
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector Zero() {
+    return _mm512_setzero_pd();
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector Load(const Scalar* ptr) {
+    return _mm512_loadu_pd(ptr);
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector Broadcast(Scalar value) {
+    return _mm512_set1_pd(value);
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector MulAdd(Vector a, Vector b,
+                                                    Vector acc) {
+    return _mm512_fmadd_pd(a, b, acc);
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static void Store(Scalar* ptr, Vector value) {
+    _mm512_storeu_pd(ptr, value);
+  }
+};
+
+/**
+ * @brief AVX-512 operations on 16 32 bit integers
+ */
+struct Avx512Int32Ops {
+  using Scalar = int32_t;
+  using Vector = __m512i;
+  static constexpr size_t kWidth = 16;
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector Zero() {
+    return _mm512_setzero_si512();
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector Load(const Scalar* ptr) {
+    return _mm512_loadu_si512(ptr);
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector Broadcast(Scalar value) {
+    return _mm512_set1_epi32(value);
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static Vector MulAdd(Vector a, Vector b,
+                                                    Vector acc) {
+    return _mm512_add_epi32(_mm512_mullo_epi32(a, b), acc);
+  }
+  MATRIX_LIBRARY_TARGET_AVX512 static void Store(Scalar* ptr, Vector value) {
+    _mm512_storeu_si512(ptr, value);
+  }
+};
+
+// The three kernel bodies below are identical apart from the target attribute,
+// which has to be spelled out on each function that uses the vector types
+
+/**
+ * @brief Register blocked MR x (NV * width) micro-kernel for SSE4.2
+ *
+ * @tparam Ops One of the Sse42 operation sets
+ * @tparam MR Rows in the tile
+ * @tparam NV Vectors per row of the tile
+ */
+template <typename Ops, size_t MR, size_t NV>
+MATRIX_LIBRARY_TARGET_SSE42 inline void Sse42MicroKernel(
+    size_t kc, const typename Ops::Scalar* a_panel,
+    const typename Ops::Scalar* b_panel, typename Ops::Scalar* c_tile) {
+  typename Ops::Vector acc[MR][NV];
+#pragma GCC unroll 16
+  for (size_t r = 0; r < MR; r++) {
+#pragma GCC unroll 4
+    for (size_t v = 0; v < NV; v++) {
+      acc[r][v] = Ops::Zero();
+    }
+  }
+  for (size_t p = 0; p < kc; p++) {
+    typename Ops::Vector b[NV];
+#pragma GCC unroll 4
+    for (size_t v = 0; v < NV; v++) {
+      b[v] = Ops::Load(b_panel + v * Ops::kWidth);
+    }
+#pragma GCC unroll 16
+    for (size_t r = 0; r < MR; r++) {
+      const typename Ops::Vector a = Ops::Broadcast(a_panel[r]);
+#pragma GCC unroll 4
+      for (size_t v = 0; v < NV; v++) {
+        acc[r][v] = Ops::MulAdd(a, b[v], acc[r][v]);
+      }
+    }
+    a_panel += MR;
+    b_panel += NV * Ops::kWidth;
+  }
+  for (size_t r = 0; r < MR; r++) {
+    for (size_t v = 0; v < NV; v++) {
+      Ops::Store(c_tile + (r * NV + v) * Ops::kWidth, acc[r][v]);
+    }
+  }
+}
+
+/**
+ * @brief Register blocked MR x (NV * width) micro-kernel for AVX2
+ *
+ * @tparam Ops One of the Avx2 operation sets
+ * @tparam MR Rows in the tile
+ * @tparam NV Vectors per row of the tile
+ */
+template <typename Ops, size_t MR, size_t NV>
+MATRIX_LIBRARY_TARGET_AVX2 inline void Avx2MicroKernel(
+    size_t kc, const typename Ops::Scalar* a_panel,
+    const typename Ops::Scalar* b_panel, typename Ops::Scalar* c_tile) {
+  typename Ops::Vector acc[MR][NV];
+#pragma GCC unroll 16
+  for (size_t r = 0; r < MR; r++) {
+#pragma GCC unroll 4
+    for (size_t v = 0; v < NV; v++) {
+      acc[r][v] = Ops::Zero();
+    }
+  }
+  for (size_t p = 0; p < kc; p++) {
+    typename Ops::Vector b[NV];
+#pragma GCC unroll 4
+    for (size_t v = 0; v < NV; v++) {
+      b[v] = Ops::Load(b_panel + v * Ops::kWidth);
+    }
+#pragma GCC unroll 16
+    for (size_t r = 0; r < MR; r++) {
+      const typename Ops::Vector a = Ops::Broadcast(a_panel[r]);
+#pragma GCC unroll 4
+      for (size_t v = 0; v < NV; v++) {
+        acc[r][v] = Ops::MulAdd(a, b[v], acc[r][v]);
+      }
+    }
+    a_panel += MR;
+    b_panel += NV * Ops::kWidth;
+  }
+  for (size_t r = 0; r < MR; r++) {
+    for (size_t v = 0; v < NV; v++) {
+      Ops::Store(c_tile + (r * NV + v) * Ops::kWidth, acc[r][v]);
+    }
+  }
+}
+
+/**
+ * @brief Register blocked MR x (NV * width) micro-kernel for AVX-512
+ *
+ * @tparam Ops One of the Avx512 operation sets
+ * @tparam MR Rows in the tile
+ * @tparam NV Vectors per row of the tile
+ */
+template <typename Ops, size_t MR, size_t NV>
+MATRIX_LIBRARY_TARGET_AVX512 inline void Avx512MicroKernel(
+    size_t kc, const typename Ops::Scalar* a_panel,
+    const typename Ops::Scalar* b_panel, typename Ops::Scalar* c_tile) {
+  typename Ops::Vector acc[MR][NV];
+#pragma GCC unroll 16
+  for (size_t r = 0; r < MR; r++) {
+#pragma GCC unroll 4
+    for (size_t v = 0; v < NV; v++) {
+      acc[r][v] = Ops::Zero();
+    }
+  }
+  for (size_t p = 0; p < kc; p++) {
+    typename Ops::Vector b[NV];
+#pragma GCC unroll 4
+    for (size_t v = 0; v < NV; v++) {
+      b[v] = Ops::Load(b_panel + v * Ops::kWidth);
+    }
+#pragma GCC unroll 16
+    for (size_t r = 0; r < MR; r++) {
+      const typename Ops::Vector a = Ops::Broadcast(a_panel[r]);
+#pragma GCC unroll 4
+      for (size_t v = 0; v < NV; v++) {
+        acc[r][v] = Ops::MulAdd(a, b[v], acc[r][v]);
+      }
+    }
+    a_panel += MR;
+    b_panel += NV * Ops::kWidth;
+  }
+  for (size_t r = 0; r < MR; r++) {
+    for (size_t v = 0; v < NV; v++) {
+      Ops::Store(c_tile + (r * NV + v) * Ops::kWidth, acc[r][v]);
+    }
+  }
+}
+
+}  // namespace simd_kernels
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif  // MATRIX_LIBRARY_X86_SIMD
+
+#endif
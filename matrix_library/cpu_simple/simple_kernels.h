@@ -0,0 +1,302 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the unblocked multiplication and
+ * transposition loops used by the CPU simple version of library, along with
+ * the bounds check policy they are compiled with
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__SIMPLE_KERNELS_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__SIMPLE_KERNELS_H_
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "matrix_library/cpu_simple/transpose_kernels.h"
+#include "matrix_library/utils/dense_matrix.h"
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace simple_kernels {
+
+/**
+ * @brief Policy that bounds checks every element access with .at()
+ */
+struct CheckedAccess {};
+
+/**
+ * @brief Policy that hoists row pointers out of the loops and indexes them
+ * directly. Shapes must already have been validated
+ */
+struct UncheckedAccess {};
+
+#ifdef MATRIX_LIBRARY_CHECKED_ACCESS
+/// Policy used by matrix_ops. Checked because MATRIX_LIBRARY_CHECKED_ACCESS
+/// is defined
+using DefaultAccess = CheckedAccess;
+#else
+/// Policy used by matrix_ops. Unchecked because MATRIX_LIBRARY_CHECKED_ACCESS
+/// is not defined
+using DefaultAccess = UncheckedAccess;
+#endif
+
+/**
+ * @brief Adds A * B to C with every access bounds checked
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A with at least one row
+ * @param B Matrix B with at least one row
+ * @param C Matrix C with A number of rows and B number of columns
+ */
+template <typename T>
+inline void MultiplyAccumulate(const std::vector<std::vector<T>>& A,
+                               const std::vector<std::vector<T>>& B,
+                               std::vector<std::vector<T>>& C, CheckedAccess) {
+  // i loops over every row in A
+  // k loops over every column in A and row in B
+  // j loops over every column in B
+  for (size_t i = 0; i < A.size(); i++) {
+    for (size_t k = 0; k < A.front().size(); k++) {
+      for (size_t j = 0; j < B.front().size(); j++) {
+        C.at(i).at(j) += (A.at(i).at(k) * B.at(k).at(j));
+      }
+    }
+  }
+}
+
+/**
+ * @brief Adds A * B to C using raw row pointers. The j loop has no bounds
+ * checks or double indirection so the compiler can vectorize it
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A with at least one row
+ * @param B Matrix B with at least one row
+ * @param C Matrix C with A number of rows and B number of columns
+ */
+template <typename T>
+inline void MultiplyAccumulate(const std::vector<std::vector<T>>& A,
+                               const std::vector<std::vector<T>>& B,
+                               std::vector<std::vector<T>>& C,
+                               UncheckedAccess) {
+  const size_t num_rows = A.size();
+  const size_t inner = B.size();
+  const size_t num_cols = B.front().size();
+  for (size_t i = 0; i < num_rows; i++) {
+    const T* a_row = A[i].data();
+    T* c_row = C[i].data();
+    for (size_t k = 0; k < inner; k++) {
+      const T a_ik = a_row[k];
+      const T* b_row = B[k].data();
+      for (size_t j = 0; j < num_cols; j++) {
+        c_row[j] += a_ik * b_row[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Adds A * B to C with every access bounds checked
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param B Matrix B with A number of columns as rows
+ * @param C Matrix C with A number of rows and B number of columns
+ */
+template <typename T>
+inline void MultiplyAccumulate(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C, CheckedAccess) {
+  for (size_t i = 0; i < A.num_rows(); i++) {
+    for (size_t k = 0; k < A.num_cols(); k++) {
+      for (size_t j = 0; j < B.num_cols(); j++) {
+        C.At(i, j) += A.At(i, k) * B.At(k, j);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Adds A * B to C using raw row pointers of the contiguous buffers
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param B Matrix B with A number of columns as rows
+ * @param C Matrix C with A number of rows and B number of columns
+ */
+template <typename T>
+inline void MultiplyAccumulate(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& C, UncheckedAccess) {
+  const size_t num_rows = A.num_rows();
+  const size_t inner = A.num_cols();
+  const size_t num_cols = B.num_cols();
+  for (size_t i = 0; i < num_rows; i++) {
+    const T* a_row = A.row(i);
+    T* c_row = C.row(i);
+    for (size_t k = 0; k < inner; k++) {
+      const T a_ik = a_row[k];
+      const T* b_row = B.row(k);
+      for (size_t j = 0; j < num_cols; j++) {
+        c_row[j] += a_ik * b_row[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Adds A * B to a row-major C reading A and B through operands, so
+ * either can be the transpose of what is stored
+ *
+ * @tparam T Any numeric type
+ * @tparam OpA Operand type of A
+ * @tparam OpB Operand type of B
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a Operand A
+ * @param b Operand B
+ * @param c C
+ * @param ldc Leading dimension of C
+ */
+template <typename T, typename OpA, typename OpB>
+inline void MultiplyAccumulate(size_t m, size_t n, size_t k, const OpA& a,
+                               const OpB& b, T* c, size_t ldc) {
+  for (size_t i = 0; i < m; i++) {
+    T* c_row = c + i * ldc;
+    for (size_t p = 0; p < k; p++) {
+      const T a_ip = a(i, p);
+      for (size_t j = 0; j < n; j++) {
+        c_row[j] += a_ip * b(p, j);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Writes the transpose of original into transposed with every access
+ * bounds checked
+ *
+ * @tparam T Any numeric type
+ * @param original Matrix with at least one row
+ * @param transposed Matrix with the flipped dimensions of original
+ */
+template <typename T>
+inline void Transpose(const std::vector<std::vector<T>>& original,
+                      std::vector<std::vector<T>>& transposed, CheckedAccess) {
+  for (size_t i = 0; i < original.size(); i++) {
+    for (size_t j = 0; j < original.front().size(); j++) {
+      // Storing element in flipped location in transposed matrix
+      transposed.at(j).at(i) = original.at(i).at(j);
+    }
+  }
+}
+
+/**
+ * @brief Writes the transpose of original into transposed using raw row
+ * pointers. Square blocks are done one at a time so the rows of both matrices
+ * they touch stay in cache
+ *
+ * @tparam T Any numeric type
+ * @param original Matrix with at least one row
+ * @param transposed Matrix with the flipped dimensions of original
+ */
+template <typename T>
+inline void Transpose(const std::vector<std::vector<T>>& original,
+                      std::vector<std::vector<T>>& transposed,
+                      UncheckedAccess) {
+  const size_t block =
+      matrix_library::cpu_simple::transpose_kernels::kTransposeLeaf;
+  const size_t num_rows = original.size();
+  const size_t num_cols = original.front().size();
+  for (size_t row_start = 0; row_start < num_rows; row_start += block) {
+    const size_t row_end = std::min(row_start + block, num_rows);
+    for (size_t col_start = 0; col_start < num_cols; col_start += block) {
+      const size_t col_end = std::min(col_start + block, num_cols);
+      for (size_t i = row_start; i < row_end; i++) {
+        const T* row = original[i].data();
+        for (size_t j = col_start; j < col_end; j++) {
+          transposed[j][i] = row[j];
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Writes the transpose of a matrix of bools, whose packed rows have no
+ * data(), through operator[] in the same blocked order
+ *
+ * @param original Matrix with at least one row
+ * @param transposed Matrix with the flipped dimensions of original
+ */
+inline void Transpose(const std::vector<std::vector<bool>>& original,
+                      std::vector<std::vector<bool>>& transposed,
+                      UncheckedAccess) {
+  const size_t block =
+      matrix_library::cpu_simple::transpose_kernels::kTransposeLeaf;
+  const size_t num_rows = original.size();
+  const size_t num_cols = original.front().size();
+  for (size_t row_start = 0; row_start < num_rows; row_start += block) {
+    const size_t row_end = std::min(row_start + block, num_rows);
+    for (size_t col_start = 0; col_start < num_cols; col_start += block) {
+      const size_t col_end = std::min(col_start + block, num_cols);
+      for (size_t i = row_start; i < row_end; i++) {
+        const std::vector<bool>& row = original[i];
+        for (size_t j = col_start; j < col_end; j++) {
+          transposed[j][i] = row[j];
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Writes the transpose of original into transposed with every access
+ * bounds checked
+ *
+ * @tparam T Any numeric type
+ * @param original Matrix to transpose
+ * @param transposed Matrix with the flipped dimensions of original
+ */
+template <typename T>
+inline void Transpose(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& original,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& transposed,
+    CheckedAccess) {
+  for (size_t i = 0; i < original.num_rows(); i++) {
+    for (size_t j = 0; j < original.num_cols(); j++) {
+      transposed.At(j, i) = original.At(i, j);
+    }
+  }
+}
+
+/**
+ * @brief Writes the transpose of original into transposed using raw pointers
+ * into the contiguous buffers. Runs the cache-oblivious tiled transpose
+ *
+ * @tparam T Any numeric type
+ * @param original Matrix to transpose
+ * @param transposed Matrix with the flipped dimensions of original
+ */
+template <typename T>
+inline void Transpose(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& original,
+    matrix_library::utils::dense_matrix::DenseMatrix<T>& transposed,
+    UncheckedAccess) {
+  matrix_library::cpu_simple::transpose_kernels::Transpose(
+      original.num_rows(), original.num_cols(), original.data(),
+      original.leading_dimension(), transposed.data(),
+      transposed.leading_dimension());
+}
+
+}  // namespace simple_kernels
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
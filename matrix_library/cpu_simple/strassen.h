@@ -0,0 +1,259 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the Winograd variant of Strassen's
+ * multiplication used by the CPU simple version of library. It does 7 half
+ * sized products and 15 additions per level instead of 8 products and recurses
+ * until a crossover where the blocked kernel is faster
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__STRASSEN_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__STRASSEN_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/utils/dense_matrix.h"
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace strassen {
+
+/**
+ * @brief Products where any dimension is at most this run on the blocked
+ * kernel instead of recursing further. Below it the extra additions and
+ * memory traffic cost more than the saved multiplications
+ */
+constexpr size_t kDefaultStrassenCrossover = 1024;
+
+/**
+ * @brief Number of elements of workspace a product of the given shape needs.
+ * Every level holds one half sized quadrant of A, B and C while the 7
+ * recursive products share the workspace of the level below
+ *
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param crossover Dimension at or below which the blocked kernel is used
+ * @return size_t Number of elements of workspace needed
+ */
+inline size_t WorkspaceSize(size_t m, size_t n, size_t k, size_t crossover) {
+  size_t size = 0;
+  while (std::min(m, std::min(n, k)) > std::max<size_t>(crossover, 1)) {
+    m /= 2;
+    n /= 2;
+    k /= 2;
+    size += m * k + k * n + m * n;
+  }
+  return size;
+}
+
+/**
+ * @brief Computes out = x + y over a rows x cols block. out may be x or y
+ *
+ * @tparam T Any numeric type
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @param x First block
+ * @param ldx Leading dimension of x
+ * @param y Second block
+ * @param ldy Leading dimension of y
+ * @param out Sum
+ * @param ldo Leading dimension of out
+ */
+template <typename T>
+inline void Add(size_t rows, size_t cols, const T* x, size_t ldx, const T* y,
+                size_t ldy, T* out, size_t ldo) {
+  for (size_t i = 0; i < rows; i++) {
+    for (size_t j = 0; j < cols; j++) {
+      out[i * ldo + j] = x[i * ldx + j] + y[i * ldy + j];
+    }
+  }
+}
+
+/**
+ * @brief Computes out = x - y over a rows x cols block. out may be x or y
+ *
+ * @tparam T Any numeric type
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @param x First block
+ * @param ldx Leading dimension of x
+ * @param y Block subtracted from x
+ * @param ldy Leading dimension of y
+ * @param out Difference
+ * @param ldo Leading dimension of out
+ */
+template <typename T>
+inline void Subtract(size_t rows, size_t cols, const T* x, size_t ldx,
+                     const T* y, size_t ldy, T* out, size_t ldo) {
+  for (size_t i = 0; i < rows; i++) {
+    for (size_t j = 0; j < cols; j++) {
+      out[i * ldo + j] = x[i * ldx + j] - y[i * ldy + j];
+    }
+  }
+}
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, with the blocked
+ * kernel on row-major blocks
+ *
+ * @tparam T Any numeric type
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a A
+ * @param lda Leading dimension of A
+ * @param b B
+ * @param ldb Leading dimension of B
+ * @param c C
+ * @param ldc Leading dimension of C
+ * @param accumulate Add the product to C instead of overwriting it
+ */
+template <typename T>
+inline void BaseMultiply(size_t m, size_t n, size_t k, const T* a, size_t lda,
+                         const T* b, size_t ldb, T* c, size_t ldc,
+                         bool accumulate) {
+  if (m == 0 || n == 0) {
+    return;
+  }
+  matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+      m, n, k,
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(a, lda, 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(b, ldb, 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(c, ldc),
+      accumulate);
+}
+
+/**
+ * @brief Computes C = A * B on row-major blocks. The even sized leading part
+ * recurses through the Winograd schedule and odd last rows, columns and inner
+ * index are peeled off and done with the blocked kernel
+ *
+ * @tparam T Any numeric type
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a A
+ * @param lda Leading dimension of A
+ * @param b B
+ * @param ldb Leading dimension of B
+ * @param c C. Must not overlap A or B
+ * @param ldc Leading dimension of C
+ * @param crossover Dimension at or below which the blocked kernel is used
+ * @param workspace At least WorkspaceSize(m, n, k, crossover) elements
+ */
+template <typename T>
+inline void Multiply(size_t m, size_t n, size_t k, const T* a, size_t lda,
+                     const T* b, size_t ldb, T* c, size_t ldc,
+                     size_t crossover, T* workspace) {
+  if (std::min(m, std::min(n, k)) <= std::max<size_t>(crossover, 1)) {
+    BaseMultiply(m, n, k, a, lda, b, ldb, c, ldc, false);
+    return;
+  }
+  const size_t hm = m / 2;
+  const size_t hn = n / 2;
+  const size_t hk = k / 2;
+  const T* a11 = a;
+  const T* a12 = a + hk;
+  const T* a21 = a + hm * lda;
+  const T* a22 = a21 + hk;
+  const T* b11 = b;
+  const T* b12 = b + hn;
+  const T* b21 = b + hk * ldb;
+  const T* b22 = b21 + hn;
+  T* c11 = c;
+  T* c12 = c + hn;
+  T* c21 = c + hm * ldc;
+  T* c22 = c21 + hn;
+  // Quadrant sized temporaries of this level. The rest of the workspace is
+  // reused by each of the 7 recursive products in turn
+  T* x = workspace;
+  T* y = x + hm * hk;
+  T* z = y + hk * hn;
+  T* next = z + hm * hn;
+
+  // C21 = M7 = (A11 - A21) * (B22 - B12)
+  Subtract(hm, hk, a11, lda, a21, lda, x, hk);
+  Subtract(hk, hn, b22, ldb, b12, ldb, y, hn);
+  Multiply(hm, hn, hk, x, hk, y, hn, c21, ldc, crossover, next);
+  // C22 = M5 = (A21 + A22) * (B12 - B11)
+  Add(hm, hk, a21, lda, a22, lda, x, hk);
+  Subtract(hk, hn, b12, ldb, b11, ldb, y, hn);
+  Multiply(hm, hn, hk, x, hk, y, hn, c22, ldc, crossover, next);
+  // C12 = M6 = (A21 + A22 - A11) * (B22 - B12 + B11)
+  Subtract(hm, hk, x, hk, a11, lda, x, hk);
+  Subtract(hk, hn, b22, ldb, y, hn, y, hn);
+  Multiply(hm, hn, hk, x, hk, y, hn, c12, ldc, crossover, next);
+  // C11 = M3 = (A12 - A21 - A22 + A11) * B22
+  Subtract(hm, hk, a12, lda, x, hk, x, hk);
+  Multiply(hm, hn, hk, x, hk, b22, ldb, c11, ldc, crossover, next);
+  // Z = M1 = A11 * B11
+  Multiply(hm, hn, hk, a11, lda, b11, ldb, z, hn, crossover, next);
+  // C12 = M1 + M6, C21 = M1 + M6 + M7, C12 = M1 + M6 + M5,
+  // C22 = M1 + M6 + M7 + M5 and finally C12 = M1 + M6 + M5 + M3
+  Add(hm, hn, z, hn, c12, ldc, c12, ldc);
+  Add(hm, hn, c12, ldc, c21, ldc, c21, ldc);
+  Add(hm, hn, c12, ldc, c22, ldc, c12, ldc);
+  Add(hm, hn, c21, ldc, c22, ldc, c22, ldc);
+  Add(hm, hn, c12, ldc, c11, ldc, c12, ldc);
+  // C11 = M4 = A22 * (B22 - B12 + B11 - B21), C21 = M1 + M6 + M7 - M4
+  Subtract(hk, hn, y, hn, b21, ldb, y, hn);
+  Multiply(hm, hn, hk, a22, lda, y, hn, c11, ldc, crossover, next);
+  Subtract(hm, hn, c21, ldc, c11, ldc, c21, ldc);
+  // C11 = M2 + M1 = A12 * B21 + A11 * B11
+  Multiply(hm, hn, hk, a12, lda, b21, ldb, c11, ldc, crossover, next);
+  Add(hm, hn, c11, ldc, z, hn, c11, ldc);
+
+  // Peel the odd last index of each dimension
+  const size_t em = 2 * hm;
+  const size_t en = 2 * hn;
+  const size_t ek = 2 * hk;
+  if (ek < k) {
+    BaseMultiply(em, en, k - ek, a + ek, lda, b + ek * ldb, ldb, c, ldc, true);
+  }
+  if (en < n) {
+    BaseMultiply(m, n - en, k, a, lda, b + en, ldb, c + en, ldc, false);
+  }
+  if (em < m) {
+    BaseMultiply(m - em, en, k, a + em * lda, lda, b, ldb, c + em * ldc, ldc,
+                 false);
+  }
+}
+
+/**
+ * @brief Computes C = A * B with the Winograd variant of Strassen's
+ * multiplication. The workspace for every level of recursion is allocated
+ * once up front
+ *
+ * @tparam T Any numeric type
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a A
+ * @param lda Leading dimension of A
+ * @param b B
+ * @param ldb Leading dimension of B
+ * @param c C. Must not overlap A or B
+ * @param ldc Leading dimension of C
+ * @param crossover Dimension at or below which the blocked kernel is used
+ */
+template <typename T>
+inline void Multiply(size_t m, size_t n, size_t k, const T* a, size_t lda,
+                     const T* b, size_t ldb, T* c, size_t ldc,
+                     size_t crossover) {
+  std::vector<T, matrix_library::utils::dense_matrix::DefaultInitAllocator<T>>
+      workspace(WorkspaceSize(m, n, k, crossover));
+  Multiply(m, n, k, a, lda, b, ldb, c, ldc, crossover, workspace.data());
+}
+
+}  // namespace strassen
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,190 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the symmetric rank-k update used by the
+ * CPU simple version of library. C = A * A^T is symmetric so only the blocks
+ * on and above the diagonal are multiplied and the rest is mirrored, which
+ * does a little over half the work of a general product
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__SYRK_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__SYRK_H_
+
+#include <algorithm>
+#include <cstddef>
+
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/cpu_simple/transpose_kernels.h"
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace syrk {
+
+/**
+ * @brief Copies the upper triangle of a square row-major block into its lower
+ * triangle. Blocks mirrored across the diagonal go through the transpose tile
+ * kernels
+ *
+ * @tparam T Any numeric type
+ * @param n Number of rows and columns of C
+ * @param c C
+ * @param ldc Leading dimension of C
+ */
+template <typename T>
+inline void MirrorUpper(size_t n, T* c, size_t ldc) {
+  const size_t leaf =
+      matrix_library::cpu_simple::transpose_kernels::kTransposeLeaf;
+  for (size_t ib = 0; ib < n; ib += leaf) {
+    const size_t rows = std::min(leaf, n - ib);
+    // Diagonal blocks mirror onto themselves
+    for (size_t i = 1; i < rows; i++) {
+      for (size_t j = 0; j < i; j++) {
+        c[(ib + i) * ldc + ib + j] = c[(ib + j) * ldc + ib + i];
+      }
+    }
+    const size_t cols = n - ib - rows;
+    if (cols > 0) {
+      matrix_library::cpu_simple::transpose_kernels::Transpose(
+          rows, cols, c + ib * ldc + ib + rows, ldc,
+          c + (ib + rows) * ldc + ib, ldc);
+    }
+  }
+}
+
+/**
+ * @brief Computes the upper triangle of C = A * A^T, or C += A * A^T when
+ * accumulating, with the blocked algorithm of the general product. B = A^T is
+ * packed once per block as usual but micro-tiles entirely below the diagonal
+ * are skipped, as are row blocks below a column block. Tiles crossing the
+ * diagonal are computed whole and leave their lower part to be mirrored over
+ *
+ * @tparam T Any numeric type
+ * @tparam Op Operand type of A
+ * @param n Number of rows in A and rows and columns in C
+ * @param k Number of columns in A
+ * @param a Operand A
+ * @param a_transposed Operand A^T
+ * @param c C
+ * @param ldc Leading dimension of C
+ * @param accumulate Add the product to C instead of overwriting it
+ */
+template <typename T, typename Op>
+inline void BlockedUpper(size_t n, size_t k, const Op& a,
+                         const Op& a_transposed, T* c, size_t ldc,
+                         bool accumulate) {
+  const matrix_library::cpu_simple::blocked_gemm::MicroKernel<T> kernel =
+      matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<T>();
+  static const matrix_library::cpu_simple::blocked_gemm::BlockSizes blocks =
+      matrix_library::cpu_simple::blocked_gemm::ComputeBlockSizes(
+          kernel, matrix_library::cpu_simple::blocked_gemm::GetCacheSizes());
+  const size_t mr = kernel.mr;
+  const size_t nr = kernel.nr;
+  // Same block rounding as the general product
+  const size_t mc_block =
+      std::max((blocks.mc + mr - 1) / mr, static_cast<size_t>(1)) * mr;
+  const size_t nc_block =
+      std::max((blocks.nc + nr - 1) / nr, static_cast<size_t>(1)) * nr;
+  const size_t kc_block = std::max(blocks.kc, static_cast<size_t>(1));
+  const size_t mc_max = std::min(mc_block, (n + mr - 1) / mr * mr);
+  const size_t nc_max = std::min(nc_block, (n + nr - 1) / nr * nr);
+  const size_t kc_max = std::min(kc_block, k);
+  const size_t packed_a_size = mc_max * kc_max;
+  const size_t packed_b_size = kc_max * nc_max;
+  T* const packed_a =
+      matrix_library::cpu_simple::blocked_gemm::ScratchBuffer<T>(
+          packed_a_size + packed_b_size + mr * nr);
+  T* const packed_b = packed_a + packed_a_size;
+  T* const tile = packed_b + packed_b_size;
+
+  for (size_t jc = 0; jc < n; jc += nc_block) {
+    const size_t nc = std::min(nc_block, n - jc);
+    // Rows past the last column of the block lie wholly below the diagonal
+    const size_t m = std::min(n, jc + nc);
+    for (size_t pc = 0; pc < k; pc += kc_block) {
+      const size_t kc = std::min(kc_block, k - pc);
+      const bool overwrite = pc == 0 && !accumulate;
+      matrix_library::cpu_simple::blocked_gemm::PackB(a_transposed, pc, jc, kc,
+                                                      nc, nr, packed_b);
+      for (size_t ic = 0; ic < m; ic += mc_block) {
+        const size_t mc = std::min(mc_block, m - ic);
+        matrix_library::cpu_simple::blocked_gemm::PackA(a, ic, pc, mc, kc, mr,
+                                                        packed_a);
+        for (size_t jr = 0; jr < nc; jr += nr) {
+          const size_t cols = std::min(nr, nc - jr);
+          const T* b_panel = packed_b + jr * kc;
+          // Micro-tiles starting below the last column of this panel are
+          // skipped
+          const size_t last_col = jc + jr + cols - 1;
+          for (size_t ir = 0; ir < mc && ic + ir <= last_col; ir += mr) {
+            const size_t rows = std::min(mr, mc - ir);
+            kernel.compute(kc, packed_a + ir * kc, b_panel, tile);
+            for (size_t r = 0; r < rows; r++) {
+              T* c_row = c + (ic + ir + r) * ldc + jc + jr;
+              const T* tile_row = tile + r * nr;
+              if (overwrite) {
+                std::copy(tile_row, tile_row + cols, c_row);
+              } else {
+                for (size_t col = 0; col < cols; col++) {
+                  c_row[col] += tile_row[col];
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Computes C = A * A^T, or C += A * A^T when accumulating, for an
+ * n x k operand A read with arbitrary strides. Passing the strides of a
+ * stored matrix swapped computes A^T * A instead
+ *
+ * @tparam T Any numeric type
+ * @param n Number of rows in A and rows and columns in C
+ * @param k Number of columns in A
+ * @param a A
+ * @param row_stride Distance between rows of A
+ * @param col_stride Distance between columns of A
+ * @param c C. Must not overlap A and must be symmetric when accumulating
+ * @param ldc Leading dimension of C
+ * @param accumulate Add the product to C instead of overwriting it
+ */
+template <typename T>
+inline void SymmetricRankK(size_t n, size_t k, const T* a, size_t row_stride,
+                           size_t col_stride, T* c, size_t ldc,
+                           bool accumulate) {
+  if (k > 0 &&
+      matrix_library::cpu_simple::blocked_gemm::UseBlockedGemm(n, n, k)) {
+    BlockedUpper(n, k,
+                 matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+                     a, row_stride, col_stride),
+                 matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+                     a, col_stride, row_stride),
+                 c, ldc, accumulate);
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      T* c_row = c + i * ldc;
+      if (!accumulate) {
+        std::fill(c_row + i, c_row + n, static_cast<T>(0));
+      }
+      for (size_t p = 0; p < k; p++) {
+        const T a_ip = a[i * row_stride + p * col_stride];
+        for (size_t j = i; j < n; j++) {
+          c_row[j] += a_ip * a[j * row_stride + p * col_stride];
+        }
+      }
+    }
+  }
+  MirrorUpper(n, c, ldc);
+}
+
+}  // namespace syrk
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,482 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the cache-oblivious transpose used by the
+ * CPU simple version of library
+ *
+ * The matrix is split in half along its longer side until both sides fit a
+ * leaf, so at some level of the recursion the source and destination blocks
+ * fit every cache level and TLB reach without knowing their sizes. A leaf is
+ * cut into small square tiles that are loaded row by row into vector
+ * registers, transposed there with unpack and shuffle instructions and stored
+ * row by row, so both sides are read and written a full vector at a time.
+ * Like the multiplication micro-kernels the tile kernels are compiled for
+ * their instruction set with target attributes and picked at runtime.
+ * In place transposes swap mirrored leaves for square matrices and follow the
+ * cycles of the permutation for other shapes
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__TRANSPOSE_KERNELS_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__TRANSPOSE_KERNELS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "matrix_library/cpu_simple/cpu_features.h"
+#include "matrix_library/cpu_simple/simd_kernels.h"
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace transpose_kernels {
+
+/**
+ * @brief Blocks with both sides at most this are transposed tile by tile
+ * instead of being split further. A leaf of doubles and its transpose take
+ * 64 KiB which stays within L2 and touches few enough pages for the TLB
+ */
+constexpr size_t kTransposeLeaf = 64;
+
+/**
+ * @brief Description of a square tile transpose
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+struct TransposeKernel {
+  /// Rows and columns of the tile
+  size_t tile;
+  /// Writes the transpose of the tile at in into out
+  void (*transpose)(const T* in, size_t ldi, T* out, size_t ldo);
+};
+
+/**
+ * @brief Portable tile transpose
+ *
+ * @tparam T Any numeric type
+ * @tparam Tile Rows and columns of the tile
+ * @param in Tile to transpose
+ * @param ldi Leading dimension of in
+ * @param out Transposed tile
+ * @param ldo Leading dimension of out
+ */
+template <typename T, size_t Tile>
+inline void ScalarTransposeTile(const T* in, size_t ldi, T* out, size_t ldo) {
+  for (size_t i = 0; i < Tile; i++) {
+    for (size_t j = 0; j < Tile; j++) {
+      out[j * ldo + i] = in[i * ldi + j];
+    }
+  }
+}
+
+#ifdef MATRIX_LIBRARY_X86_SIMD
+/**
+ * @brief Transposes a 4x4 tile of 32 bit elements in SSE registers
+ *
+ * @tparam T float or int32_t. Only the bits are moved
+ * @param in Tile to transpose
+ * @param ldi Leading dimension of in
+ * @param out Transposed tile
+ * @param ldo Leading dimension of out
+ */
+template <typename T>
+MATRIX_LIBRARY_TARGET_SSE42 inline void Sse42Transpose4x4(const T* in,
+                                                          size_t ldi, T* out,
+                                                          size_t ldo) {
+  static_assert(sizeof(T) == 4, "Tile transpose moves 32 bit elements");
+  const float* src = reinterpret_cast<const float*>(in);
+  float* dst = reinterpret_cast<float*>(out);
+  const __m128 r0 = _mm_loadu_ps(src);
+  const __m128 r1 = _mm_loadu_ps(src + ldi);
+  const __m128 r2 = _mm_loadu_ps(src + 2 * ldi);
+  const __m128 r3 = _mm_loadu_ps(src + 3 * ldi);
+  // Interleave pairs of rows then pick the halves holding each column
+  const __m128 t0 = _mm_unpacklo_ps(r0, r1);
+  const __m128 t1 = _mm_unpacklo_ps(r2, r3);
+  const __m128 t2 = _mm_unpackhi_ps(r0, r1);
+  const __m128 t3 = _mm_unpackhi_ps(r2, r3);
+  _mm_storeu_ps(dst, _mm_movelh_ps(t0, t1));
+  _mm_storeu_ps(dst + ldo, _mm_movehl_ps(t1, t0));
+  _mm_storeu_ps(dst + 2 * ldo, _mm_movelh_ps(t2, t3));
+  _mm_storeu_ps(dst + 3 * ldo, _mm_movehl_ps(t3, t2));
+}
+
+/**
+ * @brief Transposes a 2x2 tile of doubles in SSE registers
+ *
+ * @param in Tile to transpose
+ * @param ldi Leading dimension of in
+ * @param out Transposed tile
+ * @param ldo Leading dimension of out
+ */
+MATRIX_LIBRARY_TARGET_SSE42 inline void Sse42Transpose2x2(const double* in,
+                                                          size_t ldi,
+                                                          double* out,
+                                                          size_t ldo) {
+  const __m128d r0 = _mm_loadu_pd(in);
+  const __m128d r1 = _mm_loadu_pd(in + ldi);
+  _mm_storeu_pd(out, _mm_unpacklo_pd(r0, r1));
+  _mm_storeu_pd(out + ldo, _mm_unpackhi_pd(r0, r1));
+}
+
+/**
+ * @brief Transposes an 8x8 tile of 32 bit elements in AVX registers
+ *
+ * @tparam T float or int32_t. Only the bits are moved
+ * @param in Tile to transpose
+ * @param ldi Leading dimension of in
+ * @param out Transposed tile
+ * @param ldo Leading dimension of out
+ */
+template <typename T>
+MATRIX_LIBRARY_TARGET_AVX2 inline void Avx2Transpose8x8(const T* in,
+                                                        size_t ldi, T* out,
+                                                        size_t ldo) {
+  static_assert(sizeof(T) == 4, "Tile transpose moves 32 bit elements");
+  const float* src = reinterpret_cast<const float*>(in);
+  float* dst = reinterpret_cast<float*>(out);
+  __m256 r[8];
+  for (size_t i = 0; i < 8; i++) {
+    r[i] = _mm256_loadu_ps(src + i * ldi);
+  }
+  // Interleave pairs of rows, then pairs of pairs within each 128 bit lane
+  __m256 t[8];
+  for (size_t i = 0; i < 8; i += 2) {
+    t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+    t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+  }
+  __m256 s[8];
+  for (size_t i = 0; i < 8; i += 4) {
+    s[i] = _mm256_shuffle_ps(t[i], t[i + 2], 0x44);
+    s[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], 0xEE);
+    s[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+    s[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0xEE);
+  }
+  // Lanes hold the top and bottom halves of the rows so swap them across
+  for (size_t j = 0; j < 4; j++) {
+    _mm256_storeu_ps(dst + j * ldo,
+                     _mm256_permute2f128_ps(s[j], s[j + 4], 0x20));
+    _mm256_storeu_ps(dst + (j + 4) * ldo,
+                     _mm256_permute2f128_ps(s[j], s[j + 4], 0x31));
+  }
+}
+
+/**
+ * @brief Transposes a 4x4 tile of doubles in AVX registers
+ *
+ * @param in Tile to transpose
+ * @param ldi Leading dimension of in
+ * @param out Transposed tile
+ * @param ldo Leading dimension of out
+ */
+MATRIX_LIBRARY_TARGET_AVX2 inline void Avx2Transpose4x4(const double* in,
+                                                        size_t ldi, double* out,
+                                                        size_t ldo) {
+  const __m256d r0 = _mm256_loadu_pd(in);
+  const __m256d r1 = _mm256_loadu_pd(in + ldi);
+  const __m256d r2 = _mm256_loadu_pd(in + 2 * ldi);
+  const __m256d r3 = _mm256_loadu_pd(in + 3 * ldi);
+  const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+  const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+  const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+  const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+  _mm256_storeu_pd(out, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(out + ldo, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(out + 2 * ldo, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(out + 3 * ldo, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+#endif
+
+/**
+ * @brief Picks the tile transpose for a type and instruction set level. Types
+ * without SIMD kernels always get the portable one
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+struct TransposeKernelSelector {
+  static TransposeKernel<T> Select(
+      matrix_library::cpu_simple::cpu_features::SimdLevel) {
+    TransposeKernel<T> kernel = {8, &ScalarTransposeTile<T, 8>};
+    return kernel;
+  }
+};
+
+#ifdef MATRIX_LIBRARY_X86_SIMD
+/**
+ * @brief Tile transposes of 32 bit elements. 4x4 on SSE4.2 and 8x8 on AVX2
+ * and above
+ *
+ * @tparam T float or int32_t
+ */
+template <typename T>
+struct TransposeKernel32Selector {
+  static TransposeKernel<T> Select(
+      matrix_library::cpu_simple::cpu_features::SimdLevel level) {
+    using matrix_library::cpu_simple::cpu_features::SimdLevel;
+    TransposeKernel<T> kernel = {8, &ScalarTransposeTile<T, 8>};
+    if (level >= SimdLevel::kAvx2) {
+      kernel = {8, &Avx2Transpose8x8<T>};
+    } else if (level >= SimdLevel::kSse42) {
+      kernel = {4, &Sse42Transpose4x4<T>};
+    }
+    return kernel;
+  }
+};
+
+/**
+ * @brief Float tile transposes
+ */
+template <>
+struct TransposeKernelSelector<float> : TransposeKernel32Selector<float> {};
+
+/**
+ * @brief 32 bit integer tile transposes
+ */
+template <>
+struct TransposeKernelSelector<int32_t> : TransposeKernel32Selector<int32_t> {
+};
+
+/**
+ * @brief Double tile transposes. 2x2 on SSE4.2 and 4x4 on AVX2 and above
+ */
+template <>
+struct TransposeKernelSelector<double> {
+  static TransposeKernel<double> Select(
+      matrix_library::cpu_simple::cpu_features::SimdLevel level) {
+    using matrix_library::cpu_simple::cpu_features::SimdLevel;
+    TransposeKernel<double> kernel = {8, &ScalarTransposeTile<double, 8>};
+    if (level >= SimdLevel::kAvx2) {
+      kernel = {4, &Avx2Transpose4x4};
+    } else if (level >= SimdLevel::kSse42) {
+      kernel = {2, &Sse42Transpose2x2};
+    }
+    return kernel;
+  }
+};
+#endif
+
+/**
+ * @brief Tile transpose for a type at a given instruction set level
+ *
+ * @tparam T Any numeric type
+ * @param level Instruction set level. Must be supported by the CPU
+ * @return TransposeKernel<T> Tile transpose description
+ */
+template <typename T>
+inline TransposeKernel<T> TransposeKernelForLevel(
+    matrix_library::cpu_simple::cpu_features::SimdLevel level) {
+  return TransposeKernelSelector<T>::Select(level);
+}
+
+/**
+ * @brief Tile transpose used for a given type. The best one for the CPU the
+ * process runs on
+ *
+ * @tparam T Any numeric type
+ * @return TransposeKernel<T> Tile transpose description
+ */
+template <typename T>
+inline TransposeKernel<T> DefaultTransposeKernel() {
+  static const TransposeKernel<T> kernel = TransposeKernelForLevel<T>(
+      matrix_library::cpu_simple::cpu_features::GetSimdLevel());
+  return kernel;
+}
+
+/**
+ * @brief Transposes a leaf block tile by tile. Rows and columns left over
+ * past the last whole tile are copied element by element
+ *
+ * @tparam T Any numeric type
+ * @param rows Number of rows of in
+ * @param cols Number of columns of in
+ * @param in Block to transpose
+ * @param ldi Leading dimension of in
+ * @param out Transposed block
+ * @param ldo Leading dimension of out
+ * @param kernel Tile transpose
+ */
+template <typename T>
+inline void TransposeLeaf(size_t rows, size_t cols, const T* in, size_t ldi,
+                          T* out, size_t ldo,
+                          const TransposeKernel<T>& kernel) {
+  const size_t tile = kernel.tile;
+  const size_t row_tiles = rows / tile;
+  const size_t col_tiles = cols / tile;
+  for (size_t ti = 0; ti < row_tiles; ti++) {
+    for (size_t tj = 0; tj < col_tiles; tj++) {
+      kernel.transpose(in + ti * tile * ldi + tj * tile, ldi,
+                       out + tj * tile * ldo + ti * tile, ldo);
+    }
+  }
+  const size_t full_rows = row_tiles * tile;
+  const size_t full_cols = col_tiles * tile;
+  for (size_t i = 0; i < rows; i++) {
+    // Whole tiles covered the first full_cols columns of the first full_rows
+    const size_t col_start = i < full_rows ? full_cols : 0;
+    const T* in_row = in + i * ldi;
+    for (size_t j = col_start; j < cols; j++) {
+      out[j * ldo + i] = in_row[j];
+    }
+  }
+}
+
+/**
+ * @brief Transposes a block by halving its longer side until it is a leaf.
+ * Splits land on tile boundaries so only the last tile of each side is partial
+ *
+ * @tparam T Any numeric type
+ * @param rows Number of rows of in
+ * @param cols Number of columns of in
+ * @param in Block to transpose
+ * @param ldi Leading dimension of in
+ * @param out Transposed block
+ * @param ldo Leading dimension of out
+ * @param kernel Tile transpose
+ */
+template <typename T>
+inline void TransposeRecursive(size_t rows, size_t cols, const T* in,
+                               size_t ldi, T* out, size_t ldo,
+                               const TransposeKernel<T>& kernel) {
+  if (rows <= kTransposeLeaf && cols <= kTransposeLeaf) {
+    TransposeLeaf(rows, cols, in, ldi, out, ldo, kernel);
+    return;
+  }
+  if (rows >= cols) {
+    const size_t half = rows / 2 / kernel.tile * kernel.tile;
+    TransposeRecursive(half, cols, in, ldi, out, ldo, kernel);
+    TransposeRecursive(rows - half, cols, in + half * ldi, ldi, out + half,
+                       ldo, kernel);
+  } else {
+    const size_t half = cols / 2 / kernel.tile * kernel.tile;
+    TransposeRecursive(rows, half, in, ldi, out, ldo, kernel);
+    TransposeRecursive(rows, cols - half, in + half, ldi, out + half * ldo,
+                       ldo, kernel);
+  }
+}
+
+/**
+ * @brief Writes the transpose of a row-major block into another
+ *
+ * @tparam T Any numeric type
+ * @param rows Number of rows of in
+ * @param cols Number of columns of in
+ * @param in Block to transpose
+ * @param ldi Leading dimension of in
+ * @param out Transposed block with cols rows and rows columns. Must not
+ * overlap in
+ * @param ldo Leading dimension of out
+ */
+template <typename T>
+inline void Transpose(size_t rows, size_t cols, const T* in, size_t ldi,
+                      T* out, size_t ldo) {
+  TransposeRecursive(rows, cols, in, ldi, out, ldo,
+                     DefaultTransposeKernel<T>());
+}
+
+/**
+ * @brief Transposes a square block in place. The block is cut into leaves and
+ * each pair of leaves mirrored across the diagonal is swapped through a one
+ * leaf buffer, so every leaf is still transposed by the tile kernels
+ *
+ * @tparam T Any numeric type
+ * @param n Number of rows and columns of the block
+ * @param data Block to transpose
+ * @param ld Leading dimension of data
+ */
+template <typename T>
+inline void TransposeSquareInPlace(size_t n, T* data, size_t ld) {
+  const TransposeKernel<T> kernel = DefaultTransposeKernel<T>();
+  std::vector<T> buffer(kTransposeLeaf * kTransposeLeaf);
+  for (size_t ib = 0; ib < n; ib += kTransposeLeaf) {
+    const size_t rows = std::min(kTransposeLeaf, n - ib);
+    // The diagonal leaf is its own mirror so it goes out and back
+    T* diagonal = data + ib * ld + ib;
+    TransposeLeaf(rows, rows, diagonal, ld, buffer.data(), rows, kernel);
+    for (size_t i = 0; i < rows; i++) {
+      std::copy(buffer.data() + i * rows, buffer.data() + (i + 1) * rows,
+                diagonal + i * ld);
+    }
+    for (size_t jb = ib + kTransposeLeaf; jb < n; jb += kTransposeLeaf) {
+      const size_t cols = std::min(kTransposeLeaf, n - jb);
+      T* upper = data + ib * ld + jb;
+      T* lower = data + jb * ld + ib;
+      TransposeLeaf(rows, cols, upper, ld, buffer.data(), rows, kernel);
+      TransposeLeaf(cols, rows, lower, ld, upper, ld, kernel);
+      for (size_t i = 0; i < cols; i++) {
+        std::copy(buffer.data() + i * rows, buffer.data() + (i + 1) * rows,
+                  lower + i * ld);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Transposes a packed rows x cols matrix in place into a packed
+ * cols x rows matrix by following the cycles of the permutation. The element
+ * at k = i * cols + j moves to j * rows + i, and a bitmap with one bit per
+ * element marks the positions already placed so each cycle is walked once
+ *
+ * @tparam T Any numeric type
+ * @param rows Number of rows before the transpose
+ * @param cols Number of columns before the transpose
+ * @param data Packed row-major matrix with leading dimension cols, left with
+ * leading dimension rows
+ */
+template <typename T>
+inline void TransposeRectangularInPlace(size_t rows, size_t cols, T* data) {
+  const size_t size = rows * cols;
+  if (rows <= 1 || cols <= 1) {
+    // A single row or column has the same packed layout as its transpose
+    return;
+  }
+  std::vector<bool> placed(size, false);
+  // The first and last elements never move
+  for (size_t start = 1; start + 1 < size; start++) {
+    if (placed[start]) {
+      continue;
+    }
+    T carried = data[start];
+    size_t current = start;
+    do {
+      const size_t next = (current % cols) * rows + current / cols;
+      std::swap(carried, data[next]);
+      placed[next] = true;
+      current = next;
+    } while (current != start);
+  }
+}
+
+/**
+ * @brief Transposes a row-major matrix in place. Square matrices keep their
+ * leading dimension. Other shapes have their padding squeezed out first and
+ * come back packed with leading dimension rows
+ *
+ * @tparam T Any numeric type
+ * @param rows Number of rows before the transpose
+ * @param cols Number of columns before the transpose
+ * @param data Matrix to transpose
+ * @param ld Leading dimension of data before the transpose
+ */
+template <typename T>
+inline void TransposeInPlace(size_t rows, size_t cols, T* data, size_t ld) {
+  if (rows == cols) {
+    TransposeSquareInPlace(rows, data, ld);
+    return;
+  }
+  // Rows only ever move towards the front so they can be packed in order
+  for (size_t i = 1; i < rows && ld != cols; i++) {
+    std::copy(data + i * ld, data + i * ld + cols, data + i * cols);
+  }
+  TransposeRectangularInPlace(rows, cols, data);
+}
+
+}  // namespace transpose_kernels
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
@@ -0,0 +1,615 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the dot product, matrix-vector and outer
+ * product kernels used by the CPU simple version of library
+ *
+ * Products where one of the 3 dimensions is 1 do a single multiply-add per
+ * element loaded, so they are bound by memory bandwidth and gain nothing from
+ * the packing of the blocked kernel. They are instead built from 3 streaming
+ * kernels: a dot product that keeps several vector accumulators in flight, an
+ * axpy (y += alpha * x) and a scale (y = alpha * x) that broadcast one value
+ * over a row. Like the multiplication micro-kernels they are compiled for
+ * their instruction set with target attributes and picked at runtime
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__CPU_SIMPLE__VECTOR_KERNELS_H_
+#define MATRIX_LIBRARY__CPU_SIMPLE__VECTOR_KERNELS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/cpu_simple/cpu_features.h"
+#include "matrix_library/cpu_simple/simd_kernels.h"
+
+namespace matrix_library {
+namespace cpu_simple {
+namespace vector_kernels {
+
+/**
+ * @brief Independent accumulators a dot product keeps in flight so the
+ * latency of each multiply-add is hidden behind the others
+ */
+constexpr size_t kDotAccumulators = 4;
+
+/**
+ * @brief Streaming kernels for one type and instruction set
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+struct VectorKernels {
+  /// Returns the sum of x[i] * y[i] over n elements
+  T (*dot)(size_t n, const T* x, const T* y);
+  /// Computes y[i] += alpha * x[i] over n elements
+  void (*axpy)(size_t n, T alpha, const T* x, T* y);
+  /// Computes y[i] = alpha * x[i] over n elements
+  void (*scale)(size_t n, T alpha, const T* x, T* y);
+};
+
+/**
+ * @brief Portable dot product with independent accumulators
+ *
+ * @tparam T Any numeric type
+ * @param n Number of elements
+ * @param x First vector
+ * @param y Second vector
+ * @return T Dot product of x and y
+ */
+template <typename T>
+inline T ScalarDot(size_t n, const T* x, const T* y) {
+  T acc[kDotAccumulators] = {};
+  size_t i = 0;
+  for (; i + kDotAccumulators <= n; i += kDotAccumulators) {
+    for (size_t u = 0; u < kDotAccumulators; u++) {
+      acc[u] += x[i + u] * y[i + u];
+    }
+  }
+  for (; i < n; i++) {
+    acc[0] += x[i] * y[i];
+  }
+  T sum = static_cast<T>(0);
+  for (size_t u = 0; u < kDotAccumulators; u++) {
+    sum += acc[u];
+  }
+  return sum;
+}
+
+/**
+ * @brief Portable y += alpha * x
+ *
+ * @tparam T Any numeric type
+ * @param n Number of elements
+ * @param alpha Scale applied to x
+ * @param x Vector added
+ * @param y Vector updated
+ */
+template <typename T>
+inline void ScalarAxpy(size_t n, T alpha, const T* x, T* y) {
+  for (size_t i = 0; i < n; i++) {
+    y[i] += alpha * x[i];
+  }
+}
+
+/**
+ * @brief Portable y = alpha * x
+ *
+ * @tparam T Any numeric type
+ * @param n Number of elements
+ * @param alpha Scale applied to x
+ * @param x Vector scaled
+ * @param y Vector written
+ */
+template <typename T>
+inline void ScalarScale(size_t n, T alpha, const T* x, T* y) {
+  for (size_t i = 0; i < n; i++) {
+    y[i] = alpha * x[i];
+  }
+}
+
+#ifdef MATRIX_LIBRARY_X86_SIMD
+/**
+ * @brief SSE4.2 dot product with independent vector accumulators
+ *
+ * @tparam Ops One of the Sse42 operation sets
+ */
+template <typename Ops>
+MATRIX_LIBRARY_TARGET_SSE42 inline typename Ops::Scalar Sse42Dot(
+    size_t n, const typename Ops::Scalar* x, const typename Ops::Scalar* y) {
+  typename Ops::Vector acc[kDotAccumulators];
+#pragma GCC unroll 4
+  for (size_t u = 0; u < kDotAccumulators; u++) {
+    acc[u] = Ops::Zero();
+  }
+  size_t i = 0;
+  for (; i + kDotAccumulators * Ops::kWidth <= n;
+       i += kDotAccumulators * Ops::kWidth) {
+#pragma GCC unroll 4
+    for (size_t u = 0; u < kDotAccumulators; u++) {
+      acc[u] = Ops::MulAdd(Ops::Load(x + i + u * Ops::kWidth),
+                           Ops::Load(y + i + u * Ops::kWidth), acc[u]);
+    }
+  }
+  for (; i + Ops::kWidth <= n; i += Ops::kWidth) {
+    acc[0] = Ops::MulAdd(Ops::Load(x + i), Ops::Load(y + i), acc[0]);
+  }
+  typename Ops::Scalar lanes[Ops::kWidth];
+  typename Ops::Scalar sum = 0;
+  for (size_t u = 0; u < kDotAccumulators; u++) {
+    Ops::Store(lanes, acc[u]);
+    for (size_t l = 0; l < Ops::kWidth; l++) {
+      sum += lanes[l];
+    }
+  }
+  for (; i < n; i++) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+/**
+ * @brief SSE4.2 y += alpha * x
+ *
+ * @tparam Ops One of the Sse42 operation sets
+ */
+template <typename Ops>
+MATRIX_LIBRARY_TARGET_SSE42 inline void Sse42Axpy(
+    size_t n, typename Ops::Scalar alpha, const typename Ops::Scalar* x,
+    typename Ops::Scalar* y) {
+  const typename Ops::Vector a = Ops::Broadcast(alpha);
+  size_t i = 0;
+  for (; i + Ops::kWidth <= n; i += Ops::kWidth) {
+    Ops::Store(y + i, Ops::MulAdd(a, Ops::Load(x + i), Ops::Load(y + i)));
+  }
+  for (; i < n; i++) {
+    y[i] += alpha * x[i];
+  }
+}
+
+/**
+ * @brief SSE4.2 y = alpha * x
+ *
+ * @tparam Ops One of the Sse42 operation sets
+ */
+template <typename Ops>
+MATRIX_LIBRARY_TARGET_SSE42 inline void Sse42Scale(
+    size_t n, typename Ops::Scalar alpha, const typename Ops::Scalar* x,
+    typename Ops::Scalar* y) {
+  const typename Ops::Vector a = Ops::Broadcast(alpha);
+  size_t i = 0;
+  for (; i + Ops::kWidth <= n; i += Ops::kWidth) {
+    Ops::Store(y + i, Ops::MulAdd(a, Ops::Load(x + i), Ops::Zero()));
+  }
+  for (; i < n; i++) {
+    y[i] = alpha * x[i];
+  }
+}
+
+/**
+ * @brief AVX2 dot product with independent vector accumulators
+ *
+ * @tparam Ops One of the Avx2 operation sets
+ */
+template <typename Ops>
+MATRIX_LIBRARY_TARGET_AVX2 inline typename Ops::Scalar Avx2Dot(
+    size_t n, const typename Ops::Scalar* x, const typename Ops::Scalar* y) {
+  typename Ops::Vector acc[kDotAccumulators];
+#pragma GCC unroll 4
+  for (size_t u = 0; u < kDotAccumulators; u++) {
+    acc[u] = Ops::Zero();
+  }
+  size_t i = 0;
+  for (; i + kDotAccumulators * Ops::kWidth <= n;
+       i += kDotAccumulators * Ops::kWidth) {
+#pragma GCC unroll 4
+    for (size_t u = 0; u < kDotAccumulators; u++) {
+      acc[u] = Ops::MulAdd(Ops::Load(x + i + u * Ops::kWidth),
+                           Ops::Load(y + i + u * Ops::kWidth), acc[u]);
+    }
+  }
+  for (; i + Ops::kWidth <= n; i += Ops::kWidth) {
+    acc[0] = Ops::MulAdd(Ops::Load(x + i), Ops::Load(y + i), acc[0]);
+  }
+  typename Ops::Scalar lanes[Ops::kWidth];
+  typename Ops::Scalar sum = 0;
+  for (size_t u = 0; u < kDotAccumulators; u++) {
+    Ops::Store(lanes, acc[u]);
+    for (size_t l = 0; l < Ops::kWidth; l++) {
+      sum += lanes[l];
+    }
+  }
+  for (; i < n; i++) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+/**
+ * @brief AVX2 y += alpha * x
+ *
+ * @tparam Ops One of the Avx2 operation sets
+ */
+template <typename Ops>
+MATRIX_LIBRARY_TARGET_AVX2 inline void Avx2Axpy(size_t n,
+                                                typename Ops::Scalar alpha,
+                                                const typename Ops::Scalar* x,
+                                                typename Ops::Scalar* y) {
+  const typename Ops::Vector a = Ops::Broadcast(alpha);
+  size_t i = 0;
+  for (; i + Ops::kWidth <= n; i += Ops::kWidth) {
+    Ops::Store(y + i, Ops::MulAdd(a, Ops::Load(x + i), Ops::Load(y + i)));
+  }
+  for (; i < n; i++) {
+    y[i] += alpha * x[i];
+  }
+}
+
+/**
+ * @brief AVX2 y = alpha * x
+ *
+ * @tparam Ops One of the Avx2 operation sets
+ */
+template <typename Ops>
+MATRIX_LIBRARY_TARGET_AVX2 inline void Avx2Scale(size_t n,
+                                                 typename Ops::Scalar alpha,
+                                                 const typename Ops::Scalar* x,
+                                                 typename Ops::Scalar* y) {
+  const typename Ops::Vector a = Ops::Broadcast(alpha);
+  size_t i = 0;
+  for (; i + Ops::kWidth <= n; i += Ops::kWidth) {
+    Ops::Store(y + i, Ops::MulAdd(a, Ops::Load(x + i), Ops::Zero()));
+  }
+  for (; i < n; i++) {
+    y[i] = alpha * x[i];
+  }
+}
+
+/**
+ * @brief AVX-512 dot product with independent vector accumulators
+ *
+ * @tparam Ops One of the Avx512 operation sets
+ */
+template <typename Ops>
+MATRIX_LIBRARY_TARGET_AVX512 inline typename Ops::Scalar Avx512Dot(
+    size_t n, const typename Ops::Scalar* x, const typename Ops::Scalar* y) {
+  typename Ops::Vector acc[kDotAccumulators];
+#pragma GCC unroll 4
+  for (size_t u = 0; u < kDotAccumulators; u++) {
+    acc[u] = Ops::Zero();
+  }
+  size_t i = 0;
+  for (; i + kDotAccumulators * Ops::kWidth <= n;
+       i += kDotAccumulators * Ops::kWidth) {
+#pragma GCC unroll 4
+    for (size_t u = 0; u < kDotAccumulators; u++) {
+      acc[u] = Ops::MulAdd(Ops::Load(x + i + u * Ops::kWidth),
+                           Ops::Load(y + i + u * Ops::kWidth), acc[u]);
+    }
+  }
+  for (; i + Ops::kWidth <= n; i += Ops::kWidth) {
+    acc[0] = Ops::MulAdd(Ops::Load(x + i), Ops::Load(y + i), acc[0]);
+  }
+  typename Ops::Scalar lanes[Ops::kWidth];
+  typename Ops::Scalar sum = 0;
+  for (size_t u = 0; u < kDotAccumulators; u++) {
+    Ops::Store(lanes, acc[u]);
+    for (size_t l = 0; l < Ops::kWidth; l++) {
+      sum += lanes[l];
+    }
+  }
+  for (; i < n; i++) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+/**
+ * @brief AVX-512 y += alpha * x
+ *
+ * @tparam Ops One of the Avx512 operation sets
+ */
+template <typename Ops>
+MATRIX_LIBRARY_TARGET_AVX512 inline void Avx512Axpy(
+    size_t n, typename Ops::Scalar alpha, const typename Ops::Scalar* x,
+    typename Ops::Scalar* y) {
+  const typename Ops::Vector a = Ops::Broadcast(alpha);
+  size_t i = 0;
+  for (; i + Ops::kWidth <= n; i += Ops::kWidth) {
+    Ops::Store(y + i, Ops::MulAdd(a, Ops::Load(x + i), Ops::Load(y + i)));
+  }
+  for (; i < n; i++) {
+    y[i] += alpha * x[i];
+  }
+}
+
+/**
+ * @brief AVX-512 y = alpha * x
+ *
+ * @tparam Ops One of the Avx512 operation sets
+ */
+template <typename Ops>
+MATRIX_LIBRARY_TARGET_AVX512 inline void Avx512Scale(
+    size_t n, typename Ops::Scalar alpha, const typename Ops::Scalar* x,
+    typename Ops::Scalar* y) {
+  const typename Ops::Vector a = Ops::Broadcast(alpha);
+  size_t i = 0;
+  for (; i + Ops::kWidth <= n; i += Ops::kWidth) {
+    Ops::Store(y + i, Ops::MulAdd(a, Ops::Load(x + i), Ops::Zero()));
+  }
+  for (; i < n; i++) {
+    y[i] = alpha * x[i];
+  }
+}
+#endif
+
+/**
+ * @brief Picks the streaming kernels for a type and instruction set level.
+ * Types without SIMD kernels always get the portable ones
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+struct VectorKernelSelector {
+  static VectorKernels<T> Select(
+      matrix_library::cpu_simple::cpu_features::SimdLevel) {
+    VectorKernels<T> kernels = {&ScalarDot<T>, &ScalarAxpy<T>,
+                                &ScalarScale<T>};
+    return kernels;
+  }
+};
+
+#ifdef MATRIX_LIBRARY_X86_SIMD
+/**
+ * @brief Picks between the kernels built on one operation set per level
+ *
+ * @tparam Sse42Ops Operation set used on SSE4.2
+ * @tparam Avx2Ops Operation set used on AVX2
+ * @tparam Avx512Ops Operation set used on AVX-512
+ */
+template <typename Sse42Ops, typename Avx2Ops, typename Avx512Ops>
+struct SimdVectorKernelSelector {
+  using Scalar = typename Sse42Ops::Scalar;
+  static VectorKernels<Scalar> Select(
+      matrix_library::cpu_simple::cpu_features::SimdLevel level) {
+    using matrix_library::cpu_simple::cpu_features::SimdLevel;
+    VectorKernels<Scalar> kernels = {&ScalarDot<Scalar>, &ScalarAxpy<Scalar>,
+                                     &ScalarScale<Scalar>};
+    if (level >= SimdLevel::kAvx512) {
+      kernels = {&Avx512Dot<Avx512Ops>, &Avx512Axpy<Avx512Ops>,
+                 &Avx512Scale<Avx512Ops>};
+    } else if (level >= SimdLevel::kAvx2) {
+      kernels = {&Avx2Dot<Avx2Ops>, &Avx2Axpy<Avx2Ops>, &Avx2Scale<Avx2Ops>};
+    } else if (level >= SimdLevel::kSse42) {
+      kernels = {&Sse42Dot<Sse42Ops>, &Sse42Axpy<Sse42Ops>,
+                 &Sse42Scale<Sse42Ops>};
+    }
+    return kernels;
+  }
+};
+/**
+ * @brief Float kernels. 4, 8 and 16 wide on SSE4.2, AVX2 and AVX-512
+ */
+template <>
+struct VectorKernelSelector<float>
+    : SimdVectorKernelSelector<
+          matrix_library::cpu_simple::simd_kernels::Sse42FloatOps,
+          matrix_library::cpu_simple::simd_kernels::Avx2FloatOps,
+          matrix_library::cpu_simple::simd_kernels::Avx512FloatOps> {};
+
+/**
+ * @brief Double kernels. 2, 4 and 8 wide on SSE4.2, AVX2 and AVX-512
+ */
+template <>
+struct VectorKernelSelector<double>
+    : SimdVectorKernelSelector<
+          matrix_library::cpu_simple::simd_kernels::Sse42DoubleOps,
+          matrix_library::cpu_simple::simd_kernels::Avx2DoubleOps,
+          matrix_library::cpu_simple::simd_kernels::Avx512DoubleOps> {};
+
+/**
+ * @brief 32 bit integer kernels. 4, 8 and 16 wide on SSE4.2, AVX2 and
+ * AVX-512. Products wrap exactly like the scalar loop
+ */
+template <>
+struct VectorKernelSelector<int32_t>
+    : SimdVectorKernelSelector<
+          matrix_library::cpu_simple::simd_kernels::Sse42Int32Ops,
+          matrix_library::cpu_simple::simd_kernels::Avx2Int32Ops,
+          matrix_library::cpu_simple::simd_kernels::Avx512Int32Ops> {};
+#endif
+
+/**
+ * @brief Streaming kernels for a type at a given instruction set level
+ *
+ * @tparam T Any numeric type
+ * @param level Instruction set level. Must be supported by the CPU
+ * @return VectorKernels<T> Streaming kernels
+ */
+template <typename T>
+inline VectorKernels<T> VectorKernelsForLevel(
+    matrix_library::cpu_simple::cpu_features::SimdLevel level) {
+  return VectorKernelSelector<T>::Select(level);
+}
+
+/**
+ * @brief Streaming kernels used for a given type. The best ones for the CPU
+ * the process runs on
+ *
+ * @tparam T Any numeric type
+ * @return VectorKernels<T> Streaming kernels
+ */
+template <typename T>
+inline VectorKernels<T> DefaultVectorKernels() {
+  static const VectorKernels<T> kernels = VectorKernelsForLevel<T>(
+      matrix_library::cpu_simple::cpu_features::GetSimdLevel());
+  return kernels;
+}
+
+/**
+ * @brief Computes rows [row_start, row_end) of y = A * x, or y += A * x when
+ * accumulating, one dot product per row
+ *
+ * @tparam T Any numeric type
+ * @tparam RowA Callable returning a pointer to row i of A
+ * @tparam OutY Callable returning a pointer to element i of y
+ * @param row_start First row to compute
+ * @param row_end One past the last row to compute
+ * @param k Number of columns in A and elements in x
+ * @param a_row Rows of A
+ * @param x Contiguous vector x
+ * @param y_at Elements of y
+ * @param accumulate Add the product to y instead of overwriting it
+ */
+template <typename T, typename RowA, typename OutY>
+inline void MatrixVector(size_t row_start, size_t row_end, size_t k,
+                         const RowA& a_row, const T* x, const OutY& y_at,
+                         bool accumulate) {
+  const VectorKernels<T> kernels = DefaultVectorKernels<T>();
+  for (size_t i = row_start; i < row_end; i++) {
+    const T dot = kernels.dot(k, a_row(i), x);
+    T* out = y_at(i);
+    *out = accumulate ? *out + dot : dot;
+  }
+}
+
+/**
+ * @brief Computes rows [row_start, row_end) of C = x * y^T, or C += x * y^T
+ * when accumulating, by broadcasting x[i] over y for every row
+ *
+ * @tparam T Any numeric type
+ * @tparam ColX Callable returning element i of x
+ * @tparam RowC Callable returning a pointer to row i of C
+ * @param row_start First row to compute
+ * @param row_end One past the last row to compute
+ * @param n Number of elements in y and columns in C
+ * @param x_at Elements of x
+ * @param y Contiguous vector y
+ * @param c_row Rows of C
+ * @param accumulate Add the product to C instead of overwriting it
+ */
+template <typename T, typename ColX, typename RowC>
+inline void OuterProduct(size_t row_start, size_t row_end, size_t n,
+                         const ColX& x_at, const T* y, const RowC& c_row,
+                         bool accumulate) {
+  const VectorKernels<T> kernels = DefaultVectorKernels<T>();
+  for (size_t i = row_start; i < row_end; i++) {
+    if (accumulate) {
+      kernels.axpy(n, x_at(i), y, c_row(i));
+    } else {
+      kernels.scale(n, x_at(i), y, c_row(i));
+    }
+  }
+}
+
+/**
+ * @brief Computes the row vector c = x^T * B, or c += x^T * B when
+ * accumulating, as a sum of the rows of B scaled by x
+ *
+ * @tparam T Any numeric type
+ * @tparam RowB Callable returning a pointer to row p of B
+ * @param n Number of columns in B and elements in c
+ * @param k Number of rows in B and elements in x
+ * @param x Contiguous vector x
+ * @param b_row Rows of B
+ * @param c Contiguous row vector c
+ * @param accumulate Add the product to c instead of overwriting it
+ */
+template <typename T, typename RowB>
+inline void VectorMatrix(size_t n, size_t k, const T* x, const RowB& b_row,
+                         T* c, bool accumulate) {
+  const VectorKernels<T> kernels = DefaultVectorKernels<T>();
+  if (!accumulate) {
+    kernels.scale(n, x[0], b_row(0), c);
+  } else {
+    kernels.axpy(n, x[0], b_row(0), c);
+  }
+  for (size_t p = 1; p < k; p++) {
+    kernels.axpy(n, x[p], b_row(p), c);
+  }
+}
+
+/**
+ * @brief Copies column 0 of a matrix into a buffer so it can be streamed as a
+ * contiguous vector
+ *
+ * @tparam T Any numeric type
+ * @tparam RowB Callable returning a pointer to row p of the matrix
+ * @param k Number of rows
+ * @param b_row Rows of the matrix
+ * @param column Buffer of at least k elements owned by the caller, which
+ * decides how long the copy lives and which threads read it
+ * @return const T* The buffer holding the column
+ */
+template <typename T, typename RowB>
+inline const T* GatherColumn(size_t k, const RowB& b_row, T* column) {
+  for (size_t p = 0; p < k; p++) {
+    column[p] = b_row(p)[0];
+  }
+  return column;
+}
+
+/**
+ * @brief Checks if a product of the given shape is a dot product, a
+ * matrix-vector product or an outer product, which the streaming kernels
+ * handle better than the blocked kernel
+ *
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @return true If one of the dimensions is 1 and none is 0
+ * @return false Otherwise
+ */
+inline bool IsVectorShape(size_t m, size_t n, size_t k) {
+  return m != 0 && n != 0 && k != 0 && (m == 1 || n == 1 || k == 1);
+}
+
+/**
+ * @brief Computes C = A * B, or C += A * B when accumulating, for a product
+ * where IsVectorShape holds. An inner dimension of 1 is an outer product, a
+ * single column of B is a matrix-vector product (a dot product when A is a
+ * single row too) and a single row of A is a vector-matrix product. Shapes
+ * are assumed to be validated by the caller
+ *
+ * @tparam T Any numeric type
+ * @tparam RowA Callable returning a pointer to row i of A
+ * @tparam RowB Callable returning a pointer to row p of B
+ * @tparam RowC Callable returning a pointer to row i of C
+ * @param m Number of rows in A and C
+ * @param n Number of columns in B and C
+ * @param k Number of columns in A and rows in B
+ * @param a_row Rows of A
+ * @param b_row Rows of B
+ * @param c_row Rows of C
+ * @param accumulate Add the product to C instead of overwriting it
+ */
+template <typename T, typename RowA, typename RowB, typename RowC>
+inline void MultiplyVectorShape(size_t m, size_t n, size_t k,
+                                const RowA& a_row, const RowB& b_row,
+                                const RowC& c_row, bool accumulate) {
+  if (k == 1) {
+    OuterProduct<T>(
+        0, m, n, [&a_row](size_t i) { return a_row(i)[0]; }, b_row(0), c_row,
+        accumulate);
+  } else if (n == 1) {
+    // Only this thread reads the column, before any other product runs on it
+    MatrixVector<T>(
+        0, m, k, a_row,
+        GatherColumn<T>(
+            k, b_row,
+            matrix_library::cpu_simple::blocked_gemm::ScratchBuffer<T>(k)),
+        c_row, accumulate);
+  } else {
+    VectorMatrix<T>(n, k, a_row(0), b_row, c_row(0), accumulate);
+  }
+}
+
+}  // namespace vector_kernels
+}  // namespace cpu_simple
+}  // namespace matrix_library
+
+#endif
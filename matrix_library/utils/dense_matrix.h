@@ -0,0 +1,460 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the contiguous row-major dense matrix and
+ * its utilities
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__UTILS__DENSE_MATRIX_H_
+#define MATRIX_LIBRARY__UTILS__DENSE_MATRIX_H_
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace matrix_library {
+namespace utils {
+namespace dense_matrix {
+
+/**
+ * @brief Allocator that default initializes instead of value initializing.
+ * For numeric types this means resizing a buffer does not write to it, so
+ * kernels that overwrite every element do not pay for a zero fill first
+ *
+ * @tparam T Element type
+ * @tparam A Underlying allocator
+ */
+template <typename T, typename A = std::allocator<T>>
+class DefaultInitAllocator : public A {
+  using Traits = std::allocator_traits<A>;
+
+ public:
+  template <typename U>
+  struct rebind {
+    using other =
+        DefaultInitAllocator<U, typename Traits::template rebind_alloc<U>>;
+  };
+
+  using A::A;
+
+  template <typename U>
+  void construct(U* ptr) noexcept(
+      std::is_nothrow_default_constructible<U>::value) {
+    ::new (static_cast<void*>(ptr)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* ptr, Args&&... args) {
+    Traits::construct(static_cast<A&>(*this), ptr,
+                      std::forward<Args>(args)...);
+  }
+};
+
+/**
+ * @brief Tag used to request a matrix whose elements are left uninitialized
+ */
+struct UninitializedTag {};
+
+/**
+ * @brief Dense matrix stored in one contiguous row-major buffer. Element (i, j)
+ * lives at data()[i * leading_dimension() + j]. The leading dimension is at
+ * least the number of columns and lets rows be padded
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class DenseMatrix {
+  static_assert(std::is_arithmetic<T>::value,
+                "DenseMatrix requires a numeric type");
+
+ public:
+  /// Contiguous storage type backing the matrix
+  using Storage = std::vector<T, DefaultInitAllocator<T>>;
+  using value_type = T;
+
+  /**
+   * @brief Creates an empty matrix with no rows and no columns
+   */
+  DenseMatrix() : num_rows_(0), num_cols_(0), leading_dimension_(0) {}
+
+  /**
+   * @brief Creates a matrix of provided dimensions filled with the value
+   * provided
+   *
+   * @param num_rows Number of rows in matrix
+   * @param num_cols Number of columns in matrix
+   * @param value_to_fill Value to fill in matrix
+   * @throws Runtime error if we are trying to make a matrix with 0 rows and
+   * non zero columns
+   */
+  DenseMatrix(size_t num_rows, size_t num_cols,
+              T value_to_fill = static_cast<T>(0))
+      : DenseMatrix(num_rows, num_cols, num_cols, value_to_fill) {}
+
+  /**
+   * @brief Creates a matrix of provided dimensions with padded rows filled
+   * with the value provided
+   *
+   * @param num_rows Number of rows in matrix
+   * @param num_cols Number of columns in matrix
+   * @param leading_dimension Distance in elements between starts of rows
+   * @param value_to_fill Value to fill in matrix
+   * @throws Runtime error if we are trying to make a matrix with 0 rows and
+   * non zero columns
+   * @throws Runtime error if the leading dimension is less than the number of
+   * columns
+   */
+  DenseMatrix(size_t num_rows, size_t num_cols, size_t leading_dimension,
+              T value_to_fill)
+      : num_rows_(num_rows),
+        num_cols_(num_cols),
+        leading_dimension_(leading_dimension) {
+    ValidateDimensions();
+    storage_.resize(num_rows_ * leading_dimension_, value_to_fill);
+  }
+
+  /**
+   * @brief Creates a matrix of provided dimensions without initializing its
+   * elements. Meant for outputs that are fully overwritten
+   *
+   * @param num_rows Number of rows in matrix
+   * @param num_cols Number of columns in matrix
+   * @throws Runtime error if we are trying to make a matrix with 0 rows and
+   * non zero columns
+   */
+  DenseMatrix(size_t num_rows, size_t num_cols, UninitializedTag)
+      : num_rows_(num_rows),
+        num_cols_(num_cols),
+        leading_dimension_(num_cols) {
+    ValidateDimensions();
+    storage_.resize(num_rows_ * leading_dimension_);
+  }
+
+  /**
+   * @brief Adopts an existing row-major buffer without copying it
+   *
+   * @param num_rows Number of rows in matrix
+   * @param num_cols Number of columns in matrix
+   * @param storage Buffer holding num_rows * num_cols elements
+   * @throws Runtime error if the buffer size does not match the dimensions
+   */
+  DenseMatrix(size_t num_rows, size_t num_cols, Storage&& storage)
+      : num_rows_(num_rows),
+        num_cols_(num_cols),
+        leading_dimension_(num_cols),
+        storage_(std::move(storage)) {
+    ValidateDimensions();
+    if (storage_.size() != num_rows_ * leading_dimension_) {
+      throw std::runtime_error("Storage size does not match dimensions");
+    }
+  }
+
+  /**
+   * @brief Creates a matrix by evaluating a lazy expression, such as the ones
+   * built by the operators of cpu_simple::matrix_expressions
+   *
+   * @tparam Expression Type with an EvaluateInto(DenseMatrix<T>&) member
+   * @param expression Expression to evaluate
+   */
+  template <typename Expression,
+            typename = decltype(std::declval<const Expression&>().EvaluateInto(
+                std::declval<DenseMatrix&>()))>
+  DenseMatrix(const Expression& expression)  // NOLINT(runtime/explicit)
+      : DenseMatrix() {
+    expression.EvaluateInto(*this);
+  }
+
+  /**
+   * @brief Evaluates a lazy expression into this matrix, reusing its storage
+   * when the shape already matches
+   *
+   * @tparam Expression Type with an EvaluateInto(DenseMatrix<T>&) member
+   * @param expression Expression to evaluate
+   * @return DenseMatrix& This matrix
+   */
+  template <typename Expression,
+            typename = decltype(std::declval<const Expression&>().EvaluateInto(
+                std::declval<DenseMatrix&>()))>
+  DenseMatrix& operator=(const Expression& expression) {
+    expression.EvaluateInto(*this);
+    return *this;
+  }
+
+  size_t num_rows() const { return num_rows_; }
+  size_t num_cols() const { return num_cols_; }
+  size_t leading_dimension() const { return leading_dimension_; }
+
+  /**
+   * @brief Checks if matrix has no rows
+   */
+  bool empty() const { return num_rows_ == 0; }
+
+  T* data() { return storage_.data(); }
+  const T* data() const { return storage_.data(); }
+
+  /**
+   * @brief Pointer to the first element of a row. Not bounds checked
+   */
+  T* row(size_t i) { return storage_.data() + i * leading_dimension_; }
+  const T* row(size_t i) const {
+    return storage_.data() + i * leading_dimension_;
+  }
+
+  /**
+   * @brief Unchecked element access
+   */
+  T& operator()(size_t i, size_t j) { return row(i)[j]; }
+  const T& operator()(size_t i, size_t j) const { return row(i)[j]; }
+
+  /**
+   * @brief Bounds checked element access
+   *
+   * @throws Out of range error if the index is outside the matrix
+   */
+  T& At(size_t i, size_t j) {
+    CheckIndex(i, j);
+    return row(i)[j];
+  }
+  const T& At(size_t i, size_t j) const {
+    CheckIndex(i, j);
+    return row(i)[j];
+  }
+
+  /**
+   * @brief Hands back the underlying buffer without copying it and leaves the
+   * matrix empty
+   *
+   * @return Storage Buffer of num_rows * leading_dimension elements
+   */
+  Storage ReleaseStorage() {
+    Storage released = std::move(storage_);
+    storage_.clear();
+    num_rows_ = 0;
+    num_cols_ = 0;
+    leading_dimension_ = 0;
+    return released;
+  }
+
+ private:
+  void ValidateDimensions() const {
+    // If number of rows is 0 and number of columns > 0 then this is impossible
+    if (num_rows_ == 0 && num_cols_ != 0) {
+      throw std::runtime_error("Impossible Matrix received");
+    }
+    if (leading_dimension_ < num_cols_) {
+      throw std::runtime_error("Leading dimension smaller than columns");
+    }
+  }
+
+  void CheckIndex(size_t i, size_t j) const {
+    if (i >= num_rows_ || j >= num_cols_) {
+      throw std::out_of_range("DenseMatrix index out of range");
+    }
+  }
+
+  size_t num_rows_;
+  size_t num_cols_;
+  size_t leading_dimension_;
+  Storage storage_;
+};
+
+/**
+ * @brief How a multiplication reads one of its operands
+ */
+enum class Operation {
+  /// The operand is used as stored
+  kNoTranspose,
+  /// The operand is read in transposed order without being copied
+  kTranspose,
+};
+
+/**
+ * @brief Read only view of the transpose of a matrix. Nothing is copied, the
+ * multiplications read the viewed matrix in transposed order. The view must
+ * not outlive the matrix it refers to
+ *
+ * @tparam T Any numeric type
+ */
+template <typename T>
+class TransposeView {
+ public:
+  explicit TransposeView(const DenseMatrix<T>& matrix) : matrix_(&matrix) {}
+
+  size_t num_rows() const { return matrix_->num_cols(); }
+  size_t num_cols() const { return matrix_->num_rows(); }
+  const T& operator()(size_t i, size_t j) const { return (*matrix_)(j, i); }
+
+  /**
+   * @brief Matrix whose transpose is viewed
+   */
+  const DenseMatrix<T>& matrix() const { return *matrix_; }
+
+ private:
+  const DenseMatrix<T>* matrix_;
+};
+
+/**
+ * @brief Creates a view of the transpose of a matrix without copying it
+ *
+ * @tparam T Any numeric type
+ * @param matrix Matrix to view. Must outlive the view
+ * @return TransposeView<T> View of the transpose of matrix
+ */
+template <typename T>
+inline TransposeView<T> Transposed(const DenseMatrix<T>& matrix) {
+  return TransposeView<T>(matrix);
+}
+
+/**
+ * @brief Views of temporaries would dangle so they are rejected
+ */
+template <typename T>
+void Transposed(const DenseMatrix<T>&& matrix) = delete;
+
+/**
+ * @brief Create a Matrix of provided dimensions. Fills with value provided
+ *
+ * @tparam T Any numeric type
+ * @param num_rows Number of rows in matrix
+ * @param num_cols Number of columns in matrix
+ * @param value_to_fill Value to fill in matrix
+ * @return DenseMatrix<T> Contiguous matrix with provided dimensions and value
+ * @throws Runtime error if we are trying to make a matrix with 0 rows and non
+ * zero columns
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline DenseMatrix<T> CreateMatrix(size_t num_rows, size_t num_cols,
+                                   T value_to_fill) {
+  return DenseMatrix<T>(num_rows, num_cols, value_to_fill);
+}
+
+/**
+ * @brief Create a Sequential Matrix of provided dimensions. Values are filled
+ * in row-major order starting from start and incrementing by increment, the
+ * same as the nested vector version
+ *
+ * @tparam T Any numeric type
+ * @param num_rows Number of rows in matrix
+ * @param num_cols Number of columns in matrix
+ * @param start Base value to start with
+ * @param increment Value to increment with (Note: In unsigned matrices this
+ * can't be negative)
+ * @return DenseMatrix<T> Contiguous matrix as specified
+ * @throws Runtime error if we are trying to make a matrix with 0 rows and non
+ * zero columns
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline DenseMatrix<T> CreateSequentialMatrix(size_t num_rows, size_t num_cols,
+                                             T start, T increment) {
+  DenseMatrix<T> matrix(num_rows, num_cols, UninitializedTag());
+  // Storage is contiguous so the whole matrix is a single sequence
+  T current_value = start;
+  T* elem = matrix.data();
+  T* const end = elem + num_rows * num_cols;
+  for (; elem != end; ++elem) {
+    *elem = current_value;
+    current_value += increment;
+  }
+  return matrix;
+}
+
+/**
+ * @brief Just prints the matrix for debugging purpose
+ *
+ * @tparam T Any numeric type
+ * @param matrix Matrix to print
+ */
+template <typename T>
+inline void PrintMatrix(const DenseMatrix<T>& matrix) {
+  for (size_t i = 0; i < matrix.num_rows(); i++) {
+    const T* row = matrix.row(i);
+    for (size_t j = 0; j < matrix.num_cols(); j++) {
+      std::cout << row[j] << ", ";
+    }
+    std::cout << std::endl;
+  }
+}
+
+/**
+ * @brief Checks if 2 matrices have the same shape and contents. Row padding
+ * is ignored
+ *
+ * @tparam T Any numeric type
+ * @param A Matrix A
+ * @param B Matrix B
+ * @return true If both matrices have same contents
+ * @return false If both matrices do not have same contents
+ */
+template <typename T>
+inline bool IsMatricesEqual(const DenseMatrix<T>& A, const DenseMatrix<T>& B) {
+  // If the dimensions are not equal they are not equal
+  if (A.num_rows() != B.num_rows() || A.num_cols() != B.num_cols()) {
+    return false;
+  }
+  for (size_t i = 0; i < A.num_rows(); i++) {
+    if (!std::equal(A.row(i), A.row(i) + A.num_cols(), B.row(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Copies a nested vector matrix into contiguous storage. The rows of a
+ * nested vector are separate allocations so they cannot be adopted in place
+ *
+ * @tparam T Any numeric type
+ * @param matrix 2D nested vector matrix
+ * @return DenseMatrix<T> Contiguous copy of matrix
+ * @throws Runtime error if the matrix has a column mismatch
+ */
+template <typename T, typename = typename std::enable_if<
+                          std::is_arithmetic<T>::value, T>::type>
+inline DenseMatrix<T> FromNestedVector(
+    const std::vector<std::vector<T>>& matrix) {
+  const size_t num_cols = matrix.empty() ? 0 : matrix.front().size();
+  DenseMatrix<T> dense(matrix.size(), num_cols, UninitializedTag());
+  for (size_t i = 0; i < matrix.size(); i++) {
+    // Ragged rows cannot be represented contiguously
+    if (matrix[i].size() != num_cols) {
+      throw std::runtime_error("Matrix has a column mismatch");
+    }
+    std::copy(matrix[i].begin(), matrix[i].end(), dense.row(i));
+  }
+  return dense;
+}
+
+/**
+ * @brief Copies a contiguous matrix into the nested vector form used by the
+ * rest of the library
+ *
+ * @tparam T Any numeric type
+ * @param matrix Contiguous matrix
+ * @return std::vector<std::vector<T>> 2D nested vector copy of matrix
+ */
+template <typename T>
+inline std::vector<std::vector<T>> ToNestedVector(
+    const DenseMatrix<T>& matrix) {
+  std::vector<std::vector<T>> nested;
+  nested.reserve(matrix.num_rows());
+  for (size_t i = 0; i < matrix.num_rows(); i++) {
+    nested.emplace_back(matrix.row(i), matrix.row(i) + matrix.num_cols());
+  }
+  return nested;
+}
+
+}  // namespace dense_matrix
+}  // namespace utils
+}  // namespace matrix_library
+
+#endif
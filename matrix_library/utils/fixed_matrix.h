@@ -0,0 +1,351 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing declaration of the fixed size matrix and its utilities.
+ * Dimensions are template parameters so storage lives inline, operations are
+ * constexpr and unrolled at compile time, and shape mismatches are compile
+ * errors
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#ifndef MATRIX_LIBRARY__UTILS__FIXED_MATRIX_H_
+#define MATRIX_LIBRARY__UTILS__FIXED_MATRIX_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "matrix_library/utils/dense_matrix.h"
+
+namespace matrix_library {
+namespace utils {
+namespace fixed_matrix {
+
+/**
+ * @brief Compile time sequence of indices, std::index_sequence is C++14
+ *
+ * @tparam I Indices
+ */
+template <size_t... I>
+struct IndexSequence {};
+
+/**
+ * @brief Joins 2 index sequences, shifting the second past the first
+ *
+ * @tparam First First sequence
+ * @tparam Second Second sequence
+ */
+template <typename First, typename Second>
+struct ConcatIndexSequence;
+
+template <size_t... I, size_t... J>
+struct ConcatIndexSequence<IndexSequence<I...>, IndexSequence<J...>> {
+  using type = IndexSequence<I..., (sizeof...(I) + J)...>;
+};
+
+/**
+ * @brief Builds the sequence 0, 1, ..., N - 1. Halving keeps the template
+ * recursion depth logarithmic so large matrices still compile
+ *
+ * @tparam N Length of the sequence
+ */
+template <size_t N>
+struct MakeIndexSequence
+    : ConcatIndexSequence<typename MakeIndexSequence<N / 2>::type,
+                          typename MakeIndexSequence<N - N / 2>::type> {};
+
+template <>
+struct MakeIndexSequence<0> {
+  using type = IndexSequence<>;
+};
+
+template <>
+struct MakeIndexSequence<1> {
+  using type = IndexSequence<0>;
+};
+
+/**
+ * @brief Matrix whose dimensions are template parameters, stored inline in
+ * row-major order. Element (i, j) lives at elements[i * C + j]. It is an
+ * aggregate so it can be brace initialized and used in constant expressions
+ * and it never allocates
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows
+ * @tparam C Number of columns
+ */
+template <typename T, size_t R, size_t C>
+struct Matrix {
+  static_assert(std::is_arithmetic<T>::value,
+                "Matrix requires a numeric type");
+  static_assert(R > 0 && C > 0,
+                "Matrix requires at least one row and one column");
+
+  using value_type = T;
+
+  /**
+   * @brief Gets the number of rows
+   *
+   * @return size_t Number of rows
+   */
+  static constexpr size_t num_rows() { return R; }
+
+  /**
+   * @brief Gets the number of columns
+   *
+   * @return size_t Number of columns
+   */
+  static constexpr size_t num_cols() { return C; }
+
+  /**
+   * @brief Gets an element
+   *
+   * @param i Row index
+   * @param j Column index
+   * @return const T& Element (i, j)
+   */
+  constexpr const T& operator()(size_t i, size_t j) const {
+    return elements[i * C + j];
+  }
+
+  /**
+   * @brief Gets an element
+   *
+   * @param i Row index
+   * @param j Column index
+   * @return T& Element (i, j)
+   */
+  T& operator()(size_t i, size_t j) { return elements[i * C + j]; }
+
+  /**
+   * @brief Gets the storage
+   *
+   * @return T* Row-major elements
+   */
+  T* data() { return elements; }
+
+  /**
+   * @brief Gets the storage
+   *
+   * @return const T* Row-major elements
+   */
+  constexpr const T* data() const { return elements; }
+
+  /// Row-major elements. Public so the matrix stays an aggregate
+  T elements[R * C];
+};
+
+/**
+ * @brief Sums the products of row i of A and column j of B over the first P
+ * indices. Each index is its own instantiation so the sum is unrolled at
+ * compile time, in the same order as the dynamic kernels
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows in A
+ * @tparam K Number of columns in A and rows in B
+ * @tparam C Number of columns in B
+ * @tparam P Number of products summed
+ */
+template <typename T, size_t R, size_t K, size_t C, size_t P>
+struct PartialDot {
+  static constexpr T Compute(const Matrix<T, R, K>& A,
+                             const Matrix<T, K, C>& B, size_t i, size_t j) {
+    return static_cast<T>(PartialDot<T, R, K, C, P - 1>::Compute(A, B, i, j) +
+                          A(i, P - 1) * B(P - 1, j));
+  }
+};
+
+template <typename T, size_t R, size_t K, size_t C>
+struct PartialDot<T, R, K, C, 0> {
+  static constexpr T Compute(const Matrix<T, R, K>&, const Matrix<T, K, C>&,
+                             size_t, size_t) {
+    return static_cast<T>(0);
+  }
+};
+
+/**
+ * @brief Multiplies 2 matrices, one expanded element of C per index
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows in A and C
+ * @tparam K Number of columns in A and rows in B
+ * @tparam C Number of columns in B and C
+ * @tparam I Indices of the elements of C
+ * @param A Matrix A
+ * @param B Matrix B
+ * @return Matrix<T, R, C> Matrix C that is equal to A * B
+ */
+template <typename T, size_t R, size_t K, size_t C, size_t... I>
+constexpr Matrix<T, R, C> MultiplyElements(const Matrix<T, R, K>& A,
+                                           const Matrix<T, K, C>& B,
+                                           IndexSequence<I...>) {
+  return Matrix<T, R, C>{
+      {PartialDot<T, R, K, C, K>::Compute(A, B, I / C, I % C)...}};
+}
+
+/**
+ * @brief Transposes a matrix, one expanded element of the result per index
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows in the original matrix
+ * @tparam C Number of columns in the original matrix
+ * @tparam I Indices of the elements of the transposed matrix
+ * @param matrix Original matrix
+ * @return Matrix<T, C, R> Transposed matrix
+ */
+template <typename T, size_t R, size_t C, size_t... I>
+constexpr Matrix<T, C, R> TransposeElements(const Matrix<T, R, C>& matrix,
+                                            IndexSequence<I...>) {
+  return Matrix<T, C, R>{{matrix(I % R, I / R)...}};
+}
+
+/**
+ * @brief Multiplies 2 matrices. The inner dimensions are part of the types so
+ * mismatched shapes do not compile
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows in A and C
+ * @tparam K Number of columns in A and rows in B
+ * @tparam C Number of columns in B and C
+ * @param A Matrix A to be multiplied in A * B
+ * @param B Matrix B to be multipled in A * B
+ * @return Matrix<T, R, C> Matrix C that is equal to A * B
+ */
+template <typename T, size_t R, size_t K, size_t C>
+constexpr Matrix<T, R, C> Multiply(const Matrix<T, R, K>& A,
+                                   const Matrix<T, K, C>& B) {
+  return MultiplyElements(A, B, typename MakeIndexSequence<R * C>::type());
+}
+
+/**
+ * @brief Transposes a matrix
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows in the original matrix
+ * @tparam C Number of columns in the original matrix
+ * @param matrix Original matrix
+ * @return Matrix<T, C, R> Transposed matrix
+ */
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, C, R> Transpose(const Matrix<T, R, C>& matrix) {
+  return TransposeElements(matrix, typename MakeIndexSequence<R * C>::type());
+}
+
+/**
+ * @brief Checks if 2 matrices of the same shape have the same contents
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows
+ * @tparam C Number of columns
+ * @param A Matrix A
+ * @param B Matrix B
+ * @return true If both matrices have same contents
+ * @return false If both matrices do not have same contents
+ */
+template <typename T, size_t R, size_t C>
+inline bool IsMatricesEqual(const Matrix<T, R, C>& A,
+                            const Matrix<T, R, C>& B) {
+  return std::equal(A.data(), A.data() + R * C, B.data());
+}
+
+/**
+ * @brief Copies a nested vector matrix into a fixed size matrix
+ *
+ * @tparam R Number of rows
+ * @tparam C Number of columns
+ * @tparam T Any numeric type
+ * @param matrix 2D nested vector matrix with R rows of C columns
+ * @return Matrix<T, R, C> Fixed size copy of matrix
+ * @throws Runtime error if the matrix does not have R rows of C columns
+ */
+template <size_t R, size_t C, typename T>
+inline Matrix<T, R, C> FromNestedVector(
+    const std::vector<std::vector<T>>& matrix) {
+  if (matrix.size() != R) {
+    throw std::runtime_error("Matrix does not have the fixed dimensions");
+  }
+  Matrix<T, R, C> fixed;
+  for (size_t i = 0; i < R; i++) {
+    if (matrix[i].size() != C) {
+      throw std::runtime_error("Matrix does not have the fixed dimensions");
+    }
+    std::copy(matrix[i].begin(), matrix[i].end(), fixed.data() + i * C);
+  }
+  return fixed;
+}
+
+/**
+ * @brief Copies a fixed size matrix into the nested vector form used by the
+ * rest of the library
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows
+ * @tparam C Number of columns
+ * @param matrix Fixed size matrix
+ * @return std::vector<std::vector<T>> 2D nested vector copy of matrix
+ */
+template <typename T, size_t R, size_t C>
+inline std::vector<std::vector<T>> ToNestedVector(
+    const Matrix<T, R, C>& matrix) {
+  std::vector<std::vector<T>> nested;
+  nested.reserve(R);
+  for (size_t i = 0; i < R; i++) {
+    nested.emplace_back(matrix.data() + i * C, matrix.data() + (i + 1) * C);
+  }
+  return nested;
+}
+
+/**
+ * @brief Copies a contiguous matrix into a fixed size matrix
+ *
+ * @tparam R Number of rows
+ * @tparam C Number of columns
+ * @tparam T Any numeric type
+ * @param matrix Contiguous matrix with R rows and C columns
+ * @return Matrix<T, R, C> Fixed size copy of matrix
+ * @throws Runtime error if the matrix does not have R rows and C columns
+ */
+template <size_t R, size_t C, typename T>
+inline Matrix<T, R, C> FromDenseMatrix(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& matrix) {
+  if (matrix.num_rows() != R || matrix.num_cols() != C) {
+    throw std::runtime_error("Matrix does not have the fixed dimensions");
+  }
+  Matrix<T, R, C> fixed;
+  for (size_t i = 0; i < R; i++) {
+    std::copy(matrix.row(i), matrix.row(i) + C, fixed.data() + i * C);
+  }
+  return fixed;
+}
+
+/**
+ * @brief Copies a fixed size matrix into contiguous storage
+ *
+ * @tparam T Any numeric type
+ * @tparam R Number of rows
+ * @tparam C Number of columns
+ * @param matrix Fixed size matrix
+ * @return matrix_library::utils::dense_matrix::DenseMatrix<T> Contiguous copy
+ * of matrix
+ */
+template <typename T, size_t R, size_t C>
+inline matrix_library::utils::dense_matrix::DenseMatrix<T> ToDenseMatrix(
+    const Matrix<T, R, C>& matrix) {
+  matrix_library::utils::dense_matrix::DenseMatrix<T> dense(
+      R, C, matrix_library::utils::dense_matrix::UninitializedTag());
+  for (size_t i = 0; i < R; i++) {
+    std::copy(matrix.data() + i * C, matrix.data() + (i + 1) * C,
+              dense.row(i));
+  }
+  return dense;
+}
+
+}  // namespace fixed_matrix
+}  // namespace utils
+}  // namespace matrix_library
+
+#endif
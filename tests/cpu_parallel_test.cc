@@ -0,0 +1,2806 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing tests for cpu parallel version of library
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "matrix_library/cpu_parallel/gemm_plan.h"
+#include "matrix_library/cpu_parallel/matrix_ops.h"
+#include "matrix_library/cpu_parallel/numa_topology.h"
+#include "matrix_library/cpu_parallel/parallel_config.h"
+#include "matrix_library/cpu_parallel/parallel_kernels.h"
+#include "matrix_library/cpu_parallel/task_graph.h"
+#include "matrix_library/cpu_parallel/thread_affinity.h"
+#include "matrix_library/cpu_parallel/thread_pool.h"
+#include "matrix_library/cpu_simple/matrix_ops.h"
+#include "matrix_library/utils/dense_matrix.h"
+#include "matrix_library/utils/matrix_utils.h"
+
+TEST(CpuParallelTest, EmptyMatrixTranspose) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(A),
+               std::runtime_error);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(B),
+               std::runtime_error);
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(C),
+               std::runtime_error);
+
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(D),
+               std::runtime_error);
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(E),
+               std::runtime_error);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(F),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(G),
+               std::runtime_error);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(H),
+               std::runtime_error);
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(I),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, EmptyColVectorTranspose) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(A),
+               std::runtime_error);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(B),
+               std::runtime_error);
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(C),
+               std::runtime_error);
+
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(D),
+               std::runtime_error);
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(E),
+               std::runtime_error);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(F),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(G),
+               std::runtime_error);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(H),
+               std::runtime_error);
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(I),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, ScalarTranspose) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1);
+  auto A_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(A);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(A, A_T));
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1);
+  auto B_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(B);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(B, B_T));
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0);
+  auto C_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(C);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(C, C_T));
+
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0f);
+  auto D_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(D);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(D, D_T));
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0f);
+  auto E_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(E);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(E, E_T));
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0f);
+  auto F_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(F);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(F, F_T));
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0);
+  auto G_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(G);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(G, G_T));
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0);
+  auto H_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(H);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(H, H_T));
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0);
+  auto I_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(I);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(I, I_T));
+}
+
+TEST(CpuParallelTest, ColVectorTranspose) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1);
+  auto A_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1);
+  auto A_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(A);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(A_ans, A_T));
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1);
+  auto B_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1);
+  auto B_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(B);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(B_ans, B_T));
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0);
+  auto C_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0);
+  auto C_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(C);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(C_ans, C_T));
+
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0f);
+  auto D_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0f);
+  auto D_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(D);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(D_ans, D_T));
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0f);
+  auto E_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0f);
+  auto E_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(E);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(E_ans, E_T));
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0f);
+  auto F_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0f);
+  auto F_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(F);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(F_ans, F_T));
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0);
+  auto G_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0);
+  auto G_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(G);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(G_ans, G_T));
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0);
+  auto H_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0);
+  auto H_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(H);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(H_ans, H_T));
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0);
+  auto I_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0);
+  auto I_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(I_ans);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(I, I_T));
+}
+
+TEST(CpuParallelTest, RowVectorTranspose) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1);
+  auto A_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1);
+  auto A_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(A);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(A_ans, A_T));
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1);
+  auto B_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1);
+  auto B_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(B);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(B_ans, B_T));
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0);
+  auto C_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0);
+  auto C_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(C);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(C_ans, C_T));
+
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0f);
+  auto D_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0f);
+  auto D_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(D);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(D_ans, D_T));
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0f);
+  auto E_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0f);
+  auto E_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(E);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(E_ans, E_T));
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0f);
+  auto F_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0f);
+  auto F_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(F);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(F_ans, F_T));
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0);
+  auto G_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0);
+  auto G_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(G);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(G_ans, G_T));
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0);
+  auto H_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0);
+  auto H_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(H);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(H_ans, H_T));
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0);
+  auto I_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0);
+  auto I_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(I_ans);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(I, I_T));
+}
+
+TEST(CpuParallelTest, MatrixTranspose) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1);
+  auto A_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 1);
+  auto A_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(A);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(A_ans, A_T));
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1);
+  auto B_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, -1);
+  auto B_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(B);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(B_ans, B_T));
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0);
+  auto C_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 0);
+  auto C_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(C);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(C_ans, C_T));
+
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0f);
+  auto D_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 1.0f);
+  auto D_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(D);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(D_ans, D_T));
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0f);
+  auto E_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, -1.0f);
+  auto E_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(E);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(E_ans, E_T));
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0f);
+  auto F_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 0.0f);
+  auto F_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(F);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(F_ans, F_T));
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0);
+  auto G_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 1.0);
+  auto G_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(G);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(G_ans, G_T));
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0);
+  auto H_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, -1.0);
+  auto H_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(H);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(H_ans, H_T));
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0);
+  auto I_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 0.0);
+  auto I_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(I_ans);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(I, I_T));
+
+  // Rows of bools are packed and have no data()
+  std::vector<std::vector<bool>> J{{true, false, true}, {false, false, true}};
+  std::vector<std::vector<bool>> J_ans{
+      {true, false}, {false, false}, {true, true}};
+  auto J_T = matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(J);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(J_ans, J_T));
+}
+
+TEST(CpuParallelTest, TwoEmptyMatrixMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1);
+  auto AB = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  auto BA = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(AB, A));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(BA, A));
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1);
+  auto CD = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D);
+  auto DC = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(CD, A));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(DC, A));
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0);
+  auto EF = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F);
+  auto FE = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(EF, A));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(FE, A));
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0f);
+  auto GH = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H);
+  auto HG = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(GH, G));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(HG, G));
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0f);
+  auto IJ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J);
+  auto JI = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(IJ, G));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(JI, G));
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0f);
+  auto KL = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L);
+  auto LK = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(KL, G));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(LK, G));
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0);
+  auto MN = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N);
+  auto NM = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(MN, M));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(NM, M));
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0);
+  auto OP = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P);
+  auto PO = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(OP, M));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(PO, M));
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0);
+  auto QR = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R);
+  auto RQ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(QR, M));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(RQ, M));
+}
+
+TEST(CpuParallelTest, OneEmptyColVectorOneEmptyMatrixMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1);
+  auto AB = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(AB, A));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1);
+  auto CD = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(CD, A));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0);
+  auto EF = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(EF, A));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0f);
+  auto GH = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(GH, G));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0f);
+  auto IJ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(IJ, G));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0f);
+  auto KL = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(KL, G));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0);
+  auto MN = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(MN, M));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0);
+  auto OP = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(OP, M));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0);
+  auto QR = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(QR, M));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneScalarOneEmptyMatrixMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneColumnVectorOneEmptyMatrixMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneRowVectorOneEmptyMatrixMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneMatrixOneEmptyMatrixMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, TwoEmptyColVectorsMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneScalarOneEmptyColVectorMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneColumnVectorOneEmptyColVectorMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneRowVectorOneEmptyColVectorMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1);
+  auto AB_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 0, 0);
+  auto AB = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(AB, AB_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1);
+  auto CD_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 0, 0);
+  auto CD = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(CD, CD_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0);
+  auto EF_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 0, 0);
+  auto EF = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(EF, EF_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0f);
+  auto GH_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 0, 1.0f);
+  auto GH = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(GH, GH_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0f);
+  auto IJ_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 0, 1.0f);
+  auto IJ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(IJ, IJ_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0f);
+  auto KL_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 0, 1.0f);
+  auto KL = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(KL, KL_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0);
+  auto MN_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 0, 1.0);
+  auto MN = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(MN, MN_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0);
+  auto OP_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 0, 1.0);
+  auto OP = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(OP, OP_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0);
+  auto QR_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 0, 1.0);
+  auto QR = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(QR, QR_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneMatrixOneEmptyColVectorMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1);
+  auto AB_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 0, 0);
+  auto AB = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(AB, AB_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1);
+  auto CD_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 0, 0);
+  auto CD = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(CD, CD_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0);
+  auto EF_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 0, 0);
+  auto EF = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(EF, EF_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0f);
+  auto GH_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 0, 0.0f);
+  auto GH = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(GH, GH_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0f);
+  auto IJ_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 0, 0.0f);
+  auto IJ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(IJ, IJ_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0f);
+  auto KL_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 0, 0.0f);
+  auto KL = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(KL, KL_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0);
+  auto MN_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 0, 0.0);
+  auto MN = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(MN, MN_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, -1.0);
+  auto OP_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 0, 0.0);
+  auto OP = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(OP, OP_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 0.0);
+  auto QR_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 0, 0.0);
+  auto QR = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(QR, QR_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, TwoScalarsMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1);
+  auto AB = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  auto BA = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(AB, A));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(BA, A));
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1);
+  auto CD = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D);
+  auto DC = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(CD, A));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(DC, A));
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0);
+  auto EF = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F);
+  auto FE = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(EF, E));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(FE, E));
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0f);
+  auto GH = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H);
+  auto HG = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(GH, G));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(HG, G));
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0f);
+  auto IJ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J);
+  auto JI = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(IJ, H));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(JI, H));
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0f);
+  auto KL = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L);
+  auto LK = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(KL, K));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(LK, K));
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0);
+  auto MN = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N);
+  auto NM = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(MN, M));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(NM, N));
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0);
+  auto OP = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P);
+  auto PO = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(OP, M));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(PO, M));
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0);
+  auto QR = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R);
+  auto RQ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(QR, Q));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(RQ, Q));
+}
+
+TEST(CpuParallelTest, OneColumnVectorOneScalarMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1);
+  auto AB = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(AB, A));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1);
+  auto CD = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(CD, A));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0);
+  auto EF = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(EF, E));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0f);
+  auto GH = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(GH, G));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0f);
+  auto IJ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(IJ, G));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0f);
+  auto KL = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(KL, K));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0);
+  auto MN = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(MN, M));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0);
+  auto OP = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(OP, M));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0);
+  auto QR = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(QR, Q));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneRowVectorOneScalarMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1);
+  auto BA = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(BA, A));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1);
+  auto DC = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(DC, A));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0);
+  auto FE = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(FE, E));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0f);
+  auto HG = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(HG, G));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0f);
+  auto JI = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(JI, G));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0f);
+  auto LK = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(LK, K));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0);
+  auto NM = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(NM, M));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0);
+  auto PO = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(PO, M));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0);
+  auto RQ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(RQ, Q));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneMatrixOneScalarMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, TwoColumnVectorsMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneRowVectorOneColumnVectorMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1);
+  auto AB_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 3);
+  auto BA_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 1);
+  auto AB = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  auto BA = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(AB, AB_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(BA, BA_ans));
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1);
+  auto CD_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 3);
+  auto DC_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 1);
+  auto CD = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D);
+  auto DC = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(CD, CD_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(DC, DC_ans));
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0);
+  auto EF_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0);
+  auto FE_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 0);
+  auto EF = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F);
+  auto FE = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(EF, EF_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(FE, FE_ans));
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0f);
+  auto GH_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 3.0f);
+  auto HG_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 1.0f);
+  auto GH = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H);
+  auto HG = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(GH, GH_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(HG, HG_ans));
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0f);
+  auto IJ_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 3.0f);
+  auto IJ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J);
+  auto JI_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 1.0f);
+  auto JI = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(IJ, IJ_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(JI, JI_ans));
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0f);
+  auto KL_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0f);
+  auto KL = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L);
+  auto LK_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 0.0f);
+  auto LK = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(KL, KL_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(LK, LK_ans));
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0);
+  auto MN_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 3.0);
+  auto MN = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N);
+  auto NM_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 1.0);
+  auto NM = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(MN, MN_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(NM, NM_ans));
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0);
+  auto OP_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 3.0);
+  auto OP = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P);
+  auto PO_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 1.0);
+  auto PO = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(OP, OP_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(PO, PO_ans));
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0);
+  auto QR_ans = matrix_library::utils::matrix_utils::CreateMatrix(1, 1, 0.0);
+  auto QR = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R);
+  auto RQ_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 0.0);
+  auto RQ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(QR, QR_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(RQ, RQ_ans));
+}
+
+TEST(CpuParallelTest, OneMatrixOneColumnVectorMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1);
+  auto AB_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 1, 3);
+  auto AB = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(AB, AB_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1);
+  auto CD_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 1, 3);
+  auto CD = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(CD, CD_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0);
+  auto EF_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 1, 0);
+  auto EF = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(EF, EF_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0f);
+  auto GH_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 1, 3.0f);
+  auto GH = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(GH, GH_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0f);
+  auto IJ_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 1, 3.0f);
+  auto IJ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(IJ, IJ_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0f);
+  auto KL_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 1, 0.0f);
+  auto KL = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(KL, KL_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 1.0);
+  auto MN_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 1, 3.0);
+  auto MN = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(MN, MN_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, -1.0);
+  auto OP_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 1, 3.0);
+  auto OP = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(OP, OP_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(3, 1, 0.0);
+  auto QR_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 1, 0.0);
+  auto QR = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(QR, QR_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, TwoRowVectorsMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, OneMatrixOneRowVectorMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E),
+               std::runtime_error);
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G),
+               std::runtime_error);
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I),
+               std::runtime_error);
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0f);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K),
+               std::runtime_error);
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M),
+               std::runtime_error);
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, -1.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O),
+               std::runtime_error);
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(1, 3, 0.0);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, TwoMatricesMultiply) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 1);
+  auto AB_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 2, 3);
+  auto BA_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 2);
+  auto AB = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+  auto BA = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(B, A);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(AB, AB_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(BA, BA_ans));
+
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, -1);
+  auto CD_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 2, 3);
+  auto DC_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 2);
+  auto CD = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, D);
+  auto DC = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, C);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(CD, CD_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(DC, DC_ans));
+
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 0);
+  auto EF_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 2, 0);
+  auto FE_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 0);
+  auto EF = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(E, F);
+  auto FE = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(F, E);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(EF, EF_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(FE, FE_ans));
+
+  auto G = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0f);
+  auto H = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 1.0f);
+  auto GH_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 2, 3.0f);
+  auto HG_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 2.0f);
+  auto GH = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H);
+  auto HG = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(H, G);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(GH, GH_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(HG, HG_ans));
+
+  auto I = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0f);
+  auto J = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, -1.0f);
+  auto IJ_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 2, 3.0f);
+  auto IJ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(I, J);
+  auto JI_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 2.0f);
+  auto JI = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(J, I);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(IJ, IJ_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(JI, JI_ans));
+
+  auto K = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0f);
+  auto L = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 0.0f);
+  auto KL_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 2, 0.0f);
+  auto KL = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(K, L);
+  auto LK_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 0.0f);
+  auto LK = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(L, K);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(KL, KL_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(LK, LK_ans));
+
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 1.0);
+  auto N = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 1.0);
+  auto MN_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 2, 3.0);
+  auto MN = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(M, N);
+  auto NM_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 2.0);
+  auto NM = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(N, M);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(MN, MN_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(NM, NM_ans));
+
+  auto O = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, -1.0);
+  auto P = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, -1.0);
+  auto OP_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 2, 3.0);
+  auto OP = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(O, P);
+  auto PO_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 2.0);
+  auto PO = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(P, O);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(OP, OP_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(PO, PO_ans));
+
+  auto Q = matrix_library::utils::matrix_utils::CreateMatrix(2, 3, 0.0);
+  auto R = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 0.0);
+  auto QR_ans = matrix_library::utils::matrix_utils::CreateMatrix(2, 2, 0.0);
+  auto QR = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(Q, R);
+  auto RQ_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 3, 0.0);
+  auto RQ = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(R, Q);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(QR, QR_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(RQ, RQ_ans));
+}
+
+TEST(CpuParallelTest, NumThreads) {
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(3);
+  ASSERT_TRUE(matrix_library::cpu_parallel::parallel_config::GetNumThreads() ==
+              3);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+  ASSERT_TRUE(matrix_library::cpu_parallel::parallel_config::GetNumThreads() >=
+              1);
+}
+
+TEST(CpuParallelTest, LargeMatricesMultiply) {
+  // Large enough to be split across threads and ragged against the row blocks
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      203, 171, -9000, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      171, 157, 5000, -3);
+  auto AB_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  auto A_dense = matrix_library::utils::dense_matrix::FromNestedVector(A);
+  auto B_dense = matrix_library::utils::dense_matrix::FromNestedVector(B);
+  for (size_t num_threads = 1; num_threads <= 8; num_threads++) {
+    matrix_library::cpu_parallel::parallel_config::SetNumThreads(num_threads);
+    ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B),
+        AB_ans));
+    ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+        matrix_library::utils::dense_matrix::ToNestedVector(
+            matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A_dense,
+                                                                     B_dense)),
+        AB_ans));
+  }
+
+  // Small integer valued floats are exact in any summation order
+  auto C = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      150, 140, -4.0f, 0.0625f);
+  auto F = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      140, 120, 3.0f, -0.0625f);
+  auto D = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      140, 130, 2.0, -0.03125);
+  auto E = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      130, 150, 1.0, 0.015625);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(4);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(C, F),
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(C, F)));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(D, E),
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(D, E)));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(
+                   A_dense, A_dense),
+               std::runtime_error);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+}
+
+TEST(CpuParallelTest, LargeMatrixTranspose) {
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      301, 259, 0, 1);
+  auto A_T_ans = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      259, 301, 0.0f, 0.5f);
+  auto B_T_ans = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(B);
+  auto C = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      1, 70000, 0.0, 1.0);
+  auto C_T_ans = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(C);
+  std::vector<std::vector<bool>> D(301, std::vector<bool>(259));
+  for (size_t i = 0; i < D.size(); i++) {
+    for (size_t j = 0; j < D[i].size(); j++) {
+      D[i][j] = (i * 7 + j * 3) % 5 == 0;
+    }
+  }
+  auto D_T_ans = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(D);
+  for (size_t num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    matrix_library::cpu_parallel::parallel_config::SetNumThreads(num_threads);
+    ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(A),
+        A_T_ans));
+    ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(B),
+        B_T_ans));
+    ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(C),
+        C_T_ans));
+    ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(D),
+        D_T_ans));
+  }
+
+  // A ragged matrix is rejected even when it is large
+  A.back().pop_back();
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixTranspose(A),
+               std::runtime_error);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+}
+
+TEST(CpuParallelTest, MatrixMultiplyInto) {
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      203, 171, -9000, 1);
+  auto B = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      171, 157, 5000, -3);
+  auto AB_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  auto A_dense = matrix_library::utils::dense_matrix::FromNestedVector(A);
+  auto B_dense = matrix_library::utils::dense_matrix::FromNestedVector(B);
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(203, 157, 1);
+  auto C_dense = matrix_library::utils::dense_matrix::CreateMatrix(203, 157, 1);
+  const int* data = C_dense.data();
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(4);
+  // Overwrite then accumulate a second product on top
+  for (int rep = 0; rep < 2; rep++) {
+    matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyInto(A, B, C,
+                                                                 rep == 1);
+    matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyInto(
+        A_dense, B_dense, C_dense, rep == 1);
+  }
+  for (auto& row : AB_ans) {
+    for (auto& value : row) {
+      value *= 2;
+    }
+  }
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(C, AB_ans));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(C_dense), AB_ans));
+  ASSERT_TRUE(C_dense.data() == data);
+
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(203, 156, 1);
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyInto(A, B, D),
+      std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyInto(
+                   A_dense, B_dense, B_dense),
+               std::runtime_error);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+}
+
+TEST(CpuParallelTest, MatrixTransposeInto) {
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      301, 259, 0, 1);
+  auto A_T = matrix_library::utils::matrix_utils::CreateMatrix(259, 301, 0);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      259, 301, 0.0, 0.5);
+  matrix_library::utils::dense_matrix::DenseMatrix<double> B_T(301, 259, 260,
+                                                               0.0);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(4);
+  matrix_library::cpu_parallel::matrix_ops::MatrixTransposeInto(A, A_T);
+  matrix_library::cpu_parallel::matrix_ops::MatrixTransposeInto(B, B_T);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      A_T, matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A)));
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      B_T, matrix_library::cpu_simple::matrix_ops::MatrixTranspose(B)));
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::matrix_ops::MatrixTransposeInto(A, A),
+      std::runtime_error);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+}
+
+TEST(CpuParallelTest, TransposedOperandsMultiply) {
+  // Large enough to be split across threads and ragged against the row blocks
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      171, 203, -9000, 1);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      157, 171, 5000, -3);
+  auto A_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A);
+  auto B_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(B);
+  auto AB_ans =
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A_T, B_T);
+  for (size_t num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    matrix_library::cpu_parallel::parallel_config::SetNumThreads(num_threads);
+    ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(
+            matrix_library::utils::dense_matrix::Transposed(A), B_T),
+        AB_ans));
+    ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(
+            A_T, matrix_library::utils::dense_matrix::Transposed(B)),
+        AB_ans));
+    ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(
+            matrix_library::utils::dense_matrix::Transposed(A),
+            matrix_library::utils::dense_matrix::Transposed(B)),
+        AB_ans));
+  }
+
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(203, 157, 1);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(4);
+  matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyInto(
+      A, matrix_library::utils::dense_matrix::Operation::kTranspose, B,
+      matrix_library::utils::dense_matrix::Operation::kTranspose, C, true);
+  bool matches = true;
+  for (size_t i = 0; i < C.num_rows(); i++) {
+    for (size_t j = 0; j < C.num_cols(); j++) {
+      matches = matches && C(i, j) == AB_ans(i, j) + 1;
+    }
+  }
+  ASSERT_TRUE(matches);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(
+                   matrix_library::utils::dense_matrix::Transposed(A), B),
+               std::runtime_error);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+}
+
+TEST(CpuParallelTest, VectorShapesMultiply) {
+  // Matrix-vector and outer products large enough to be split across threads
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      1001, 300, -9000, 1);
+  auto x = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      300, 1, 5, -3);
+  auto u = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      503, 1, 0.0, 0.5);
+  auto w = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      1, 211, 1.0, -0.25);
+  auto Ax_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, x);
+  auto uw_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(u, w);
+  auto A_dense = matrix_library::utils::dense_matrix::FromNestedVector(A);
+  std::vector<int> x_vector(300);
+  for (size_t p = 0; p < 300; p++) {
+    x_vector[p] = x[p][0];
+  }
+  std::vector<int> Ax_vector(Ax_ans.size());
+  for (size_t i = 0; i < Ax_ans.size(); i++) {
+    Ax_vector[i] = Ax_ans[i][0];
+  }
+  std::vector<double> u_vector(503);
+  for (size_t i = 0; i < 503; i++) {
+    u_vector[i] = u[i][0];
+  }
+  for (size_t num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    matrix_library::cpu_parallel::parallel_config::SetNumThreads(num_threads);
+    ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, x),
+        Ax_ans));
+    ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+        matrix_library::utils::dense_matrix::ToNestedVector(
+            matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(
+                A_dense,
+                matrix_library::utils::dense_matrix::FromNestedVector(x))),
+        Ax_ans));
+    ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(u, w),
+        uw_ans));
+    ASSERT_TRUE(matrix_library::cpu_parallel::matrix_ops::MatrixVectorMultiply(
+                    A, x_vector) == Ax_vector);
+    ASSERT_TRUE(matrix_library::cpu_parallel::matrix_ops::MatrixVectorMultiply(
+                    A_dense, x_vector) == Ax_vector);
+    ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+        matrix_library::utils::dense_matrix::ToNestedVector(
+            matrix_library::cpu_parallel::matrix_ops::OuterProduct(
+                u_vector, w.front())),
+        uw_ans));
+  }
+  ASSERT_TRUE(matrix_library::cpu_parallel::matrix_ops::Dot(
+                  w.front(), w.front()) ==
+              matrix_library::cpu_simple::matrix_ops::Dot(w.front(),
+                                                          w.front()));
+
+  // A ragged matrix is rejected even when it is large
+  A.back().pop_back();
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::matrix_ops::MatrixVectorMultiply(
+          A, x_vector),
+      std::runtime_error);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+}
+
+TEST(CpuParallelTest, BatchedMatrixMultiply) {
+  // Enough small products to be split across threads, in both forms
+  const size_t batch_size = 2000;
+  std::vector<double> a(batch_size * 64);
+  std::vector<double> b(batch_size * 64);
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<double>(i % 13) - 6.0;
+    b[i] = static_cast<double>(i % 7) - 3.0;
+  }
+  std::vector<double> c_ans(batch_size * 64);
+  matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply(
+      batch_size, 8, 8, 8, a.data(), 8, 64, b.data(), 8, 64, c_ans.data(), 8,
+      64);
+  std::vector<const double*> a_entries;
+  std::vector<const double*> b_entries;
+  for (size_t e = 0; e < batch_size; e++) {
+    a_entries.push_back(a.data() + e * 64);
+    b_entries.push_back(b.data() + e * 64);
+  }
+  for (size_t num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    matrix_library::cpu_parallel::parallel_config::SetNumThreads(num_threads);
+    std::vector<double> c(batch_size * 64);
+    matrix_library::cpu_parallel::matrix_ops::BatchedMatrixMultiply(
+        batch_size, 8, 8, 8, a.data(), 8, 64, b.data(), 8, 64, c.data(), 8,
+        64);
+    ASSERT_TRUE(c == c_ans);
+    std::vector<double> d(batch_size * 64);
+    std::vector<double*> d_entries;
+    for (size_t e = 0; e < batch_size; e++) {
+      d_entries.push_back(d.data() + e * 64);
+    }
+    matrix_library::cpu_parallel::matrix_ops::BatchedMatrixMultiply(
+        8, 8, 8, a_entries, 8, b_entries, 8, d_entries, 8);
+    ASSERT_TRUE(d == c_ans);
+  }
+
+  // Invalid batches are rejected even when they are large
+  std::vector<double> c(batch_size * 64);
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::matrix_ops::BatchedMatrixMultiply(
+          batch_size, 8, 8, 8, a.data(), 8, 64, b.data(), 8, 64, c.data(), 8,
+          32),
+      std::runtime_error);
+  a_entries.pop_back();
+  std::vector<double*> c_entries(batch_size, c.data());
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::matrix_ops::BatchedMatrixMultiply(
+          8, 8, 8, a_entries, 8, b_entries, 8, c_entries, 8),
+      std::runtime_error);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+}
+
+TEST(CpuParallelTest, MultiplyChain) {
+  // (A * B) * (C * D) runs its 2 independent products concurrently
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      8, 400, -3.0, 0.5);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      400, 8, 1.0, -0.25);
+  auto C = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      8, 400, 2.0, 0.125);
+  auto D = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      400, 8, -1.0, 0.5);
+  auto chain_ans = matrix_library::cpu_simple::matrix_ops::MultiplyChain(
+      {std::cref(A), std::cref(B), std::cref(C), std::cref(D)});
+  // A large product in the chain uses every thread on its own
+  auto E = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      300, 8, 1, 1);
+  auto F = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      300, 300, -10, 1);
+  auto large_ans = matrix_library::cpu_simple::matrix_ops::MultiplyChain(
+      {std::cref(F), std::cref(F), std::cref(F), std::cref(E)});
+  for (size_t num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    matrix_library::cpu_parallel::parallel_config::SetNumThreads(num_threads);
+    ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MultiplyChain(
+            {std::cref(A), std::cref(B), std::cref(C), std::cref(D)}),
+        chain_ans));
+    ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+        matrix_library::cpu_parallel::matrix_ops::MultiplyChain(
+            {std::cref(F), std::cref(F), std::cref(F), std::cref(E)}),
+        large_ans));
+  }
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::matrix_ops::MultiplyChain(
+          {std::cref(A), std::cref(C)}),
+      std::runtime_error);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+}
+
+TEST(CpuParallelTest, GemmEpilogues) {
+  namespace epilogues = matrix_library::cpu_simple::gemm_epilogues;
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      150, 600, -9000.0, 0.25);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      600, 90, 1.0, -0.25);
+  std::vector<double> bias(90);
+  for (size_t j = 0; j < 90; j++) {
+    bias[j] = static_cast<double>(j % 7) * 1e6;
+  }
+  auto AB = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  // Rows of C are split across threads, the epilogue still sees global rows,
+  // and the double products are stored as float
+  matrix_library::utils::dense_matrix::DenseMatrix<float> C(
+      150, 90, matrix_library::utils::dense_matrix::UninitializedTag());
+  matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyInto(
+      A, matrix_library::utils::dense_matrix::Operation::kNoTranspose, B,
+      matrix_library::utils::dense_matrix::Operation::kNoTranspose, C,
+      epilogues::Fuse(epilogues::ColumnBias<double>(bias.data()),
+                      epilogues::Relu(), [](size_t i, size_t, double value) {
+                        return value + static_cast<double>(i);
+                      }));
+  bool matches = true;
+  size_t num_positive = 0;
+  for (size_t i = 0; i < 150; i++) {
+    for (size_t j = 0; j < 90; j++) {
+      const double biased = AB(i, j) + bias[j];
+      num_positive += biased > 0 ? 1 : 0;
+      matches = matches &&
+                C(i, j) == static_cast<float>((biased > 0 ? biased : 0.0) +
+                                              static_cast<double>(i));
+    }
+  }
+  EXPECT_TRUE(matches);
+  // Both sides of the ReLU are exercised
+  EXPECT_TRUE(num_positive > 0 && num_positive < 150 * 90);
+}
+
+TEST(CpuParallelTest, PackedMatrixMultiply) {
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      160, 300, -2000.0, 0.25);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      300, 120, 3.0, -0.125);
+  auto AB_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  // Every thread reads the same panels of B
+  const matrix_library::cpu_simple::packed_matrix::PackedMatrix<double> packed(
+      B);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, packed),
+      AB_ans));
+  matrix_library::utils::dense_matrix::DenseMatrix<double> C(160, 120, 1.0);
+  matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyInto(A, packed, C,
+                                                               true);
+  matrix_library::utils::dense_matrix::DenseMatrix<float> D(
+      160, 120, matrix_library::utils::dense_matrix::UninitializedTag());
+  matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyInto(
+      A, packed, D, matrix_library::cpu_simple::gemm_epilogues::Relu());
+  bool matches = true;
+  for (size_t i = 0; i < 160; i++) {
+    for (size_t j = 0; j < 120; j++) {
+      matches = matches && C(i, j) == AB_ans(i, j) + 1.0 &&
+                D(i, j) == static_cast<float>(AB_ans(i, j) > 0 ? AB_ans(i, j)
+                                                               : 0.0);
+    }
+  }
+  EXPECT_TRUE(matches);
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(
+                   B, packed),
+               std::runtime_error);
+}
+
+TEST(CpuParallelTest, GemmPlan) {
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      171, 203, -9000, 1);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      157, 171, 5000, -3);
+  auto A_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A);
+  auto B_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(B);
+  auto AB_ans =
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A_T, B_T);
+  for (size_t num_threads = 1; num_threads <= 4; num_threads *= 4) {
+    matrix_library::cpu_parallel::gemm_plan::GemmPlan<int> plan(
+        203, 157, 171,
+        matrix_library::utils::dense_matrix::Operation::kTranspose,
+        matrix_library::utils::dense_matrix::Operation::kTranspose,
+        num_threads);
+    ASSERT_TRUE(plan.path() ==
+                matrix_library::cpu_parallel::gemm_plan::GemmPath::kBlocked);
+    auto C = matrix_library::utils::dense_matrix::CreateMatrix(203, 157, 1);
+    // The workspace is reused so repeated runs must give the same result
+    plan.Execute(A, B, C, true);
+    plan.Execute(A, B, C, true);
+    bool matches = true;
+    for (size_t i = 0; i < C.num_rows(); i++) {
+      for (size_t j = 0; j < C.num_cols(); j++) {
+        matches = matches && C(i, j) == 2 * AB_ans(i, j) + 1;
+      }
+    }
+    ASSERT_TRUE(matches);
+    matrix_library::cpu_parallel::gemm_plan::GemmPlan<int> plain_plan(
+        203, 157, 171,
+        matrix_library::utils::dense_matrix::Operation::kNoTranspose,
+        matrix_library::utils::dense_matrix::Operation::kNoTranspose,
+        num_threads);
+    plain_plan.Execute(A_T, B_T, C);
+    ASSERT_TRUE(
+        matrix_library::utils::dense_matrix::IsMatricesEqual(C, AB_ans));
+    EXPECT_THROW(plain_plan.Execute(A, B, C), std::runtime_error);
+    EXPECT_THROW(plain_plan.Execute(A_T, C, C), std::runtime_error);
+  }
+
+  // Small and vector shapes take the unpacked kernels
+  auto S = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      5, 7, -10, 1);
+  auto U = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      7, 3, 4, -1);
+  auto x = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      7, 1, 2, 1);
+  matrix_library::cpu_parallel::gemm_plan::GemmPlan<int> small_plan(5, 3, 7);
+  ASSERT_TRUE(small_plan.path() ==
+              matrix_library::cpu_parallel::gemm_plan::GemmPath::kSimple);
+  auto ST = matrix_library::utils::dense_matrix::CreateMatrix(5, 3, 9);
+  small_plan.Execute(S, U, ST);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      ST, matrix_library::cpu_simple::matrix_ops::MatrixMultiply(S, U)));
+  matrix_library::cpu_parallel::gemm_plan::GemmPlan<int> vector_plan(5, 1, 7);
+  ASSERT_TRUE(vector_plan.path() ==
+              matrix_library::cpu_parallel::gemm_plan::GemmPath::kVector);
+  auto Sx = matrix_library::utils::dense_matrix::CreateMatrix(5, 1, 0);
+  vector_plan.Execute(S, x, Sx);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      Sx, matrix_library::cpu_simple::matrix_ops::MatrixMultiply(S, x)));
+
+  // The gathered column lives in the plan, so the plan can run while another
+  // thread keeps the pool busy
+  auto M = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      4096, 64, -100, 1);
+  auto v = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      64, 1, 3, -1);
+  auto Mv_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(M, v);
+  matrix_library::cpu_parallel::gemm_plan::GemmPlan<int> parallel_plan(
+      4096, 1, 64,
+      matrix_library::utils::dense_matrix::Operation::kNoTranspose,
+      matrix_library::utils::dense_matrix::Operation::kNoTranspose, 4);
+  ASSERT_TRUE(
+      parallel_plan.path() ==
+      matrix_library::cpu_parallel::gemm_plan::GemmPath::kParallelVector);
+  auto G = matrix_library::utils::dense_matrix::CreateMatrix(256, 1024, 1);
+  auto H = matrix_library::utils::dense_matrix::CreateMatrix(1024, 256, 2);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(4);
+  std::thread gemm_thread([&G, &H]() {
+    for (size_t run = 0; run < 4; run++) {
+      matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(G, H);
+    }
+  });
+  bool matches = true;
+  auto Mv = matrix_library::utils::dense_matrix::CreateMatrix(4096, 1, 0);
+  for (size_t run = 0; run < 32; run++) {
+    parallel_plan.Execute(M, v, Mv);
+    matches = matches &&
+              matrix_library::utils::dense_matrix::IsMatricesEqual(Mv, Mv_ans);
+  }
+  gemm_thread.join();
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+  ASSERT_TRUE(matches);
+}
+
+TEST(CpuParallelTest, ConcurrentProducts) {
+  // A thread waiting on its own loop may run tasks of the other thread's
+  // loop, so neither may share per thread scratch with its workers
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(4);
+  auto A = matrix_library::utils::dense_matrix::CreateMatrix(256, 2048, 1.0f);
+  auto B = matrix_library::utils::dense_matrix::CreateMatrix(2048, 256, 0.5f);
+  auto M = matrix_library::utils::dense_matrix::CreateMatrix(4096, 64, 2.0f);
+  const std::vector<float> x(64, 0.25f);
+  std::atomic<bool> stop(false);
+  bool gemm_matches = true;
+  std::thread gemm_thread([&]() {
+    for (size_t run = 0; run < 8; run++) {
+      auto C = matrix_library::cpu_parallel::matrix_ops::MatrixMultiply(A, B);
+      gemm_matches = gemm_matches && C(255, 255) == 1024.0f;
+    }
+    stop.store(true);
+  });
+  bool vector_matches = true;
+  size_t num_runs = 0;
+  while (!stop.load() || num_runs < 8) {
+    const std::vector<float> y =
+        matrix_library::cpu_parallel::matrix_ops::MatrixVectorMultiply(M, x);
+    vector_matches = vector_matches && y[0] == 32.0f && y[4095] == 32.0f;
+    num_runs++;
+  }
+  gemm_thread.join();
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+  ASSERT_TRUE(gemm_matches);
+  ASSERT_TRUE(vector_matches);
+}
+
+TEST(CpuParallelTest, WorkStealingDeque) {
+  // The owner takes the newest item and thieves the oldest, across growth
+  int items[100];
+  matrix_library::cpu_parallel::thread_pool::WorkStealingDeque<int*> deque(4);
+  for (int& item : items) {
+    deque.Push(&item);
+  }
+  int* item = nullptr;
+  ASSERT_TRUE(deque.Steal(item) && item == &items[0]);
+  ASSERT_TRUE(deque.Pop(item) && item == &items[99]);
+  size_t count = 2;
+  while (deque.Pop(item)) {
+    count++;
+  }
+  ASSERT_TRUE(count == 100 && deque.Empty() && !deque.Steal(item));
+
+  // Every item is taken exactly once with thieves racing the owner
+  const size_t num_items = 20000;
+  std::vector<int> values(num_items, 0);
+  std::vector<std::atomic<int>> taken(num_items);
+  for (auto& flag : taken) {
+    flag.store(0);
+  }
+  std::atomic<bool> done(false);
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < 3; t++) {
+    thieves.emplace_back([&]() {
+      int* stolen = nullptr;
+      while (!done.load()) {
+        if (deque.Steal(stolen)) {
+          taken[static_cast<size_t>(stolen - values.data())]++;
+        }
+      }
+    });
+  }
+  for (size_t i = 0; i < num_items; i++) {
+    deque.Push(&values[i]);
+    if (i % 3 == 0 && deque.Pop(item)) {
+      taken[static_cast<size_t>(item - values.data())]++;
+    }
+  }
+  while (deque.Pop(item)) {
+    taken[static_cast<size_t>(item - values.data())]++;
+  }
+  while (!deque.Empty()) {
+  }
+  done.store(true);
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+  bool once = true;
+  for (auto& flag : taken) {
+    once = once && flag.load() == 1;
+  }
+  ASSERT_TRUE(once);
+}
+
+TEST(CpuParallelTest, ThreadPool) {
+  for (size_t num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    std::vector<std::atomic<int>> visits(1000);
+    for (auto& visit : visits) {
+      visit.store(0);
+    }
+    matrix_library::cpu_parallel::thread_pool::ParallelFor(
+        visits.size(), [&visits](size_t i) { visits[i]++; }, num_threads);
+    bool once = true;
+    for (auto& visit : visits) {
+      once = once && visit.load() == 1;
+    }
+    ASSERT_TRUE(once);
+  }
+
+  // Nested loops run on the threads already in the pool
+  matrix_library::cpu_parallel::thread_pool::SharedThreadPool().Reserve(3);
+  const size_t num_workers =
+      matrix_library::cpu_parallel::thread_pool::SharedThreadPool()
+          .num_workers();
+  std::atomic<size_t> sum(0);
+  matrix_library::cpu_parallel::thread_pool::ParallelFor(
+      16,
+      [&sum](size_t i) {
+        matrix_library::cpu_parallel::thread_pool::ParallelFor(
+            16, [&sum, i](size_t j) { sum += i * 16 + j; }, 4);
+      },
+      4);
+  ASSERT_TRUE(sum.load() == 256 * 255 / 2);
+  ASSERT_TRUE(matrix_library::cpu_parallel::thread_pool::SharedThreadPool()
+                  .num_workers() == num_workers);
+
+  std::vector<int> tiles(37 * 53, 0);
+  matrix_library::cpu_parallel::thread_pool::ParallelForTiles(
+      37, 53, 8, 16,
+      [&tiles](size_t row_start, size_t row_end, size_t col_start,
+               size_t col_end) {
+        for (size_t i = row_start; i < row_end; i++) {
+          for (size_t j = col_start; j < col_end; j++) {
+            tiles[i * 53 + j]++;
+          }
+        }
+      },
+      4);
+  bool covered = true;
+  for (int tile : tiles) {
+    covered = covered && tile == 1;
+  }
+  ASSERT_TRUE(covered);
+
+  // Parked workers wake up for the next loop and exceptions reach the caller
+  matrix_library::cpu_parallel::parallel_config::SetSpinCount(0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_THROW(matrix_library::cpu_parallel::thread_pool::ParallelFor(
+                   100,
+                   [](size_t i) {
+                     if (i == 42) {
+                       throw std::runtime_error("Iteration failed");
+                     }
+                   },
+                   4),
+               std::runtime_error);
+  matrix_library::cpu_parallel::parallel_config::SetSpinCount(
+      matrix_library::cpu_parallel::parallel_config::kDefaultSpinCount);
+}
+
+TEST(CpuParallelTest, NumaTopology) {
+  ASSERT_TRUE(matrix_library::cpu_parallel::numa_topology::ParseCpuList(
+                  "0-3,8,10-11\n") ==
+              std::vector<size_t>({0, 1, 2, 3, 8, 10, 11}));
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::numa_topology::ParseCpuList("0-,3"),
+      std::runtime_error);
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::numa_topology::ParseCpuList("3-1"),
+      std::runtime_error);
+
+  // Same layout as /sys/devices/system/node, node 2 holding only memory
+  const std::string root = ::testing::TempDir() + "numa_topology_test";
+  mkdir(root.c_str(), 0755);
+  mkdir((root + "/node0").c_str(), 0755);
+  mkdir((root + "/node1").c_str(), 0755);
+  mkdir((root + "/node2").c_str(), 0755);
+  std::ofstream(root + "/online") << "0-2\n";
+  std::ofstream(root + "/node0/cpulist") << "0-1,4\n";
+  std::ofstream(root + "/node1/cpulist") << "2-3\n";
+  std::ofstream(root + "/node2/cpulist") << "\n";
+  const auto topology =
+      matrix_library::cpu_parallel::numa_topology::ReadNumaTopology(root);
+  ASSERT_TRUE(topology.num_nodes() == 2);
+  ASSERT_TRUE(topology.nodes[1].id == 1);
+  ASSERT_TRUE(topology.nodes[0].cpus == std::vector<size_t>({0, 1, 4}));
+  ASSERT_TRUE(topology.NumCpus() == 5);
+  ASSERT_TRUE(topology.NodeOfCpu(3) == 1);
+  ASSERT_TRUE(matrix_library::cpu_parallel::numa_topology::ReadNumaTopology(
+                  root + "/missing")
+                  .num_nodes() == 1);
+
+  // Rows are split in whole micro-panels in proportion to the cores
+  ASSERT_TRUE(
+      matrix_library::cpu_parallel::numa_topology::PartitionRowsByNode(
+          100, 8, topology) == std::vector<size_t>({0, 56, 100}));
+  ASSERT_TRUE(matrix_library::cpu_parallel::numa_topology::ThreadsOnNode(
+                  1, 10, topology) == 4);
+  std::vector<size_t> block_bounds;
+  const auto blocks =
+      matrix_library::cpu_parallel::parallel_kernels::PartitionNodeRows(
+          100, 8, 5, topology, block_bounds);
+  size_t next_row = 0;
+  for (size_t node = 0; node < 2; node++) {
+    for (size_t i = block_bounds[node]; i < block_bounds[node + 1]; i++) {
+      ASSERT_TRUE(blocks[i].node == node && blocks[i].row_start == next_row);
+      next_row += blocks[i].rows;
+    }
+  }
+  ASSERT_TRUE(next_row == 100 && block_bounds[2] == blocks.size());
+}
+
+TEST(CpuParallelTest, NumaThreadPool) {
+  // Two nodes sharing the cores of this machine so node queues are used.
+  // Unpinned workers alternate between them
+  matrix_library::cpu_parallel::thread_affinity::SetAffinity(
+      matrix_library::cpu_parallel::thread_affinity::AffinityPolicy::kNone);
+  matrix_library::cpu_parallel::numa_topology::NumaTopology topology;
+  topology.nodes.push_back(
+      matrix_library::cpu_parallel::numa_topology::NumaNode{0, {0}});
+  topology.nodes.push_back(
+      matrix_library::cpu_parallel::numa_topology::NumaNode{1, {0}});
+  matrix_library::cpu_parallel::thread_pool::ThreadPool pool(topology);
+  pool.Reserve(3);
+  ASSERT_TRUE(pool.num_nodes() == 2);
+  std::vector<std::atomic<int>> visits(500);
+  for (auto& visit : visits) {
+    visit.store(0);
+  }
+  const std::vector<size_t> bounds = {0, 200, 500};
+  std::atomic<bool> on_node(true);
+  pool.ParallelForNodes(
+      bounds,
+      [&](size_t i) {
+        visits[i]++;
+        if (pool.CurrentNode() != (i < 200 ? 0u : 1u)) {
+          on_node.store(false);
+        }
+      },
+      4);
+  bool once = true;
+  for (auto& visit : visits) {
+    once = once && visit.load() == 1;
+  }
+  ASSERT_TRUE(once);
+  ASSERT_TRUE(on_node.load());
+  EXPECT_THROW(pool.ParallelForNodes(
+                   bounds,
+                   [](size_t i) {
+                     if (i == 300) {
+                       throw std::runtime_error("Iteration failed");
+                     }
+                   },
+                   4),
+               std::runtime_error);
+
+  // Each node packs its own copy of B
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      190, 170, -1000.0, 0.25);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      170, 150, 2.0, -0.125);
+  auto AB_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  matrix_library::utils::dense_matrix::DenseMatrix<double> C(190, 150, 1.0);
+  matrix_library::cpu_parallel::parallel_kernels::NumaGemm<double>(
+      190, 150, 170,
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<double>(
+          A.data(), A.leading_dimension(), 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<double>(
+          B.data(), B.leading_dimension(), 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<double>(
+          C.data(), C.leading_dimension()),
+      false, 4, pool);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(C, AB_ans));
+}
+
+TEST(CpuParallelTest, NestedNodeLoops) {
+  // The only worker is on node 1. It takes the second outer iteration and
+  // waits in an inner loop whose second half the caller steals and splits by
+  // node, so the worker has to serve node 1 while it waits
+  matrix_library::cpu_parallel::thread_affinity::SetAffinity(
+      matrix_library::cpu_parallel::thread_affinity::AffinityPolicy::kNone);
+  matrix_library::cpu_parallel::numa_topology::NumaTopology topology;
+  topology.nodes.push_back(
+      matrix_library::cpu_parallel::numa_topology::NumaNode{0, {0}});
+  topology.nodes.push_back(
+      matrix_library::cpu_parallel::numa_topology::NumaNode{1, {0}});
+  matrix_library::cpu_parallel::thread_pool::ThreadPool pool(topology);
+  pool.Reserve(1);
+  std::atomic<bool> outer_started(false);
+  std::atomic<bool> inner_started(false);
+  std::vector<std::atomic<int>> visits(2);
+  for (auto& visit : visits) {
+    visit.store(0);
+  }
+  pool.ParallelFor(
+      2,
+      [&](size_t outer) {
+        if (outer == 0) {
+          while (!outer_started.load()) {
+            std::this_thread::yield();
+          }
+          return;
+        }
+        outer_started.store(true);
+        pool.ParallelFor(
+            2,
+            [&](size_t inner) {
+              if (inner == 0) {
+                while (!inner_started.load()) {
+                  std::this_thread::yield();
+                }
+                return;
+              }
+              inner_started.store(true);
+              pool.ParallelForNodes(
+                  {0, 1, 2}, [&](size_t i) { visits[i]++; }, 2);
+            },
+            2);
+      },
+      2);
+  EXPECT_EQ(visits[0].load(), 1);
+  EXPECT_EQ(visits[1].load(), 1);
+}
+
+TEST(CpuParallelTest, CreateMatrix) {
+  for (size_t num_rows : {size_t{3}, size_t{600}}) {
+    auto matrix = matrix_library::cpu_parallel::matrix_ops::CreateMatrix(
+        num_rows, 500, 2.5f);
+    ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+        matrix, matrix_library::utils::dense_matrix::CreateMatrix(
+                    num_rows, 500, 2.5f)));
+  }
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::matrix_ops::CreateMatrix(0, 500, 2.5f),
+      std::runtime_error);
+}
+
+TEST(CpuParallelTest, ThreadAffinity) {
+  ASSERT_TRUE(matrix_library::cpu_parallel::thread_affinity::ParseAffinity(
+                  "scatter")
+                  .policy == matrix_library::cpu_parallel::thread_affinity::
+                                 AffinityPolicy::kScatter);
+  const auto cpu_list =
+      matrix_library::cpu_parallel::thread_affinity::ParseAffinity("5-6");
+  ASSERT_TRUE(cpu_list.policy == matrix_library::cpu_parallel::
+                                     thread_affinity::AffinityPolicy::kCpuList);
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::thread_affinity::ParseAffinity("spread"),
+      std::runtime_error);
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::thread_affinity::ParseAffinity("\n"),
+      std::runtime_error);
+  EXPECT_THROW(
+      matrix_library::cpu_parallel::thread_affinity::SetAffinity("\n"),
+      std::runtime_error);
+  EXPECT_THROW(matrix_library::cpu_parallel::thread_affinity::SetAffinityCpus(
+                   std::vector<size_t>()),
+               std::runtime_error);
+
+  // Compact fills node 0 first, scatter alternates nodes, lists wrap around
+  matrix_library::cpu_parallel::numa_topology::NumaTopology topology;
+  topology.nodes.push_back(
+      matrix_library::cpu_parallel::numa_topology::NumaNode{0, {0, 1}});
+  topology.nodes.push_back(
+      matrix_library::cpu_parallel::numa_topology::NumaNode{1, {2, 3}});
+  const auto compact =
+      matrix_library::cpu_parallel::thread_affinity::ParseAffinity("compact");
+  const auto scatter =
+      matrix_library::cpu_parallel::thread_affinity::ParseAffinity("scatter");
+  std::vector<size_t> compact_cpus;
+  std::vector<size_t> scatter_cpus;
+  std::vector<size_t> list_cpus;
+  for (size_t worker = 0; worker < 4; worker++) {
+    compact_cpus.push_back(
+        matrix_library::cpu_parallel::thread_affinity::WorkerCpus(
+            compact, topology, worker)[0]);
+    scatter_cpus.push_back(
+        matrix_library::cpu_parallel::thread_affinity::WorkerCpus(
+            scatter, topology, worker)[0]);
+    list_cpus.push_back(
+        matrix_library::cpu_parallel::thread_affinity::WorkerCpus(
+            cpu_list, topology, worker)[0]);
+  }
+  ASSERT_TRUE(compact_cpus == std::vector<size_t>({1, 2, 3, 0}));
+  ASSERT_TRUE(scatter_cpus == std::vector<size_t>({2, 1, 3, 0}));
+  ASSERT_TRUE(list_cpus == std::vector<size_t>({5, 6, 5, 6}));
+  ASSERT_TRUE(matrix_library::cpu_parallel::thread_affinity::WorkerCpus(
+                  matrix_library::cpu_parallel::thread_affinity::ParseAffinity(
+                      "none"),
+                  topology, 0)
+                  .empty());
+
+  // Workers are pinned when started and again when the policy changes
+  const std::vector<size_t> initial_cpus =
+      matrix_library::cpu_parallel::thread_affinity::CurrentThreadCpus();
+  matrix_library::cpu_parallel::thread_affinity::SetAffinityCpus(
+      {initial_cpus[0]});
+  matrix_library::cpu_parallel::thread_pool::ThreadPool pool;
+  pool.Reserve(2);
+  auto affinities = pool.WorkerAffinities();
+  ASSERT_TRUE(affinities.size() == 2);
+  for (const auto& affinity : affinities) {
+    ASSERT_TRUE(affinity.cpus == std::vector<size_t>({initial_cpus[0]}));
+  }
+  matrix_library::cpu_parallel::thread_affinity::SetAffinity(
+      matrix_library::cpu_parallel::thread_affinity::AffinityPolicy::kNone);
+  affinities = pool.WorkerAffinities();
+  for (const auto& affinity : affinities) {
+    ASSERT_TRUE(affinity.cpus == initial_cpus);
+  }
+  ASSERT_TRUE(matrix_library::cpu_parallel::thread_affinity::GetAffinity()
+                  .policy == matrix_library::cpu_parallel::thread_affinity::
+                                 AffinityPolicy::kNone);
+}
+
+TEST(CpuParallelTest, AsyncMatrixOps) {
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      150, 130, -500.0, 0.25);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      130, 140, 3.0, -0.125);
+  auto AB_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  // Operands are copied into the operation so A and B may change meanwhile
+  auto product =
+      matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyAsync(A, B);
+  auto transpose =
+      matrix_library::cpu_parallel::matrix_ops::MatrixTransposeAsync(A);
+  A(0, 0) = 1.0;
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      product.get(), AB_ans));
+  ASSERT_TRUE(transpose.get()(0, 0) == -500.0);
+
+  auto vector_product =
+      matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyAsync(
+          matrix_library::utils::matrix_utils::CreateMatrix(3, 4, 2),
+          matrix_library::utils::matrix_utils::CreateMatrix(4, 2, 3));
+  ASSERT_TRUE(vector_product.get() ==
+              matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 24));
+  EXPECT_THROW(matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyAsync(
+                   A, A)
+                   .get(),
+               std::runtime_error);
+
+  matrix_library::utils::dense_matrix::DenseMatrix<double> C(150, 140, 1.0);
+  matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyIntoAsync(A, B, C,
+                                                                    true)
+      .get();
+  ASSERT_TRUE(C(10, 20) == AB_ans(10, 20) + 1.0);
+
+  // Callbacks run on the executor, errors are passed instead of thrown
+  std::promise<double> first;
+  bool failed = false;
+  auto handle = matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyAsync(
+      B, A,
+      [&failed](matrix_library::utils::dense_matrix::DenseMatrix<double>&&
+                    result,
+                std::exception_ptr error) {
+        failed = error != nullptr && result.empty();
+      });
+  matrix_library::cpu_parallel::matrix_ops::MatrixTransposeAsync(
+      std::move(B),
+      [&first](matrix_library::utils::dense_matrix::DenseMatrix<double>&&
+                   result,
+               std::exception_ptr) { first.set_value(result(0, 0)); });
+  handle.get();
+  ASSERT_TRUE(failed);
+  ASSERT_TRUE(first.get_future().get() == 3.0);
+
+  // Products on the caller overlap the one on the executor and share the pool
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(4);
+  auto G = matrix_library::utils::dense_matrix::CreateMatrix(256, 2048, 1.0f);
+  auto H = matrix_library::utils::dense_matrix::CreateMatrix(2048, 256, 0.5f);
+  auto M = matrix_library::utils::dense_matrix::CreateMatrix(4096, 64, 2.0f);
+  const std::vector<float> v(64, 0.25f);
+  auto in_flight =
+      matrix_library::cpu_parallel::matrix_ops::MatrixMultiplyAsync(G, H);
+  bool vector_matches = true;
+  while (in_flight.wait_for(std::chrono::seconds(0)) !=
+         std::future_status::ready) {
+    const std::vector<float> y =
+        matrix_library::cpu_parallel::matrix_ops::MatrixVectorMultiply(M, v);
+    vector_matches = vector_matches && y[0] == 32.0f && y[4095] == 32.0f;
+  }
+  ASSERT_TRUE(in_flight.get()(255, 255) == 1024.0f);
+  matrix_library::cpu_parallel::parallel_config::SetNumThreads(0);
+  ASSERT_TRUE(vector_matches);
+}
+
+TEST(CpuParallelTest, TaskGraph) {
+  // Readers wait for the writer, the next writer waits for the readers
+  matrix_library::cpu_parallel::task_graph::TaskGraph graph;
+  std::vector<int> log;
+  std::mutex log_mutex;
+  int tile = 0;
+  int other_tile = 0;
+  auto record = [&log, &log_mutex](int value) {
+    return [&log, &log_mutex, value]() {
+      std::lock_guard<std::mutex> lock(log_mutex);
+      log.push_back(value);
+    };
+  };
+  graph.Submit(record(0),
+               {matrix_library::cpu_parallel::task_graph::Write(&tile)});
+  graph.Submit(record(1),
+               {matrix_library::cpu_parallel::task_graph::Read(&tile),
+                matrix_library::cpu_parallel::task_graph::Write(&other_tile)});
+  graph.Submit(record(1),
+               {matrix_library::cpu_parallel::task_graph::Read(&tile)});
+  graph.Submit(record(2),
+               {matrix_library::cpu_parallel::task_graph::ReadWrite(&tile),
+                matrix_library::cpu_parallel::task_graph::Read(&other_tile)});
+  ASSERT_TRUE(graph.num_tasks() == 4);
+  ASSERT_TRUE(graph.NumDependencies(0) == 0);
+  ASSERT_TRUE(graph.NumDependencies(2) == 1);
+  ASSERT_TRUE(graph.NumDependencies(3) == 2);
+  graph.Wait(4);
+  ASSERT_TRUE(log == std::vector<int>({0, 1, 1, 2}));
+  ASSERT_TRUE(graph.num_tasks() == 0);
+
+  // Tasks may run parallel loops of their own
+  std::atomic<size_t> sum(0);
+  for (size_t task = 0; task < 8; task++) {
+    graph.Submit(
+        [&sum, task]() {
+          matrix_library::cpu_parallel::thread_pool::ParallelFor(
+              16, [&sum, task](size_t i) { sum += task * 16 + i; }, 4);
+        },
+        {});
+  }
+  graph.Wait(4);
+  ASSERT_TRUE(sum.load() == 128 * 127 / 2);
+
+  // A chained product starts on each tile once the tiles it reads are done
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      100, 70, -300.0, 0.25);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      70, 90, 2.0, -0.125);
+  auto E = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      90, 50, 1.0, 0.5);
+  auto ABE_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B), E);
+  matrix_library::utils::dense_matrix::DenseMatrix<double> AB(100, 90, 7.0);
+  matrix_library::utils::dense_matrix::DenseMatrix<double> ABE(100, 50, 7.0);
+  matrix_library::cpu_parallel::task_graph::SubmitTiledMultiply(graph, A, B,
+                                                                AB, 32);
+  matrix_library::cpu_parallel::task_graph::SubmitTiledMultiply(graph, AB, E,
+                                                                ABE, 32);
+  graph.Wait(4);
+  ASSERT_TRUE(
+      matrix_library::utils::dense_matrix::IsMatricesEqual(ABE, ABE_ans));
+  EXPECT_THROW(matrix_library::cpu_parallel::task_graph::SubmitTiledMultiply(
+                   graph, A, E, AB, 32),
+               std::runtime_error);
+
+  // The first exception reaches Wait and the tasks after it are skipped
+  bool ran = false;
+  graph.Submit([]() { throw std::runtime_error("Task failed"); },
+               {matrix_library::cpu_parallel::task_graph::Write(&tile)});
+  graph.Submit([&ran]() { ran = true; },
+               {matrix_library::cpu_parallel::task_graph::Read(&tile)});
+  EXPECT_THROW(graph.Wait(4), std::runtime_error);
+  ASSERT_FALSE(ran);
+  graph.Wait(4);
+
+  // A task cannot wait on its own graph
+  graph.Submit([&graph]() { graph.Wait(2); }, {});
+  EXPECT_THROW(graph.Wait(4), std::runtime_error);
+}
+
+TEST(CpuParallelTest, ConcurrentTaskGraphs) {
+  // Threads waiting on their own graphs share the pool with the parallel
+  // loops of every task, so waiting threads run the tasks of other graphs
+  const size_t num_graphs = 8;
+  std::vector<std::atomic<size_t>> sums(num_graphs);
+  for (auto& sum : sums) {
+    sum.store(0);
+  }
+  std::vector<std::thread> threads;
+  for (size_t index = 0; index < num_graphs; index++) {
+    threads.emplace_back([&sums, index]() {
+      matrix_library::cpu_parallel::task_graph::TaskGraph graph;
+      std::atomic<size_t>& sum = sums[index];
+      for (size_t task = 0; task < 64; task++) {
+        graph.Submit(
+            [&sum, task]() {
+              matrix_library::cpu_parallel::thread_pool::ParallelFor(
+                  16,
+                  [&sum, task](size_t i) {
+                    sum += task * 16 + i;
+                    std::this_thread::yield();
+                  },
+                  8);
+            },
+            {});
+      }
+      graph.Wait(16);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  bool complete = true;
+  for (auto& sum : sums) {
+    complete = complete && sum.load() == 1024 * 1023 / 2;
+  }
+  ASSERT_TRUE(complete);
+}
@@ -9,11 +9,63 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <string>
 #include <vector>
 
+#include "matrix_library/cpu_simple/batched_gemm.h"
+#include "matrix_library/cpu_simple/blocked_gemm.h"
+#include "matrix_library/cpu_simple/cpu_features.h"
+#include "matrix_library/cpu_simple/gemm_epilogues.h"
+#include "matrix_library/cpu_simple/matrix_chain.h"
+#include "matrix_library/cpu_simple/matrix_expressions.h"
+#include "matrix_library/cpu_simple/packed_matrix.h"
 #include "matrix_library/cpu_simple/matrix_ops.h"
+#include "matrix_library/cpu_simple/simple_kernels.h"
+#include "matrix_library/cpu_simple/transpose_kernels.h"
+#include "matrix_library/cpu_simple/vector_kernels.h"
+#include "matrix_library/utils/dense_matrix.h"
 #include "matrix_library/utils/matrix_utils.h"
 
+/**
+ * @brief Straightforward i-k-j product used as the reference result
+ */
+template <typename T>
+std::vector<std::vector<T>> ReferenceMultiply(
+    const std::vector<std::vector<T>>& A,
+    const std::vector<std::vector<T>>& B) {
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(
+      A.size(), B.front().size(), static_cast<T>(0));
+  for (size_t i = 0; i < A.size(); i++) {
+    for (size_t k = 0; k < B.size(); k++) {
+      for (size_t j = 0; j < B.front().size(); j++) {
+        C[i][j] += A[i][k] * B[k][j];
+      }
+    }
+  }
+  return C;
+}
+
+/**
+ * @brief Matrix of small integer values between -8 and 8. Products of these
+ * are exact for floating point types in any summation order
+ */
+template <typename T>
+std::vector<std::vector<T>> PatternMatrix(size_t num_rows, size_t num_cols) {
+  auto matrix = matrix_library::utils::matrix_utils::CreateMatrix(
+      num_rows, num_cols, static_cast<T>(0));
+  for (size_t i = 0; i < num_rows; i++) {
+    for (size_t j = 0; j < num_cols; j++) {
+      matrix[i][j] = static_cast<T>(static_cast<int>((i * 7 + j * 3) % 17) - 8);
+    }
+  }
+  return matrix;
+}
+
 TEST(CpuSimpleTest, EmptyMatrixTranspose) {
   auto A = matrix_library::utils::matrix_utils::CreateMatrix(0, 0, 1);
   EXPECT_THROW(matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A),
@@ -231,6 +283,13 @@ TEST(CpuSimpleTest, MatrixTranspose) {
   auto I_ans = matrix_library::utils::matrix_utils::CreateMatrix(3, 2, 0.0);
   auto I_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(I_ans);
   ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(I, I_T));
+
+  // Rows of bools are packed and have no data()
+  std::vector<std::vector<bool>> J{{true, false, true}, {false, false, true}};
+  std::vector<std::vector<bool>> J_ans{
+      {true, false}, {false, false}, {true, true}};
+  auto J_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(J);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(J_ans, J_T));
 }
 
 TEST(CpuSimpleTest, TwoEmptyMatrixMultiply) {
@@ -1660,3 +1719,1300 @@ TEST(CpuSimpleTest, TwoMatricesMultiply) {
   ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(QR, QR_ans));
   ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(RQ, RQ_ans));
 }
+
+TEST(CpuSimpleTest, DenseMatrixTranspose) {
+  auto A = matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 1);
+  EXPECT_THROW(matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A),
+               std::runtime_error);
+  auto B = matrix_library::utils::dense_matrix::CreateMatrix(3, 0, 1.0f);
+  EXPECT_THROW(matrix_library::cpu_simple::matrix_ops::MatrixTranspose(B),
+               std::runtime_error);
+
+  auto C = matrix_library::utils::matrix_utils::CreateSequentialMatrix(4, 3, 1,
+                                                                       1);
+  auto C_T = matrix_library::utils::dense_matrix::ToNestedVector(
+      matrix_library::cpu_simple::matrix_ops::MatrixTranspose(
+          matrix_library::utils::dense_matrix::FromNestedVector(C)));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      C_T, matrix_library::cpu_simple::matrix_ops::MatrixTranspose(C)));
+
+  auto D = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      1, 5, -1.0f, 0.5f);
+  auto D_T = matrix_library::utils::dense_matrix::ToNestedVector(
+      matrix_library::cpu_simple::matrix_ops::MatrixTranspose(
+          matrix_library::utils::dense_matrix::FromNestedVector(D)));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      D_T, matrix_library::cpu_simple::matrix_ops::MatrixTranspose(D)));
+
+  matrix_library::utils::dense_matrix::DenseMatrix<double> E(2, 3, 5, 1.0);
+  auto E_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(E);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      E_T, matrix_library::utils::dense_matrix::CreateMatrix(3, 2, 1.0)));
+}
+
+TEST(CpuSimpleTest, DenseMatrixMultiply) {
+  auto A = matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 1);
+  auto B = matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 1);
+  ASSERT_TRUE(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B).empty());
+
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(3, 0, 1.0f);
+  auto CA = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+      C, matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 1.0f));
+  ASSERT_TRUE(CA.num_rows() == 3);
+  ASSERT_TRUE(CA.num_cols() == 0);
+
+  auto D = matrix_library::utils::dense_matrix::CreateMatrix(2, 3, 1.0);
+  EXPECT_THROW(matrix_library::cpu_simple::matrix_ops::MatrixMultiply(D, D),
+               std::runtime_error);
+
+  auto E = matrix_library::utils::matrix_utils::CreateSequentialMatrix(5, 3, -4,
+                                                                       1);
+  auto F = matrix_library::utils::matrix_utils::CreateSequentialMatrix(3, 4, 2,
+                                                                       -1);
+  auto EF = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+      matrix_library::utils::dense_matrix::FromNestedVector(E),
+      matrix_library::utils::dense_matrix::FromNestedVector(F));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(EF),
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(E, F)));
+
+  auto G = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      4, 2, 0.5f, 0.25f);
+  auto H = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      2, 3, -1.0f, 0.5f);
+  auto GH = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+      matrix_library::utils::dense_matrix::FromNestedVector(G),
+      matrix_library::utils::dense_matrix::FromNestedVector(H));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(GH),
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(G, H)));
+
+  matrix_library::utils::dense_matrix::DenseMatrix<double> I(2, 3, 7, 1.0);
+  matrix_library::utils::dense_matrix::DenseMatrix<double> J(3, 2, 4, -1.0);
+  auto IJ = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(I, J);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      IJ, matrix_library::utils::dense_matrix::CreateMatrix(2, 2, -3.0)));
+}
+
+TEST(CpuSimpleTest, BlockedMatrixMultiplyMatchesSimpleKernel) {
+  // Large enough to take the blocked path and ragged against every block size
+  ASSERT_TRUE(
+      matrix_library::cpu_simple::blocked_gemm::UseBlockedGemm(131, 77, 259));
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      131, 259, -5000, 3);
+  auto B = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      259, 77, 7000, -7);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B),
+      ReferenceMultiply(A, B)));
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(
+          matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+              matrix_library::utils::dense_matrix::FromNestedVector(A),
+              matrix_library::utils::dense_matrix::FromNestedVector(B))),
+      ReferenceMultiply(A, B)));
+
+  // Small integer valued floats are exact in any summation order
+  auto C = PatternMatrix<float>(70, 90);
+  auto E = PatternMatrix<float>(90, 70);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(C, E),
+      ReferenceMultiply(C, E)));
+  auto F = PatternMatrix<double>(65, 90);
+  auto D = PatternMatrix<double>(90, 65);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(F, D),
+      ReferenceMultiply(F, D)));
+}
+
+TEST(CpuSimpleTest, BlockedGemmRaggedBlocks) {
+  // Tiny blocks force every edge case of the packing and tile stores
+  const matrix_library::cpu_simple::blocked_gemm::BlockSizes blocks = {8, 5,
+                                                                       12};
+  const auto kernel =
+      matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<int>();
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      19, 23, -100, 3);
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      23, 29, 50, -1);
+  auto C_ans = ReferenceMultiply(
+      matrix_library::utils::dense_matrix::ToNestedVector(A),
+      matrix_library::utils::dense_matrix::ToNestedVector(B));
+  matrix_library::utils::dense_matrix::DenseMatrix<int> C(19, 29, 31, 0);
+  matrix_library::cpu_simple::blocked_gemm::Gemm<int>(
+      19, 29, 23,
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<int>(
+          A.data(), A.leading_dimension(), 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<int>(
+          B.data(), B.leading_dimension(), 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<int>(
+          C.data(), C.leading_dimension()),
+      false, kernel, blocks);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(C), C_ans));
+
+  // Accumulating adds the product on top of what is already there
+  matrix_library::cpu_simple::blocked_gemm::Gemm<int>(
+      19, 29, 23,
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<int>(
+          A.data(), A.leading_dimension(), 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<int>(
+          B.data(), B.leading_dimension(), 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<int>(
+          C.data(), C.leading_dimension()),
+      true, kernel, blocks);
+  for (auto& row : C_ans) {
+    for (auto& elem : row) {
+      elem *= 2;
+    }
+  }
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(C), C_ans));
+}
+
+TEST(CpuSimpleTest, AccessPoliciesAgree) {
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(7, 5, -3,
+                                                                       2);
+  auto B = matrix_library::utils::matrix_utils::CreateSequentialMatrix(5, 9, 4,
+                                                                       -1);
+  auto C_checked = matrix_library::utils::matrix_utils::CreateMatrix(7, 9, 1);
+  auto C_unchecked = matrix_library::utils::matrix_utils::CreateMatrix(7, 9, 1);
+  matrix_library::cpu_simple::simple_kernels::MultiplyAccumulate(
+      A, B, C_checked,
+      matrix_library::cpu_simple::simple_kernels::CheckedAccess());
+  matrix_library::cpu_simple::simple_kernels::MultiplyAccumulate(
+      A, B, C_unchecked,
+      matrix_library::cpu_simple::simple_kernels::UncheckedAccess());
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      C_checked, C_unchecked));
+
+  auto D = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      6, 4, 0.5f, 0.25f);
+  matrix_library::utils::dense_matrix::DenseMatrix<float> D_T_checked(4, 6,
+                                                                      0.0f);
+  matrix_library::utils::dense_matrix::DenseMatrix<float> D_T_unchecked(
+      4, 6, 0.0f);
+  matrix_library::cpu_simple::simple_kernels::Transpose(
+      D, D_T_checked,
+      matrix_library::cpu_simple::simple_kernels::CheckedAccess());
+  matrix_library::cpu_simple::simple_kernels::Transpose(
+      D, D_T_unchecked,
+      matrix_library::cpu_simple::simple_kernels::UncheckedAccess());
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      D_T_checked, D_T_unchecked));
+
+  // The checked policy reports an output that is too small
+  auto E = matrix_library::utils::matrix_utils::CreateMatrix(6, 9, 1);
+  EXPECT_THROW(matrix_library::cpu_simple::simple_kernels::MultiplyAccumulate(
+                   A, B, E,
+                   matrix_library::cpu_simple::simple_kernels::CheckedAccess()),
+               std::out_of_range);
+}
+
+/**
+ * @brief Runs the blocked kernel with the micro-kernel of every instruction
+ * set level the CPU supports and compares against the reference
+ */
+template <typename T>
+void ExpectEveryMicroKernelMatches(size_t m, size_t n, size_t k) {
+  auto A = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<T>(m, k));
+  auto B = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<T>(k, n));
+  auto C_ans = ReferenceMultiply(
+      matrix_library::utils::dense_matrix::ToNestedVector(A),
+      matrix_library::utils::dense_matrix::ToNestedVector(B));
+  const auto detected =
+      matrix_library::cpu_simple::cpu_features::DetectSimdLevel();
+  for (int level = 0; level <= static_cast<int>(detected); level++) {
+    const auto kernel =
+        matrix_library::cpu_simple::blocked_gemm::MicroKernelForLevel<T>(
+            static_cast<matrix_library::cpu_simple::cpu_features::SimdLevel>(
+                level));
+    // Small blocks so every kernel sees partial panels in every direction
+    const matrix_library::cpu_simple::blocked_gemm::BlockSizes blocks = {
+        2 * kernel.mr, 7, 3 * kernel.nr};
+    matrix_library::utils::dense_matrix::DenseMatrix<T> C(m, n,
+                                                          static_cast<T>(0));
+    matrix_library::cpu_simple::blocked_gemm::Gemm<T>(
+        m, n, k,
+        matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+            A.data(), A.leading_dimension(), 1),
+        matrix_library::cpu_simple::blocked_gemm::StridedOperand<T>(
+            B.data(), B.leading_dimension(), 1),
+        matrix_library::cpu_simple::blocked_gemm::StridedOutput<T>(
+            C.data(), C.leading_dimension()),
+        false, kernel, blocks);
+    EXPECT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+        matrix_library::utils::dense_matrix::ToNestedVector(C), C_ans))
+        << "SIMD level " << level;
+  }
+}
+
+TEST(CpuSimpleTest, SimdMicroKernelsMatchReference) {
+  ExpectEveryMicroKernelMatches<int>(37, 71, 23);
+  ExpectEveryMicroKernelMatches<int>(1, 33, 5);
+  ExpectEveryMicroKernelMatches<float>(37, 71, 23);
+  ExpectEveryMicroKernelMatches<float>(15, 17, 19);
+  ExpectEveryMicroKernelMatches<double>(37, 71, 23);
+  ExpectEveryMicroKernelMatches<double>(29, 9, 40);
+}
+
+TEST(CpuSimpleTest, SimdLevelNames) {
+  matrix_library::cpu_simple::cpu_features::SimdLevel level;
+  ASSERT_TRUE(
+      matrix_library::cpu_simple::cpu_features::ParseSimdLevel("avx2", &level));
+  ASSERT_TRUE(level ==
+              matrix_library::cpu_simple::cpu_features::SimdLevel::kAvx2);
+  ASSERT_FALSE(
+      matrix_library::cpu_simple::cpu_features::ParseSimdLevel("avx3", &level));
+  ASSERT_TRUE(matrix_library::cpu_simple::cpu_features::GetSimdLevel() <=
+              matrix_library::cpu_simple::cpu_features::DetectSimdLevel());
+}
+
+/**
+ * @brief Checks StrassenMultiply against the reference product with a small
+ * crossover so several levels of recursion and peeling run
+ */
+template <typename T>
+void ExpectStrassenMatches(size_t m, size_t n, size_t k, size_t crossover) {
+  auto A = PatternMatrix<T>(m, k);
+  auto B = PatternMatrix<T>(k, n);
+  auto C = matrix_library::cpu_simple::matrix_ops::StrassenMultiply(
+      matrix_library::utils::dense_matrix::FromNestedVector(A),
+      matrix_library::utils::dense_matrix::FromNestedVector(B), crossover);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(C),
+      ReferenceMultiply(A, B)));
+}
+
+TEST(CpuSimpleTest, StrassenMultiply) {
+  // Powers of two, odd sizes at every level and rectangular shapes
+  ExpectStrassenMatches<int>(64, 64, 64, 8);
+  ExpectStrassenMatches<int>(67, 53, 45, 4);
+  ExpectStrassenMatches<float>(96, 96, 96, 16);
+  ExpectStrassenMatches<float>(33, 100, 17, 4);
+  ExpectStrassenMatches<double>(75, 75, 75, 8);
+  ExpectStrassenMatches<double>(130, 41, 99, 10);
+  // Crossover at or above the smallest dimension never recurses
+  ExpectStrassenMatches<double>(20, 30, 40, 20);
+
+  ASSERT_TRUE(matrix_library::cpu_simple::strassen::WorkspaceSize(
+                  64, 64, 64, 64) == 0);
+  ASSERT_TRUE(matrix_library::cpu_simple::strassen::WorkspaceSize(
+                  64, 64, 64, 16) == 3 * 32 * 32 + 3 * 16 * 16);
+
+  auto D = matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 1.0);
+  auto DD = matrix_library::cpu_simple::matrix_ops::StrassenMultiply(D, D);
+  ASSERT_TRUE(DD.empty());
+  auto E = matrix_library::utils::dense_matrix::CreateMatrix(3, 2, 1);
+  EXPECT_THROW(matrix_library::cpu_simple::matrix_ops::StrassenMultiply(E, E),
+               std::runtime_error);
+}
+
+TEST(CpuSimpleTest, MatrixMultiplyInto) {
+  // Small products take the simple loop and large ones the blocked kernel
+  auto A = PatternMatrix<int>(5, 4);
+  auto B = PatternMatrix<int>(4, 3);
+  auto C = matrix_library::utils::matrix_utils::CreateMatrix(5, 3, 100);
+  const int* row_data = C.front().data();
+  matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(A, B, C);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      C, ReferenceMultiply(A, B)));
+  ASSERT_TRUE(C.front().data() == row_data);
+  matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(A, B, C, true);
+  auto AB = ReferenceMultiply(A, B);
+  for (auto& row : AB) {
+    for (auto& value : row) {
+      value *= 2;
+    }
+  }
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(C, AB));
+
+  auto D = PatternMatrix<float>(70, 90);
+  auto E = PatternMatrix<float>(90, 80);
+  auto F = matrix_library::utils::matrix_utils::CreateMatrix(70, 80, 1.0f);
+  matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(D, E, F, true);
+  auto DE = ReferenceMultiply(D, E);
+  for (auto& row : DE) {
+    for (auto& value : row) {
+      value += 1.0f;
+    }
+  }
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(F, DE));
+
+  auto G = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<double>(65, 90));
+  auto H = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<double>(90, 70));
+  matrix_library::utils::dense_matrix::DenseMatrix<double> I(65, 70, 75, 3.0);
+  const double* data = I.data();
+  matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(G, H, I);
+  ASSERT_TRUE(I.data() == data);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      I, matrix_library::cpu_simple::matrix_ops::MatrixMultiply(G, H)));
+  // Small dense products take the simple loop
+  auto J = matrix_library::utils::dense_matrix::CreateMatrix(2, 3, 1);
+  auto K = matrix_library::utils::dense_matrix::CreateMatrix(3, 2, 2);
+  auto L = matrix_library::utils::dense_matrix::CreateMatrix(2, 2, 1);
+  matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(J, K, L, true);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      L, matrix_library::utils::dense_matrix::CreateMatrix(2, 2, 7)));
+
+  // Wrong shapes and aliasing are rejected
+  auto M = matrix_library::utils::matrix_utils::CreateMatrix(5, 4, 0);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(A, B, M),
+      std::runtime_error);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(B, A, C),
+      std::runtime_error);
+  auto N = matrix_library::utils::dense_matrix::CreateMatrix(2, 2, 1);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(N, N, N),
+      std::runtime_error);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(J, K, J),
+      std::runtime_error);
+}
+
+TEST(CpuSimpleTest, MatrixTransposeInto) {
+  auto A = PatternMatrix<int>(3, 5);
+  auto A_T = matrix_library::utils::matrix_utils::CreateMatrix(5, 3, 0);
+  const int* row_data = A_T.front().data();
+  matrix_library::cpu_simple::matrix_ops::MatrixTransposeInto(A, A_T);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      A_T, matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A)));
+  ASSERT_TRUE(A_T.front().data() == row_data);
+
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      4, 6, 0.0f, 0.5f);
+  matrix_library::utils::dense_matrix::DenseMatrix<float> B_T(6, 4, 9, 0.0f);
+  matrix_library::cpu_simple::matrix_ops::MatrixTransposeInto(B, B_T);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      B_T, matrix_library::cpu_simple::matrix_ops::MatrixTranspose(B)));
+
+  auto C = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      3, 3, 0.0, 1.0);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixTransposeInto(C, C),
+      std::runtime_error);
+  auto D = matrix_library::utils::matrix_utils::CreateMatrix(3, 5, 0);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixTransposeInto(A, D),
+      std::runtime_error);
+}
+
+/**
+ * @brief Checks the cache-oblivious transpose with every tile kernel the CPU
+ * supports against the reference transpose
+ */
+template <typename T>
+void ExpectEveryTransposeKernelMatches(size_t num_rows, size_t num_cols) {
+  // Padded rows so the leading dimensions differ from the widths
+  matrix_library::utils::dense_matrix::DenseMatrix<T> A(
+      num_rows, num_cols, num_cols + 3, static_cast<T>(0));
+  for (size_t i = 0; i < num_rows; i++) {
+    for (size_t j = 0; j < num_cols; j++) {
+      A(i, j) = static_cast<T>(i * num_cols + j);
+    }
+  }
+  const auto detected =
+      matrix_library::cpu_simple::cpu_features::DetectSimdLevel();
+  for (int level = 0; level <= static_cast<int>(detected); level++) {
+    const auto kernel =
+        matrix_library::cpu_simple::transpose_kernels::TransposeKernelForLevel<
+            T>(static_cast<matrix_library::cpu_simple::cpu_features::SimdLevel>(
+            level));
+    matrix_library::utils::dense_matrix::DenseMatrix<T> A_T(
+        num_cols, num_rows, num_rows + 5, static_cast<T>(-1));
+    matrix_library::cpu_simple::transpose_kernels::TransposeRecursive(
+        num_rows, num_cols, A.data(), A.leading_dimension(), A_T.data(),
+        A_T.leading_dimension(), kernel);
+    bool matches = true;
+    for (size_t i = 0; i < num_rows; i++) {
+      for (size_t j = 0; j < num_cols; j++) {
+        matches = matches && A_T(j, i) == A(i, j);
+      }
+    }
+    EXPECT_TRUE(matches) << "SIMD level " << level;
+  }
+}
+
+TEST(CpuSimpleTest, SimdTransposeKernelsMatchReference) {
+  // Leaves, recursion on both sides and ragged edges against every tile size
+  ExpectEveryTransposeKernelMatches<int>(8, 8);
+  ExpectEveryTransposeKernelMatches<int>(301, 259);
+  ExpectEveryTransposeKernelMatches<float>(1, 200);
+  ExpectEveryTransposeKernelMatches<float>(67, 130);
+  ExpectEveryTransposeKernelMatches<double>(200, 3);
+  ExpectEveryTransposeKernelMatches<double>(129, 129);
+}
+
+/**
+ * @brief Checks the in place transpose of a padded sequential matrix against
+ * the out of place transpose
+ */
+template <typename T>
+void ExpectTransposeInPlaceMatches(size_t num_rows, size_t num_cols,
+                                   size_t leading_dimension) {
+  matrix_library::utils::dense_matrix::DenseMatrix<T> A(
+      num_rows, num_cols, leading_dimension, static_cast<T>(0));
+  for (size_t i = 0; i < num_rows; i++) {
+    for (size_t j = 0; j < num_cols; j++) {
+      A(i, j) = static_cast<T>(i * num_cols + j);
+    }
+  }
+  const auto expected =
+      matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A);
+  const T* buffer = A.data();
+  matrix_library::cpu_simple::matrix_ops::MatrixTransposeInPlace(A);
+  EXPECT_TRUE(A.data() == buffer);
+  EXPECT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(A,
+                                                                   expected));
+}
+
+TEST(CpuSimpleTest, MatrixTransposeInPlace) {
+  // Square matrices over whole and partial blocks keep their padding
+  ExpectTransposeInPlaceMatches<int>(1, 1, 1);
+  ExpectTransposeInPlaceMatches<int>(64, 64, 64);
+  ExpectTransposeInPlaceMatches<float>(130, 130, 133);
+  ExpectTransposeInPlaceMatches<double>(7, 7, 7);
+  // Other shapes, packed and padded, including vectors
+  ExpectTransposeInPlaceMatches<int>(1, 9, 9);
+  ExpectTransposeInPlaceMatches<int>(9, 1, 4);
+  ExpectTransposeInPlaceMatches<float>(3, 5, 5);
+  ExpectTransposeInPlaceMatches<float>(67, 130, 131);
+  ExpectTransposeInPlaceMatches<double>(200, 3, 3);
+  ExpectTransposeInPlaceMatches<double>(12, 18, 20);
+
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      2, 3, 0.0, 1.0);
+  matrix_library::cpu_simple::matrix_ops::MatrixTransposeInPlace(B);
+  ASSERT_TRUE(B.num_rows() == 3);
+  ASSERT_TRUE(B.num_cols() == 2);
+  ASSERT_TRUE(B.leading_dimension() == 2);
+  ASSERT_TRUE(B(2, 1) == 5.0);
+
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 1);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixTransposeInPlace(C),
+      std::runtime_error);
+  auto D = matrix_library::utils::dense_matrix::CreateMatrix(2, 0, 1.0f);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixTransposeInPlace(D),
+      std::runtime_error);
+}
+
+/**
+ * @brief Checks every combination of transposed operands against multiplying
+ * materialized transposes. Pattern values keep floating point sums exact
+ */
+template <typename T>
+void ExpectTransposedOperandsMatch(size_t m, size_t n, size_t k) {
+  auto A = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<T>(m, k));
+  auto B = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<T>(k, n));
+  auto A_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A);
+  auto B_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(B);
+  auto AB_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  EXPECT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+          matrix_library::utils::dense_matrix::Transposed(A_T), B),
+      AB_ans));
+  EXPECT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+          A, matrix_library::utils::dense_matrix::Transposed(B_T)),
+      AB_ans));
+  EXPECT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+          matrix_library::utils::dense_matrix::Transposed(A_T),
+          matrix_library::utils::dense_matrix::Transposed(B_T)),
+      AB_ans));
+
+  // Accumulating into a padded C doubles the product
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(m, n, n + 3,
+                                                        static_cast<T>(0));
+  for (int rep = 0; rep < 2; rep++) {
+    matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+        A_T, matrix_library::utils::dense_matrix::Operation::kTranspose, B_T,
+        matrix_library::utils::dense_matrix::Operation::kTranspose, C,
+        rep == 1);
+  }
+  bool matches = true;
+  for (size_t i = 0; i < m; i++) {
+    for (size_t j = 0; j < n; j++) {
+      matches = matches && C(i, j) == AB_ans(i, j) + AB_ans(i, j);
+    }
+  }
+  EXPECT_TRUE(matches);
+}
+
+TEST(CpuSimpleTest, TransposedOperandsMultiply) {
+  // Small products use the simple loop and large ones the blocked kernel
+  ExpectTransposedOperandsMatch<int>(3, 4, 5);
+  ExpectTransposedOperandsMatch<int>(70, 81, 90);
+  ExpectTransposedOperandsMatch<float>(1, 7, 1);
+  ExpectTransposedOperandsMatch<float>(67, 130, 65);
+  ExpectTransposedOperandsMatch<double>(9, 1, 4);
+  ExpectTransposedOperandsMatch<double>(100, 64, 77);
+
+  // A * A^T is the common case of multiplying by a transpose
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(4, 3, 1,
+                                                                       1);
+  auto AAT = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+      A, matrix_library::utils::dense_matrix::Transposed(A));
+  ASSERT_TRUE(AAT.num_rows() == 4);
+  ASSERT_TRUE(AAT.num_cols() == 4);
+  ASSERT_TRUE(AAT(1, 2) == 4 * 7 + 5 * 8 + 6 * 9);
+
+  EXPECT_THROW(matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+                   matrix_library::utils::dense_matrix::Transposed(A),
+                   matrix_library::utils::dense_matrix::Transposed(A)),
+               std::runtime_error);
+  // A^T * A is 3 x 3
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(3, 4, 0);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+          A, matrix_library::utils::dense_matrix::Operation::kTranspose, A,
+          matrix_library::utils::dense_matrix::Operation::kNoTranspose, C),
+      std::runtime_error);
+}
+
+/**
+ * @brief Checks the symmetric rank-k update against the general product for
+ * both orientations, overwriting and accumulating into a padded C
+ */
+template <typename T>
+void ExpectSymmetricRankKMatches(size_t n, size_t k) {
+  auto A = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<T>(n, k));
+  auto AAT_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+      A, matrix_library::utils::dense_matrix::Transposed(A));
+  auto ATA_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+      matrix_library::utils::dense_matrix::Transposed(A), A);
+  EXPECT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::SymmetricRankKUpdate(A),
+      AAT_ans));
+  EXPECT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::SymmetricRankKUpdate(
+          A, matrix_library::utils::dense_matrix::Operation::kTranspose),
+      ATA_ans));
+
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(n, n, n + 5,
+                                                        static_cast<T>(0));
+  for (int rep = 0; rep < 2; rep++) {
+    matrix_library::cpu_simple::matrix_ops::SymmetricRankKUpdateInto(
+        A, matrix_library::utils::dense_matrix::Operation::kNoTranspose, C,
+        rep == 1);
+  }
+  bool matches = true;
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = 0; j < n; j++) {
+      matches = matches && C(i, j) == AAT_ans(i, j) + AAT_ans(i, j);
+    }
+  }
+  EXPECT_TRUE(matches);
+}
+
+TEST(CpuSimpleTest, SymmetricRankKUpdate) {
+  // Small products use the simple loop and large ones the blocked kernel with
+  // tiles crossing the diagonal
+  ExpectSymmetricRankKMatches<int>(1, 1);
+  ExpectSymmetricRankKMatches<int>(5, 3);
+  ExpectSymmetricRankKMatches<int>(131, 70);
+  ExpectSymmetricRankKMatches<float>(2, 9);
+  ExpectSymmetricRankKMatches<float>(100, 129);
+  ExpectSymmetricRankKMatches<double>(7, 1);
+  ExpectSymmetricRankKMatches<double>(90, 65);
+
+  // An empty inner dimension gives zeros
+  auto B = matrix_library::utils::dense_matrix::CreateMatrix(3, 0, 1.0f);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::SymmetricRankKUpdate(B),
+      matrix_library::utils::dense_matrix::CreateMatrix(3, 3, 0.0f)));
+
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(4, 3, 1);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::SymmetricRankKUpdateInto(
+          C, matrix_library::utils::dense_matrix::Operation::kTranspose, C),
+      std::runtime_error);
+  auto D = matrix_library::utils::dense_matrix::CreateMatrix(3, 3, 0);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::SymmetricRankKUpdateInto(
+          C, matrix_library::utils::dense_matrix::Operation::kNoTranspose, D),
+      std::runtime_error);
+}
+
+/**
+ * @brief Checks the streaming kernels of every instruction set the CPU
+ * supports against scalar loops, over lengths with and without tails
+ */
+template <typename T>
+void ExpectEveryVectorKernelMatches(size_t n) {
+  const auto x = PatternMatrix<T>(1, n).front();
+  const auto y = PatternMatrix<T>(2, n).back();
+  T dot_ans = static_cast<T>(0);
+  std::vector<T> axpy_ans(y);
+  std::vector<T> scale_ans(n);
+  for (size_t i = 0; i < n; i++) {
+    dot_ans += x[i] * y[i];
+    axpy_ans[i] += static_cast<T>(3) * x[i];
+    scale_ans[i] = static_cast<T>(-2) * x[i];
+  }
+  const auto detected =
+      matrix_library::cpu_simple::cpu_features::DetectSimdLevel();
+  for (int level = 0; level <= static_cast<int>(detected); level++) {
+    const auto kernels =
+        matrix_library::cpu_simple::vector_kernels::VectorKernelsForLevel<T>(
+            static_cast<matrix_library::cpu_simple::cpu_features::SimdLevel>(
+                level));
+    EXPECT_TRUE(kernels.dot(n, x.data(), y.data()) == dot_ans)
+        << "SIMD level " << level;
+    std::vector<T> axpy(y);
+    kernels.axpy(n, static_cast<T>(3), x.data(), axpy.data());
+    EXPECT_TRUE(axpy == axpy_ans) << "SIMD level " << level;
+    std::vector<T> scale(n, static_cast<T>(1));
+    kernels.scale(n, static_cast<T>(-2), x.data(), scale.data());
+    EXPECT_TRUE(scale == scale_ans) << "SIMD level " << level;
+  }
+}
+
+TEST(CpuSimpleTest, SimdVectorKernelsMatchReference) {
+  ExpectEveryVectorKernelMatches<int>(1);
+  ExpectEveryVectorKernelMatches<int>(203);
+  ExpectEveryVectorKernelMatches<float>(15);
+  ExpectEveryVectorKernelMatches<float>(64);
+  ExpectEveryVectorKernelMatches<double>(3);
+  ExpectEveryVectorKernelMatches<double>(131);
+}
+
+/**
+ * @brief Checks a product of the given shape through both MatrixMultiply
+ * overloads and accumulating into a padded C against the reference product
+ */
+template <typename T>
+void ExpectVectorShapeMatches(size_t m, size_t n, size_t k) {
+  auto A = PatternMatrix<T>(m, k);
+  auto B = PatternMatrix<T>(k, n);
+  auto AB_ans = ReferenceMultiply(A, B);
+  EXPECT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B), AB_ans));
+  auto A_dense = matrix_library::utils::dense_matrix::FromNestedVector(A);
+  auto B_dense = matrix_library::utils::dense_matrix::FromNestedVector(B);
+  matrix_library::utils::dense_matrix::DenseMatrix<T> C(m, n, n + 2,
+                                                        static_cast<T>(1));
+  matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(A_dense, B_dense,
+                                                             C, true);
+  for (auto& row : AB_ans) {
+    for (auto& value : row) {
+      value += static_cast<T>(1);
+    }
+  }
+  EXPECT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(C), AB_ans));
+}
+
+TEST(CpuSimpleTest, VectorShapesMultiply) {
+  // Dot, matrix-vector, vector-matrix and outer products with ragged tails
+  ExpectVectorShapeMatches<int>(1, 1, 1);
+  ExpectVectorShapeMatches<int>(1, 1, 1000);
+  ExpectVectorShapeMatches<int>(300, 1, 77);
+  ExpectVectorShapeMatches<float>(1, 129, 40);
+  ExpectVectorShapeMatches<float>(65, 33, 1);
+  ExpectVectorShapeMatches<double>(1, 5, 1);
+  ExpectVectorShapeMatches<double>(7, 1, 1);
+  ExpectVectorShapeMatches<double>(2, 1, 9);
+}
+
+TEST(CpuSimpleTest, DotMatrixVectorOuterProduct) {
+  std::vector<int> x = {1, 2, 3};
+  std::vector<int> y = {4, -5, 6};
+  ASSERT_TRUE(matrix_library::cpu_simple::matrix_ops::Dot(x, y) == 12);
+  EXPECT_THROW(matrix_library::cpu_simple::matrix_ops::Dot(
+                   x, std::vector<int>(2, 1)),
+               std::runtime_error);
+
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      2, 3, 1.0f, 1.0f);
+  std::vector<float> v = {1.0f, 0.0f, -1.0f};
+  std::vector<float> Av_ans = {-2.0f, -2.0f};
+  ASSERT_TRUE(matrix_library::cpu_simple::matrix_ops::MatrixVectorMultiply(
+                  A, v) == Av_ans);
+  ASSERT_TRUE(matrix_library::cpu_simple::matrix_ops::MatrixVectorMultiply(
+                  matrix_library::utils::dense_matrix::FromNestedVector(A),
+                  v) == Av_ans);
+  EXPECT_THROW(matrix_library::cpu_simple::matrix_ops::MatrixVectorMultiply(
+                   A, std::vector<float>(2, 1.0f)),
+               std::runtime_error);
+
+  std::vector<double> u = {1.0, -2.0};
+  std::vector<double> w = {0.5, 1.0, 2.0};
+  auto uw = matrix_library::cpu_simple::matrix_ops::OuterProduct(u, w);
+  ASSERT_TRUE(uw.num_rows() == 2);
+  ASSERT_TRUE(uw.num_cols() == 3);
+  ASSERT_TRUE(uw(1, 2) == -4.0);
+  ASSERT_TRUE(uw(0, 0) == 0.5);
+  auto empty = matrix_library::cpu_simple::matrix_ops::OuterProduct(
+      std::vector<double>(), w);
+  ASSERT_TRUE(empty.empty());
+  ASSERT_TRUE(empty.num_cols() == 0);
+}
+
+/**
+ * @brief Copies a matrix into a row-major block of a larger buffer
+ */
+template <typename T>
+void StoreBlock(const std::vector<std::vector<T>>& matrix, T* block,
+                size_t ld) {
+  for (size_t i = 0; i < matrix.size(); i++) {
+    std::copy(matrix[i].begin(), matrix[i].end(), block + i * ld);
+  }
+}
+
+/**
+ * @brief Checks whether a row-major block of a larger buffer equals a matrix
+ */
+template <typename T>
+bool IsBlockEqual(const std::vector<std::vector<T>>& matrix, const T* block,
+                  size_t ld) {
+  for (size_t i = 0; i < matrix.size(); i++) {
+    if (!std::equal(matrix[i].begin(), matrix[i].end(), block + i * ld)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Checks a batch of products of the given shape in strided form and
+ * then accumulated in pointer-array form against the reference product, with
+ * padded leading dimensions and gaps between entries
+ */
+template <typename T>
+void ExpectBatchMatches(size_t batch_size, size_t m, size_t n, size_t k) {
+  const size_t lda = k + 1;
+  const size_t ldb = n + 2;
+  const size_t ldc = n + 1;
+  const size_t stride_a = m * lda + 3;
+  const size_t stride_b = k * ldb;
+  const size_t stride_c = m * ldc + 1;
+  std::vector<T> a(batch_size * stride_a, static_cast<T>(0));
+  std::vector<T> b(batch_size * stride_b, static_cast<T>(0));
+  std::vector<T> c(batch_size * stride_c, static_cast<T>(7));
+  std::vector<std::vector<std::vector<T>>> answers;
+  for (size_t e = 0; e < batch_size; e++) {
+    auto A = PatternMatrix<T>(m, k);
+    auto B = PatternMatrix<T>(k, n);
+    // Make entries differ from each other
+    if (m > 0 && k > 0) {
+      A[e % m][e % k] += static_cast<T>(e);
+    }
+    StoreBlock(A, a.data() + e * stride_a, lda);
+    StoreBlock(B, b.data() + e * stride_b, ldb);
+    answers.push_back(ReferenceMultiply(A, B));
+  }
+  matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply(
+      batch_size, m, n, k, a.data(), lda, stride_a, b.data(), ldb, stride_b,
+      c.data(), ldc, stride_c);
+  for (size_t e = 0; e < batch_size; e++) {
+    EXPECT_TRUE(IsBlockEqual(answers[e], c.data() + e * stride_c, ldc))
+        << "Entry " << e;
+  }
+
+  std::vector<const T*> a_entries;
+  std::vector<const T*> b_entries;
+  std::vector<T*> c_entries;
+  for (size_t e = 0; e < batch_size; e++) {
+    a_entries.push_back(a.data() + e * stride_a);
+    b_entries.push_back(b.data() + e * stride_b);
+    c_entries.push_back(c.data() + e * stride_c);
+    for (auto& row : answers[e]) {
+      for (auto& value : row) {
+        value += value;
+      }
+    }
+  }
+  matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply(
+      m, n, k, a_entries, lda, b_entries, ldb, c_entries, ldc, true);
+  for (size_t e = 0; e < batch_size; e++) {
+    EXPECT_TRUE(IsBlockEqual(answers[e], c.data() + e * stride_c, ldc))
+        << "Entry " << e;
+  }
+  // The gaps between entries are never written
+  EXPECT_TRUE(batch_size == 0 || c[m * ldc] == static_cast<T>(7));
+}
+
+TEST(CpuSimpleTest, BatchedMatrixMultiply) {
+  // Fixed dimension kernels
+  ExpectBatchMatches<int>(50, 4, 4, 4);
+  ExpectBatchMatches<float>(9, 8, 8, 8);
+  ExpectBatchMatches<double>(5, 32, 32, 32);
+  ExpectBatchMatches<double>(3, 3, 3, 3);
+  // Simple loop, blocked kernel and degenerate shapes
+  ExpectBatchMatches<int>(7, 5, 3, 9);
+  ExpectBatchMatches<float>(2, 70, 66, 65);
+  ExpectBatchMatches<int>(0, 4, 4, 4);
+  // An empty inner dimension sets C to 0
+  std::vector<double> zeros(12, 1.0);
+  matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply<double>(
+      2, 2, 3, 0, nullptr, 0, 0, nullptr, 3, 0, zeros.data(), 3, 6);
+  ASSERT_TRUE(zeros == std::vector<double>(12, 0.0));
+
+  // A stride of 0 reuses one B for the whole batch
+  auto A = PatternMatrix<float>(4, 4);
+  auto B = PatternMatrix<float>(4, 4);
+  std::vector<float> a(8 * 16);
+  std::vector<float> b(16);
+  std::vector<float> c(8 * 16);
+  for (size_t e = 0; e < 8; e++) {
+    StoreBlock(A, a.data() + e * 16, 4);
+  }
+  StoreBlock(B, b.data(), 4);
+  matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply(
+      8, 4, 4, 4, a.data(), 4, 16, b.data(), 4, 0, c.data(), 4, 16);
+  for (size_t e = 0; e < 8; e++) {
+    ASSERT_TRUE(IsBlockEqual(ReferenceMultiply(A, B), c.data() + e * 16, 4));
+  }
+
+  // Entries of C overlapping, short leading dimensions and mismatched batches
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply(
+          8, 4, 4, 4, a.data(), 4, 16, b.data(), 4, 0, c.data(), 4, 12),
+      std::runtime_error);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply(
+          8, 4, 4, 4, a.data(), 3, 16, b.data(), 4, 0, c.data(), 4, 16),
+      std::runtime_error);
+  std::vector<const float*> a_entries = {a.data(), a.data() + 16};
+  std::vector<const float*> b_entries = {b.data(), b.data()};
+  std::vector<float*> c_entries = {c.data()};
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply(
+          4, 4, 4, a_entries, 4, b_entries, 4, c_entries, 4),
+      std::runtime_error);
+  c_entries.push_back(c.data() + 16);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::BatchedMatrixMultiply(
+          4, 4, 4, a_entries, 4, b_entries, 4, c_entries, 3),
+      std::runtime_error);
+}
+
+TEST(CpuSimpleTest, MatrixChainPlan) {
+  // A * (B * C) avoids the large intermediate of (A * B) * C
+  auto plan =
+      matrix_library::cpu_simple::matrix_chain::PlanChain({500, 500, 500, 1});
+  ASSERT_TRUE(plan.num_matrices() == 3);
+  ASSERT_TRUE(plan.Split(0, 2) == 0);
+  ASSERT_TRUE(plan.cost * 10 <
+              matrix_library::cpu_simple::matrix_chain::LeftToRightCost(
+                  {500, 500, 500, 1}));
+
+  // (A * B) * (C * D) has 2 independent products in its first wave
+  auto waves = matrix_library::cpu_simple::matrix_chain::PlanWaves(
+      matrix_library::cpu_simple::matrix_chain::PlanChain(
+          {2, 300, 2, 300, 2}));
+  ASSERT_TRUE(waves.size() == 2);
+  ASSERT_TRUE(waves[0].size() == 2);
+  ASSERT_TRUE(waves[1].size() == 1);
+  ASSERT_TRUE(waves[1][0].first == 0 && waves[1][0].split == 1 &&
+              waves[1][0].last == 3);
+}
+
+TEST(CpuSimpleTest, MultiplyChain) {
+  auto A = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<int>(30, 1));
+  auto B = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<int>(1, 40));
+  auto C = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<int>(40, 70));
+  auto D = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<int>(70, 3));
+  auto ABCD_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+          matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B), C),
+      D);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MultiplyChain(
+          {std::cref(A), std::cref(B), std::cref(C), std::cref(D)}),
+      ABCD_ans));
+  // The same matrix can appear more than once
+  auto E = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<double>(9, 9));
+  std::vector<std::reference_wrapper<
+      const matrix_library::utils::dense_matrix::DenseMatrix<double>>>
+      chain(5, std::cref(E));
+  auto E2 = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(E, E);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MultiplyChain(chain),
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+          matrix_library::cpu_simple::matrix_ops::MatrixMultiply(E2, E2),
+          E)));
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MultiplyChain({std::cref(E)}),
+      E));
+
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MultiplyChain(
+          {std::cref(A), std::cref(C)}),
+      std::runtime_error);
+  chain.clear();
+  EXPECT_THROW(matrix_library::cpu_simple::matrix_ops::MultiplyChain(chain),
+               std::runtime_error);
+}
+
+/**
+ * @brief Checks C = alpha * A * B + beta * C against separate products and
+ * element loops for every special value of alpha and beta
+ */
+template <typename T>
+void ExpectAlphaBetaMultiplyMatches(size_t m, size_t n, size_t k) {
+  auto A = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<T>(m, k));
+  auto B_T = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<T>(n, k));
+  auto D = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<T>(m, n));
+  auto AB = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+      A, matrix_library::utils::dense_matrix::Transposed(B_T));
+  const T scales[] = {static_cast<T>(0), static_cast<T>(1), static_cast<T>(2),
+                      static_cast<T>(-3)};
+  for (T alpha : scales) {
+    for (T beta : scales) {
+      auto C = D;
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+          alpha, A,
+          matrix_library::utils::dense_matrix::Operation::kNoTranspose, B_T,
+          matrix_library::utils::dense_matrix::Operation::kTranspose, beta, C);
+      bool matches = true;
+      for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+          matches = matches && C(i, j) == static_cast<T>(alpha * AB(i, j) +
+                                                         beta * D(i, j));
+        }
+      }
+      EXPECT_TRUE(matches);
+    }
+  }
+}
+
+TEST(CpuSimpleTest, AlphaBetaMatrixMultiplyInto) {
+  // Small products use the simple loop and large ones the blocked kernel
+  ExpectAlphaBetaMultiplyMatches<int>(5, 4, 3);
+  ExpectAlphaBetaMultiplyMatches<float>(70, 65, 80);
+  ExpectAlphaBetaMultiplyMatches<double>(1, 9, 6);
+  ExpectAlphaBetaMultiplyMatches<double>(66, 90, 64);
+
+  auto A = matrix_library::utils::dense_matrix::CreateMatrix(2, 3, 1);
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(2, 2, 0);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+          2, A, matrix_library::utils::dense_matrix::Operation::kNoTranspose,
+          A, matrix_library::utils::dense_matrix::Operation::kNoTranspose, 1,
+          C),
+      std::runtime_error);
+}
+
+TEST(CpuSimpleTest, MatrixExpressions) {
+  using namespace matrix_library::cpu_simple::matrix_expressions;  // NOLINT
+  auto A = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<double>(70, 80));
+  auto B = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<double>(80, 65));
+  auto D = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<double>(70, 65));
+  auto E = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      65, 70, 0.0, 1.0);
+  auto AB = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+
+  // Elementwise chains are one pass with no temporaries
+  matrix_library::utils::dense_matrix::DenseMatrix<double> C =
+      D + 2.0 * D - matrix_library::utils::dense_matrix::Transposed(E) * 0.5;
+  bool matches = true;
+  for (size_t i = 0; i < 70; i++) {
+    for (size_t j = 0; j < 65; j++) {
+      matches = matches && C(i, j) == 3 * D(i, j) - 0.5 * E(j, i);
+    }
+  }
+  EXPECT_TRUE(matches);
+
+  // alpha * A * B + beta * D evaluates into the storage C already has
+  const double* data = C.data();
+  C = 2.0 * A * B + 3.0 * D;
+  ASSERT_TRUE(C.data() == data);
+  matches = true;
+  for (size_t i = 0; i < 70; i++) {
+    for (size_t j = 0; j < 65; j++) {
+      matches = matches && C(i, j) == 2 * AB(i, j) + 3 * D(i, j);
+    }
+  }
+  EXPECT_TRUE(matches);
+
+  // C may be read elementwise, as the beta term of a GEMM
+  auto F = D;
+  F = A * B * -1.0 + 2.0 * F - D;
+  matches = true;
+  for (size_t i = 0; i < 70; i++) {
+    for (size_t j = 0; j < 65; j++) {
+      matches = matches && F(i, j) == D(i, j) - AB(i, j);
+    }
+  }
+  EXPECT_TRUE(matches);
+
+  // Products with transposed operands and a reshaped result
+  auto A_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A);
+  matrix_library::utils::dense_matrix::DenseMatrix<double> G;
+  G = matrix_library::utils::dense_matrix::Transposed(A_T) * B -
+      0.5 * (A * B);
+  EXPECT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      G, matrix_library::utils::dense_matrix::DenseMatrix<double>(0.5 * AB)));
+
+  auto H = matrix_library::utils::dense_matrix::CreateMatrix(3, 3, 1);
+  auto I = matrix_library::utils::dense_matrix::CreateMatrix(3, 2, 1);
+  EXPECT_THROW(H = H + I, std::runtime_error);
+  EXPECT_THROW(H = I * H, std::runtime_error);
+  EXPECT_THROW(H = H * H, std::runtime_error);
+  EXPECT_THROW(H = matrix_library::utils::dense_matrix::Transposed(H) + H,
+               std::runtime_error);
+}
+
+/**
+ * @brief Checks C = epilogue(A * B^T) against the plain product followed by
+ * the epilogue, for an output type that may differ from the inputs
+ */
+template <typename T, typename U, typename Epilogue>
+void ExpectEpilogueMatches(size_t m, size_t n, size_t k,
+                           const Epilogue& epilogue) {
+  auto A = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<T>(m, k));
+  auto B_T = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<T>(n, k));
+  auto AB = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+      A, matrix_library::utils::dense_matrix::Transposed(B_T));
+  matrix_library::utils::dense_matrix::DenseMatrix<U> C(m, n, n + 2,
+                                                        static_cast<U>(7));
+  matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+      A, matrix_library::utils::dense_matrix::Operation::kNoTranspose, B_T,
+      matrix_library::utils::dense_matrix::Operation::kTranspose, C, epilogue);
+  bool matches = true;
+  for (size_t i = 0; i < m; i++) {
+    for (size_t j = 0; j < n; j++) {
+      // Activations may be evaluated with different contractions
+      const double expected =
+          static_cast<double>(static_cast<U>(epilogue(i, j, AB(i, j))));
+      matches = matches && std::abs(static_cast<double>(C(i, j)) - expected) <=
+                               1e-6 * (1 + std::abs(expected));
+    }
+  }
+  EXPECT_TRUE(matches);
+}
+
+TEST(CpuSimpleTest, GemmEpilogues) {
+  namespace epilogues = matrix_library::cpu_simple::gemm_epilogues;
+  std::vector<float> float_bias(70);
+  std::vector<int> int_bias(70);
+  for (size_t j = 0; j < 70; j++) {
+    float_bias[j] = static_cast<float>(j % 9) - 4.5f;
+    int_bias[j] = static_cast<int>(j % 13) - 6;
+  }
+  // Bias, scale and ReLU on small and blocked sizes
+  ExpectEpilogueMatches<float, float>(
+      5, 6, 7,
+      epilogues::Fuse(epilogues::Scale<float>(2),
+                      epilogues::ColumnBias<float>(float_bias.data()),
+                      epilogues::Relu()));
+  ExpectEpilogueMatches<float, float>(
+      69, 70, 80,
+      epilogues::Fuse(epilogues::ColumnBias<float>(float_bias.data()),
+                      epilogues::Relu()));
+  ExpectEpilogueMatches<double, double>(33, 17, 65, epilogues::Gelu());
+  // Deep inner dimensions keep partial sums between passes, in C itself or
+  // in a scratch matrix when C has another type
+  ExpectEpilogueMatches<int, int>(
+      20, 30, 1100, epilogues::RowBias<int>(int_bias.data()));
+  ExpectEpilogueMatches<double, float>(9, 40, 1100, epilogues::Identity());
+  ExpectEpilogueMatches<int, int64_t>(
+      3, 70, 600,
+      epilogues::Fuse(epilogues::Scale<int>(-3), epilogues::Relu()));
+  // Tiny blocks split the scratch partial sums over several column panels
+  const matrix_library::cpu_simple::blocked_gemm::BlockSizes blocks = {8, 5,
+                                                                       12};
+  auto D = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      19, 23, -100, 3);
+  auto E = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      23, 29, 50, -1);
+  auto DE = ReferenceMultiply(
+      matrix_library::utils::dense_matrix::ToNestedVector(D),
+      matrix_library::utils::dense_matrix::ToNestedVector(E));
+  matrix_library::utils::dense_matrix::DenseMatrix<int64_t> F(19, 29, 31, 0);
+  matrix_library::cpu_simple::blocked_gemm::GemmEpilogue<int>(
+      19, 29, 23,
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<int>(
+          D.data(), D.leading_dimension(), 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOperand<int>(
+          E.data(), E.leading_dimension(), 1),
+      matrix_library::cpu_simple::blocked_gemm::StridedOutput<int64_t>(
+          F.data(), F.leading_dimension()),
+      epilogues::Identity(),
+      matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<int>(),
+      blocks);
+  bool panels_match = true;
+  for (size_t i = 0; i < 19; i++) {
+    for (size_t j = 0; j < 29; j++) {
+      panels_match = panels_match && F(i, j) == DE[i][j];
+    }
+  }
+  EXPECT_TRUE(panels_match);
+  // Any callable works and sees the position of each element
+  ExpectEpilogueMatches<int, int>(
+      70, 65, 66, [](size_t i, size_t j, int value) {
+        return value + static_cast<int>(i * 100 + j);
+      });
+  // An empty inner dimension stores the epilogue of 0
+  ExpectEpilogueMatches<float, float>(
+      4, 3, 0, epilogues::ColumnBias<float>(float_bias.data()));
+
+  auto A = matrix_library::utils::dense_matrix::CreateMatrix(2, 3, 1);
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(2, 2, 0);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+          A, matrix_library::utils::dense_matrix::Operation::kNoTranspose, A,
+          matrix_library::utils::dense_matrix::Operation::kNoTranspose, C,
+          epilogues::Relu()),
+      std::runtime_error);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+          A, matrix_library::utils::dense_matrix::Operation::kNoTranspose, A,
+          matrix_library::utils::dense_matrix::Operation::kTranspose, A,
+          epilogues::Relu()),
+      std::runtime_error);
+}
+
+/**
+ * @brief Checks products with a packed B against the same products with B
+ * packed on every call, overwriting, accumulating and with an epilogue
+ */
+template <typename T>
+void ExpectPackedMultiplyMatches(
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& A,
+    const matrix_library::utils::dense_matrix::DenseMatrix<T>& B,
+    const matrix_library::cpu_simple::packed_matrix::PackedMatrix<T>& packed) {
+  auto AB_ans = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  EXPECT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, packed),
+      AB_ans));
+  bool matches = true;
+  for (size_t i = 0; i < B.num_rows(); i++) {
+    for (size_t j = 0; j < B.num_cols(); j++) {
+      matches = matches && packed(i, j) == B(i, j);
+    }
+  }
+  EXPECT_TRUE(matches);
+  auto C = AB_ans;
+  matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(A, packed, C,
+                                                             true);
+  matrix_library::utils::dense_matrix::DenseMatrix<double> D(
+      A.num_rows(), B.num_cols(), 0.0);
+  matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(
+      A, packed, D, matrix_library::cpu_simple::gemm_epilogues::Relu());
+  for (size_t i = 0; i < C.num_rows(); i++) {
+    for (size_t j = 0; j < C.num_cols(); j++) {
+      matches = matches && C(i, j) == AB_ans(i, j) + AB_ans(i, j) &&
+                D(i, j) == static_cast<double>(AB_ans(i, j) > 0 ? AB_ans(i, j)
+                                                                : 0);
+    }
+  }
+  EXPECT_TRUE(matches);
+}
+
+TEST(CpuSimpleTest, PackedMatrixMultiply) {
+  auto A = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<float>(150, 300));
+  auto B = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<float>(300, 200));
+  auto B_T = matrix_library::cpu_simple::matrix_ops::MatrixTranspose(B);
+  ExpectPackedMultiplyMatches(
+      A, B, matrix_library::cpu_simple::packed_matrix::PackedMatrix<float>(B));
+  // Weights stored with one row per output are packed transposed
+  ExpectPackedMultiplyMatches(
+      A, B,
+      matrix_library::cpu_simple::packed_matrix::PackedMatrix<float>(
+          B_T, matrix_library::utils::dense_matrix::Operation::kTranspose));
+  // Several blocks in both directions, and panels packed for another
+  // micro-kernel which are read element by element
+  const size_t nr =
+      matrix_library::cpu_simple::blocked_gemm::DefaultMicroKernel<float>()
+          .nr;
+  const matrix_library::cpu_simple::blocked_gemm::BlockSizes blocks = {64, 37,
+                                                                       50};
+  ExpectPackedMultiplyMatches(
+      A, B,
+      matrix_library::cpu_simple::packed_matrix::PackedMatrix<float>(
+          B, matrix_library::utils::dense_matrix::Operation::kNoTranspose, nr,
+          blocks));
+  ExpectPackedMultiplyMatches(
+      A, B,
+      matrix_library::cpu_simple::packed_matrix::PackedMatrix<float>(
+          B, matrix_library::utils::dense_matrix::Operation::kNoTranspose,
+          nr + 3, blocks));
+  auto E = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<int>(3, 5));
+  auto F = matrix_library::utils::dense_matrix::FromNestedVector(
+      PatternMatrix<int>(5, 4));
+  ExpectPackedMultiplyMatches(
+      E, F, matrix_library::cpu_simple::packed_matrix::PackedMatrix<int>(F));
+
+  // A serialized matrix reads back identical and only as its own type
+  const matrix_library::cpu_simple::packed_matrix::PackedMatrix<float> packed(
+      B_T, matrix_library::utils::dense_matrix::Operation::kTranspose);
+  std::stringstream stream;
+  packed.Serialize(stream);
+  const std::string bytes = stream.str();
+  auto loaded =
+      matrix_library::cpu_simple::packed_matrix::PackedMatrix<float>::
+          Deserialize(stream);
+  ASSERT_TRUE(loaded.num_rows() == 300 && loaded.num_cols() == 200);
+  ASSERT_TRUE(loaded.nr() == packed.nr() && loaded.kc() == packed.kc() &&
+              loaded.nc() == packed.nc());
+  ASSERT_TRUE(loaded.storage() == packed.storage());
+  ExpectPackedMultiplyMatches(A, B, loaded);
+  std::stringstream as_int(bytes);
+  EXPECT_THROW(matrix_library::cpu_simple::packed_matrix::PackedMatrix<
+                   int>::Deserialize(as_int),
+               std::runtime_error);
+  std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+  EXPECT_THROW(matrix_library::cpu_simple::packed_matrix::PackedMatrix<
+                   float>::Deserialize(truncated),
+               std::runtime_error);
+  // Dimensions whose padded size overflows, or that need more elements than
+  // the stream holds, are rejected before anything is allocated
+  auto with_dimensions = [&bytes](uint64_t num_rows, uint64_t num_cols) {
+    std::string corrupt = bytes;
+    std::memcpy(&corrupt[3 * sizeof(uint64_t)], &num_rows, sizeof(num_rows));
+    std::memcpy(&corrupt[4 * sizeof(uint64_t)], &num_cols, sizeof(num_cols));
+    return corrupt;
+  };
+  std::stringstream overflowing(with_dimensions(2, ~uint64_t{0}));
+  EXPECT_THROW(matrix_library::cpu_simple::packed_matrix::PackedMatrix<
+                   float>::Deserialize(overflowing),
+               std::runtime_error);
+  std::stringstream wrapping(with_dimensions(uint64_t{1} << 40,
+                                             uint64_t{1} << 40));
+  EXPECT_THROW(matrix_library::cpu_simple::packed_matrix::PackedMatrix<
+                   float>::Deserialize(wrapping),
+               std::runtime_error);
+  std::stringstream too_long(with_dimensions(301, 200));
+  EXPECT_THROW(matrix_library::cpu_simple::packed_matrix::PackedMatrix<
+                   float>::Deserialize(too_long),
+               std::runtime_error);
+
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(B, packed),
+      std::runtime_error);
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(150, 199, 0.0f);
+  EXPECT_THROW(
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiplyInto(A, packed, C),
+      std::runtime_error);
+}
@@ -0,0 +1,171 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing tests for the contiguous dense matrix
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "matrix_library/utils/dense_matrix.h"
+#include "matrix_library/utils/matrix_utils.h"
+
+TEST(DenseMatrixTest, CreateMatrixEmpty) {
+  auto A = matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 1);
+  ASSERT_TRUE(A.empty());
+  ASSERT_TRUE(A.num_cols() == 0);
+  auto B = matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 1.0f);
+  ASSERT_TRUE(B.empty());
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 1.0);
+  ASSERT_TRUE(C.empty());
+}
+
+TEST(DenseMatrixTest, CreateMatrixZeroRowsOneCol) {
+  EXPECT_THROW(matrix_library::utils::dense_matrix::CreateMatrix(0, 1, 1),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::utils::dense_matrix::CreateMatrix(0, 1, 1.0f),
+               std::runtime_error);
+  EXPECT_THROW(matrix_library::utils::dense_matrix::CreateMatrix(0, 1, 1.0),
+               std::runtime_error);
+}
+
+TEST(DenseMatrixTest, CreateMatrixOneRowZeroCols) {
+  auto A = matrix_library::utils::dense_matrix::CreateMatrix(1, 0, 1);
+  ASSERT_TRUE(A.num_rows() == 1);
+  ASSERT_TRUE(A.num_cols() == 0);
+  auto B = matrix_library::utils::dense_matrix::CreateMatrix(1, 0, 1.0f);
+  ASSERT_TRUE(B.num_rows() == 1);
+  ASSERT_TRUE(B.num_cols() == 0);
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(1, 0, 1.0);
+  ASSERT_TRUE(C.num_rows() == 1);
+  ASSERT_TRUE(C.num_cols() == 0);
+}
+
+TEST(DenseMatrixTest, CreateMatrix) {
+  auto A = matrix_library::utils::dense_matrix::CreateMatrix(3, 2, -1);
+  ASSERT_TRUE(A.num_rows() == 3);
+  ASSERT_TRUE(A.num_cols() == 2);
+  ASSERT_TRUE(A.leading_dimension() == 2);
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 2; j++) {
+      ASSERT_TRUE(A.At(i, j) == -1);
+    }
+  }
+  auto B = matrix_library::utils::dense_matrix::CreateMatrix(3, 2, 1.0f);
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 2; j++) {
+      ASSERT_TRUE(B.At(i, j) == 1.0f);
+    }
+  }
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(3, 2, 0.0);
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 2; j++) {
+      ASSERT_TRUE(C.At(i, j) == 0.0);
+    }
+  }
+}
+
+TEST(DenseMatrixTest, CreateSeqMatrix) {
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(3, 2, 1,
+                                                                       2);
+  auto A_nested =
+      matrix_library::utils::matrix_utils::CreateSequentialMatrix(3, 2, 1, 2);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(A), A_nested));
+  auto B = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      2, 3, -1.0f, 0.5f);
+  auto B_nested = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      2, 3, -1.0f, 0.5f);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(B), B_nested));
+  auto C = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      4, 4, 0.0, -1.0);
+  auto C_nested = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      4, 4, 0.0, -1.0);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(C), C_nested));
+  EXPECT_THROW(
+      matrix_library::utils::dense_matrix::CreateSequentialMatrix(0, 1, 1, 1),
+      std::runtime_error);
+}
+
+TEST(DenseMatrixTest, LeadingDimension) {
+  matrix_library::utils::dense_matrix::DenseMatrix<int> A(2, 3, 8, 5);
+  ASSERT_TRUE(A.leading_dimension() == 8);
+  ASSERT_TRUE(A.row(1) - A.row(0) == 8);
+  auto B = matrix_library::utils::dense_matrix::CreateMatrix(2, 3, 5);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(A, B));
+  EXPECT_THROW(
+      matrix_library::utils::dense_matrix::DenseMatrix<int>(2, 3, 2, 0),
+      std::runtime_error);
+}
+
+TEST(DenseMatrixTest, ElementAccess) {
+  auto A = matrix_library::utils::dense_matrix::CreateSequentialMatrix(2, 3, 0,
+                                                                       1);
+  ASSERT_TRUE(A(1, 2) == 5);
+  A(1, 2) = 7;
+  ASSERT_TRUE(A.At(1, 2) == 7);
+  EXPECT_THROW(A.At(2, 0), std::out_of_range);
+  EXPECT_THROW(A.At(0, 3), std::out_of_range);
+}
+
+TEST(DenseMatrixTest, MatrixEquality) {
+  auto A = matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 1);
+  auto B = matrix_library::utils::dense_matrix::CreateMatrix(0, 0, 2);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(A, B));
+  auto C = matrix_library::utils::dense_matrix::CreateMatrix(2, 3, 1.0f);
+  auto D = matrix_library::utils::dense_matrix::CreateMatrix(3, 2, 1.0f);
+  ASSERT_FALSE(matrix_library::utils::dense_matrix::IsMatricesEqual(C, D));
+  auto E = matrix_library::utils::dense_matrix::CreateMatrix(2, 3, 1.0f);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(C, E));
+  E(1, 1) = 2.0f;
+  ASSERT_FALSE(matrix_library::utils::dense_matrix::IsMatricesEqual(C, E));
+  auto F = matrix_library::utils::dense_matrix::CreateMatrix(1, 0, 1.0);
+  auto G = matrix_library::utils::dense_matrix::CreateMatrix(2, 0, 1.0);
+  ASSERT_FALSE(matrix_library::utils::dense_matrix::IsMatricesEqual(F, G));
+}
+
+TEST(DenseMatrixTest, NestedVectorRoundTrip) {
+  auto A = matrix_library::utils::matrix_utils::CreateSequentialMatrix(4, 3, 1,
+                                                                       1);
+  auto A_dense = matrix_library::utils::dense_matrix::FromNestedVector(A);
+  ASSERT_TRUE(A_dense.num_rows() == 4);
+  ASSERT_TRUE(A_dense.num_cols() == 3);
+  ASSERT_TRUE(A_dense(3, 2) == 12);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::dense_matrix::ToNestedVector(A_dense), A));
+
+  auto B = matrix_library::utils::matrix_utils::CreateMatrix(3, 0, 1.0f);
+  auto B_dense = matrix_library::utils::dense_matrix::FromNestedVector(B);
+  ASSERT_TRUE(B_dense.num_rows() == 3);
+  ASSERT_TRUE(B_dense.num_cols() == 0);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::ToNestedVector(B_dense) ==
+              B);
+
+  std::vector<std::vector<double>> C = {{1.0, 2.0}, {3.0}};
+  EXPECT_THROW(matrix_library::utils::dense_matrix::FromNestedVector(C),
+               std::runtime_error);
+}
+
+TEST(DenseMatrixTest, StorageAdoption) {
+  matrix_library::utils::dense_matrix::DenseMatrix<double>::Storage storage = {
+      1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  const double* buffer = storage.data();
+  matrix_library::utils::dense_matrix::DenseMatrix<double> A(
+      2, 3, std::move(storage));
+  ASSERT_TRUE(A.data() == buffer);
+  ASSERT_TRUE(A(1, 0) == 4.0);
+  auto released = A.ReleaseStorage();
+  ASSERT_TRUE(released.data() == buffer);
+  ASSERT_TRUE(A.empty());
+
+  matrix_library::utils::dense_matrix::DenseMatrix<int>::Storage wrong_size(5);
+  EXPECT_THROW(matrix_library::utils::dense_matrix::DenseMatrix<int>(
+                   2, 3, std::move(wrong_size)),
+               std::runtime_error);
+}
@@ -0,0 +1,118 @@
+//  Copyright 2023 Siddharth Saha. All Rights Reserved
+/**
+ * @file
+ * @brief Containing tests for the fixed size matrix
+ *
+ * @author Siddharth Saha <sisahawork@gmail.com>
+ * @version 1.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix_library/cpu_simple/matrix_ops.h"
+#include "matrix_library/utils/dense_matrix.h"
+#include "matrix_library/utils/fixed_matrix.h"
+#include "matrix_library/utils/matrix_utils.h"
+
+/**
+ * @brief Detects whether MatrixMultiply compiles for 2 matrix types
+ */
+template <typename A, typename B, typename = void>
+struct CanMultiply : std::false_type {};
+
+template <typename A, typename B>
+struct CanMultiply<
+    A, B,
+    decltype(static_cast<void>(
+        matrix_library::cpu_simple::matrix_ops::MatrixMultiply(
+            std::declval<const A&>(), std::declval<const B&>())))>
+    : std::true_type {};
+
+TEST(FixedMatrixTest, ConstexprMultiplyTranspose) {
+  constexpr matrix_library::utils::fixed_matrix::Matrix<int, 2, 3> A = {
+      {1, 2, 3, 4, 5, 6}};
+  constexpr matrix_library::utils::fixed_matrix::Matrix<int, 3, 2> B =
+      matrix_library::cpu_simple::matrix_ops::MatrixTranspose(A);
+  constexpr matrix_library::utils::fixed_matrix::Matrix<int, 2, 2> C =
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  // Evaluated by the compiler
+  static_assert(B(0, 1) == 4 && B(2, 0) == 3, "Transpose is not constexpr");
+  static_assert(C(0, 0) == 14 && C(0, 1) == 32 && C(1, 0) == 32 &&
+                    C(1, 1) == 77,
+                "Multiply is not constexpr");
+  static_assert(C.num_rows() == 2 && C.num_cols() == 2, "Wrong shape");
+  // Inner dimensions are checked by the type system
+  static_assert(
+      CanMultiply<matrix_library::utils::fixed_matrix::Matrix<int, 2, 3>,
+                  matrix_library::utils::fixed_matrix::Matrix<int, 3, 4>>::
+          value,
+      "Matching shapes must multiply");
+  static_assert(
+      !CanMultiply<matrix_library::utils::fixed_matrix::Matrix<int, 2, 3>,
+                   matrix_library::utils::fixed_matrix::Matrix<int, 2, 3>>::
+          value,
+      "Mismatched shapes must not multiply");
+  static_assert(
+      sizeof(matrix_library::utils::fixed_matrix::Matrix<double, 4, 4>) ==
+          16 * sizeof(double),
+      "Storage must be inline");
+  ASSERT_TRUE(C(1, 1) == 77);
+}
+
+TEST(FixedMatrixTest, MatchesDynamicMultiply) {
+  auto A_nested = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      4, 4, 0.5f, 0.25f);
+  auto B_nested = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      4, 4, -2.0f, 0.5f);
+  auto A = matrix_library::utils::fixed_matrix::FromNestedVector<4, 4>(
+      A_nested);
+  auto B = matrix_library::utils::fixed_matrix::FromNestedVector<4, 4>(
+      B_nested);
+  auto C = matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A, B);
+  ASSERT_TRUE(matrix_library::utils::matrix_utils::IsMatricesEqual(
+      matrix_library::utils::fixed_matrix::ToNestedVector(C),
+      matrix_library::cpu_simple::matrix_ops::MatrixMultiply(A_nested,
+                                                             B_nested)));
+
+  auto D_dense = matrix_library::utils::dense_matrix::CreateSequentialMatrix(
+      3, 5, 1.0, 1.0);
+  auto D = matrix_library::utils::fixed_matrix::FromDenseMatrix<3, 5>(D_dense);
+  ASSERT_TRUE(matrix_library::utils::dense_matrix::IsMatricesEqual(
+      matrix_library::utils::fixed_matrix::ToDenseMatrix(
+          matrix_library::cpu_simple::matrix_ops::MatrixTranspose(D)),
+      matrix_library::cpu_simple::matrix_ops::MatrixTranspose(D_dense)));
+  ASSERT_TRUE(matrix_library::utils::fixed_matrix::IsMatricesEqual(
+      matrix_library::cpu_simple::matrix_ops::MatrixTranspose(
+          matrix_library::cpu_simple::matrix_ops::MatrixTranspose(D)),
+      D));
+
+  auto E_nested = matrix_library::utils::matrix_utils::CreateSequentialMatrix(
+      3, 3, 1, 2);
+  auto E = matrix_library::utils::fixed_matrix::FromNestedVector<3, 3>(
+      E_nested);
+  ASSERT_TRUE(E(2, 1) == 15);
+  E(2, 1) = 0;
+  ASSERT_TRUE(E.data()[7] == 0);
+}
+
+TEST(FixedMatrixTest, ConversionShapeMismatch) {
+  auto A = matrix_library::utils::matrix_utils::CreateMatrix(3, 4, 1);
+  EXPECT_THROW(
+      (matrix_library::utils::fixed_matrix::FromNestedVector<4, 4>(A)),
+      std::runtime_error);
+  EXPECT_THROW(
+      (matrix_library::utils::fixed_matrix::FromNestedVector<3, 3>(A)),
+      std::runtime_error);
+  A.back().pop_back();
+  EXPECT_THROW(
+      (matrix_library::utils::fixed_matrix::FromNestedVector<3, 4>(A)),
+      std::runtime_error);
+  auto B = matrix_library::utils::dense_matrix::CreateMatrix(2, 2, 1.0);
+  EXPECT_THROW(
+      (matrix_library::utils::fixed_matrix::FromDenseMatrix<2, 3>(B)),
+      std::runtime_error);
+}